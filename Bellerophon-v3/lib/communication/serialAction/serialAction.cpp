@@ -6,19 +6,35 @@ DataLogger& logger, PositionalServo& servo, BuzzerFunctions& buzzer, LEDManager&
  : communicator(communicator), config(config), logger(logger),
   servo(servo), buzzer(buzzer), LED(LED)  {}
 
-void SerialAction::checkSerialForMode() {
-    // Call readSerialMessage to get the message
+bool SerialAction::update() {
+    PROFILE_SCOPE(SERIAL_MODE);
+    syncMode();
+
+    // Call readSerialMessage to get the message, one character is read per call
     char* message = communicator.readSerialMessage();
+
+    if (continueFileOperation(message)) {
+        delete[] message;
+        return true;
+    }
     
     if(SerialCommunicator::isNullOrEmpty(message)){
         delete[] message;
-        return;
+        checkModeTimeout();
+        return false;
+    }
+
+    if (strcmp(message, PROFILE_REQUEST_MESSAGE) == 0) {
+        printProfile();
+        delete[] message;
+        return true;
     }
 
     // Check for mode change command from serial input
     if (strncmp(message, "mode:", 5) != 0) {
+        handleModeMessage(message);
         delete[] message;
-        return;
+        return true;
     }
 
     char newMode = message[5]; // Get the mode character
@@ -26,47 +42,128 @@ void SerialAction::checkSerialForMode() {
         mode = newMode - '0';  // Convert char to int
         Serial.print("Mode changed to: ");
         Serial.println(mode);
+        syncMode();
     } else {
         Serial.println("Invalid mode.");
     }
 
     delete[] message; // Free the allocated message buffer
+    return true;
 }
 
+void SerialAction::setBlockingActionsAllowed(bool allowed) {
+    blockingActionsAllowed = allowed;
+}
 
-void SerialAction::moveServosFromSerial() {
-
-    if (!confirmAction(MANUAL_SERVO_CONTROL_MESSAGE)) {
+void SerialAction::syncMode() {
+    if (mode == activeMode) {
         return;
     }
-    // indicate start of servo control mode
-    LED.blink(G_LED, 500);
-
-    while (true) {
+    // A new mode waits for its confirmation from now, and leaving a mode stops its file operation
+    stopFileOperation();
+    activeMode = mode;
+    modeConfirmed = false;
+    awaitingFilesAck = false;
+    waitStartTime = millis();
+}
 
-        // Updates the buzzer state so it does not get stuck even in while loop.
-        /// TODO: remove blocking so we don't need crude solutions like this
-        buzzer.update();
-        LED.updateAllLEDS();
+void SerialAction::handleModeMessage(const char* input) {
+    const char* confirmation = confirmationMessage(activeMode);
+    if (confirmation == nullptr) {
+        // Standby and logging take no commands
+        return;
+    }
 
-        // Use communicator to read the serial message
-        char* input = communicator.readSerialMessage();
+    // Cancel out of the mode and return to standby
+    if (checkForCancelRequest(input)) {
+        return;
+    }
 
-        // If input is null or empty, continue to the next iteration
-        if (communicator.isNullOrEmpty(input)) {
-            delete[] input;
-            continue;
+    if (!modeConfirmed) {
+        // Wait for unique message to confirm the mode, anything else is ignored
+        if (strcmp(input, confirmation) != 0) {
+            return;
+        }
+        modeConfirmed = true;
+        LED.blink(G_LED, 1000);
+        if (activeMode == READING_MODE) {
+            serialFileTransfer();
+        } else if (activeMode == PURGE_MODE) {
+            purgeDataFromSerial();
         }
+        return;
+    }
 
-        // Cancel out of servo control and return to standby
-        if(checkForCancelRequest(input)){
-            return;
+    switch (activeMode) {
+        case READING_MODE: {
+            if (awaitingFilesAck && strcmp(input, ALL_FILES_SENT_ACK) == 0) {
+                buzzer.success();
+                LED.blink(G_LED, 1000);
+                // return to standby
+                mode = STANDBY_MODE;
+            }
+            break;
         }
+        case FIN_CONTROL_MODE: {
+            moveServosFromSerial(input);
+            break;
+        }
+        case CONFIG_MODE: {
+            processAndChangeConfig(input);
+            break;
+        }
+    }
+}
+
+void SerialAction::checkModeTimeout() {
+    if (confirmationMessage(activeMode) == nullptr || (modeConfirmed && !awaitingFilesAck)) {
+        return;
+    }
+    if (millis() - waitStartTime < modeActivationWaitPeriod) {
+        return;
+    }
+    if (awaitingFilesAck) {
+        buzzer.failure();
+    } else {
+        LED.blink(R_LED, 1000);
+    }
+    // Return to standby if the expected message was not received
+    mode = STANDBY_MODE;
+}
+
+const char* SerialAction::confirmationMessage(int modeNum) {
+    switch (modeNum) {
+        case READING_MODE:
+            return REQUEST_FILE_DOWNLOAD;
+        case PURGE_MODE:
+            return DELETE_FILE_MESSAGE;
+        case FIN_CONTROL_MODE:
+            return MANUAL_SERVO_CONTROL_MESSAGE;
+        case CONFIG_MODE:
+            return CHANGE_SETTINGS_MESSAGE;
+        default:
+            return nullptr;
+    }
+}
 
-        processServoCommand(input);
+void SerialAction::printProfile() {
+#ifdef PROFILING
+    for (size_t i = 0; i < static_cast<size_t>(ProfileSection::NUM_SECTIONS); ++i) {
+        char line[256];
+        Profiler::format(static_cast<ProfileSection>(i), line, sizeof(line));
+        Serial.println(line);
+    }
+#else
+    Serial.println("Profiling not enabled in this build.");
+#endif
+}
 
-        delete[] input;  // Free the allocated memory
+void SerialAction::moveServosFromSerial(const char* input) {
+    // Moving a fin also rewrites its center position in the config
+    if (refuseBlockingAction("Fin control")) {
+        return;
     }
+    processServoCommand(input);
 }
 
 void SerialAction::moveServoandUpdateConfig(char servoID, int position) {
@@ -124,90 +221,86 @@ void SerialAction::processServoCommand(const char* input) {
 }
 
 void SerialAction::serialFileTransfer() {
-    
-    // Check for incoming serial message, return to standby if not receieved
-    if(!confirmAction(REQUEST_FILE_DOWNLOAD)){
+    if (refuseBlockingAction("File transfer")) {
         return;
     }
-    // Send all files if correct message receieved
     LED.blink(G_LED, 500);
-    logger.sendAllFiles();
-
-    // Send the end-of-transmission acknowledgment
-    Serial.println(ALL_FILES_SENT);
-   
-    // Wait for confirmation
-    if (!communicator.waitForMessage(ALL_FILES_SENT_ACK, modeActivationWaitPeriod)) {
-        // Handle timeout (optional)
-        buzzer.failure();
-    } else {
-        buzzer.success();
-        LED.blink(G_LED, 1000);
-    }
-
-    // return to standby
-    mode = 0;
+    logger.startFileTransfer();
+    transferringFiles = true;
 }
 
 /// TODO: have this do nothing if there are already zero files, or maybe move to standby mode
 /// TODO: create new new public method for serial based deletion, either individual files or all files and make this one private
 void SerialAction::purgeDataFromSerial() {
-
-    if(!confirmAction(DELETE_FILE_MESSAGE)){
+    if (refuseBlockingAction("Purge")) {
         return;
     }
-    ///TODO: make this a bool, in case there was any issue deleting files
-    logger.deleteAllFiles();
-
-    // Return to standby
-    buzzer.success();
-    LED.blink(FLASH_LED, 1000);
-    mode = 0;
-
+    logger.startDeletingFiles();
+    purgingFiles = true;
 }
 
-void SerialAction::processAndChangeConfig() {
-    // Wait for unique message to confirm config mode
-   if(!confirmAction(CHANGE_SETTINGS_MESSAGE)){
-        return;
-   }
+bool SerialAction::continueFileOperation(const char* message) {
+    if (!transferringFiles && !purgingFiles) {
+        return false;
+    }
+    // Launch stops a file operation part way through
+    if (refuseBlockingAction(transferringFiles ? "File transfer" : "Purge")) {
+        stopFileOperation();
+        return false;
+    }
 
-    while(true) {
+    if (purgingFiles) {
+        ///TODO: make this a bool, in case there was any issue deleting files
+        if (!logger.deleteNextFile()) {
+            purgingFiles = false;
+            // Return to standby
+            buzzer.success();
+            LED.blink(FLASH_LED, 1000);
+            mode = STANDBY_MODE;
+        }
+        return false;
+    }
 
-        // Updates the buzzer state so it does not get stuck even in while loop.
-        /// TODO: remove blocking so we don't need crude solutions like this
-        buzzer.update();
-        LED.updateAllLEDS();
+    bool handshake = strcmp(message, FILE_COPY_MESSAGE) == 0 || strcmp(message, END_OF_TRANSMISSION_ACK) == 0;
+    if (!logger.updateFileTransfer(message)) {
+        transferringFiles = false;
+        // Send the end-of-transmission acknowledgment
+        Serial.println(ALL_FILES_SENT);
 
-        char* input = communicator.readSerialMessage();
+        // Wait for confirmation in later updates
+        awaitingFilesAck = true;
+        waitStartTime = millis();
+    }
+    return handshake;
+}
 
-        if(SerialCommunicator::isNullOrEmpty(input)) {
-            delete[] input;
-            continue;
-        }
+void SerialAction::stopFileOperation() {
+    if (transferringFiles) {
+        logger.cancelFileTransfer();
+    }
+    transferringFiles = false;
+    purgingFiles = false;
+}
 
-        if(checkForCancelRequest(input)){
-            return;
-        }
+void SerialAction::processAndChangeConfig(const char* input) {
+    if (refuseBlockingAction("Config change")) {
+        return;
+    }
+    if(strcmp(input, REQUEST_SETTINGS_INFO_MESSAGE) == 0) {
+        printConfigKeysToSerial();
+        return;
+    }
 
-        if(strcmp(input, REQUEST_SETTINGS_INFO_MESSAGE) == 0) {
-            printConfigKeysToSerial();
-            continue;
-        }
+    if(strcmp(input, RESET_CONFIG_MESSAGE) == 0) {
+        config.restoreDefaults();
+        return;
+    }
 
-         if(strcmp(input, RESET_CONFIG_MESSAGE) == 0) {
-            config.restoreDefaults();
-            continue;
-        }
-    
-        if (!changeConfigValue(input)) {
-            LED.blink(R_LED, 1000);
-        } else {
-            LED.blink(G_LED, 1000);
-            buzzer.success();
-        }
-        
-        delete[] input; // Free the allocated memory
+    if (!changeConfigValue(input)) {
+        LED.blink(R_LED, 1000);
+    } else {
+        LED.blink(G_LED, 1000);
+        buzzer.success();
     }
 }
 
@@ -246,24 +339,21 @@ bool SerialAction::changeConfigValue(const char* command) {
 /*
 UTILS
 */
-bool SerialAction::confirmAction(const char* SERIAL_MESSAGE) {
-     if(!communicator.waitForMessage(SERIAL_MESSAGE, modeActivationWaitPeriod)){
-        // Return false and change mode to 0 if message if expected message not
-        // received
-        LED.blink(R_LED, 1000);
-        mode = 0;
+bool SerialAction::refuseBlockingAction(const char* action) {
+    if (blockingActionsAllowed) {
         return false;
     }
-    // else return true
-    LED.blink(G_LED, 1000);
+    Serial.print(action);
+    Serial.println(" refused in flight.");
+    LED.blink(R_LED, 1000);
+    mode = STANDBY_MODE;
     return true;
 }
 
 bool SerialAction::checkForCancelRequest(const char* input) {
     if (strcmp(input, CANCEL_MSG_REQUEST) == 0) {
             LED.blink(R_LED, 1000);
-            mode = 0;
-            delete[] input;  // Free the allocated memory
+            mode = STANDBY_MODE;
             return true;
         }
     return false;
@@ -8,11 +8,20 @@
 #include "dataLogger.hpp"
 #include "buzzerFunctions.hpp"
 #include "LEDManager.hpp"
+#include "profiler.hpp"
 #include <cstring>
 
 /**
  * @class SerialAction
  * @brief Class to perform Serial Actions for communication across the serial platform.
+ *
+ * Every call to update() does one non-blocking step: it reads at most one
+ * message and acts on it. Modes that need a confirmation message first wait
+ * for it across calls, and fall back to standby if it does not arrive within
+ * modeActivationWaitPeriod. A file transfer or purge runs one file or chunk
+ * per update, so it never holds up the flight tasks. They, config changes
+ * and fin control are refused unless blocking actions are allowed, and a
+ * transfer or purge in progress stops when they stop being allowed.
  */
 class SerialAction {
 public:
@@ -24,36 +33,93 @@ public:
     PositionalServo& servo, BuzzerFunctions& buzzer, LEDManager& LED);
 
     /**
-     * @brief Method to check and switch between serial modes based on the received message.
+     * @brief Handle the next serial message, if a complete one has arrived.
+     *
+     * "mode:MODE_NUM" changes mode and PROFILE_REQUEST_MESSAGE prints the
+     * profiling histograms. Any other message goes to the current mode.
+     * Also drops back to standby when a mode's confirmation times out.
+     *
+     * @return True if a message was handled.
+     */
+    bool update();
+
+    /**
+     * @brief Allow or refuse the file operations and the actions that change
+     * the flight setup (file transfer, purge, config changes and fin control).
+     * @param allowed False while the rocket is in flight.
      */
-    void checkSerialForMode();
+    void setBlockingActionsAllowed(bool allowed);
 
-     /**
-     * @brief Method to process serial input and change configuration values based on the received message.
+private:
+
+    /**
+     * @brief Process a configuration command.
      * MESSAGE STRUCTURE: CONFIG_NAME:VALUE
+     * @param input The received command.
      */
-    void processAndChangeConfig();
+    void processAndChangeConfig(const char* input);
 
     /**
      * @brief Moves the servos to specified positions based on serial input.
      * The expected input format is any combination of commands: "A90", "D30 B45", "A90 C120", etc.
      * where the letter represents the servo and the number represents the position.
+     * @param input The received command.
      */
-    void moveServosFromSerial();
+    void moveServosFromSerial(const char* input);
 
     /**
-     * @brief  Handles the serial file transfer process.
+     * @brief Starts sending all files, one chunk per update, then waits for
+     * ALL_FILES_SENT_ACK across later updates.
      */
     void serialFileTransfer();
 
     /**
-     * @brief Purges all data based on a serial command confirmation.
-     *        If the DELETE_FILE_MESSAGE is confirmed via serial communication, all files are deleted.
-     *        If the confirmation fails, the operation is aborted.
+     * @brief Starts deleting all files, one per update, then returns to standby.
      */
     void purgeDataFromSerial();
 
-private:
+    /**
+     * @brief Does one step of the file transfer or purge in progress.
+     * @param message The latest serial message, empty if none.
+     * @return True if the message was a transfer handshake and is used up.
+     */
+    bool continueFileOperation(const char* message);
+
+    /**
+     * @brief Stops any file transfer or purge in progress.
+     */
+    void stopFileOperation();
+
+    /**
+     * @brief Reset the mode state if the mode changed since the last update.
+     */
+    void syncMode();
+
+    /**
+     * @brief Pass a message to the current mode, confirming the mode first if it needs it.
+     * @param input The received message.
+     */
+    void handleModeMessage(const char* input);
+
+    /**
+     * @brief Return to standby if the mode's confirmation or acknowledgment has timed out.
+     */
+    void checkModeTimeout();
+
+    /**
+     * @brief Get the message a mode must receive before it acts.
+     * @param modeNum The mode.
+     * @return The confirmation message, nullptr if the mode takes no commands.
+     */
+    static const char* confirmationMessage(int modeNum);
+
+    /**
+     * @brief Refuses an action while file operations and flight setup actions are not allowed,
+     * returning to standby.
+     * @param action Name of the action for the serial message.
+     * @return True if the action was refused.
+     */
+    bool refuseBlockingAction(const char* action);
 
     /**
      * @brief Method to handle serial commands and change configuration values.
@@ -84,36 +150,40 @@ private:
     void processServoCommand(const char* input);
 
 
-    /**
-     * @brief Confirms a specific action by waiting for a designated serial message within a specified time period.
-     * @param SERIAL_MESSAGE The expected message to confirm the action.
-     * @return True if the expected message is received within the wait period, false otherwise.
-     *         If the message is not received, the mode is set to 0 and a red LED blink is triggered.
-     *         If the message is received, a green LED blink is triggered.
-     */
-    bool confirmAction(const char* SERIAL_MESSAGE);
-
     /**
      * @brief Checks if the input command is a cancel request.
      *
      * This method checks whether the provided input matches the predefined cancel message.
-     * If the input is a cancel request, it performs necessary actions such as blinking the LED,
-     * resetting the mode, and freeing the allocated memory for the input.
+     * If the input is a cancel request, it performs necessary actions such as blinking the LED
+     * and resetting the mode.
      *
      * @param input The input command to be checked.
      * @return true if the input is a cancel request, false otherwise.
  */
     bool checkForCancelRequest(const char* input);
 
+    /**
+     * @brief Prints the profiling histogram of every section to Serial.
+     */
+    void printProfile();
+
     SerialCommunicator& communicator; ///< Reference to the SerialCommunicator instance
     ConfigFileManager& config; ///< Reference to the ConfigFileManager instance
     DataLogger& logger; //<Reference to DataLogger instance
     PositionalServo& servo; //<Reference to Servo instance
-    BuzzerFunctions& buzzer; //<Reference to Buzzer instance to be used inside while loops
+    BuzzerFunctions& buzzer; //<Reference to Buzzer instance
     LEDManager& LED; //<Reference to LEDManager instance
 
     // Time to wait for a message before cancelling a mode operation
     uint32_t modeActivationWaitPeriod = 1000 * 60 * 3; // 3 minutes
+
+    int activeMode = -1; ///< Mode the state below belongs to
+    bool modeConfirmed = false; ///< True once the mode's confirmation message arrived
+    bool awaitingFilesAck = false; ///< True while waiting for ALL_FILES_SENT_ACK
+    bool transferringFiles = false; ///< True while a file transfer is in progress
+    bool purgingFiles = false; ///< True while a purge is in progress
+    uint32_t waitStartTime = 0; ///< When the current confirmation or acknowledgment wait started (ms)
+    bool blockingActionsAllowed = true; ///< False while file operations and flight setup actions are refused
 };
 
 #endif // SERIAL_ACTION_HPP
@@ -36,7 +36,7 @@ struct ConfigKey {
  */
 #define CONFIG_VARIABLES \
    X(LAUNCH_ALTITUDE_THRESHOLD, 30) /* Height above ground level to trigger launch detection (meters) */ \
-    X(G_OFFSET, 9.81) /* 1G offset for accelerometer, accelerometer will measure 0g when in unpowered flight (unit TBD) */ \
+    X(G_OFFSET, 9.81) /* 1G offset for accelerometer, accelerometer will measure 0g when in unpowered flight (m/s^2) */ \
     X(LAUNCH_VEL_THRESHOLD, 15.0) /* Launch Detect Threshold for Velocity (m/s) */ \
     X(LAUNCH_ACC_THRESHOLD, 60.0) /* Launch Detect Threshold for Acceleration (m/s^2) */ \
     X(APOGEE_TIMER, 100.0) /* Time the rocket must spend with a velocity estimate below 0 before apogee is decided (milliseconds) */ \
@@ -51,7 +51,22 @@ struct ConfigKey {
     X(SERVO_C_CENTER_POSITION, 90.0) /* 0 Deflection Angle for Servo C Based on Fin Alignment */ \
     X(SERVO_D_CENTER_POSITION, 90.0) /* 0 Deflection Angle for Servo D Based on Fin Alignment */ \
     X(REFERENCE_PRESSURE, 101325) /* Sea Level Pressure for barometric altitude estimation */ \
-    X(MINIMUM_APOGEE, 100) /* Minimum height above ground level to be reached before pyros are able to be armed (meters)  */
+    X(MINIMUM_APOGEE, 100) /* Minimum height above ground level to be reached before pyros are able to be armed (meters)  */ \
+    X(CONTROL_RATE, 500) /* Rate the sensors, sensor fusion and flight state are updated at (Hz) */ \
+    X(LAUNCH_ACC_DURATION, 50) /* Time the acceleration must stay above LAUNCH_ACC_THRESHOLD to detect launch (milliseconds) */ \
+    X(PYRO_SPACING, 50) /* Minimum time between two pyro channels firing, limits the current drawn at once (milliseconds) */ \
+    X(FIN_CONTROL, 0) /* Flag for enabling the fin rate controller during ascent and coast (0: disabled, 1: enabled) */ \
+    X(ROLL_KP, 0.3) /* Roll rate proportional gain at CONTROL_REFERENCE_VELOCITY (fin degrees per rad/s) */ \
+    X(ROLL_KI, 1.2) /* Roll rate integral gain at CONTROL_REFERENCE_VELOCITY (fin degrees per rad) */ \
+    X(ROLL_KD, 0) /* Roll rate derivative gain at CONTROL_REFERENCE_VELOCITY (fin degrees per rad/s^2) */ \
+    X(PITCH_KP, 4) /* Pitch rate proportional gain at CONTROL_REFERENCE_VELOCITY (fin degrees per rad/s) */ \
+    X(PITCH_KI, 4) /* Pitch rate integral gain at CONTROL_REFERENCE_VELOCITY (fin degrees per rad) */ \
+    X(PITCH_KD, 0) /* Pitch rate derivative gain at CONTROL_REFERENCE_VELOCITY (fin degrees per rad/s^2) */ \
+    X(YAW_KP, 4) /* Yaw rate proportional gain at CONTROL_REFERENCE_VELOCITY (fin degrees per rad/s) */ \
+    X(YAW_KI, 4) /* Yaw rate integral gain at CONTROL_REFERENCE_VELOCITY (fin degrees per rad) */ \
+    X(YAW_KD, 0) /* Yaw rate derivative gain at CONTROL_REFERENCE_VELOCITY (fin degrees per rad/s^2) */ \
+    X(CONTROL_REFERENCE_VELOCITY, 100) /* Velocity the fin gains are tuned at; gains scale with (this / velocity)^2 (m/s) */ \
+    X(CONTROL_MIN_VELOCITY, 30) /* Velocity below which the fins are held at center (m/s) */
 
 // Declare the global variables
 #define X(name, defaultValue) extern float name;
@@ -18,6 +18,7 @@ const char* CANCEL_MSG_REQUEST = "EXIT_PROGRAM";
 const char* REQUEST_SETTINGS_INFO_MESSAGE = "SETTINGS_INFO";
 const char* DELETE_FILE_MESSAGE = "PURGE_TIME";
 const char* RESET_CONFIG_MESSAGE = "RESET_SETTINGS";
+const char* PROFILE_REQUEST_MESSAGE = "PROFILE";
 
 // Serial message formatting
 /// RULES: 
@@ -25,6 +25,7 @@ extern const char* CANCEL_MSG_REQUEST;
 extern const char* REQUEST_SETTINGS_INFO_MESSAGE;
 extern const char* DELETE_FILE_MESSAGE;
 extern const char* RESET_CONFIG_MESSAGE;
+extern const char* PROFILE_REQUEST_MESSAGE;
 
 // Serial message formatting
 extern const char PREFIX;
@@ -8,8 +8,9 @@
 #define PYRO_DROGUE 15
 #define PYRO_MAIN 7
 // Pyro 3 and 4 disabled when connecting servo C and D
+// The pyro scheduler only drives PYRO_DROGUE and PYRO_MAIN
 // #define PYRO_4 5
-// #define PYRO_3 8    
+// #define PYRO_3 8
 
 
 // External UART connection
@@ -0,0 +1,81 @@
+#include "pidController.hpp"
+
+PidController::PidController()
+    : gains_{0, 0, 0}, outputLimit_(0), derivativeTau_(0), integral_(0), derivative_(0), lastMeasurement_(0),
+      hasLast_(false), output_(0), saturated_(false) {}
+
+void PidController::setGains(const PidGains& gains) {
+    gains_ = gains;
+}
+
+const PidGains& PidController::getGains() const {
+    return gains_;
+}
+
+void PidController::setOutputLimit(float limit) {
+    outputLimit_ = (limit > 0) ? limit : 0;
+}
+
+void PidController::setDerivativeFilter(float timeConstant) {
+    derivativeTau_ = (timeConstant > 0) ? timeConstant : 0;
+}
+
+float PidController::update(float setpoint, float measurement, float dt, float gainScale, bool holdIntegral) {
+    float error = setpoint - measurement;
+
+    // The first step has no previous measurement or elapsed time to work from
+    if (hasLast_ && dt > 0) {
+        float rate = (measurement - lastMeasurement_) / dt;
+        float alpha = dt / (derivativeTau_ + dt);
+        derivative_ += alpha * (rate - derivative_);
+    }
+
+    float proportional = gainScale * gains_.kp * error;
+    float derivative = -gainScale * gains_.kd * derivative_;
+    float integral = integral_;
+    if (hasLast_ && dt > 0 && !holdIntegral) {
+        integral += gainScale * gains_.ki * error * dt;
+    }
+
+    float output = proportional + integral + derivative;
+    saturated_ = false;
+    if (outputLimit_ > 0) {
+        if (output > outputLimit_ || output < -outputLimit_) {
+            saturated_ = true;
+            // Only accept integration that brings the output back inside the limit
+            if ((output > 0) == (integral > integral_)) {
+                integral = integral_;
+            }
+            output = proportional + integral + derivative;
+            output = (output > outputLimit_) ? outputLimit_ : (output < -outputLimit_ ? -outputLimit_ : output);
+        }
+        integral = (integral > outputLimit_) ? outputLimit_ : (integral < -outputLimit_ ? -outputLimit_ : integral);
+    }
+
+    integral_ = integral;
+    lastMeasurement_ = measurement;
+    hasLast_ = true;
+    output_ = output;
+    return output;
+}
+
+void PidController::reset() {
+    integral_ = 0;
+    derivative_ = 0;
+    lastMeasurement_ = 0;
+    hasLast_ = false;
+    output_ = 0;
+    saturated_ = false;
+}
+
+float PidController::getOutput() const {
+    return output_;
+}
+
+float PidController::getIntegral() const {
+    return integral_;
+}
+
+bool PidController::isSaturated() const {
+    return saturated_;
+}
@@ -0,0 +1,113 @@
+#ifndef PID_CONTROLLER_HPP
+#define PID_CONTROLLER_HPP
+
+/**
+ * @struct PidGains
+ * @brief Proportional, integral and derivative gains.
+ */
+struct PidGains {
+    float kp; ///< Proportional gain (output per unit error)
+    float ki; ///< Integral gain (output per unit error per second)
+    float kd; ///< Derivative gain (output per unit error rate)
+};
+
+/**
+ * @class PidController
+ * @brief PID controller with output limits, anti-windup and a scalable gain.
+ *
+ * The derivative acts on the measurement rather than the error, so a step in
+ * the setpoint does not kick the output, and is low-pass filtered against
+ * sensor noise. The integral is kept in output units, so scaling the gains
+ * from one update to the next does not step the output.
+ *
+ * Anti-windup is by conditional integration: the integral does not grow
+ * while the output is saturated in the direction the error would push it,
+ * or while the caller holds it because a later stage saturated. It is also
+ * bounded by the output limit.
+ */
+class PidController {
+public:
+    /**
+     * @brief Constructor for PidController. Zero gains, no output limit.
+     */
+    PidController();
+
+    /**
+     * @brief Set the gains.
+     *
+     * @param gains The gains.
+     */
+    void setGains(const PidGains& gains);
+
+    /**
+     * @brief Get the gains.
+     *
+     * @return The gains.
+     */
+    const PidGains& getGains() const;
+
+    /**
+     * @brief Limit the output to +-limit.
+     *
+     * @param limit Output limit, 0 for none.
+     */
+    void setOutputLimit(float limit);
+
+    /**
+     * @brief Set the time constant of the derivative low-pass filter.
+     *
+     * @param timeConstant Filter time constant (s), 0 for none.
+     */
+    void setDerivativeFilter(float timeConstant);
+
+    /**
+     * @brief Run the controller for one step.
+     *
+     * @param setpoint Desired value.
+     * @param measurement Measured value.
+     * @param dt Time since the previous step (s). The first step after a reset has no integral or derivative.
+     * @param gainScale Factor applied to all three gains this step.
+     * @param holdIntegral True to stop the integral growing this step.
+     * @return The output.
+     */
+    float update(float setpoint, float measurement, float dt, float gainScale = 1.0f, bool holdIntegral = false);
+
+    /**
+     * @brief Clear the integral and derivative state.
+     */
+    void reset();
+
+    /**
+     * @brief Get the last output.
+     *
+     * @return The output.
+     */
+    float getOutput() const;
+
+    /**
+     * @brief Get the integral term.
+     *
+     * @return The integral, in output units.
+     */
+    float getIntegral() const;
+
+    /**
+     * @brief Check if the last output was at its limit.
+     *
+     * @return True if saturated.
+     */
+    bool isSaturated() const;
+
+private:
+    PidGains gains_; ///< The gains
+    float outputLimit_; ///< Output limit, 0 for none
+    float derivativeTau_; ///< Derivative filter time constant (s)
+    float integral_; ///< Integral term in output units
+    float derivative_; ///< Filtered measurement rate
+    float lastMeasurement_; ///< Measurement of the previous step
+    bool hasLast_; ///< True once a step has run since the reset
+    float output_; ///< Last output
+    bool saturated_; ///< True if the last output was limited
+};
+
+#endif // PID_CONTROLLER_HPP
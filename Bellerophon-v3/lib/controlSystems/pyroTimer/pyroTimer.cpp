@@ -0,0 +1,258 @@
+#include "pyroTimer.hpp"
+#include "interruptGuard.hpp"
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#include "timer.hpp"
+
+namespace {
+    constexpr uint8_t PYRO_TIMER_PRIORITY = 32; // Above the sensor sampling tick (0 is highest)
+    constexpr uint64_t MAX_TIMER_DELAY = 1000000; // Longest one-shot; a later edge re-arms on expiry (us)
+
+    IntervalTimer pyroInterval; // Hardware timer making the pin edges
+
+    void writePin(uint8_t pin, bool high) {
+        digitalWriteFast(pin, high ? HIGH : LOW);
+    }
+
+    uint64_t readClock() {
+        return Timer::currentTimeMicros();
+    }
+}
+
+// Masks interrupts and restores the caller's mask, so the timer sees consistent channels.
+// Callers read the clock before taking it, so nothing inside the section touches the mask
+#define LOCK_CHANNELS() InterruptGuard lock
+#else
+#include <chrono>
+
+namespace {
+    constexpr uint64_t HOST_POLL_PERIOD = 1000; // Longest sleep of the host timer thread (us)
+
+    void writePin(uint8_t, bool) {}
+
+    uint64_t readClock() {
+        auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    }
+}
+
+// The host thread needs the mutex; the guard models the interrupt mask for tests
+#define LOCK_CHANNELS() std::lock_guard<std::mutex> lock(mutex_); InterruptGuard guard
+#endif
+
+std::atomic<PyroTimer*> PyroTimer::active_(nullptr);
+
+PyroTimer::PyroTimer(PinWriter writer, Clock clock)
+    : channels_(), numChannels_(0), writer_(writer != nullptr ? writer : writePin),
+      clock_(clock != nullptr ? clock : readClock), running_(false), nextEdge_(NO_EDGE) {}
+
+PyroTimer::~PyroTimer() {
+    stop();
+}
+
+int PyroTimer::addChannel(uint8_t pin, uint32_t holdMicros) {
+    LOCK_CHANNELS();
+    if (numChannels_ >= MAX_CHANNELS) {
+        return -1;
+    }
+    channels_[numChannels_] = {pin, holdMicros, PyroChannelState::IDLE, 0, 0, 0};
+#if defined(ARDUINO)
+    if (writer_ == writePin) {
+        pinMode(pin, OUTPUT);
+        digitalWriteFast(pin, LOW);
+    }
+#endif
+    return static_cast<int>(numChannels_++);
+}
+
+bool PyroTimer::start() {
+    PyroTimer* expected = nullptr;
+    if (!active_.compare_exchange_strong(expected, this)) {
+        return expected == this; // Already running, or another PyroTimer owns the interrupt
+    }
+    running_ = true;
+
+#if defined(ARDUINO)
+    uint64_t now = clock_();
+    LOCK_CHANNELS();
+    armTimer(now);
+#else
+    thread_ = std::thread([this]() {
+        while (running_) {
+            uint64_t next = nextEdge_.load();
+            uint64_t now = clock_();
+            if (next != NO_EDGE && now >= next) {
+                service(now);
+                continue;
+            }
+            uint64_t wait = (next == NO_EDGE || next - now > HOST_POLL_PERIOD) ? HOST_POLL_PERIOD : next - now;
+            std::this_thread::sleep_for(std::chrono::microseconds(wait));
+        }
+    });
+#endif
+    return true;
+}
+
+void PyroTimer::stop() {
+    if (active_ != this) {
+        return;
+    }
+#if defined(ARDUINO)
+    pyroInterval.end();
+#endif
+    running_ = false;
+#if !defined(ARDUINO)
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+#endif
+    active_ = nullptr;
+}
+
+bool PyroTimer::isRunning() const {
+    return running_;
+}
+
+bool PyroTimer::schedule(int channel, uint64_t fireTime) {
+    if (channel < 0 || static_cast<size_t>(channel) >= numChannels_) {
+        return false;
+    }
+    uint64_t now = clock_();
+    LOCK_CHANNELS();
+    Channel& c = channels_[channel];
+    if (c.state == PyroChannelState::FIRING) {
+        return false;
+    }
+    c.state = PyroChannelState::SCHEDULED;
+    c.commandedTime = fireTime;
+    c.fireTime = 0;
+    c.releaseTime = 0;
+    // Makes the edge now if it is already due, otherwise re-arms for it
+    serviceLocked(now);
+    return true;
+}
+
+bool PyroTimer::cancel(int channel) {
+    if (channel < 0 || static_cast<size_t>(channel) >= numChannels_) {
+        return false;
+    }
+    uint64_t now = clock_();
+    LOCK_CHANNELS();
+    Channel& c = channels_[channel];
+    if (c.state != PyroChannelState::SCHEDULED && c.state != PyroChannelState::FIRING) {
+        return false;
+    }
+    if (c.state == PyroChannelState::FIRING) {
+        writer_(c.pin, false);
+    }
+    c.state = PyroChannelState::IDLE;
+    serviceLocked(now);
+    return true;
+}
+
+void PyroTimer::service(uint64_t now) {
+    LOCK_CHANNELS();
+    serviceLocked(now);
+}
+
+void PyroTimer::serviceLocked(uint64_t now) {
+    uint64_t next = NO_EDGE;
+    for (size_t i = 0; i < numChannels_; ++i) {
+        Channel& c = channels_[i];
+        if (c.state == PyroChannelState::SCHEDULED && now >= c.commandedTime) {
+            writer_(c.pin, true);
+            c.fireTime = now;
+            c.state = PyroChannelState::FIRING;
+        }
+        // The hold runs from the actual fire time, so a late edge is still held in full
+        if (c.state == PyroChannelState::FIRING && now - c.fireTime >= c.holdMicros) {
+            writer_(c.pin, false);
+            c.releaseTime = now;
+            c.state = PyroChannelState::FIRED;
+        }
+
+        if (c.state == PyroChannelState::SCHEDULED && c.commandedTime < next) {
+            next = c.commandedTime;
+        } else if (c.state == PyroChannelState::FIRING && c.fireTime + c.holdMicros < next) {
+            next = c.fireTime + c.holdMicros;
+        }
+    }
+    nextEdge_ = next;
+    armTimer(now);
+}
+
+void PyroTimer::armTimer(uint64_t now) {
+#if defined(ARDUINO)
+    // IntervalTimer is periodic; restarting it for each edge makes it one-shot
+    pyroInterval.end();
+    uint64_t next = nextEdge_;
+    if (!running_ || next == NO_EDGE) {
+        return;
+    }
+    uint64_t delay = next > now ? next - now : 1;
+    if (delay > MAX_TIMER_DELAY) {
+        delay = MAX_TIMER_DELAY;
+    }
+    pyroInterval.begin(onTimer, static_cast<uint32_t>(delay));
+    pyroInterval.priority(PYRO_TIMER_PRIORITY);
+#else
+    // The host thread polls nextEdge_
+    (void)now;
+#endif
+}
+
+void PyroTimer::onTimer() {
+    PyroTimer* timer = active_.load();
+    if (timer == nullptr) {
+        return;
+    }
+    // Masked like every other section, so no interrupt runs between the pin writes and the re-arm
+    uint64_t now = timer->clock_();
+    InterruptGuard lock;
+    timer->serviceLocked(now);
+}
+
+PyroChannelState PyroTimer::getState(int channel) const {
+    if (channel < 0 || static_cast<size_t>(channel) >= numChannels_) {
+        return PyroChannelState::IDLE;
+    }
+    LOCK_CHANNELS();
+    return channels_[channel].state;
+}
+
+uint64_t PyroTimer::getCommandedTime(int channel) const {
+    if (channel < 0 || static_cast<size_t>(channel) >= numChannels_) {
+        return 0;
+    }
+    LOCK_CHANNELS();
+    return channels_[channel].commandedTime;
+}
+
+uint64_t PyroTimer::getFireTime(int channel) const {
+    if (channel < 0 || static_cast<size_t>(channel) >= numChannels_) {
+        return 0;
+    }
+    LOCK_CHANNELS();
+    return channels_[channel].fireTime;
+}
+
+uint64_t PyroTimer::getReleaseTime(int channel) const {
+    if (channel < 0 || static_cast<size_t>(channel) >= numChannels_) {
+        return 0;
+    }
+    LOCK_CHANNELS();
+    return channels_[channel].releaseTime;
+}
+
+uint64_t PyroTimer::getNextEdge() const {
+    return nextEdge_;
+}
+
+uint64_t PyroTimer::now() const {
+    return clock_();
+}
+
+size_t PyroTimer::getNumChannels() const {
+    return numChannels_;
+}
@@ -0,0 +1,216 @@
+#ifndef PYRO_TIMER_HPP
+#define PYRO_TIMER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+
+#if !defined(ARDUINO)
+#include <mutex>
+#include <thread>
+#endif
+
+/**
+ * @enum PyroChannelState
+ * @brief Where a pyro channel is in its firing sequence.
+ */
+enum class PyroChannelState : uint8_t {
+    IDLE,      ///< Nothing scheduled
+    SCHEDULED, ///< Waiting for the commanded fire time
+    FIRING,    ///< Pin HIGH, holding
+    FIRED      ///< Pin released after the hold
+};
+
+/**
+ * @class PyroTimer
+ * @brief Drives pyro pins from a hardware timer at their scheduled times.
+ *
+ * Each channel is a pin and a hold time. Scheduling a channel commands its
+ * pin HIGH at an absolute time and LOW once it has been held; the edges are
+ * made by the timer interrupt, so their timing does not depend on the main
+ * loop. The timer runs one-shot, re-armed for the next pending edge, and is
+ * idle when nothing is scheduled. The commanded time and the times the pin
+ * actually went HIGH and LOW are kept for the log.
+ *
+ * On the Teensy the timer is an IntervalTimer. The host build runs the same
+ * service on a thread, and the pin writes and clock can be replaced so the
+ * sequencing can be tested without either.
+ */
+class PyroTimer {
+public:
+    typedef void (*PinWriter)(uint8_t pin, bool high); ///< Sets a pin HIGH or LOW
+    typedef uint64_t (*Clock)(); ///< Current time (us)
+
+    static constexpr size_t MAX_CHANNELS = 4; ///< Channels a timer can hold
+    static constexpr uint64_t NO_EDGE = UINT64_MAX; ///< getNextEdge() when nothing is pending
+
+    /**
+     * @brief Constructor for PyroTimer.
+     *
+     * @param writer Pin writer, nullptr for the platform's digital write (none on the host).
+     * @param clock Clock, nullptr for the platform's microsecond clock.
+     */
+    explicit PyroTimer(PinWriter writer = nullptr, Clock clock = nullptr);
+
+    /**
+     * @brief Destructor, stops the timer.
+     */
+    ~PyroTimer();
+
+    PyroTimer(const PyroTimer&) = delete;
+    PyroTimer& operator=(const PyroTimer&) = delete;
+
+    /**
+     * @brief Add a channel. With the platform's pin writer the pin is made an output driven LOW.
+     *
+     * @param pin The pin connected to the pyro charge.
+     * @param holdMicros Time the pin is held HIGH (us).
+     * @return Channel id, -1 if the timer is full.
+     */
+    int addChannel(uint8_t pin, uint32_t holdMicros);
+
+    /**
+     * @brief Start servicing the channels from the timer interrupt.
+     *
+     * @return True if started, false if another PyroTimer owns the interrupt.
+     */
+    bool start();
+
+    /**
+     * @brief Stop the timer. Pending edges are only made by service() after this.
+     */
+    void stop();
+
+    /**
+     * @brief Check if the timer is running.
+     *
+     * @return True if running.
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Command a channel to fire. A time already passed fires at once.
+     *
+     * @param channel Channel id.
+     * @param fireTime Time to set the pin HIGH (us).
+     * @return True if scheduled, false for an invalid channel or one already firing.
+     */
+    bool schedule(int channel, uint64_t fireTime);
+
+    /**
+     * @brief Cancel a channel, driving its pin LOW if it is firing.
+     *
+     * @param channel Channel id.
+     * @return True if a scheduled or firing sequence was cancelled.
+     */
+    bool cancel(int channel);
+
+    /**
+     * @brief Make every edge that is due. Called by the timer.
+     *
+     * @param now Current time (us).
+     */
+    void service(uint64_t now);
+
+    /**
+     * @brief Get the state of a channel.
+     *
+     * @param channel Channel id.
+     * @return The state, IDLE for an invalid channel.
+     */
+    PyroChannelState getState(int channel) const;
+
+    /**
+     * @brief Get the time a channel was commanded to fire.
+     *
+     * @param channel Channel id.
+     * @return Commanded time (us), 0 if never scheduled.
+     */
+    uint64_t getCommandedTime(int channel) const;
+
+    /**
+     * @brief Get the time a channel's pin actually went HIGH.
+     *
+     * @param channel Channel id.
+     * @return Fire time (us), 0 if not fired.
+     */
+    uint64_t getFireTime(int channel) const;
+
+    /**
+     * @brief Get the time a channel's pin actually went LOW after its hold.
+     *
+     * @param channel Channel id.
+     * @return Release time (us), 0 if not released.
+     */
+    uint64_t getReleaseTime(int channel) const;
+
+    /**
+     * @brief Get the time of the next pending edge.
+     *
+     * @return Edge time (us), NO_EDGE if none.
+     */
+    uint64_t getNextEdge() const;
+
+    /**
+     * @brief Read the timer's clock.
+     *
+     * @return Current time (us).
+     */
+    uint64_t now() const;
+
+    /**
+     * @brief Get the number of channels.
+     *
+     * @return Number of channels.
+     */
+    size_t getNumChannels() const;
+
+private:
+    /**
+     * @struct Channel
+     * @brief A pyro pin and its firing sequence.
+     */
+    struct Channel {
+        uint8_t pin; ///< The pin connected to the pyro charge
+        uint32_t holdMicros; ///< Time the pin is held HIGH (us)
+        PyroChannelState state; ///< Where the channel is in its sequence
+        uint64_t commandedTime; ///< Time the pin was commanded HIGH (us)
+        uint64_t fireTime; ///< Time the pin went HIGH (us)
+        uint64_t releaseTime; ///< Time the pin went LOW after the hold (us)
+    };
+
+    Channel channels_[MAX_CHANNELS]; ///< The channels
+    size_t numChannels_; ///< Number of channels
+    PinWriter writer_; ///< Sets a pin HIGH or LOW
+    Clock clock_; ///< Current time (us)
+    std::atomic<bool> running_; ///< True while the timer is running
+    std::atomic<uint64_t> nextEdge_; ///< Time of the next pending edge (us)
+
+    static std::atomic<PyroTimer*> active_; ///< PyroTimer that owns the interrupt
+
+#if !defined(ARDUINO)
+    mutable std::mutex mutex_; ///< Stands in for masking the interrupt on the host
+    std::thread thread_; ///< Thread standing in for the timer interrupt on the host
+#endif
+
+    /**
+     * @brief Make the due edges and re-arm the timer. Called with the interrupt masked.
+     *
+     * @param now Current time (us).
+     */
+    void serviceLocked(uint64_t now);
+
+    /**
+     * @brief Arm the one-shot timer for the next pending edge, or stop it.
+     *
+     * @param now Current time (us).
+     */
+    void armTimer(uint64_t now);
+
+    /**
+     * @brief Timer interrupt handler, services the active PyroTimer.
+     */
+    static void onTimer();
+};
+
+#endif // PYRO_TIMER_HPP
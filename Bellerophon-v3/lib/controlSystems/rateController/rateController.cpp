@@ -0,0 +1,133 @@
+#include "rateController.hpp"
+#include <math.h>
+
+namespace {
+    constexpr float DERIVATIVE_FILTER = 0.01f; // Derivative low-pass time constant against gyroscope noise (s)
+    constexpr float DEFAULT_MAX_DEFLECTION = 15.0f; // Largest fin deflection until configured (degrees)
+    constexpr float MAX_STEP = 0.05f; // Longest step integrated, so a stalled tick does not jump the integral (s)
+}
+
+RateController::RateController()
+    : commands_(), deflections_(), setpoint_{0, 0, 0}, referenceVelocity_(100.0f), minimumVelocity_(0),
+      maxGainScale_(1.0f), maxDeflection_(0), gainScale_(0), lastTime_(0), engaged_(false), saturated_(false) {
+    for (PidController& pid : pids_) {
+        pid.setDerivativeFilter(DERIVATIVE_FILTER);
+    }
+    setMaxDeflection(DEFAULT_MAX_DEFLECTION);
+}
+
+void RateController::setGains(ControlAxis axis, const PidGains& gains) {
+    pids_[static_cast<size_t>(axis)].setGains(gains);
+}
+
+void RateController::setSchedule(float referenceVelocity, float minimumVelocity, float maxGainScale) {
+    referenceVelocity_ = referenceVelocity;
+    minimumVelocity_ = minimumVelocity;
+    maxGainScale_ = maxGainScale;
+}
+
+void RateController::setMaxDeflection(float degrees) {
+    maxDeflection_ = degrees;
+    // No single axis may ask more than a fin can give
+    for (PidController& pid : pids_) {
+        pid.setOutputLimit(degrees);
+    }
+}
+
+void RateController::setSetpoint(const Vector3& rate) {
+    setpoint_ = rate;
+}
+
+bool RateController::update(uint64_t now, const Vector3& bodyRate, float velocity) {
+    float speed = fabsf(velocity);
+    if (speed < minimumVelocity_ || speed <= 0) {
+        if (engaged_) {
+            reset();
+        }
+        return false;
+    }
+
+    float scale = referenceVelocity_ / speed;
+    scale *= scale;
+    gainScale_ = (scale > maxGainScale_) ? maxGainScale_ : scale;
+
+    float dt = 0;
+    if (engaged_) {
+        dt = (now - lastTime_) * 1e-6f;
+        dt = (dt > MAX_STEP) ? MAX_STEP : dt;
+    }
+    lastTime_ = now;
+    engaged_ = true;
+
+    // Scaling the last mix down means every axis was short of what it asked
+    bool hold = saturated_;
+    commands_[static_cast<size_t>(ControlAxis::ROLL)] =
+        pids_[static_cast<size_t>(ControlAxis::ROLL)].update(setpoint_.z, bodyRate.z, dt, gainScale_, hold);
+    commands_[static_cast<size_t>(ControlAxis::PITCH)] =
+        pids_[static_cast<size_t>(ControlAxis::PITCH)].update(setpoint_.x, bodyRate.x, dt, gainScale_, hold);
+    commands_[static_cast<size_t>(ControlAxis::YAW)] =
+        pids_[static_cast<size_t>(ControlAxis::YAW)].update(setpoint_.y, bodyRate.y, dt, gainScale_, hold);
+
+    mix(commands_[static_cast<size_t>(ControlAxis::ROLL)], commands_[static_cast<size_t>(ControlAxis::PITCH)],
+        commands_[static_cast<size_t>(ControlAxis::YAW)], deflections_);
+
+    float largest = 0;
+    for (float deflection : deflections_) {
+        largest = (fabsf(deflection) > largest) ? fabsf(deflection) : largest;
+    }
+    saturated_ = largest > maxDeflection_;
+    if (saturated_) {
+        float reduction = maxDeflection_ / largest;
+        for (float& deflection : deflections_) {
+            deflection *= reduction;
+        }
+    }
+    return true;
+}
+
+void RateController::mix(float roll, float pitch, float yaw, float deflections[NUM_FINS]) {
+    // A fin at angle phi about z moves the vehicle about x by cos(phi) and about y by sin(phi)
+    deflections[0] = roll + pitch; // A, 0 degrees
+    deflections[1] = roll + yaw;   // B, 90 degrees
+    deflections[2] = roll - pitch; // C, 180 degrees
+    deflections[3] = roll - yaw;   // D, 270 degrees
+}
+
+void RateController::reset() {
+    for (PidController& pid : pids_) {
+        pid.reset();
+    }
+    for (float& command : commands_) {
+        command = 0;
+    }
+    for (float& deflection : deflections_) {
+        deflection = 0;
+    }
+    gainScale_ = 0;
+    engaged_ = false;
+    saturated_ = false;
+}
+
+float RateController::getDeflection(size_t fin) const {
+    return (fin < NUM_FINS) ? deflections_[fin] : 0;
+}
+
+float RateController::getCommand(ControlAxis axis) const {
+    return commands_[static_cast<size_t>(axis)];
+}
+
+const PidController& RateController::getPid(ControlAxis axis) const {
+    return pids_[static_cast<size_t>(axis)];
+}
+
+float RateController::getGainScale() const {
+    return gainScale_;
+}
+
+bool RateController::isEngaged() const {
+    return engaged_;
+}
+
+bool RateController::isSaturated() const {
+    return saturated_;
+}
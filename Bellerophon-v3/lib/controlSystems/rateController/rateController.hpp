@@ -0,0 +1,164 @@
+#ifndef RATE_CONTROLLER_HPP
+#define RATE_CONTROLLER_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pidController.hpp"
+#include "quaternion.hpp"
+
+/**
+ * @enum ControlAxis
+ * @brief Body axes the rate controller acts on.
+ */
+enum class ControlAxis : uint8_t {
+    ROLL,  ///< About body z, the long axis
+    PITCH, ///< About body x
+    YAW,   ///< About body y
+    NUM_AXES
+};
+
+/**
+ * @class RateController
+ * @brief Roll, pitch and yaw rate control through four fins.
+ *
+ * A PID per axis drives the body rate from the gyroscope to its setpoint
+ * (zero by default, which damps any rotation). The axis commands are mixed
+ * into deflections of fins A to D, mounted at 0, 90, 180 and 270 degrees
+ * around body z from the body x axis. A positive deflection of any fin
+ * rolls the vehicle positive about z; fins A and C also pitch it, B and D
+ * yaw it. If the mix asks more than the maximum deflection of any fin, all
+ * fins are scaled down together so the axes keep their balance, and the
+ * integrals are held on the next step.
+ *
+ * Fin moments grow with dynamic pressure, so the gains are scheduled by
+ * (referenceVelocity / velocity)^2, up to a maximum scale at low speed.
+ * Below the minimum velocity the fins have too little authority and the
+ * controller disengages with the fins at neutral.
+ */
+class RateController {
+public:
+    static constexpr size_t NUM_FINS = 4; ///< Fins A to D
+    static constexpr size_t NUM_AXES = static_cast<size_t>(ControlAxis::NUM_AXES); ///< Controlled axes
+
+    /**
+     * @brief Constructor for RateController. Zero gains, disengaged.
+     */
+    RateController();
+
+    /**
+     * @brief Set the gains of an axis at the reference velocity.
+     *
+     * @param axis The axis.
+     * @param gains Gains (fin degrees per rad/s of rate error).
+     */
+    void setGains(ControlAxis axis, const PidGains& gains);
+
+    /**
+     * @brief Set the gain schedule.
+     *
+     * @param referenceVelocity Velocity the gains are set for (m/s).
+     * @param minimumVelocity Velocity below which the controller disengages (m/s).
+     * @param maxGainScale Largest gain scale, reached at low velocity.
+     */
+    void setSchedule(float referenceVelocity, float minimumVelocity, float maxGainScale);
+
+    /**
+     * @brief Set the largest deflection of any fin.
+     *
+     * @param degrees Maximum deflection either way (degrees).
+     */
+    void setMaxDeflection(float degrees);
+
+    /**
+     * @brief Set the body rate setpoint.
+     *
+     * @param rate Body rate to hold (rad/s).
+     */
+    void setSetpoint(const Vector3& rate);
+
+    /**
+     * @brief Run one control step.
+     *
+     * @param now Time of the step (us).
+     * @param bodyRate Body angular rate from the gyroscope (rad/s).
+     * @param velocity Airspeed, or vertical velocity in near-vertical flight (m/s).
+     * @return True if engaged, false if below the minimum velocity with the fins at neutral.
+     */
+    bool update(uint64_t now, const Vector3& bodyRate, float velocity);
+
+    /**
+     * @brief Disengage, clear the integrals and set the fins to neutral.
+     */
+    void reset();
+
+    /**
+     * @brief Get the deflection of a fin.
+     *
+     * @param fin Fin index, 0 for A to 3 for D.
+     * @return Deflection (degrees), 0 for an invalid fin.
+     */
+    float getDeflection(size_t fin) const;
+
+    /**
+     * @brief Get the command of an axis before mixing.
+     *
+     * @param axis The axis.
+     * @return Command (fin degrees).
+     */
+    float getCommand(ControlAxis axis) const;
+
+    /**
+     * @brief Get the PID of an axis.
+     *
+     * @param axis The axis.
+     * @return The PID.
+     */
+    const PidController& getPid(ControlAxis axis) const;
+
+    /**
+     * @brief Get the gain scale of the last step.
+     *
+     * @return Gain scale.
+     */
+    float getGainScale() const;
+
+    /**
+     * @brief Check if the controller was engaged on the last step.
+     *
+     * @return True if engaged.
+     */
+    bool isEngaged() const;
+
+    /**
+     * @brief Check if the last mix was scaled down to the maximum deflection.
+     *
+     * @return True if saturated.
+     */
+    bool isSaturated() const;
+
+    /**
+     * @brief Mix axis commands into fin deflections.
+     *
+     * @param roll Roll command (fin degrees).
+     * @param pitch Pitch command (fin degrees).
+     * @param yaw Yaw command (fin degrees).
+     * @param deflections Deflection of fins A to D (degrees).
+     */
+    static void mix(float roll, float pitch, float yaw, float deflections[NUM_FINS]);
+
+private:
+    PidController pids_[NUM_AXES]; ///< PID of each axis
+    float commands_[NUM_AXES]; ///< Axis commands of the last step (fin degrees)
+    float deflections_[NUM_FINS]; ///< Fin deflections of the last step (degrees)
+    Vector3 setpoint_; ///< Body rate setpoint (rad/s)
+    float referenceVelocity_; ///< Velocity the gains are set for (m/s)
+    float minimumVelocity_; ///< Velocity below which the controller disengages (m/s)
+    float maxGainScale_; ///< Largest gain scale
+    float maxDeflection_; ///< Largest deflection of any fin (degrees)
+    float gainScale_; ///< Gain scale of the last step
+    uint64_t lastTime_; ///< Time of the last engaged step (us)
+    bool engaged_; ///< True if engaged on the last step
+    bool saturated_; ///< True if the last mix was scaled down
+};
+
+#endif // RATE_CONTROLLER_HPP
@@ -30,9 +30,9 @@ bool DataLogger::initialize() {
 }
 
 void DataLogger::logEvent(const char* message) {
-    int currentTime = Timer::currentTime();
     char buffer[logBuffer];
-    snprintf(buffer, sizeof(buffer), "%lu: %s\n", currentTime, message);
+    int offset = Timer::formatMicros(buffer, sizeof(buffer), Timer::currentTimeMicros());
+    snprintf(buffer + offset, sizeof(buffer) - offset, ": %s\n", message);
     files.print(files.logFile, buffer);
 }
 
@@ -61,9 +61,10 @@ void DataLogger::addDataFileHeading(const char* title) {
 }
 
 void DataLogger::logData(float* data, size_t numFloats, uint8_t decimalPlaces) {
-    uint32_t currentTime = Timer::currentTime();
+    PROFILE_SCOPE(LOG_DATA);
     char buffer[logBuffer];
-    int offset = snprintf(buffer, sizeof(buffer), "%lu,", currentTime);
+    int offset = Timer::formatMicros(buffer, sizeof(buffer), Timer::currentTimeMicros());
+    offset += snprintf(buffer + offset, sizeof(buffer) - offset, ",");
 
     // Constrain decimalPlaces to a reasonable range, e.g., 0 to 10
     if (decimalPlaces > 10) {
@@ -83,99 +84,127 @@ void DataLogger::logData(float* data, size_t numFloats, uint8_t decimalPlaces) {
 }
 
 
-// Method to read data from a specific file and send it over serial
-void DataLogger::readDataFromFile(const char* fileName) {
-    
-    if (!files.fileExists(fileName)) {
-        Serial.println("Data file not found.");
-        return;
-    }
-    // Calculate CRC32 checksum
-    crc.reset(); // Reset CRC32 object before calculating a new checksum
-    FsFile file;
-    file.open(fileName, O_READ);
-
-    int data;
-    while ((data = file.read()) >= 0) {
-        crc.update(data); // Update the CRC32 checksum with each byte of data
-    }
-    uint32_t checksum = crc.finalize(); // Finalize the checksum calculation
-    file.close();
-
-    // Send file name and checksum to Python script
-    Serial.print("FILE_NAME:");
-    Serial.println(fileName);
-    Serial.print("CHECKSUM:");
-    Serial.println(checksum);
-
-    // Open the file again for reading data
-    //file.open(fileName, O_READ);
-    file.open(fileName, O_READ);
+namespace {
+    constexpr size_t TRANSFER_CHUNK = 256; // Bytes checksummed or sent per transfer step
+    constexpr uint32_t SKIP_WAIT = 100; // Time the host has to skip an offered file (ms)
+    constexpr uint32_t ACK_WAIT = 1000; // Time the host has to acknowledge a sent file (ms)
+}
 
-    // Skip File read if serial comm sends this message
-    if (serialComm.waitForMessage(FILE_COPY_MESSAGE, 100)){
-        return;
-    }
+bool DataLogger::isSystemFile(const std::string& fileName) const {
+    /// TODO: create array of files to exclude
+    return strcmp(fileName.c_str(), files.indexFileName) == 0 || strcmp(fileName.c_str(), files.configFileName) == 0;
+}
 
-    // Read from the file until there's nothing else in it
-    while ((data = file.read()) >= 0) {
-        Serial.write(data); // Send each byte of data over serial
+void DataLogger::startFileTransfer() {
+    cancelFileTransfer();
+    // Update the file list to ensure we have the latest list of files
+    files.updateFileList();
+    fileIndex = 0;
+    if (openNextTransferFile()) {
+        transferState = TransferState::CHECKSUM;
     }
+}
 
-    file.close();
-
-    // Send end-of-transmission message
-    Serial.println(END_OF_TRANSMISSION_MESSAGE);
-
-    // handshake to finish file transfer
-    if (!serialComm.waitForMessage(END_OF_TRANSMISSION_ACK, 1000)) {
-        return;
+bool DataLogger::openNextTransferFile() {
+    while (fileIndex < files.fileNames.size()) {
+        const std::string& fileName = files.fileNames[fileIndex++];
+        if (isSystemFile(fileName) || !transferFile.open(fileName.c_str(), O_READ)) {
+            continue;
+        }
+        crc.reset(); // Reset CRC32 object before calculating a new checksum
+        return true;
     }
+    return false;
 }
 
-void DataLogger::sendAllFiles() {
-
-    // Update the file list to ensure we have the latest list of files
-    files.updateFileList();
-
-    // Iterate through each file name in the list
-    for (const auto& fileName : files.fileNames) {
-        // Check if the file name is the index file and skip it if so
-        if (strcmp(fileName.c_str(), files.indexFileName) == 0) {
-            continue; // Skip this iteration and move to the next file
+bool DataLogger::updateFileTransfer(const char* message) {
+    uint8_t chunk[TRANSFER_CHUNK];
+    switch (transferState) {
+        case TransferState::IDLE:
+            return false;
+
+        case TransferState::CHECKSUM: {
+            int length = transferFile.read(chunk, sizeof(chunk));
+            for (int i = 0; i < length; ++i) {
+                crc.update(chunk[i]); // Update the CRC32 checksum with each byte of data
+            }
+            if (length > 0) {
+                return true;
+            }
+            // Send file name and checksum to Python script, then send the file from the start
+            Serial.print("FILE_NAME:");
+            Serial.println(files.fileNames[fileIndex - 1].c_str());
+            Serial.print("CHECKSUM:");
+            Serial.println(crc.finalize());
+            transferFile.rewind();
+            transferWaitStart = millis();
+            transferState = TransferState::OFFER;
+            return true;
         }
 
-        /// TODO: create array of files to exclude
-        if (strcmp(fileName.c_str(), files.configFileName) == 0) {
-            continue;
+        case TransferState::OFFER:
+            // Skip File read if serial comm sends this message
+            if (strcmp(message, FILE_COPY_MESSAGE) == 0) {
+                transferFile.close();
+                break;
+            }
+            if (millis() - transferWaitStart >= SKIP_WAIT) {
+                transferState = TransferState::SEND;
+            }
+            return true;
+
+        case TransferState::SEND: {
+            int length = transferFile.read(chunk, sizeof(chunk));
+            if (length > 0) {
+                Serial.write(chunk, length); // Send the chunk over serial
+                return true;
+            }
+            transferFile.close();
+            // Send end-of-transmission message
+            Serial.println(END_OF_TRANSMISSION_MESSAGE);
+            transferWaitStart = millis();
+            transferState = TransferState::AWAIT_ACK;
+            return true;
         }
 
-        // Read the data from the current file and send it over Serial
-        readDataFromFile(fileName.c_str());
+        case TransferState::AWAIT_ACK:
+            // handshake to finish file transfer, the next file follows once it arrives or times out
+            if (strcmp(message, END_OF_TRANSMISSION_ACK) != 0 && millis() - transferWaitStart < ACK_WAIT) {
+                return true;
+            }
+            break;
     }
+
+    // On to the next file
+    transferState = openNextTransferFile() ? TransferState::CHECKSUM : TransferState::IDLE;
+    return transferState != TransferState::IDLE;
 }
 
-void DataLogger::deleteAllFiles() {
+void DataLogger::cancelFileTransfer() {
+    if (transferFile.isOpen()) {
+        transferFile.close();
+    }
+    transferState = TransferState::IDLE;
+}
+
+void DataLogger::startDeletingFiles() {
     // update files.fileNames array, just in case
     files.updateFileList();
+    fileIndex = 0;
+}
 
-    for (const auto& fileName : files.fileNames) {
-
-        // Check if the file name is the index file and skip it if so
-        if (strcmp(fileName.c_str(), files.indexFileName) == 0) {
-            continue; // Skip this iteration and move to the next file
-        }
-        // Check if the file name is the config file and skip it if so
-        if (strcmp(fileName.c_str(), files.configFileName) == 0) {
-            continue; // Skip this iteration and move to the next file
+bool DataLogger::deleteNextFile() {
+    while (fileIndex < files.fileNames.size()) {
+        const std::string& fileName = files.fileNames[fileIndex++];
+        // The index and config files are kept
+        if (!isSystemFile(fileName)) {
+            files.deleteFile(fileName.c_str());
+            return true;
         }
-
-        files.deleteFile(fileName.c_str());
     }
-        
-    Serial.println("All files deleted.");
 
+    Serial.println("All files deleted.");
     // update fileNames array, which now should be empty
     files.updateFileList();
+    return false;
 }
-
@@ -29,13 +29,14 @@ public:
     bool initialize();
   
     /**
-     * @brief  Logs an event message to the log file.
+     * @brief  Logs an event message to the log file, prefixed with the time (us).
      * @param  message The message to be logged.
      */
     void logEvent(const char* message);
 
   /**
-     * @brief  Logs an array of floating-point data to the data file.
+     * @brief  Logs an array of floating-point data to the data file, 
+     *         prefixed with the time (us).
      * @param  data           Pointer to the array of floating-point data.
      * @param  numFloats      Number of floats in the array.
      * @param  decimalPlaces  Number of decimal places to format each float. Default is 2.
@@ -45,20 +46,36 @@ public:
 
 
     /**
-     * @brief  Reads data from the specified file and prints it to the serial monitor.
-     * @param  fileName The name of the file to be read.
+     * @brief  Starts sending every data and log file over serial. Each call to
+     *         updateFileTransfer() then does one bounded step, so the transfer
+     *         never holds up the flight tasks.
      */
-    void readDataFromFile(const char* fileName);
+    void startFileTransfer();
 
     /**
-     * @brief  Deletes all files on the SD card by iterating through the fileNames vector.
+     * @brief  Does one step of the file transfer: checksums or sends one chunk
+     *         of a file, or checks for the host's reply without waiting for it.
+     * @param  message The latest serial message, empty if none. FILE_COPY_MESSAGE
+     *         skips the offered file and END_OF_TRANSMISSION_ACK ends the sent one.
+     * @return True while files remain to be sent.
      */
-    void deleteAllFiles();
+    bool updateFileTransfer(const char* message);
 
     /**
-     * @brief  Sends all files over serial communication.
+     * @brief  Stops the file transfer, closing the file being sent.
      */
-    void sendAllFiles();
+    void cancelFileTransfer();
+
+    /**
+     * @brief  Starts deleting every data and log file, one per call to deleteNextFile().
+     */
+    void startDeletingFiles();
+
+    /**
+     * @brief  Deletes the next data or log file.
+     * @return True while files remain to be deleted.
+     */
+    bool deleteNextFile();
 
     /**
      * @brief  Adds a header title to the data file, if one does not already exist
@@ -80,8 +97,38 @@ private:
 
     uint32_t timeout = 1800*1000; // 30 minute timeout
 
+    /**
+     * @enum TransferState
+     * @brief Step of the file transfer.
+     */
+    enum class TransferState {
+        IDLE,      ///< No transfer
+        CHECKSUM,  ///< Reading the file for its checksum
+        OFFER,     ///< Name and checksum sent, the host may skip the file
+        SEND,      ///< Sending the file
+        AWAIT_ACK  ///< Waiting for END_OF_TRANSMISSION_ACK
+    };
+
+    TransferState transferState = TransferState::IDLE; ///< Step of the file transfer
+    size_t fileIndex = 0;         ///< Next entry of files.fileNames to transfer or delete
+    FsFile transferFile;          ///< File being checksummed or sent
+    uint32_t transferWaitStart = 0; ///< When the current reply wait started (ms)
+
     // ------------------------- METHODS ------------------------- //
 
+    /**
+     * @brief  Checks whether a file is kept by transfers and purges.
+     * @param  fileName The file name.
+     * @return True for the index and config files.
+     */
+    bool isSystemFile(const std::string& fileName) const;
+
+    /**
+     * @brief  Opens the next data or log file and starts its checksum.
+     * @return True if a file was opened, false once every file has been sent.
+     */
+    bool openNextTransferFile();
+
 
 };
 
@@ -218,6 +218,7 @@ bool FileManager::writeFloatToFile(FileItem& fileItem, uint32_t position, float
 }
 
 void FileManager::print(FileItem& fileItem, const char* message) {
+    PROFILE_SCOPE(FILE_PRINT);
     if (DEBUG) {
         Serial.print(message);
     }
@@ -9,6 +9,7 @@
 #include "configKeys.hpp"
 #include "constants.hpp"
 #include "pinAssn.hpp"
+#include "profiler.hpp"
 
 
 /**
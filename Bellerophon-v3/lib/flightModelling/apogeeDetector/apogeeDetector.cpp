@@ -0,0 +1,108 @@
+#include "apogeeDetector.hpp"
+
+ApogeeDetector::ApogeeDetector()
+    : holds_(), velocityThreshold_(0), altitudeDrop_(0), holdTime_(0), requiredSignals_(0),
+      enabled_(false), hasMaxAltitude_(false), maxAltitude_(0), apogee_(false),
+      detectionTime_(0), contributing_(0) {}
+
+void ApogeeDetector::configure(float velocityThreshold, float altitudeDrop, uint32_t holdMicros,
+                               size_t requiredSignals) {
+    velocityThreshold_ = velocityThreshold;
+    altitudeDrop_ = altitudeDrop;
+    holdTime_ = holdMicros;
+    requiredSignals_ = requiredSignals > 0 ? requiredSignals : 1;
+    enabled_ = true;
+}
+
+bool ApogeeDetector::update(uint64_t now, float kalmanVelocity, float imuVelocity, float altitude) {
+    if (apogee_ || !enabled_) {
+        return apogee_;
+    }
+
+    if (!hasMaxAltitude_ || altitude > maxAltitude_) {
+        maxAltitude_ = altitude;
+        hasMaxAltitude_ = true;
+    }
+
+    // Comparisons with NaN are false, so an unavailable input never holds
+    bool held[NUM_SIGNALS];
+    held[static_cast<size_t>(ApogeeSignal::KALMAN_VELOCITY)] =
+        updateHold(ApogeeSignal::KALMAN_VELOCITY, now, kalmanVelocity <= velocityThreshold_);
+    held[static_cast<size_t>(ApogeeSignal::IMU_VELOCITY)] =
+        updateHold(ApogeeSignal::IMU_VELOCITY, now, imuVelocity <= velocityThreshold_);
+    held[static_cast<size_t>(ApogeeSignal::ALTITUDE_FALLING)] =
+        updateHold(ApogeeSignal::ALTITUDE_FALLING, now, maxAltitude_ - altitude >= altitudeDrop_);
+
+    size_t votes = 0;
+    uint8_t contributing = 0;
+    for (size_t i = 0; i < NUM_SIGNALS; ++i) {
+        if (held[i]) {
+            votes++;
+            contributing |= static_cast<uint8_t>(1u << i);
+        }
+    }
+    if (votes >= requiredSignals_) {
+        apogee_ = true;
+        detectionTime_ = now;
+        contributing_ = contributing;
+    }
+    return apogee_;
+}
+
+bool ApogeeDetector::updateHold(ApogeeSignal signal, uint64_t now, bool condition) {
+    SignalHold& hold = holds_[static_cast<size_t>(signal)];
+    if (!condition) {
+        hold.holding = false;
+        return false;
+    }
+    if (!hold.holding) {
+        hold.holding = true;
+        hold.since = now;
+    }
+    return now - hold.since >= holdTime_;
+}
+
+bool ApogeeDetector::isApogee() const {
+    return apogee_;
+}
+
+uint64_t ApogeeDetector::getDetectionTime() const {
+    return detectionTime_;
+}
+
+bool ApogeeDetector::isContributing(ApogeeSignal signal) const {
+    return (contributing_ & (1u << static_cast<size_t>(signal))) != 0;
+}
+
+uint64_t ApogeeDetector::getSignalTime(ApogeeSignal signal) const {
+    const SignalHold& hold = holds_[static_cast<size_t>(signal)];
+    return hold.holding ? hold.since : 0;
+}
+
+float ApogeeDetector::getMaxAltitude() const {
+    return maxAltitude_;
+}
+
+const char* ApogeeDetector::getName(ApogeeSignal signal) {
+    switch (signal) {
+        case ApogeeSignal::KALMAN_VELOCITY:
+            return "kalman_velocity";
+        case ApogeeSignal::IMU_VELOCITY:
+            return "imu_velocity";
+        case ApogeeSignal::ALTITUDE_FALLING:
+            return "altitude_falling";
+        default:
+            return "unknown";
+    }
+}
+
+void ApogeeDetector::reset() {
+    for (size_t i = 0; i < NUM_SIGNALS; ++i) {
+        holds_[i] = {false, 0};
+    }
+    hasMaxAltitude_ = false;
+    maxAltitude_ = 0;
+    apogee_ = false;
+    detectionTime_ = 0;
+    contributing_ = 0;
+}
@@ -0,0 +1,143 @@
+#ifndef APOGEE_DETECTOR_HPP
+#define APOGEE_DETECTOR_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @enum ApogeeSignal
+ * @brief The independent tests that vote on apogee.
+ */
+enum class ApogeeSignal : uint8_t {
+    KALMAN_VELOCITY,  ///< Fused vertical velocity at or below the threshold
+    IMU_VELOCITY,     ///< Integrated IMU vertical velocity at or below the threshold
+    ALTITUDE_FALLING, ///< Fused altitude below its maximum by the drop margin
+    NUM_SIGNALS
+};
+
+/**
+ * @class ApogeeDetector
+ * @brief Debounced, cross-checked apogee detection.
+ *
+ * Each signal has to hold without a break for the hold time before it counts,
+ * so a single noisy sample cannot fire the drogue. The signals are debounced
+ * concurrently, so apogee is declared as soon as the required number of them
+ * have held, and the added latency is the hold time rather than a sum of
+ * checks. A signal whose input is unavailable (NaN) never holds.
+ *
+ * The time each contributing signal started to hold is kept for the event log.
+ */
+class ApogeeDetector {
+public:
+    /**
+     * @brief Constructor for ApogeeDetector. Detection is disabled until configured.
+     */
+    ApogeeDetector();
+
+    /**
+     * @brief Configure the tests.
+     *
+     * @param velocityThreshold Vertical velocity at or below which apogee is near (m/s).
+     * @param altitudeDrop Fall below the maximum altitude that counts as descending (m).
+     * @param holdMicros Time each signal must hold without a break (us).
+     * @param requiredSignals Number of held signals needed to declare apogee.
+     */
+    void configure(float velocityThreshold, float altitudeDrop, uint32_t holdMicros, size_t requiredSignals);
+
+    /**
+     * @brief Check the signals at a control tick.
+     *
+     * @param now Current time (us).
+     * @param kalmanVelocity Fused vertical velocity (m/s).
+     * @param imuVelocity Integrated IMU vertical velocity (m/s), NaN if unavailable.
+     * @param altitude Fused altitude (m).
+     * @return True if apogee has been detected.
+     */
+    bool update(uint64_t now, float kalmanVelocity, float imuVelocity, float altitude);
+
+    /**
+     * @brief Check if apogee has been detected.
+     *
+     * @return True once detected.
+     */
+    bool isApogee() const;
+
+    /**
+     * @brief Get the time apogee was detected.
+     *
+     * @return Detection time (us), 0 if not detected.
+     */
+    uint64_t getDetectionTime() const;
+
+    /**
+     * @brief Check if a signal was holding when apogee was declared.
+     *
+     * @param signal The signal.
+     * @return True if it contributed to the detection.
+     */
+    bool isContributing(ApogeeSignal signal) const;
+
+    /**
+     * @brief Get the time a signal started its current hold.
+     *
+     * @param signal The signal.
+     * @return Start of the hold (us), 0 if not holding.
+     */
+    uint64_t getSignalTime(ApogeeSignal signal) const;
+
+    /**
+     * @brief Get the maximum altitude seen by the altitude falling test.
+     *
+     * @return Maximum altitude (m).
+     */
+    float getMaxAltitude() const;
+
+    /**
+     * @brief Get the name of a signal.
+     *
+     * @param signal The signal.
+     * @return Name for logs.
+     */
+    static const char* getName(ApogeeSignal signal);
+
+    /**
+     * @brief Clear detection, the holds and the maximum altitude.
+     */
+    void reset();
+
+private:
+    /**
+     * @struct SignalHold
+     * @brief Debounce state of one signal.
+     */
+    struct SignalHold {
+        bool holding; ///< True while the condition has held since `since`
+        uint64_t since; ///< Time the condition started to hold (us)
+    };
+
+    static constexpr size_t NUM_SIGNALS = static_cast<size_t>(ApogeeSignal::NUM_SIGNALS); ///< Number of signals
+
+    SignalHold holds_[NUM_SIGNALS]; ///< Debounce state of each signal
+    float velocityThreshold_; ///< Vertical velocity at or below which apogee is near (m/s)
+    float altitudeDrop_; ///< Fall below the maximum altitude that counts as descending (m)
+    uint32_t holdTime_; ///< Time each signal must hold (us)
+    size_t requiredSignals_; ///< Held signals needed to declare apogee
+    bool enabled_; ///< True once configured
+    bool hasMaxAltitude_; ///< True once an altitude has been seen
+    float maxAltitude_; ///< Maximum altitude seen (m)
+    bool apogee_; ///< True once apogee is detected
+    uint64_t detectionTime_; ///< Time apogee was detected (us)
+    uint8_t contributing_; ///< Bit per signal that was holding at detection
+
+    /**
+     * @brief Advance the debounce of a signal.
+     *
+     * @param signal The signal.
+     * @param now Current time (us).
+     * @param condition True if the condition holds at this tick.
+     * @return True if the condition has held for the hold time.
+     */
+    bool updateHold(ApogeeSignal signal, uint64_t now, bool condition);
+};
+
+#endif // APOGEE_DETECTOR_HPP
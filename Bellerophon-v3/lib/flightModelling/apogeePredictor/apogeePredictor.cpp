@@ -0,0 +1,105 @@
+#include "apogeePredictor.hpp"
+#include <cmath>
+
+namespace {
+    constexpr float COAST_ACCELERATION = -0.5f; // Acceleration below which the vehicle may be coasting (g)
+    constexpr size_t COAST_SAMPLES = 10; // Coasting samples needed before predicting
+    constexpr float DRAG_MIN_VELOCITY = 20.0f; // Velocity above which drag is measurable (m/s)
+    constexpr float VACUUM_LIMIT = 1e-4f; // k v^2 / g below which drag is neglected
+}
+
+ApogeePredictor::ApogeePredictor(float gravity)
+    : gravity_(gravity), coastSamples_(0), dragMoment_(0), velocityMoment_(0), dragFactor_(0),
+      hasPrediction_(false), predictedTime_(0), predictedAltitude_(0), hasPeak_(false), peakAltitude_(0),
+      peakTime_(0) {}
+
+bool ApogeePredictor::update(uint64_t now, float altitude, float velocity, float acceleration) {
+    if (!hasPeak_ || altitude > peakAltitude_) {
+        peakAltitude_ = altitude;
+        peakTime_ = now;
+        hasPeak_ = true;
+    }
+
+    // Under thrust the acceleration is positive; once it has clearly stayed
+    // below zero the motor is out. A prediction made after apogee is kept.
+    if (acceleration > COAST_ACCELERATION * gravity_) {
+        coastSamples_ = 0;
+        return hasPrediction_;
+    }
+    if (velocity <= 0) {
+        return hasPrediction_;
+    }
+    if (++coastSamples_ < COAST_SAMPLES) {
+        return hasPrediction_;
+    }
+
+    if (velocity > DRAG_MIN_VELOCITY) {
+        updateDrag(velocity, acceleration);
+    }
+    predict(now, altitude, velocity);
+    return true;
+}
+
+void ApogeePredictor::updateDrag(float velocity, float acceleration) {
+    // a = -g - k v^2 on the way up. Least squares fit of k over the coast,
+    // which weights each sample by v^4, so the fast samples where drag
+    // dominates the noise count most
+    float drag = -(acceleration + gravity_);
+    float velocitySquared = velocity * velocity;
+    dragMoment_ += drag * velocitySquared;
+    velocityMoment_ += velocitySquared * velocitySquared;
+    dragFactor_ = dragMoment_ > 0 ? dragMoment_ / velocityMoment_ : 0;
+}
+
+void ApogeePredictor::predict(uint64_t now, float altitude, float velocity) {
+    float timeLeft;
+    float heightLeft;
+    float dragRatio = dragFactor_ * velocity * velocity / gravity_;
+    if (dragRatio < VACUUM_LIMIT) {
+        timeLeft = velocity / gravity_;
+        heightLeft = velocity * velocity / (2.0f * gravity_);
+    } else {
+        timeLeft = std::atan(velocity * std::sqrt(dragFactor_ / gravity_)) / std::sqrt(gravity_ * dragFactor_);
+        heightLeft = std::log1p(dragRatio) / (2.0f * dragFactor_);
+    }
+    predictedTime_ = now + static_cast<uint64_t>(timeLeft * 1e6f);
+    predictedAltitude_ = altitude + heightLeft;
+    hasPrediction_ = true;
+}
+
+bool ApogeePredictor::hasPrediction() const {
+    return hasPrediction_;
+}
+
+uint64_t ApogeePredictor::getPredictedTime() const {
+    return predictedTime_;
+}
+
+float ApogeePredictor::getPredictedAltitude() const {
+    return predictedAltitude_;
+}
+
+float ApogeePredictor::getDragFactor() const {
+    return dragFactor_;
+}
+
+float ApogeePredictor::getPeakAltitude() const {
+    return peakAltitude_;
+}
+
+uint64_t ApogeePredictor::getPeakTime() const {
+    return peakTime_;
+}
+
+void ApogeePredictor::reset() {
+    coastSamples_ = 0;
+    dragMoment_ = 0;
+    velocityMoment_ = 0;
+    dragFactor_ = 0;
+    hasPrediction_ = false;
+    predictedTime_ = 0;
+    predictedAltitude_ = 0;
+    hasPeak_ = false;
+    peakAltitude_ = 0;
+    peakTime_ = 0;
+}
@@ -0,0 +1,127 @@
+#ifndef APOGEE_PREDICTOR_HPP
+#define APOGEE_PREDICTOR_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @class ApogeePredictor
+ * @brief Predicts apogee time and altitude from a ballistic coast model.
+ *
+ * After burnout the vertical acceleration is gravity plus quadratic drag,
+ * a = -g - k v|v|. The drag factor k is fitted by least squares to the fused
+ * acceleration and velocity while the vehicle is fast enough for drag to be
+ * measurable, and
+ * the closed form solution of the model gives the time and height left to apogee:
+ *
+ *     t = atan(v sqrt(k/g)) / sqrt(g k)
+ *     h = ln(1 + k v^2 / g) / (2 k)
+ *
+ * which tend to v/g and v^2/(2g) as k goes to 0. Detecting apogee from the
+ * velocity reaching zero adds the whole filter lag; the prediction does not.
+ *
+ * The highest altitude fed in and when it was seen are kept as the actual
+ * apogee, to track the accuracy of the prediction.
+ */
+class ApogeePredictor {
+public:
+    /**
+     * @brief Constructor for ApogeePredictor.
+     *
+     * @param gravity Gravitational acceleration (m/s^2).
+     */
+    explicit ApogeePredictor(float gravity);
+
+    /**
+     * @brief Add the fused state at a control tick.
+     *
+     * @param now Current time (us).
+     * @param altitude Fused altitude (m).
+     * @param velocity Fused vertical velocity (m/s).
+     * @param acceleration Fused vertical acceleration, gravity removed (m/s^2).
+     * @return True if there is a prediction.
+     */
+    bool update(uint64_t now, float altitude, float velocity, float acceleration);
+
+    /**
+     * @brief Check if apogee has been predicted.
+     *
+     * A prediction needs a short run of coasting samples, so the thrust tail
+     * off at burnout is not taken for drag.
+     *
+     * @return True if there is a prediction.
+     */
+    bool hasPrediction() const;
+
+    /**
+     * @brief Get the predicted apogee time.
+     *
+     * @return Predicted time of apogee (us), 0 if none.
+     */
+    uint64_t getPredictedTime() const;
+
+    /**
+     * @brief Get the predicted apogee altitude.
+     *
+     * @return Predicted altitude (m), 0 if none.
+     */
+    float getPredictedAltitude() const;
+
+    /**
+     * @brief Get the estimated drag factor.
+     *
+     * @return k in a = -g - k v|v| (1/m).
+     */
+    float getDragFactor() const;
+
+    /**
+     * @brief Get the highest altitude fed in.
+     *
+     * @return Actual apogee altitude (m).
+     */
+    float getPeakAltitude() const;
+
+    /**
+     * @brief Get the time the highest altitude was fed in.
+     *
+     * @return Actual apogee time (us), 0 if none.
+     */
+    uint64_t getPeakTime() const;
+
+    /**
+     * @brief Clear the prediction, drag estimate and peak.
+     */
+    void reset();
+
+private:
+    float gravity_; ///< Gravitational acceleration (m/s^2)
+    size_t coastSamples_; ///< Consecutive samples decelerating like a coasting vehicle
+    float dragMoment_; ///< Sum of drag deceleration times v^2 over the coast
+    float velocityMoment_; ///< Sum of v^4 over the coast
+    float dragFactor_; ///< Least squares drag factor k (1/m)
+    bool hasPrediction_; ///< True once apogee has been predicted
+    uint64_t predictedTime_; ///< Predicted apogee time (us)
+    float predictedAltitude_; ///< Predicted apogee altitude (m)
+    bool hasPeak_; ///< True once an altitude has been fed in
+    float peakAltitude_; ///< Highest altitude fed in (m)
+    uint64_t peakTime_; ///< Time of the highest altitude (us)
+
+    /**
+     * @brief Fold a drag measurement into the drag factor.
+     *
+     * @param velocity Vertical velocity (m/s).
+     * @param acceleration Vertical acceleration (m/s^2).
+     */
+    void updateDrag(float velocity, float acceleration);
+
+    /**
+     * @brief Predict apogee from the current state.
+     *
+     * @param now Current time (us).
+     * @param altitude Altitude (m).
+     * @param velocity Upward vertical velocity (m/s).
+     */
+    void predict(uint64_t now, float altitude, float velocity);
+};
+
+#endif // APOGEE_PREDICTOR_HPP
@@ -1,38 +1,213 @@
 #include "flightStateMachine.hpp"
 
-FlightStateMachine::FlightStateMachine(BuzzerFunctions& buzzerFunc, DataLogger& logger)
+constexpr FlightStateMachine::StateBehaviour FlightStateMachine::STATES[] = {
+    // state                               handler                                         logging (ms)        name
+    {FlightState::PRE_LAUNCH,              &FlightStateMachine::handlePreLaunch,            NO_FLIGHT_LOGGING, "PRE_LAUNCH"},
+    {FlightState::ASCENT,                  &FlightStateMachine::handleAscent,               0,                 "ASCENT"},
+    {FlightState::APOGEE,                  &FlightStateMachine::handleApogee,               0,                 "APOGEE"},
+    {FlightState::DESCENT_DROGUE,          &FlightStateMachine::handleDescentDrogue,        500,               "DESCENT_DROGUE"},
+    {FlightState::LOW_ALTITUDE_DETECTION,  nullptr,                                         500,               "LOW_ALTITUDE_DETECTION"},
+    {FlightState::DESCENT_MAIN,            nullptr,                                         500,               "DESCENT_MAIN"},
+    {FlightState::LANDING,                 &FlightStateMachine::handleLanding,              NO_FLIGHT_LOGGING, "LANDING"},
+    {FlightState::COAST,                   &FlightStateMachine::handleCoast,                0,                 "COAST"},
+    {FlightState::FAILURE,                 nullptr,                                         500,               "FAILURE"},
+};
+
+// Rows of a state are evaluated in order and the first guard that passes is taken
+constexpr FlightStateMachine::FlightTransition FlightStateMachine::TRANSITIONS[] = {
+    // from                                  guard                                      action                                    to                                    name
+    {FlightState::PRE_LAUNCH,             &FlightStateMachine::isLaunched,           &FlightStateMachine::logLaunchDetection,  FlightState::ASCENT,                 "launch"},
+    {FlightState::ASCENT,                 &FlightStateMachine::isApogeeDetected,     &FlightStateMachine::logApogeeDetection,  FlightState::APOGEE,                 "apogee_detected"},
+    {FlightState::ASCENT,                 &FlightStateMachine::isBurnout,            &FlightStateMachine::logBurnout,          FlightState::COAST,                  "burnout"},
+    {FlightState::APOGEE,                 &FlightStateMachine::isBelowMinimumApogee, &FlightStateMachine::handleApogeeFailure, FlightState::FAILURE,                "below_minimum_apogee"},
+    {FlightState::APOGEE,                 &FlightStateMachine::isDrogueFired,        &FlightStateMachine::logDrogueDeployed,   FlightState::DESCENT_DROGUE,         "drogue_fired"},
+    {FlightState::DESCENT_DROGUE,         &FlightStateMachine::isBelowMainAltitude,  nullptr,                                  FlightState::LOW_ALTITUDE_DETECTION, "main_altitude"},
+    {FlightState::LOW_ALTITUDE_DETECTION, &FlightStateMachine::isMainFired,          &FlightStateMachine::logMainDeployed,     FlightState::DESCENT_MAIN,           "main_fired"},
+    {FlightState::DESCENT_MAIN,           &FlightStateMachine::isLanded,             &FlightStateMachine::handleTouchdown,     FlightState::LANDING,                "landed"},
+    {FlightState::COAST,                  &FlightStateMachine::isApogeeDetected,     &FlightStateMachine::logApogeeDetection,  FlightState::APOGEE,                 "apogee_detected"},
+    {FlightState::COAST,                  &FlightStateMachine::isApogeePredicted,    &FlightStateMachine::logPredictedApogee,  FlightState::APOGEE,                 "apogee_predicted"},
+    {FlightState::FAILURE,                &FlightStateMachine::isAtRestOnGround,     &FlightStateMachine::handleTouchdown,     FlightState::LANDING,                "at_rest"},
+};
+
+constexpr size_t FlightStateMachine::NUM_TRANSITIONS = sizeof(TRANSITIONS) / sizeof(TRANSITIONS[0]);
+
+// Bound by reference when forwarded to make_shared, so it needs a definition before C++17
+constexpr size_t FlightStateMachine::BARO_HISTORY_SIZE;
+
+constexpr TransitionIndex<NUM_FLIGHT_STATES> FlightStateMachine::TRANSITION_INDEX =
+    TransitionTable::makeIndex<NUM_FLIGHT_STATES>(TRANSITIONS, NUM_TRANSITIONS);
+
+FlightStateMachine::FlightStateMachine(BuzzerFunctions& buzzerFunc, DataLogger& logger, PositionalServo& fins)
     : currentState_(FlightState::PRE_LAUNCH),
-      altitudeProcessor_(std::make_shared<BarometricProcessor>(150, 0.8)),
-      imuProcessor_(std::make_shared<IMUProcessor>(150, 0.8)),
-      pyroDrogue_(PYRO_DROGUE, DROGUE_DELAY),
-      pyroMain_(PYRO_MAIN, MAIN_DELAY),
+      altitudeProcessor_(std::make_shared<BarometricProcessor>(BARO_HISTORY_SIZE, 0.8)),
+      imuProcessor_(std::make_shared<IMUProcessor>(150)),
+      drogueChannel_(-1),
+      mainChannel_(-1),
+      drogueEvent_(-1),
+      mainEvent_(-1),
       buzzerFunc_(buzzerFunc),
       logger_(logger),
-      sensors_(logger) {
+      fins_(fins),
+      finPositions_(),
+      finControlEnabled_(false),
+      finsActive_(false),
+      sensors_(logger),
+      controlLoop_(DEFAULT_CONTROL_PERIOD),
+      apogeePredictor_(9.81f),
+      drogueArmed_(false),
+      apogeeAccuracyLogged_(false),
+      tickTime_(0),
+      stateEntryTick_(0),
+      transitionCount_(0),
+      loggedOverruns_(0),
+      flightLogInterval_(NO_FLIGHT_LOGGING),
+      lastLoggedTick_(0) {
+    static_assert(BARO_HISTORY_SIZE <= MAX_HISTORY_SIZE, "Barometric history does not fit the sample buffer");
+    static_assert(TransitionTable::isIndexedByState(STATES, sizeof(STATES) / sizeof(STATES[0]), NUM_FLIGHT_STATES),
+                  "STATES needs one row per flight state, in FlightState order");
+    static_assert(TransitionTable::statesInRange(TRANSITIONS, NUM_TRANSITIONS, NUM_FLIGHT_STATES),
+                  "TRANSITIONS names a state that does not exist");
+    static_assert(TransitionTable::isGroupedByState(TRANSITIONS, NUM_TRANSITIONS),
+                  "TRANSITIONS must be grouped by state, in FlightState order");
+    static_assert(TransitionTable::isWellFormed(TRANSITIONS, NUM_TRANSITIONS),
+                  "Every transition needs a guard and must leave its state");
+    static_assert(TransitionTable::allReachable(TRANSITIONS, NUM_TRANSITIONS, NUM_FLIGHT_STATES, FlightState::PRE_LAUNCH),
+                  "Every flight state must be reachable from PRE_LAUNCH");
+    static_assert(NUM_TRANSITIONS < EXTERNAL_TRANSITION, "TRANSITIONS is too long for its index");
+
     // Initialize sensors_ and actuators
     initializeSensors();
+    initializePyros();
 }
 
 void FlightStateMachine::initializeSensors() {
    
-    // TODO: Add logic to determine if the sensor should be added
-    // Example: Check if sensor is found and if stable readings can be identified
+    // Sensors are always added; SensorFusion's health monitor leaves out any
+    // sensor that stops updating, sticks or floods errors until it recovers
     
     // Add BarometricProcessor to SensorFusion
     sensors_.addSensor(altitudeProcessor_);
     sensors_.addSensor(imuProcessor_);
 }
 
-void FlightStateMachine::update() {
+void FlightStateMachine::initializePyros() {
+    // The pins are driven LOW from construction, long before the events are set up
+    drogueChannel_ = pyroScheduler_.addChannel("drogue", PYRO_DROGUE, PYRO_HOLD);
+    mainChannel_ = pyroScheduler_.addChannel("main", PYRO_MAIN, PYRO_HOLD);
+}
+
+void FlightStateMachine::configurePyroEvents() {
+    uint32_t spacing = (PYRO_SPACING > 0) ? static_cast<uint32_t>(PYRO_SPACING * 1000) : DEFAULT_PYRO_SPACING;
+    pyroScheduler_.setMinimumSpacing(spacing);
+
+    if (drogueEvent_ >= 0) {
+        return; // Added by an earlier begin(), adding them again would fire every channel twice
+    }
+    drogueEvent_ = pyroScheduler_.addStateEvent("drogue", drogueChannel_, FlightState::APOGEE,
+                                                static_cast<uint32_t>(DROGUE_DELAY * 1000));
+    mainEvent_ = pyroScheduler_.addStateEvent("main", mainChannel_, FlightState::LOW_ALTITUDE_DETECTION,
+                                              static_cast<uint32_t>(MAIN_DELAY * 1000));
+}
+
+bool FlightStateMachine::begin() {
+    // Config files written before CONTROL_RATE existed leave it at 0
+    uint32_t period = (CONTROL_RATE > 0) ? static_cast<uint32_t>(1e6f / CONTROL_RATE) : DEFAULT_CONTROL_PERIOD;
+    controlLoop_.setPeriod(period);
+
+    uint32_t launchDuration = (LAUNCH_ACC_DURATION > 0) ? static_cast<uint32_t>(LAUNCH_ACC_DURATION * 1000) : DEFAULT_LAUNCH_ACC_DURATION;
+    launchDetector_.setAccelerationTest(LAUNCH_ACC_THRESHOLD, launchDuration);
+    launchDetector_.setBarometricTest(LAUNCH_VEL_THRESHOLD, LAUNCH_ALTITUDE_THRESHOLD);
+
+    uint32_t apogeeHold = (APOGEE_TIMER > 0) ? static_cast<uint32_t>(APOGEE_TIMER * 1000) : DEFAULT_APOGEE_TIMER;
+    apogeeDetector_.configure(APOGEE_VELOCITY_THRESHOLD, APOGEE_ALTITUDE_DROP, apogeeHold, APOGEE_REQUIRED_SIGNALS);
+    // Same gravity the IMU removes, which is only known once the config is loaded
+    apogeePredictor_ = ApogeePredictor(G_OFFSET);
+    // Delays are only known once the config is loaded
+    configurePyroEvents();
+    configureFinControl();
+
+    if (!sensors_.startSampling()) {
+        logger_.logEvent("Sensor sampling failed to start");
+        return false;
+    }
+    if (!pyroScheduler_.start()) {
+        logger_.logEvent("Pyro timer failed to start");
+        return false;
+    }
+    return true;
+}
+
+bool FlightStateMachine::update() {
+    // The sampling interrupt only counts ticks, the bus is read here
+    bool sampled = sensors_.sampleSensors();
+    tickTime_ = Timer::currentTimeMicros();
+    if (!controlLoop_.isDue(tickTime_)) {
+        return sampled;
+    }
+    PROFILE_SCOPE(FLIGHT_STATE);
     updateSensorData();
     handleStateTransition();
+    updatePyros();
+    updateFinControl();
+    controlLoop_.endTick(Timer::currentTimeMicros());
+    return true;
+}
+
+bool FlightStateMachine::updateBackground() {
+    bool logged = logOverruns();
+
+    if (flightLogInterval_ == NO_FLIGHT_LOGGING) {
+        return logged;
+    }
+    // Nothing new to log until the next tick has run
+    if (controlLoop_.getTickCount() == lastLoggedTick_) {
+        return logged;
+    }
+    lastLoggedTick_ = controlLoop_.getTickCount();
+    logSensorData(flightLogInterval_);
+    return true;
+}
+
+const ControlLoop& FlightStateMachine::getControlLoop() const {
+    return controlLoop_;
+}
+
+bool FlightStateMachine::logOverruns() {
+    uint32_t overruns = controlLoop_.getOverrunCount();
+    if (overruns == loggedOverruns_) {
+        return false;
+    }
+    char logMessage[128];
+    int offset = snprintf(logMessage, sizeof(logMessage), "CONTROL OVERRUN x%lu, last at ",
+                          static_cast<unsigned long>(overruns - loggedOverruns_));
+    offset += Timer::formatMicros(logMessage + offset, sizeof(logMessage) - offset,
+                                  controlLoop_.getLastOverrunTime());
+    snprintf(logMessage + offset, sizeof(logMessage) - offset,
+             "us, %luus late, total=%lu skipped=%lu max_response=%luus",
+             static_cast<unsigned long>(controlLoop_.getLastOverrunLength()),
+             static_cast<unsigned long>(overruns),
+             static_cast<unsigned long>(controlLoop_.getSkippedCount()),
+             static_cast<unsigned long>(controlLoop_.getMaxResponseTime()));
+    logger_.logEvent(logMessage);
+    loggedOverruns_ = overruns;
+    return true;
 }
 
 
+void FlightStateMachine::logProfile() {
+#ifdef PROFILING
+    for (size_t i = 0; i < static_cast<size_t>(ProfileSection::NUM_SECTIONS); ++i) {
+        char logMessage[256];
+        Profiler::format(static_cast<ProfileSection>(i), logMessage, sizeof(logMessage));
+        logger_.logEvent(logMessage);
+    }
+#endif
+}
+
 void FlightStateMachine::logSensorData(uint16_t delayTime) {
     if (delayTime == 0) {
         // Log data immediately if delayTime is zero
-        sensors_.logSensorData();
+        sensors_.logSensorData(controlLoop_.getOverrunCount(), pyroScheduler_.getChannelStates());
         return;
     }
     // If delay time is not zero, log data based on time delay
@@ -43,7 +218,7 @@ void FlightStateMachine::logSensorData(uint16_t delayTime) {
         return;
     }
     // Log data
-    sensors_.logSensorData();
+    sensors_.logSensorData(controlLoop_.getOverrunCount(), pyroScheduler_.getChannelStates());
 
     // Reset timer for next cycle
     loggingTimer_.reset();
@@ -60,35 +235,84 @@ void FlightStateMachine::updateSensorData() {
 
 }
 
+void FlightStateMachine::updatePyros() {
+    if (!pyroScheduler_.isArmed() && maxAltitude_ >= MINIMUM_APOGEE) {
+        pyroScheduler_.setArmed(true);
+        char logMessage[64];
+        snprintf(logMessage, sizeof(logMessage), "PYROS ARMED at %.2f METERS", maxAltitude_);
+        logger_.logEvent(logMessage);
+    }
+    if (pyroScheduler_.update(tickTime_, currentState_, currentAltitude_, currentVelocity_) > 0) {
+        logPyroEvents();
+    }
+}
+
+void FlightStateMachine::configureFinControl() {
+    rateController_.setGains(ControlAxis::ROLL, {ROLL_KP, ROLL_KI, ROLL_KD});
+    rateController_.setGains(ControlAxis::PITCH, {PITCH_KP, PITCH_KI, PITCH_KD});
+    rateController_.setGains(ControlAxis::YAW, {YAW_KP, YAW_KI, YAW_KD});
+    float referenceVelocity = (CONTROL_REFERENCE_VELOCITY > 0) ? CONTROL_REFERENCE_VELOCITY : DEFAULT_CONTROL_REFERENCE_VELOCITY;
+    rateController_.setSchedule(referenceVelocity, CONTROL_MIN_VELOCITY, FIN_MAX_GAIN_SCALE);
+    rateController_.setMaxDeflection(FIN_MAX_DEFLECTION);
+
+    finControlEnabled_ = FIN_CONTROL != 0;
+}
+
+void FlightStateMachine::updateFinControl() {
+    if (!finControlEnabled_) {
+        return;
+    }
+    bool controlled = currentState_ == FlightState::ASCENT || currentState_ == FlightState::COAST;
+    if (!controlled) {
+        if (finsActive_) {
+            centerFins();
+        }
+        return;
+    }
+    // Below CONTROL_MIN_VELOCITY the controller disengages with zero deflections, which centers the fins
+    rateController_.update(tickTime_, imuProcessor_->getBodyRate(), currentVelocity_);
+    moveFins();
+    finsActive_ = true;
+}
+
+void FlightStateMachine::moveFins() {
+    for (size_t i = 0; i < RateController::NUM_FINS; ++i) {
+        int position = static_cast<int>(lroundf(rateController_.getDeflection(i)));
+        // Servo writes only change the pulse width, so unchanged fins are skipped
+        if (finsActive_ && position == finPositions_[i]) {
+            continue;
+        }
+        fins_.moveServoRelativeToCenter(static_cast<char>('A' + i), position);
+        finPositions_[i] = position;
+    }
+}
+
+void FlightStateMachine::centerFins() {
+    rateController_.reset();
+    fins_.centerAllServoPositions();
+    for (int& position : finPositions_) {
+        position = 0;
+    }
+    finsActive_ = false;
+    logger_.logEvent("FINS CENTERED");
+}
+
 void FlightStateMachine::handleStateTransition() {
-    switch (currentState_) {
-        case FlightState::PRE_LAUNCH:
-            handlePreLaunch();
-            break;
-        case FlightState::ASCENT:
-            handleAscent();
-            break;
-        case FlightState::APOGEE:
-            handleApogee();
-            break;
-        case FlightState::DESCENT_DROGUE:
-            handleDescentDrogue();
-            break;
-        case FlightState::LOW_ALTITUDE_DETECTION:
-            handleLowAltitudeDetection();
-            break;
-        case FlightState::DESCENT_MAIN:
-            handleDescentMain();
-            break;
-        case FlightState::LANDING:
-            handleLanding();
-            break;
-        case FlightState::STAGE_SEPARATION:
-            handleStageSeparation();
-            break;
-        case FlightState::FAILURE:
-            handleFailure();
-            break;
+    const StateBehaviour& behaviour = STATES[static_cast<size_t>(currentState_)];
+    // Each state sets the flight data logging it needs, logged in the background
+    flightLogInterval_ = behaviour.logInterval;
+    if (behaviour.handler != nullptr) {
+        (this->*behaviour.handler)();
+    }
+
+    int row = TransitionTable::findTransition(*this, TRANSITIONS, TRANSITION_INDEX, currentState_);
+    if (row < 0) {
+        return;
+    }
+    const FlightTransition& transition = TRANSITIONS[row];
+    enterState(transition.to, static_cast<uint8_t>(row));
+    if (transition.action != nullptr) {
+        (this->*transition.action)();
     }
 }
 
@@ -96,104 +320,317 @@ FlightState FlightStateMachine::getCurrentState() const {
     return currentState_;
 }
 
+bool FlightStateMachine::isOnGround() const {
+    return currentState_ == FlightState::PRE_LAUNCH || currentState_ == FlightState::LANDING;
+}
+
 void FlightStateMachine::transitionToState(FlightState newState) {
+    enterState(newState, EXTERNAL_TRANSITION);
+}
+
+void FlightStateMachine::enterState(FlightState newState, uint8_t transition) {
+    uint32_t tick = controlLoop_.getTickCount();
+    transitionTrace_.push({tickTime_, currentState_, newState, transition, tick - stateEntryTick_,
+                           currentAltitude_, currentVelocity_, sensors_.getFusedAcceleration(), maxAltitude_});
+    transitionCount_++;
+
     currentState_ = newState;
+    stateEntryTick_ = tick;
+}
+
+void FlightStateMachine::logTransitionTrace() {
+    char logMessage[192];
+    if (transitionCount_ > transitionTrace_.size()) {
+        snprintf(logMessage, sizeof(logMessage), "TRANSITION TRACE dropped %lu oldest",
+                 static_cast<unsigned long>(transitionCount_ - transitionTrace_.size()));
+        logger_.logEvent(logMessage);
+    }
+    for (size_t i = 0; i < transitionTrace_.size(); ++i) {
+        const TransitionRecord& record = transitionTrace_[i];
+        const char* name = (record.transition == EXTERNAL_TRANSITION) ? "external" : TRANSITIONS[record.transition].name;
+        int offset = snprintf(logMessage, sizeof(logMessage), "TRANSITION ");
+        offset += Timer::formatMicros(logMessage + offset, sizeof(logMessage) - offset, record.time);
+        snprintf(logMessage + offset, sizeof(logMessage) - offset,
+                 "us %s->%s %s after %lu ticks alt=%.2f vel=%.2f acc=%.2f max_alt=%.2f",
+                 STATES[static_cast<size_t>(record.from)].name, STATES[static_cast<size_t>(record.to)].name,
+                 name, static_cast<unsigned long>(record.evaluations), record.altitude, record.velocity,
+                 record.acceleration, record.maxAltitude);
+        logger_.logEvent(logMessage);
+    }
 }
 
 void FlightStateMachine::handlePreLaunch() {
-    // Pre-launch logic
-    
     // play regular wait for launch tone, only in non debug mode
     if(!DEBUG) {
         buzzerFunc_.preLaunchTone();
     }
-   
-    if (currentVelocity_ > LAUNCH_VEL_THRESHOLD) {
-        transitionToState(FlightState::ASCENT);
-        char logMessage[40];
-        snprintf(logMessage, sizeof(logMessage), "Launch detected for velocity = %.2f", currentVelocity_);
-        logger_.logEvent(logMessage);
-        return;
-    }
 
-    // redudant altitude check
-    if (currentAltitude_ > LAUNCH_ALTITUDE_THRESHOLD) {
-        transitionToState(FlightState::ASCENT);
-        char logMessage[40];
-        snprintf(logMessage, sizeof(logMessage), "Launch detected for altitude = %.2f", currentAltitude_);
-        logger_.logEvent(logMessage);
-        return;
+    // Sustained IMU acceleration reacts first, velocity and altitude lag
+    // behind the barometric smoothing and back it up
+    if (imuProcessor_->hasEstimate(SensorOutput::ACCELERATION)) {
+        launchDetector_.updateAcceleration(tickTime_, imuProcessor_->getMeasurement(SensorOutput::ACCELERATION));
     }
+    launchDetector_.updateBarometric(tickTime_, currentVelocity_, currentAltitude_);
 }
 
 void FlightStateMachine::handleAscent() {
-    // Ascent logic
-    logSensorData();
-   
-    // Apogee detection logic
-    if (currentVelocity_ <= APOGEE_VELOCITY_THRESHOLD) {
-        transitionToState(FlightState::APOGEE);
-        char logMessage[40];
-        snprintf(logMessage, sizeof(logMessage), "APOGEE DETECTED = %.2f METERS", currentAltitude_);
-        logger_.logEvent(logMessage);
-    }
+    updateApogeeDetection();
+}
+
+void FlightStateMachine::handleCoast() {
+    updateApogeeDetection();
+    armDrogue();
 }
 
 void FlightStateMachine::handleApogee() {
-    // Apogee logic
-    logSensorData();
-    if(maxAltitude_ < MINIMUM_APOGEE) {
-        // Do not allow pyro to trigger if minimum apogee was not reached,
-        /// TODO: create failure mode for this
-        return;
+    // The drogue event fires from the scheduler; the pyros are never armed below the minimum apogee
+    updateApogeeAccuracy();
+}
+
+void FlightStateMachine::handleDescentDrogue() {
+    updateApogeeAccuracy();
+}
+
+void FlightStateMachine::handleLanding() {
+    // infinitely play
+    buzzerFunc_.landingTone();
+}
+
+bool FlightStateMachine::isLaunched() const {
+    return launchDetector_.isLaunched();
+}
+
+bool FlightStateMachine::isApogeeDetected() const {
+    return apogeeDetector_.isApogee();
+}
+
+bool FlightStateMachine::isBurnout() const {
+    // The predictor only predicts once the vehicle is coasting
+    return apogeePredictor_.hasPrediction();
+}
+
+bool FlightStateMachine::isApogeePredicted() const {
+    // Deploy at the predicted instant, skipping the filter lag, but only if
+    // the measured velocity agrees that the vehicle has nearly stopped climbing
+    return drogueArmed_ && tickTime_ >= apogeePredictor_.getPredictedTime()
+        && currentVelocity_ <= PREDICTED_APOGEE_CONFIRM_VELOCITY;
+}
+
+bool FlightStateMachine::isBelowMinimumApogee() const {
+    return maxAltitude_ < MINIMUM_APOGEE;
+}
+
+bool FlightStateMachine::isDrogueFired() const {
+    return pyroScheduler_.isEventComplete(drogueEvent_);
+}
+
+bool FlightStateMachine::isMainFired() const {
+    return pyroScheduler_.isEventComplete(mainEvent_);
+}
+
+bool FlightStateMachine::isBelowMainAltitude() const {
+    return currentAltitude_ <= MAIN_DEPLOYMENT_ALT;
+}
+
+bool FlightStateMachine::isLanded() const {
+    return currentVelocity_ <= LANDING_VEL_THRESHOLD;
+}
+
+bool FlightStateMachine::isAtRestOnGround() const {
+    return std::fabs(currentVelocity_) <= LANDING_VEL_THRESHOLD && currentAltitude_ <= LAUNCH_ALTITUDE_THRESHOLD;
+}
+
+void FlightStateMachine::logLaunchDetection() {
+    const char* test = "altitude";
+    if (launchDetector_.getTrigger() == LaunchTrigger::ACCELERATION) {
+        test = "acceleration";
+    } else if (launchDetector_.getTrigger() == LaunchTrigger::VELOCITY) {
+        test = "velocity";
     }
-    // Trigger drogue parachute
-    if(pyroDrogue_.trigger()) {
-        transitionToState(FlightState::DESCENT_DROGUE);
-        logger_.logEvent("DROGUE DEPLOYED");
+
+    char logMessage[96];
+    int offset = snprintf(logMessage, sizeof(logMessage), "Launch detected for %s = %.2f",
+                          test, launchDetector_.getTriggerValue());
+    if (launchDetector_.getIgnitionTime() != 0) {
+        snprintf(logMessage + offset, sizeof(logMessage) - offset, ", %.1f ms after ignition",
+                 (launchDetector_.getDetectionTime() - launchDetector_.getIgnitionTime()) * 1e-3f);
     }
+    logger_.logEvent(logMessage);
 }
 
-void FlightStateMachine::handleDescentDrogue() {
-    // Descent under drogue logic
-    logSensorData(500);
-    if (currentAltitude_ <= MAIN_DEPLOYMENT_ALT) {
-        transitionToState(FlightState::LOW_ALTITUDE_DETECTION);
+void FlightStateMachine::updateApogeeDetection() {
+    apogeePredictor_.update(tickTime_, currentAltitude_, currentVelocity_, sensors_.getFusedAcceleration());
+
+    // Apogee needs two of the Kalman velocity, IMU velocity and falling
+    // altitude tests to hold for APOGEE_TIMER, so one noisy sample can't fire the drogue
+    float imuVelocity = NAN;
+    if (imuProcessor_->hasEstimate(SensorOutput::VERTICAL_VELOCITY)) {
+        imuVelocity = imuProcessor_->getMeasurement(SensorOutput::VERTICAL_VELOCITY);
     }
+    apogeeDetector_.update(tickTime_, currentVelocity_, imuVelocity, currentAltitude_);
 }
 
-void FlightStateMachine::handleLowAltitudeDetection() {
-    
-    logSensorData(500);
-    // Trigger main parachutes
-    if(pyroMain_.trigger()){
-        transitionToState(FlightState::DESCENT_MAIN);
-        logger_.logEvent("MAIN DEPLOYED");
+void FlightStateMachine::armDrogue() {
+    if (drogueArmed_ || !apogeePredictor_.hasPrediction()) {
+        return;
     }
-    
+    uint64_t predictedTime = apogeePredictor_.getPredictedTime();
+    if (tickTime_ + DROGUE_ARM_LEAD < predictedTime || apogeePredictor_.getPredictedAltitude() < MINIMUM_APOGEE) {
+        return;
+    }
+    drogueArmed_ = true;
+    char logMessage[96];
+    int offset = snprintf(logMessage, sizeof(logMessage), "DROGUE ARMED for apogee of %.2f METERS at ",
+                          apogeePredictor_.getPredictedAltitude());
+    offset += Timer::formatMicros(logMessage + offset, sizeof(logMessage) - offset, predictedTime);
+    snprintf(logMessage + offset, sizeof(logMessage) - offset, "us");
+    logger_.logEvent(logMessage);
 }
 
-void FlightStateMachine::handleDescentMain() {
-    
-    logSensorData(500);
-    // Descent under main logic
-    if (currentVelocity_ <= LANDING_VEL_THRESHOLD) {
-        transitionToState(FlightState::LANDING);
-        logger_.logEvent("LANDING DETECTED");
+void FlightStateMachine::updateApogeeAccuracy() {
+    if (apogeeAccuracyLogged_) {
+        return;
+    }
+    if (!apogeeDetector_.isApogee()) {
+        updateApogeeDetection();
+        if (!apogeeDetector_.isApogee()) {
+            return;
+        }
+        logApogeeDetection();
     }
+    apogeeAccuracyLogged_ = true;
+
+    // The detector only confirms once the altitude is past its peak
+    char logMessage[192];
+    int offset = snprintf(logMessage, sizeof(logMessage), "APOGEE ACTUAL = %.2f METERS at ",
+                          apogeePredictor_.getPeakAltitude());
+    offset += Timer::formatMicros(logMessage + offset, sizeof(logMessage) - offset,
+                                  apogeePredictor_.getPeakTime());
+    if (!apogeePredictor_.hasPrediction()) {
+        snprintf(logMessage + offset, sizeof(logMessage) - offset, "us, no prediction");
+        logger_.logEvent(logMessage);
+        return;
+    }
+    offset += snprintf(logMessage + offset, sizeof(logMessage) - offset, "us, PREDICTED = %.2f METERS at ",
+                       apogeePredictor_.getPredictedAltitude());
+    offset += Timer::formatMicros(logMessage + offset, sizeof(logMessage) - offset,
+                                  apogeePredictor_.getPredictedTime());
+    float timeError = (static_cast<int64_t>(apogeePredictor_.getPredictedTime())
+                       - static_cast<int64_t>(apogeePredictor_.getPeakTime())) * 1e-3f;
+    snprintf(logMessage + offset, sizeof(logMessage) - offset, "us, error = %.2f m %.1f ms, drag = %.6f",
+             apogeePredictor_.getPredictedAltitude() - apogeePredictor_.getPeakAltitude(), timeError,
+             apogeePredictor_.getDragFactor());
+    logger_.logEvent(logMessage);
 }
 
-void FlightStateMachine::handleLanding() {
-    // infinitely play
-    buzzerFunc_.landingTone();
+void FlightStateMachine::logApogeeDetection() {
+    char logMessage[192];
+    int offset = snprintf(logMessage, sizeof(logMessage), "APOGEE DETECTED = %.2f METERS at ", currentAltitude_);
+    offset += Timer::formatMicros(logMessage + offset, sizeof(logMessage) - offset,
+                                  apogeeDetector_.getDetectionTime());
+    offset += snprintf(logMessage + offset, sizeof(logMessage) - offset, "us");
+    // Sized for every signal contributing with 10 digit timestamps
+    for (size_t i = 0; i < static_cast<size_t>(ApogeeSignal::NUM_SIGNALS); ++i) {
+        ApogeeSignal signal = static_cast<ApogeeSignal>(i);
+        if (!apogeeDetector_.isContributing(signal)) {
+            continue;
+        }
+        offset += snprintf(logMessage + offset, sizeof(logMessage) - offset, ", %s since ",
+                           ApogeeDetector::getName(signal));
+        offset += Timer::formatMicros(logMessage + offset, sizeof(logMessage) - offset,
+                                      apogeeDetector_.getSignalTime(signal));
+        offset += snprintf(logMessage + offset, sizeof(logMessage) - offset, "us");
+    }
+    logger_.logEvent(logMessage);
+}
+
+void FlightStateMachine::logBurnout() {
+    char logMessage[64];
+    snprintf(logMessage, sizeof(logMessage), "BURNOUT at %.2f METERS, velocity = %.2f",
+             currentAltitude_, currentVelocity_);
+    logger_.logEvent(logMessage);
+}
+
+void FlightStateMachine::logPredictedApogee() {
+    char logMessage[96];
+    int offset = snprintf(logMessage, sizeof(logMessage), "APOGEE PREDICTED = %.2f METERS at ",
+                          apogeePredictor_.getPredictedAltitude());
+    offset += Timer::formatMicros(logMessage + offset, sizeof(logMessage) - offset, tickTime_);
+    snprintf(logMessage + offset, sizeof(logMessage) - offset, "us, velocity = %.2f", currentVelocity_);
+    logger_.logEvent(logMessage);
+}
+
+void FlightStateMachine::handleApogeeFailure() {
+    char logMessage[80];
+    snprintf(logMessage, sizeof(logMessage), "APOGEE OF %.2f METERS BELOW MINIMUM, PYROS SAFE", maxAltitude_);
+    logger_.logEvent(logMessage);
+    buzzerFunc_.failure();
+}
+
+void FlightStateMachine::logDrogueDeployed() {
+    logDeployment("DROGUE DEPLOYED", drogueEvent_);
+}
+
+void FlightStateMachine::logMainDeployed() {
+    logDeployment("MAIN DEPLOYED", mainEvent_);
+}
+
+void FlightStateMachine::logDeployment(const char* name, int event) {
+    const PyroTimer& timer = pyroScheduler_.getTimer();
+    int channel = pyroScheduler_.getEventChannel(event);
+    char logMessage[128];
+    int offset = snprintf(logMessage, sizeof(logMessage), "%s commanded at ", name);
+    offset += Timer::formatMicros(logMessage + offset, sizeof(logMessage) - offset, timer.getCommandedTime(channel));
+    offset += snprintf(logMessage + offset, sizeof(logMessage) - offset, "us, fired at ");
+    offset += Timer::formatMicros(logMessage + offset, sizeof(logMessage) - offset, timer.getFireTime(channel));
+    // How late the timer made the edge, the accuracy the timer is there for
+    offset += snprintf(logMessage + offset, sizeof(logMessage) - offset, "us (+%ldus), released at ",
+                       static_cast<long>(timer.getFireTime(channel) - timer.getCommandedTime(channel)));
+    offset += Timer::formatMicros(logMessage + offset, sizeof(logMessage) - offset, timer.getReleaseTime(channel));
+    snprintf(logMessage + offset, sizeof(logMessage) - offset, "us");
+    logger_.logEvent(logMessage);
+}
+
+void FlightStateMachine::logPyroEvents() {
+    char logMessage[160];
+    for (size_t i = 0; i < pyroScheduler_.getNumEvents(); ++i) {
+        int event = static_cast<int>(i);
+        PyroEventState state = pyroScheduler_.getEventState(event);
+        if (state == PyroEventState::WAITING || pyroScheduler_.getEventTime(event) != tickTime_) {
+            continue;
+        }
+        int channel = pyroScheduler_.getEventChannel(event);
+        int offset = snprintf(logMessage, sizeof(logMessage), "PYRO %s on %s ", pyroScheduler_.getEventName(event),
+                              pyroScheduler_.getChannelName(channel));
+        if (state == PyroEventState::SKIPPED) {
+            snprintf(logMessage + offset, sizeof(logMessage) - offset, "SKIPPED, channel already used");
+            logger_.logEvent(logMessage);
+            continue;
+        }
+        offset += snprintf(logMessage + offset, sizeof(logMessage) - offset, "requested at ");
+        offset += Timer::formatMicros(logMessage + offset, sizeof(logMessage) - offset,
+                                      pyroScheduler_.getRequestedTime(event));
+        // Later than requested when moved clear of another channel by the minimum spacing
+        offset += snprintf(logMessage + offset, sizeof(logMessage) - offset, "us, commanded at ");
+        offset += Timer::formatMicros(logMessage + offset, sizeof(logMessage) - offset,
+                                      pyroScheduler_.getTimer().getCommandedTime(channel));
+        snprintf(logMessage + offset, sizeof(logMessage) - offset, "us");
+        logger_.logEvent(logMessage);
+    }
+    logPyroChannels();
 }
 
-void FlightStateMachine::handleStageSeparation() {
-    // Stage separation logic
-    // Placeholder for future implementation
+void FlightStateMachine::logPyroChannels() {
+    char logMessage[160];
+    int offset = snprintf(logMessage, sizeof(logMessage), "PYRO CHANNELS ");
+    pyroScheduler_.formatChannels(logMessage + offset, sizeof(logMessage) - offset);
+    logger_.logEvent(logMessage);
 }
 
-void FlightStateMachine::handleFailure() {
-    // failure logic
-    // Placeholder for future implementation
+void FlightStateMachine::handleTouchdown() {
+    logger_.logEvent("LANDING DETECTED");
+    logPyroChannels();
+    sensors_.logSchedulerStatistics();
+    logProfile();
+    logTransitionTrace();
 }
@@ -4,7 +4,9 @@
 #include "flightStates.hpp"
 #include "IMUSensor.hpp"
 #include "pressureSensor.hpp"
-#include "pyroController.hpp"
+#include "pyroScheduler.hpp"
+#include "rateController.hpp"
+#include "positionalServo.hpp"
 #include "pinAssn.hpp"
 #include "configKeys.hpp"
 #include "barometricProcessor.hpp"
@@ -12,6 +14,13 @@
 #include "buzzerFunctions.hpp"
 #include "dataLogger.hpp"
 #include "IMUProcessor.hpp"
+#include "controlLoop.hpp"
+#include "launchDetector.hpp"
+#include "apogeeDetector.hpp"
+#include "apogeePredictor.hpp"
+#include "transitionTable.hpp"
+#include "ringBuffer.hpp"
+#include "profiler.hpp"
 
 /**
  * @class FlightStateMachine
@@ -20,7 +29,31 @@
  *
  * This class handles the state transitions during the flight, 
  * updates and processes sensor data, and controls actuators 
- * such as the pyro controllers and buzzers.
+ * such as the pyro channels and buzzers.
+ *
+ * Sensor processing, sensor fusion and the state logic run in a fixed-rate
+ * control tick (CONTROL_RATE). Flight data logging and timing fault reports
+ * run in updateBackground(), in the time left between ticks, so a slow flash
+ * write delays a tick at most once instead of every tick.
+ *
+ * The state logic is table driven. STATES gives the handler that runs every
+ * tick in each state and the logging interval it needs, and TRANSITIONS lists
+ * each transition as (state, guard, action, next state). Both tables are
+ * checked at compile time, and the transitions out of the current state are
+ * found through an index, so a tick evaluates only those guards. Every
+ * transition taken is recorded with its time and guard inputs in a fixed-size
+ * trace, which is written to the log at landing.
+ *
+ * The pyro channels are fired by a PyroScheduler from events set up in
+ * begin(): the drogue on entering APOGEE and the main on entering
+ * LOW_ALTITUDE_DETECTION. It owns only the PYRO_DROGUE and PYRO_MAIN pins;
+ * the PYRO_3 and PYRO_4 pads share their pins with servos C and D, which the
+ * fins keep. The scheduler is armed once the altitude reaches MINIMUM_APOGEE.
+ *
+ * With FIN_CONTROL set, a RateController damps the body rates through the
+ * four fins every tick of ASCENT and COAST, with gains from the config
+ * scheduled by the vertical velocity. The fins are centered in every other
+ * state.
  */
 class FlightStateMachine {
 public:
@@ -29,15 +62,49 @@ public:
      * 
      * @param buzzerFunc_ Reference to the BuzzerFunctions object.
      * @param logger_ Reference to the DataLogger object.
+     * @param fins_ Reference to the PositionalServo object driving the fins.
+     */
+    FlightStateMachine(BuzzerFunctions& buzzerFunc_, DataLogger& logger_, PositionalServo& fins_);
+
+    /**
+     * @brief Start acquiring the sensors and apply the config to the control
+     * tick rate, launch and apogee detection and the fin rate controller.
+     * 
+     * Call from setup() once the config has been loaded and the I2C bus has
+     * been started. From then on update() reads the sensors on the bus.
+     * 
+     * @return True if sampling started.
+     */
+    bool begin();
+
+    /**
+     * @brief Read the sensors on a passed sampling tick, then run the control tick if it is due.
+     * 
+     * Sampling is checked on every call, so the sensors keep the sampling tick
+     * rate rather than the control rate. The control tick updates the sensor
+     * data, handles the state transitions, checks the pyro events and runs the
+     * fin rate controller.
+     * 
+     * @return True if a sampling tick or the control tick ran.
+     */
+    bool update();
+
+    /**
+     * @brief Do the work that does not need to run in the control tick.
+     * 
+     * Logs flight data at the interval the current state asks for, and logs
+     * any control tick overruns since the last call.
+     * 
+     * @return True if there was anything to log this tick.
      */
-    FlightStateMachine(BuzzerFunctions& buzzerFunc_, DataLogger& logger_);
+    bool updateBackground();
 
     /**
-     * @brief Update the flight state machine.
+     * @brief Get the control loop timing.
      * 
-     * This method updates the sensor data and handles the state transitions.
+     * @return The control loop.
      */
-    void update();
+    const ControlLoop& getControlLoop() const;
 
     /**
      * @brief Get the current flight state.
@@ -47,7 +114,16 @@ public:
     FlightState getCurrentState() const;
 
     /**
-     * @brief Transition to a new flight state.
+     * @brief Check if the rocket is on the ground, before launch or after landing.
+     * 
+     * @return True if on the ground.
+     */
+    bool isOnGround() const;
+
+    /**
+     * @brief Transition to a new flight state outside the transition table.
+     * 
+     * The transition is recorded in the trace like any other.
      * 
      * @param newState The new flight state to transition to.
      */
@@ -61,83 +137,335 @@ public:
     void logSensorData(uint16_t delayTime = 0);
 
 private:
+    /**
+     * @struct StateBehaviour
+     * @brief What a state does every control tick.
+     */
+    struct StateBehaviour {
+        FlightState state; ///< The state, which is also its row in STATES
+        void (FlightStateMachine::*handler)(); ///< Run every tick before the guards, nullptr for none
+        int32_t logInterval; ///< Flight data logging interval (ms), NO_FLIGHT_LOGGING for none
+        const char* name; ///< Name for logs
+    };
+
+    /**
+     * @struct TransitionRecord
+     * @brief A transition taken, with the inputs its guard saw.
+     */
+    struct TransitionRecord {
+        uint64_t time; ///< Control tick the guard passed in (us)
+        FlightState from; ///< State left
+        FlightState to; ///< State entered
+        uint8_t transition; ///< Row in TRANSITIONS, EXTERNAL_TRANSITION for transitionToState
+        uint32_t evaluations; ///< Ticks the guards of the state left were evaluated
+        float altitude; ///< Fused altitude (m)
+        float velocity; ///< Fused vertical velocity (m/s)
+        float acceleration; ///< Fused vertical acceleration (m/s^2)
+        float maxAltitude; ///< Maximum recorded altitude (m)
+    };
+
+    typedef Transition<FlightState, FlightStateMachine> FlightTransition;
+
+    static constexpr size_t TRANSITION_TRACE_SIZE = 32; ///< Transitions kept in the trace
+    static constexpr uint8_t EXTERNAL_TRANSITION = 0xFF; ///< TransitionRecord::transition for transitionToState
+    static const StateBehaviour STATES[]; ///< Behaviour of each state, in FlightState order
+    static const FlightTransition TRANSITIONS[]; ///< Transition table, grouped by state
+    static const size_t NUM_TRANSITIONS; ///< Rows in TRANSITIONS
+    static const TransitionIndex<NUM_FLIGHT_STATES> TRANSITION_INDEX; ///< First row of each state in TRANSITIONS
+
     FlightState currentState_; ///< The current flight state
     std::shared_ptr<BarometricProcessor> altitudeProcessor_; ///< The barometric processor
     std::shared_ptr<IMUProcessor> imuProcessor_; ///< The IMU processor
-    PyroController pyroDrogue_; ///< The pyro controller for drogue deployment
-    PyroController pyroMain_; ///< The pyro controller for main deployment
+    PyroScheduler pyroScheduler_; ///< Owns the pyro channels and fires them from the deployment events
+    int drogueChannel_; ///< Pyro channel of the drogue charge
+    int mainChannel_; ///< Pyro channel of the main charge
+    int drogueEvent_; ///< Pyro event deploying the drogue
+    int mainEvent_; ///< Pyro event deploying the main
     BuzzerFunctions& buzzerFunc_; ///< Reference to the BuzzerFunctions object
     DataLogger& logger_; ///< Reference to the DataLogger object
+    PositionalServo& fins_; ///< Reference to the PositionalServo object driving the fins
+    RateController rateController_; ///< Body rate control through the fins
+    int finPositions_[RateController::NUM_FINS]; ///< Deflection last written to each fin (degrees)
+    bool finControlEnabled_; ///< True if FIN_CONTROL is set and all four servos are connected
+    bool finsActive_; ///< True while the rate controller is driving the fins
     SensorFusion sensors_; ///< The sensor fusion object
     Timer loggingTimer_; ///< Timer for managing logging intervals
+    ControlLoop controlLoop_; ///< Releases the control tick and checks its deadlines
+    LaunchDetector launchDetector_; ///< Detects launch from acceleration, velocity and altitude
+    ApogeeDetector apogeeDetector_; ///< Debounced, cross-checked apogee detection
+    ApogeePredictor apogeePredictor_; ///< Predicts apogee from the coast after burnout
+    bool drogueArmed_; ///< True once apogee is predicted close enough to deploy at the predicted instant
+    bool apogeeAccuracyLogged_; ///< True once predicted and actual apogee have been logged
+    uint64_t tickTime_; ///< Start of the current control tick (us)
+    uint32_t stateEntryTick_; ///< Control tick the current state was entered on
+    RingBuffer<TransitionRecord, TRANSITION_TRACE_SIZE> transitionTrace_; ///< Most recent transitions
+    uint32_t transitionCount_; ///< Transitions taken, including any dropped from the trace
+    uint32_t loggedOverruns_; ///< Control tick overruns already written to the log
+    int32_t flightLogInterval_; ///< Flight data logging interval the state asks for (ms), NO_FLIGHT_LOGGING for none
+    uint32_t lastLoggedTick_; ///< Control tick the flight data was last logged after
     float currentAltitude_; ///< Current altitude
     float currentVelocity_; ///< Current velocity
     float maxAltitude_; ///< Maximum recorded altitude
     float maxVelocity_; ///< Maximum recorded velocity
     float groundAltitude_; ///< Ground altitude
-    const float APOGEE_VELOCITY_THRESHOLD = 0.5; ///< Velocity threshold for apogee detection (m/s)
-    const float LANDING_VEL_THRESHOLD = 1; ///< Velocity threshold for landing detection (m/s)
+    static constexpr float APOGEE_VELOCITY_THRESHOLD = 0.5f; ///< Velocity threshold for apogee detection (m/s)
+    static constexpr float APOGEE_ALTITUDE_DROP = 1.0f; ///< Fall below the maximum altitude that counts as descending (m)
+    static constexpr size_t APOGEE_REQUIRED_SIGNALS = 2; ///< Apogee signals that must agree
+    static constexpr float PREDICTED_APOGEE_CONFIRM_VELOCITY = 5.0f; ///< Velocity at or below which the measured data confirms a predicted apogee (m/s)
+    static constexpr uint64_t DROGUE_ARM_LEAD = 1000000; ///< Time before the predicted apogee the drogue is armed (us)
+    static constexpr float LANDING_VEL_THRESHOLD = 1.0f; ///< Velocity threshold for landing detection (m/s)
+    static constexpr size_t BARO_HISTORY_SIZE = 150; ///< Barometric samples buffered, within MAX_HISTORY_SIZE
+    static constexpr uint32_t DEFAULT_CONTROL_PERIOD = 2000; ///< Control tick period if CONTROL_RATE is unset (us)
+    static constexpr int32_t NO_FLIGHT_LOGGING = -1; ///< flightLogInterval_ when the state logs nothing
+    static constexpr uint32_t DEFAULT_LAUNCH_ACC_DURATION = 50000; ///< Launch acceleration duration if LAUNCH_ACC_DURATION is unset (us)
+    static constexpr uint32_t DEFAULT_APOGEE_TIMER = 100000; ///< Apogee hold time if APOGEE_TIMER is unset (us)
+    static constexpr uint32_t PYRO_HOLD = 2000000; ///< Time a pyro pin is held HIGH (us)
+    static constexpr uint32_t DEFAULT_PYRO_SPACING = 50000; ///< Minimum time between pyro channels firing if PYRO_SPACING is unset (us)
+    static constexpr float FIN_MAX_DEFLECTION = 15.0f; ///< Largest fin deflection the rate controller commands (degrees)
+    static constexpr float FIN_MAX_GAIN_SCALE = 4.0f; ///< Largest fin gain scale, reached at half CONTROL_REFERENCE_VELOCITY and below
+    static constexpr float DEFAULT_CONTROL_REFERENCE_VELOCITY = 100.0f; ///< Fin gain reference velocity if CONTROL_REFERENCE_VELOCITY is unset (m/s)
 
     /**
      * @brief Initialize sensors and add them to sensor fusion.
      */
     void initializeSensors();
 
+    /**
+     * @brief Add the pyro channels to the scheduler, driving their pins LOW.
+     */
+    void initializePyros();
+
+    /**
+     * @brief Set up the deployment events from the config. The events are
+     * only added by the first call.
+     */
+    void configurePyroEvents();
+
     /**
      * @brief Update sensor data by reading from the sensors.
      */
     void updateSensorData();
 
     /**
-     * @brief Handle the state transitions based on sensor data
-     *  and current state.
+     * @brief Arm the pyros at MINIMUM_APOGEE and check the pyro events
+     * against the flight, logging any that trigger.
+     */
+    void updatePyros();
+
+    /**
+     * @brief Set up the fin rate controller from the config.
+     */
+    void configureFinControl();
+
+    /**
+     * @brief Run the fin rate controller in ASCENT and COAST and write the
+     * fin deflections, centering the fins in any other state.
+     */
+    void updateFinControl();
+
+    /**
+     * @brief Write the rate controller deflections to the fins that changed.
+     */
+    void moveFins();
+
+    /**
+     * @brief Center the fins and reset the rate controller.
+     */
+    void centerFins();
+
+    /**
+     * @brief Log control tick overruns since the last call.
+     * 
+     * @return True if there were any to log.
+     */
+    bool logOverruns();
+
+    /**
+     * @brief Log the profiling histograms, if profiling is compiled in.
+     */
+    void logProfile();
+
+    /**
+     * @brief Log which test detected launch and how long after ignition.
+     */
+    void logLaunchDetection();
+
+    /**
+     * @brief Log the apogee altitude and when each contributing signal started to hold.
+     */
+    void logApogeeDetection();
+
+    /**
+     * @brief Feed the fused state to the apogee predictor and detector.
+     */
+    void updateApogeeDetection();
+
+    /**
+     * @brief Arm the drogue once the predicted apogee is within
+     * DROGUE_ARM_LEAD and above MINIMUM_APOGEE.
+     */
+    void armDrogue();
+
+    /**
+     * @brief Keep tracking apogee after the transition until the detector
+     * confirms it, then log the predicted against the actual apogee.
+     */
+    void updateApogeeAccuracy();
+
+    /**
+     * @brief Run the handler of the current state, then take the first
+     * transition out of it whose guard passes.
      */
     void handleStateTransition();
 
     /**
-     * @brief Handle pre-launch state logic.
+     * @brief Enter a new state and record the transition in the trace.
+     * 
+     * @param newState The state to enter.
+     * @param transition Row in TRANSITIONS, EXTERNAL_TRANSITION if none.
+     */
+    void enterState(FlightState newState, uint8_t transition);
+
+    /**
+     * @brief Write the transition trace to the log.
+     */
+    void logTransitionTrace();
+
+    // State handlers, run every tick in their state
+
+    /**
+     * @brief Play the pre-launch tone and feed the launch detector.
      */
     void handlePreLaunch();
 
     /**
-     * @brief Handle ascent state logic.
+     * @brief Feed the apogee predictor and detector during powered ascent.
      */
     void handleAscent();
 
     /**
-     * @brief Handle apogee state logic.
+     * @brief Feed the apogee predictor and detector during the coast, and arm
+     * the drogue ahead of the predicted apogee.
+     */
+    void handleCoast();
+
+    /**
+     * @brief Keep tracking apogee while the drogue fires.
      */
     void handleApogee();
 
     /**
-     * @brief Handle descent under drogue state logic.
+     * @brief Keep tracking apogee until its accuracy has been logged.
      */
     void handleDescentDrogue();
 
     /**
-     * @brief Handle low altitude detection state logic.
+     * @brief Play the landing tone.
      */
-    void handleLowAltitudeDetection();
+    void handleLanding();
+
+    // Transition guards
 
     /**
-     * @brief Handle descent under main state logic.
+     * @brief Guard: launch has been detected.
      */
-    void handleDescentMain();
+    bool isLaunched() const;
 
     /**
-     * @brief Handle landing state logic.
+     * @brief Guard: the debounced detector has confirmed apogee.
      */
-    void handleLanding();
+    bool isApogeeDetected() const;
+
+    /**
+     * @brief Guard: the motor has burnt out and the vehicle is coasting.
+     */
+    bool isBurnout() const;
+
+    /**
+     * @brief Guard: the predicted apogee time has come with the drogue armed,
+     * and the measured velocity confirms it.
+     */
+    bool isApogeePredicted() const;
+
+    /**
+     * @brief Guard: apogee was below MINIMUM_APOGEE.
+     */
+    bool isBelowMinimumApogee() const;
+
+    /**
+     * @brief Guard: the drogue charge has fired and been released.
+     */
+    bool isDrogueFired() const;
+
+    /**
+     * @brief Guard: the main charge has fired and been released.
+     */
+    bool isMainFired() const;
+
+    /**
+     * @brief Guard: the altitude is at or below MAIN_DEPLOYMENT_ALT.
+     */
+    bool isBelowMainAltitude() const;
+
+    /**
+     * @brief Guard: descent under main has slowed to the landing velocity.
+     */
+    bool isLanded() const;
+
+    /**
+     * @brief Guard: after a failure, the vehicle is at rest near the ground.
+     */
+    bool isAtRestOnGround() const;
+
+    // Transition actions
+
+    /**
+     * @brief Log the start of the coast.
+     */
+    void logBurnout();
+
+    /**
+     * @brief Log apogee taken at the predicted instant.
+     */
+    void logPredictedApogee();
+
+    /**
+     * @brief Log the failure to reach the minimum apogee and sound the failure tone.
+     */
+    void handleApogeeFailure();
+
+    /**
+     * @brief Log the drogue deployment.
+     */
+    void logDrogueDeployed();
+
+    /**
+     * @brief Log the main deployment.
+     */
+    void logMainDeployed();
+
+    /**
+     * @brief Log a pyro deployment with its commanded, fire and release times.
+     *
+     * @param name Event name for the log.
+     * @param event The pyro event that fired.
+     */
+    void logDeployment(const char* name, int event);
+
+    /**
+     * @brief Log the pyro events triggered this tick and the channel states.
+     */
+    void logPyroEvents();
 
     /**
-     * @brief Handle stage separation state logic.
+     * @brief Log the name and state of every pyro channel.
      */
-    void handleStageSeparation();
+    void logPyroChannels();
 
     /**
-     * @brief Handle failure state logic.
+     * @brief Log the landing, the scheduler statistics, the profile and the transition trace.
      */
-    void handleFailure();
+    void handleTouchdown();
 };
 
 #endif // FLIGHT_STATE_MACHINE_HPP
@@ -2,6 +2,8 @@
 #ifndef FLIGHTSTATES_HPP
 #define FLIGHTSTATES_HPP
 
+#include <stddef.h>
+
 enum class FlightState {
     PRE_LAUNCH,
     ASCENT,
@@ -10,8 +12,10 @@ enum class FlightState {
     LOW_ALTITUDE_DETECTION,
     DESCENT_MAIN,
     LANDING,
-    STAGE_SEPARATION, // Placeholder for future expansion
+    COAST, // Motor burnout to apogee
     FAILURE // Handle off-nominal conditions
 };
 
+constexpr size_t NUM_FLIGHT_STATES = static_cast<size_t>(FlightState::FAILURE) + 1; ///< Number of flight states
+
 #endif // FLIGHTSTATES_HPP
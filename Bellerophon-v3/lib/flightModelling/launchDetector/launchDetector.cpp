@@ -0,0 +1,89 @@
+#include "launchDetector.hpp"
+
+LaunchDetector::LaunchDetector()
+    : accelerationThreshold_(0), accelerationDuration_(0), velocityThreshold_(0),
+      altitudeThreshold_(0), accelerationEnabled_(false), barometricEnabled_(false),
+      inRun_(false), runStart_(0), trigger_(LaunchTrigger::NONE), detectionTime_(0),
+      ignitionTime_(0), triggerValue_(0) {}
+
+void LaunchDetector::setAccelerationTest(float threshold, uint32_t durationMicros) {
+    accelerationThreshold_ = threshold;
+    accelerationDuration_ = durationMicros;
+    accelerationEnabled_ = true;
+}
+
+void LaunchDetector::setBarometricTest(float velocityThreshold, float altitudeThreshold) {
+    velocityThreshold_ = velocityThreshold;
+    altitudeThreshold_ = altitudeThreshold;
+    barometricEnabled_ = true;
+}
+
+bool LaunchDetector::updateAcceleration(uint64_t timestamp, float acceleration) {
+    if (isLaunched() || !accelerationEnabled_) {
+        return isLaunched();
+    }
+
+    if (!(acceleration > accelerationThreshold_)) {
+        // Any sample at or below the threshold breaks the run
+        inRun_ = false;
+        return false;
+    }
+    if (!inRun_) {
+        inRun_ = true;
+        runStart_ = timestamp;
+    }
+    if (timestamp - runStart_ >= accelerationDuration_) {
+        detect(LaunchTrigger::ACCELERATION, timestamp, acceleration);
+    }
+    return isLaunched();
+}
+
+bool LaunchDetector::updateBarometric(uint64_t now, float velocity, float altitude) {
+    if (isLaunched() || !barometricEnabled_) {
+        return isLaunched();
+    }
+
+    if (velocity > velocityThreshold_) {
+        detect(LaunchTrigger::VELOCITY, now, velocity);
+    } else if (altitude > altitudeThreshold_) {
+        // redundant altitude check
+        detect(LaunchTrigger::ALTITUDE, now, altitude);
+    }
+    return isLaunched();
+}
+
+bool LaunchDetector::isLaunched() const {
+    return trigger_ != LaunchTrigger::NONE;
+}
+
+LaunchTrigger LaunchDetector::getTrigger() const {
+    return trigger_;
+}
+
+uint64_t LaunchDetector::getDetectionTime() const {
+    return detectionTime_;
+}
+
+uint64_t LaunchDetector::getIgnitionTime() const {
+    return ignitionTime_;
+}
+
+float LaunchDetector::getTriggerValue() const {
+    return triggerValue_;
+}
+
+void LaunchDetector::reset() {
+    inRun_ = false;
+    runStart_ = 0;
+    trigger_ = LaunchTrigger::NONE;
+    detectionTime_ = 0;
+    ignitionTime_ = 0;
+    triggerValue_ = 0;
+}
+
+void LaunchDetector::detect(LaunchTrigger trigger, uint64_t now, float value) {
+    trigger_ = trigger;
+    detectionTime_ = now;
+    ignitionTime_ = inRun_ ? runStart_ : 0;
+    triggerValue_ = value;
+}
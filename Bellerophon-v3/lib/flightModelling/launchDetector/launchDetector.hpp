@@ -0,0 +1,136 @@
+#ifndef LAUNCH_DETECTOR_HPP
+#define LAUNCH_DETECTOR_HPP
+
+#include <stdint.h>
+
+/**
+ * @enum LaunchTrigger
+ * @brief The test that detected launch.
+ */
+enum class LaunchTrigger : uint8_t {
+    NONE,         ///< Launch not detected
+    ACCELERATION, ///< Sustained IMU acceleration
+    VELOCITY,     ///< Vertical velocity estimate
+    ALTITUDE      ///< Altitude above the ground
+};
+
+/**
+ * @class LaunchDetector
+ * @brief Detects launch from sustained acceleration, velocity or altitude.
+ *
+ * The acceleration test passes once the IMU vertical acceleration has stayed
+ * above its threshold for a set duration, so a knock on the pad does not
+ * trigger it. It reacts within that duration of ignition, while the velocity
+ * and altitude estimates lag behind the barometric smoothing window. Those
+ * tests are kept as a redundant path in case the IMU has no estimate.
+ *
+ * The start of the acceleration run that is in progress at detection is
+ * taken as the ignition time, which gives the detection latency.
+ */
+class LaunchDetector {
+public:
+    /**
+     * @brief Constructor for LaunchDetector. Every test is disabled until configured.
+     */
+    LaunchDetector();
+
+    /**
+     * @brief Configure the sustained acceleration test.
+     *
+     * @param threshold Vertical acceleration to exceed, gravity removed (m/s^2).
+     * @param durationMicros Time it must be exceeded without a break (us).
+     */
+    void setAccelerationTest(float threshold, uint32_t durationMicros);
+
+    /**
+     * @brief Configure the velocity and altitude tests.
+     *
+     * @param velocityThreshold Vertical velocity to exceed (m/s).
+     * @param altitudeThreshold Altitude above the ground to exceed (m).
+     */
+    void setBarometricTest(float velocityThreshold, float altitudeThreshold);
+
+    /**
+     * @brief Add a vertical acceleration sample.
+     *
+     * @param timestamp Acquisition time of the sample (us).
+     * @param acceleration Vertical acceleration, gravity removed (m/s^2).
+     * @return True if launch has been detected.
+     */
+    bool updateAcceleration(uint64_t timestamp, float acceleration);
+
+    /**
+     * @brief Check the velocity and altitude estimates.
+     *
+     * @param now Current time (us).
+     * @param velocity Vertical velocity (m/s).
+     * @param altitude Altitude above the ground (m).
+     * @return True if launch has been detected.
+     */
+    bool updateBarometric(uint64_t now, float velocity, float altitude);
+
+    /**
+     * @brief Check if launch has been detected.
+     *
+     * @return True once detected.
+     */
+    bool isLaunched() const;
+
+    /**
+     * @brief Get the test that detected launch.
+     *
+     * @return The trigger, NONE if not detected.
+     */
+    LaunchTrigger getTrigger() const;
+
+    /**
+     * @brief Get the time launch was detected.
+     *
+     * @return Detection time (us), 0 if not detected.
+     */
+    uint64_t getDetectionTime() const;
+
+    /**
+     * @brief Get the estimated ignition time.
+     *
+     * @return Start of the acceleration run in progress at detection (us), 0 if unknown.
+     */
+    uint64_t getIgnitionTime() const;
+
+    /**
+     * @brief Get the value that triggered detection.
+     *
+     * @return Acceleration (m/s^2), velocity (m/s) or altitude (m) by trigger.
+     */
+    float getTriggerValue() const;
+
+    /**
+     * @brief Clear detection and any acceleration run in progress.
+     */
+    void reset();
+
+private:
+    float accelerationThreshold_; ///< Vertical acceleration to exceed (m/s^2)
+    uint32_t accelerationDuration_; ///< Time the acceleration must be exceeded (us)
+    float velocityThreshold_; ///< Vertical velocity to exceed (m/s)
+    float altitudeThreshold_; ///< Altitude to exceed (m)
+    bool accelerationEnabled_; ///< True once the acceleration test is configured
+    bool barometricEnabled_; ///< True once the velocity and altitude tests are configured
+    bool inRun_; ///< True while the acceleration is above its threshold
+    uint64_t runStart_; ///< Timestamp of the first sample of the current run (us)
+    LaunchTrigger trigger_; ///< The test that detected launch
+    uint64_t detectionTime_; ///< Time launch was detected (us)
+    uint64_t ignitionTime_; ///< Estimated ignition time (us)
+    float triggerValue_; ///< Value that triggered detection
+
+    /**
+     * @brief Latch detection.
+     *
+     * @param trigger The test that passed.
+     * @param now Detection time (us).
+     * @param value Value that passed the test.
+     */
+    void detect(LaunchTrigger trigger, uint64_t now, float value);
+};
+
+#endif // LAUNCH_DETECTOR_HPP
@@ -0,0 +1,295 @@
+#include "pyroScheduler.hpp"
+#include <stdio.h>
+
+PyroScheduler::PyroScheduler(PyroTimer::PinWriter writer, PyroTimer::Clock clock)
+    : timer_(writer, clock), channelNames_(), events_(), numEvents_(0), spacingMicros_(0), armed_(false),
+      flight_{0, FlightState::PRE_LAUNCH, 0, 0, 0, 0} {}
+
+bool PyroScheduler::start() {
+    return timer_.start();
+}
+
+int PyroScheduler::addChannel(const char* name, uint8_t pin, uint32_t holdMicros) {
+    int channel = timer_.addChannel(pin, holdMicros);
+    if (channel >= 0) {
+        channelNames_[channel] = name;
+    }
+    return channel;
+}
+
+int PyroScheduler::addStateEvent(const char* name, int channel, FlightState state, uint32_t delayMicros) {
+    int event = addEvent(name, channel, PyroTrigger::STATE, delayMicros);
+    if (event >= 0) {
+        events_[event].state = state;
+    }
+    return event;
+}
+
+int PyroScheduler::addAltitudeEvent(const char* name, int channel, float altitude, bool descending,
+                                    uint32_t delayMicros) {
+    PyroTrigger trigger = descending ? PyroTrigger::ALTITUDE_DESCENT : PyroTrigger::ALTITUDE_ASCENT;
+    int event = addEvent(name, channel, trigger, delayMicros);
+    if (event >= 0) {
+        events_[event].altitude = altitude;
+    }
+    return event;
+}
+
+int PyroScheduler::addTimeEvent(const char* name, int channel, bool sinceApogee, uint32_t afterMicros) {
+    PyroTrigger trigger = sinceApogee ? PyroTrigger::TIME_SINCE_APOGEE : PyroTrigger::TIME_SINCE_LAUNCH;
+    return addEvent(name, channel, trigger, afterMicros);
+}
+
+int PyroScheduler::addConditionEvent(const char* name, int channel, PyroCondition condition, uint32_t delayMicros) {
+    if (condition == nullptr) {
+        return -1;
+    }
+    int event = addEvent(name, channel, PyroTrigger::CONDITION, delayMicros);
+    if (event >= 0) {
+        events_[event].condition = condition;
+    }
+    return event;
+}
+
+int PyroScheduler::addBackup(const char* name, int primary, int channel, uint32_t offsetMicros) {
+    // A backup on the primary's own channel would only ever be skipped
+    if (!isValidEvent(primary) || events_[primary].channel == channel) {
+        return -1;
+    }
+    int event = addEvent(name, channel, PyroTrigger::BACKUP, offsetMicros);
+    if (event >= 0) {
+        events_[event].primary = primary;
+    }
+    return event;
+}
+
+int PyroScheduler::addEvent(const char* name, int channel, PyroTrigger trigger, uint32_t delayMicros) {
+    if (!isValidChannel(channel) || numEvents_ >= MAX_EVENTS) {
+        return -1;
+    }
+    Event& event = events_[numEvents_];
+    event = {name, channel, trigger, FlightState::PRE_LAUNCH, 0, nullptr, -1, delayMicros,
+             PyroEventState::WAITING, 0, 0};
+    return static_cast<int>(numEvents_++);
+}
+
+void PyroScheduler::setMinimumSpacing(uint32_t spacingMicros) {
+    spacingMicros_ = spacingMicros;
+}
+
+void PyroScheduler::setArmed(bool armed) {
+    armed_ = armed;
+    if (armed) {
+        return;
+    }
+    // Charges not yet fired are made safe, and their events wait to be re-armed
+    for (size_t i = 0; i < numEvents_; ++i) {
+        Event& event = events_[i];
+        if (event.eventState == PyroEventState::SCHEDULED && timer_.cancel(event.channel)) {
+            event.eventState = PyroEventState::WAITING;
+        }
+    }
+}
+
+bool PyroScheduler::isArmed() const {
+    return armed_;
+}
+
+int PyroScheduler::update(uint64_t time, FlightState state, float altitude, float velocity) {
+    flight_.time = time;
+    flight_.state = state;
+    flight_.altitude = altitude;
+    flight_.velocity = velocity;
+    if (flight_.launchTime == 0 && state != FlightState::PRE_LAUNCH) {
+        flight_.launchTime = time;
+    }
+    if (flight_.apogeeTime == 0 && state == FlightState::APOGEE) {
+        flight_.apogeeTime = time;
+    }
+    if (!armed_) {
+        return 0;
+    }
+
+    int triggered = 0;
+    // Backups come after their primary, so they see it triggered in the same tick
+    for (size_t i = 0; i < numEvents_; ++i) {
+        Event& event = events_[i];
+        uint64_t fireTime = 0;
+        if (event.eventState != PyroEventState::WAITING || !isTriggered(event, fireTime)) {
+            continue;
+        }
+        event.triggerTime = time;
+        event.requestedTime = fireTime;
+        triggered++;
+        if (timer_.getState(event.channel) != PyroChannelState::IDLE) {
+            event.eventState = PyroEventState::SKIPPED;
+            continue;
+        }
+        timer_.schedule(event.channel, applySpacing(event.channel, fireTime));
+        event.eventState = PyroEventState::SCHEDULED;
+    }
+    return triggered;
+}
+
+void PyroScheduler::service(uint64_t now) {
+    timer_.service(now);
+}
+
+bool PyroScheduler::isTriggered(const Event& event, uint64_t& fireTime) const {
+    bool met = false;
+    switch (event.trigger) {
+        case PyroTrigger::STATE:
+            met = flight_.state == event.state;
+            break;
+        case PyroTrigger::ALTITUDE_ASCENT:
+            met = flight_.launchTime != 0 && flight_.apogeeTime == 0 && flight_.altitude >= event.altitude;
+            break;
+        case PyroTrigger::ALTITUDE_DESCENT:
+            met = flight_.apogeeTime != 0 && flight_.altitude <= event.altitude;
+            break;
+        case PyroTrigger::TIME_SINCE_LAUNCH:
+            // Commanded at the exact time as soon as it is known; the timer waits for it
+            if (flight_.launchTime != 0) {
+                fireTime = flight_.launchTime + event.delayMicros;
+                return true;
+            }
+            return false;
+        case PyroTrigger::TIME_SINCE_APOGEE:
+            if (flight_.apogeeTime != 0) {
+                fireTime = flight_.apogeeTime + event.delayMicros;
+                return true;
+            }
+            return false;
+        case PyroTrigger::CONDITION:
+            met = event.condition(flight_);
+            break;
+        case PyroTrigger::BACKUP: {
+            const Event& primary = events_[event.primary];
+            if (primary.eventState != PyroEventState::WAITING) {
+                fireTime = primary.requestedTime + event.delayMicros;
+                return true;
+            }
+            return false;
+        }
+    }
+    if (met) {
+        fireTime = flight_.time + event.delayMicros;
+    }
+    return met;
+}
+
+uint64_t PyroScheduler::applySpacing(int channel, uint64_t fireTime) const {
+    if (spacingMicros_ == 0) {
+        return fireTime;
+    }
+    // Each pass moves past at least one channel, so it settles within a pass per channel
+    for (size_t pass = 0; pass <= timer_.getNumChannels(); ++pass) {
+        bool moved = false;
+        for (size_t c = 0; c < timer_.getNumChannels(); ++c) {
+            int other = static_cast<int>(c);
+            PyroChannelState state = timer_.getState(other);
+            if (other == channel || state == PyroChannelState::IDLE) {
+                continue;
+            }
+            uint64_t otherTime = (state == PyroChannelState::SCHEDULED) ? timer_.getCommandedTime(other)
+                                                                         : timer_.getFireTime(other);
+            if (fireTime < otherTime + spacingMicros_ && fireTime + spacingMicros_ > otherTime) {
+                fireTime = otherTime + spacingMicros_;
+                moved = true;
+            }
+        }
+        if (!moved) {
+            break;
+        }
+    }
+    return fireTime;
+}
+
+const PyroFlightData& PyroScheduler::getFlightData() const {
+    return flight_;
+}
+
+PyroEventState PyroScheduler::getEventState(int event) const {
+    return isValidEvent(event) ? events_[event].eventState : PyroEventState::WAITING;
+}
+
+bool PyroScheduler::isEventComplete(int event) const {
+    return isValidEvent(event) && events_[event].eventState == PyroEventState::SCHEDULED
+           && timer_.getState(events_[event].channel) == PyroChannelState::FIRED;
+}
+
+uint64_t PyroScheduler::getEventTime(int event) const {
+    return isValidEvent(event) ? events_[event].triggerTime : 0;
+}
+
+uint64_t PyroScheduler::getRequestedTime(int event) const {
+    return isValidEvent(event) ? events_[event].requestedTime : 0;
+}
+
+int PyroScheduler::getEventChannel(int event) const {
+    return isValidEvent(event) ? events_[event].channel : -1;
+}
+
+const char* PyroScheduler::getEventName(int event) const {
+    return isValidEvent(event) ? events_[event].name : "";
+}
+
+size_t PyroScheduler::getNumEvents() const {
+    return numEvents_;
+}
+
+const char* PyroScheduler::getChannelName(int channel) const {
+    return isValidChannel(channel) ? channelNames_[channel] : "";
+}
+
+size_t PyroScheduler::getNumChannels() const {
+    return timer_.getNumChannels();
+}
+
+const PyroTimer& PyroScheduler::getTimer() const {
+    return timer_;
+}
+
+uint32_t PyroScheduler::getChannelStates() const {
+    uint32_t states = 0;
+    for (size_t c = 0; c < timer_.getNumChannels(); ++c) {
+        states |= static_cast<uint32_t>(timer_.getState(static_cast<int>(c))) << (c * CHANNEL_STATE_BITS);
+    }
+    return states;
+}
+
+int PyroScheduler::formatChannels(char* buffer, size_t size) const {
+    if (size == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+    size_t offset = 0;
+    for (size_t c = 0; c < timer_.getNumChannels() && offset < size; ++c) {
+        int channel = static_cast<int>(c);
+        offset += snprintf(buffer + offset, size - offset, "%s%s=%s", (c == 0) ? "" : " ",
+                           channelNames_[c], getStateName(timer_.getState(channel)));
+    }
+    return static_cast<int>(offset < size ? offset : size - 1);
+}
+
+const char* PyroScheduler::getStateName(PyroChannelState state) {
+    switch (state) {
+        case PyroChannelState::IDLE:
+            return "IDLE";
+        case PyroChannelState::SCHEDULED:
+            return "SCHEDULED";
+        case PyroChannelState::FIRING:
+            return "FIRING";
+        case PyroChannelState::FIRED:
+            return "FIRED";
+    }
+    return "UNKNOWN";
+}
+
+bool PyroScheduler::isValidChannel(int channel) const {
+    return channel >= 0 && static_cast<size_t>(channel) < timer_.getNumChannels();
+}
+
+bool PyroScheduler::isValidEvent(int event) const {
+    return event >= 0 && static_cast<size_t>(event) < numEvents_;
+}
@@ -0,0 +1,371 @@
+#ifndef PYRO_SCHEDULER_HPP
+#define PYRO_SCHEDULER_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include "flightStates.hpp"
+#include "pyroTimer.hpp"
+
+/**
+ * @struct PyroFlightData
+ * @brief The flight as the pyro events see it at a control tick.
+ */
+struct PyroFlightData {
+    uint64_t time; ///< Control tick time (us)
+    FlightState state; ///< Current flight state
+    float altitude; ///< Altitude above the ground (m)
+    float velocity; ///< Vertical velocity (m/s)
+    uint64_t launchTime; ///< Tick the state first left PRE_LAUNCH (us), 0 before launch
+    uint64_t apogeeTime; ///< Tick the state first became APOGEE (us), 0 before apogee
+};
+
+/**
+ * @brief Condition for a pyro event, evaluated every control tick until it passes.
+ */
+typedef bool (*PyroCondition)(const PyroFlightData& flight);
+
+/**
+ * @enum PyroTrigger
+ * @brief What a pyro event waits for.
+ */
+enum class PyroTrigger : uint8_t {
+    STATE,             ///< Entering a flight state
+    ALTITUDE_ASCENT,   ///< Climbing through an altitude before apogee
+    ALTITUDE_DESCENT,  ///< Descending through an altitude after apogee
+    TIME_SINCE_LAUNCH, ///< A time after launch
+    TIME_SINCE_APOGEE, ///< A time after apogee
+    CONDITION,         ///< A PyroCondition passing
+    BACKUP             ///< Another event, as a redundant charge
+};
+
+/**
+ * @enum PyroEventState
+ * @brief Where a pyro event is.
+ */
+enum class PyroEventState : uint8_t {
+    WAITING,   ///< Trigger not met yet
+    SCHEDULED, ///< Trigger met and the channel commanded
+    SKIPPED    ///< Trigger met but the channel had already been used
+};
+
+/**
+ * @class PyroScheduler
+ * @brief Owns the pyro channels and fires them from configured events.
+ *
+ * Each event names a channel and what it waits for: a flight state, an
+ * altitude on ascent or descent, a time since launch or apogee, or a
+ * condition. Once the scheduler is armed and an event's trigger is met, the
+ * channel is commanded on the PyroTimer, so the charge fires on time
+ * between control ticks. Time events are commanded at their exact time as
+ * soon as launch or apogee is known; the others fire their delay after the
+ * tick the trigger was met.
+ *
+ * A backup event fires another channel an offset after its primary, as a
+ * redundant charge. No two channels are commanded closer together than the
+ * minimum spacing, so the ignition currents do not add up. Each channel
+ * fires once; a later event on a used channel is skipped.
+ */
+class PyroScheduler {
+public:
+    static constexpr size_t MAX_EVENTS = 8; ///< Events a scheduler can hold
+    static constexpr size_t CHANNEL_STATE_BITS = 2; ///< Bits per channel in getChannelStates()
+    static_assert(CHANNEL_STATE_BITS * PyroTimer::MAX_CHANNELS <= 24,
+                  "Channel states must stay exact when logged as a float");
+
+    /**
+     * @brief Constructor for PyroScheduler. The scheduler starts disarmed.
+     *
+     * @param writer Pin writer for the timer, nullptr for the platform's.
+     * @param clock Clock for the timer, nullptr for the platform's.
+     */
+    explicit PyroScheduler(PyroTimer::PinWriter writer = nullptr, PyroTimer::Clock clock = nullptr);
+
+    /**
+     * @brief Start the pyro timer.
+     *
+     * @return True if started.
+     */
+    bool start();
+
+    /**
+     * @brief Add a channel.
+     *
+     * @param name Name for logs.
+     * @param pin The pin connected to the pyro charge.
+     * @param holdMicros Time the pin is held HIGH (us).
+     * @return Channel id, -1 if there are no channels left.
+     */
+    int addChannel(const char* name, uint8_t pin, uint32_t holdMicros);
+
+    /**
+     * @brief Add an event fired on entering a flight state.
+     *
+     * @param name Name for logs.
+     * @param channel Channel to fire.
+     * @param state State that triggers it.
+     * @param delayMicros Delay from the trigger to firing (us).
+     * @return Event id, -1 if the channel is invalid or there are no events left.
+     */
+    int addStateEvent(const char* name, int channel, FlightState state, uint32_t delayMicros);
+
+    /**
+     * @brief Add an event fired passing an altitude.
+     *
+     * @param name Name for logs.
+     * @param channel Channel to fire.
+     * @param altitude Altitude above the ground (m).
+     * @param descending True to fire descending through it after apogee, false climbing through it before.
+     * @param delayMicros Delay from the trigger to firing (us).
+     * @return Event id, -1 if the channel is invalid or there are no events left.
+     */
+    int addAltitudeEvent(const char* name, int channel, float altitude, bool descending, uint32_t delayMicros);
+
+    /**
+     * @brief Add an event fired a time after launch or apogee.
+     *
+     * @param name Name for logs.
+     * @param channel Channel to fire.
+     * @param sinceApogee True to time from apogee, false from launch.
+     * @param afterMicros Time after launch or apogee (us).
+     * @return Event id, -1 if the channel is invalid or there are no events left.
+     */
+    int addTimeEvent(const char* name, int channel, bool sinceApogee, uint32_t afterMicros);
+
+    /**
+     * @brief Add an event fired when a condition passes.
+     *
+     * @param name Name for logs.
+     * @param channel Channel to fire.
+     * @param condition Condition evaluated every tick until it passes.
+     * @param delayMicros Delay from the trigger to firing (us).
+     * @return Event id, -1 if the channel or condition is invalid or there are no events left.
+     */
+    int addConditionEvent(const char* name, int channel, PyroCondition condition, uint32_t delayMicros);
+
+    /**
+     * @brief Add a redundant charge fired an offset after another event.
+     *
+     * @param name Name for logs.
+     * @param primary Event it backs up, added before it.
+     * @param channel Channel to fire, other than the primary's.
+     * @param offsetMicros Time after the primary's fire time (us).
+     * @return Event id, -1 if the primary or channel is invalid or there are no events left.
+     */
+    int addBackup(const char* name, int primary, int channel, uint32_t offsetMicros);
+
+    /**
+     * @brief Set the minimum time between two channels firing.
+     *
+     * @param spacingMicros Minimum spacing (us).
+     */
+    void setMinimumSpacing(uint32_t spacingMicros);
+
+    /**
+     * @brief Arm or disarm the scheduler. Disarming cancels any channel not yet fired.
+     *
+     * @param armed True to arm.
+     */
+    void setArmed(bool armed);
+
+    /**
+     * @brief Check if the scheduler is armed.
+     *
+     * @return True if armed.
+     */
+    bool isArmed() const;
+
+    /**
+     * @brief Check the events against the flight at a control tick.
+     *
+     * @param time Control tick time (us).
+     * @param state Current flight state.
+     * @param altitude Altitude above the ground (m).
+     * @param velocity Vertical velocity (m/s).
+     * @return Number of events whose trigger was met this tick.
+     */
+    int update(uint64_t time, FlightState state, float altitude, float velocity);
+
+    /**
+     * @brief Make every pyro edge that is due. The timer does this once started.
+     *
+     * @param now Current time (us).
+     */
+    void service(uint64_t now);
+
+    /**
+     * @brief Get the flight as last passed to update().
+     *
+     * @return The flight data.
+     */
+    const PyroFlightData& getFlightData() const;
+
+    /**
+     * @brief Get the state of an event.
+     *
+     * @param event Event id.
+     * @return The state, WAITING for an invalid event.
+     */
+    PyroEventState getEventState(int event) const;
+
+    /**
+     * @brief Check if an event's channel has fired and been released.
+     *
+     * @param event Event id.
+     * @return True once the charge of the event has completed.
+     */
+    bool isEventComplete(int event) const;
+
+    /**
+     * @brief Get the tick an event's trigger was met in.
+     *
+     * @param event Event id.
+     * @return Trigger time (us), 0 while waiting.
+     */
+    uint64_t getEventTime(int event) const;
+
+    /**
+     * @brief Get the time an event asked its channel to fire, before spacing.
+     *
+     * @param event Event id.
+     * @return Requested fire time (us), 0 while waiting.
+     */
+    uint64_t getRequestedTime(int event) const;
+
+    /**
+     * @brief Get the channel of an event.
+     *
+     * @param event Event id.
+     * @return Channel id, -1 for an invalid event.
+     */
+    int getEventChannel(int event) const;
+
+    /**
+     * @brief Get the name of an event.
+     *
+     * @param event Event id.
+     * @return The name, "" for an invalid event.
+     */
+    const char* getEventName(int event) const;
+
+    /**
+     * @brief Get the number of events.
+     *
+     * @return Number of events.
+     */
+    size_t getNumEvents() const;
+
+    /**
+     * @brief Get the name of a channel.
+     *
+     * @param channel Channel id.
+     * @return The name, "" for an invalid channel.
+     */
+    const char* getChannelName(int channel) const;
+
+    /**
+     * @brief Get the number of channels.
+     *
+     * @return Number of channels.
+     */
+    size_t getNumChannels() const;
+
+    /**
+     * @brief Get the timer, for the state and times of each channel.
+     *
+     * @return The pyro timer.
+     */
+    const PyroTimer& getTimer() const;
+
+    /**
+     * @brief Get the state of every channel as one telemetry value.
+     *
+     * A bitfield with CHANNEL_STATE_BITS per channel, the first channel in the
+     * lowest bits, each holding its PyroChannelState (0 idle, 1 scheduled,
+     * 2 firing, 3 fired). Every channel fits within the 24 bits a logged float
+     * holds exactly.
+     *
+     * @return The packed channel states.
+     */
+    uint32_t getChannelStates() const;
+
+    /**
+     * @brief Write the name and state of every channel, e.g. "drogue=FIRED main=IDLE".
+     *
+     * @param buffer Buffer to write to.
+     * @param size Size of the buffer.
+     * @return Characters written, excluding the terminator.
+     */
+    int formatChannels(char* buffer, size_t size) const;
+
+    /**
+     * @brief Get the name of a channel state.
+     *
+     * @param state The channel state.
+     * @return The name.
+     */
+    static const char* getStateName(PyroChannelState state);
+
+private:
+    /**
+     * @struct Event
+     * @brief A charge and what fires it.
+     */
+    struct Event {
+        const char* name; ///< Name for logs
+        int channel; ///< Channel to fire
+        PyroTrigger trigger; ///< What the event waits for
+        FlightState state; ///< State for STATE
+        float altitude; ///< Altitude for ALTITUDE_ASCENT and ALTITUDE_DESCENT (m)
+        PyroCondition condition; ///< Condition for CONDITION
+        int primary; ///< Event backed up, for BACKUP
+        uint32_t delayMicros; ///< Delay, time after launch or apogee, or backup offset (us)
+        PyroEventState eventState; ///< Where the event is
+        uint64_t triggerTime; ///< Tick the trigger was met in (us)
+        uint64_t requestedTime; ///< Fire time asked for, before spacing (us)
+    };
+
+    PyroTimer timer_; ///< Makes the pin edges
+    const char* channelNames_[PyroTimer::MAX_CHANNELS]; ///< Name of each channel
+    Event events_[MAX_EVENTS]; ///< The events, in the order added
+    size_t numEvents_; ///< Number of events
+    uint32_t spacingMicros_; ///< Minimum time between two channels firing (us)
+    bool armed_; ///< True once armed
+    PyroFlightData flight_; ///< Flight as last passed to update()
+
+    /**
+     * @brief Add an event.
+     *
+     * @return Event id, -1 if the channel is invalid or there are no events left.
+     */
+    int addEvent(const char* name, int channel, PyroTrigger trigger, uint32_t delayMicros);
+
+    /**
+     * @brief Check whether an event's trigger is met and, if so, when it should fire.
+     *
+     * @param event The event.
+     * @param fireTime Set to the fire time when met (us).
+     * @return True if the trigger is met.
+     */
+    bool isTriggered(const Event& event, uint64_t& fireTime) const;
+
+    /**
+     * @brief Move a fire time clear of every other channel's by the minimum spacing.
+     *
+     * @param channel Channel to fire.
+     * @param fireTime Requested fire time (us).
+     * @return Spaced fire time (us).
+     */
+    uint64_t applySpacing(int channel, uint64_t fireTime) const;
+
+    /**
+     * @brief Check if a channel id is valid.
+     */
+    bool isValidChannel(int channel) const;
+
+    /**
+     * @brief Check if an event id is valid.
+     */
+    bool isValidEvent(int event) const;
+};
+
+#endif // PYRO_SCHEDULER_HPP
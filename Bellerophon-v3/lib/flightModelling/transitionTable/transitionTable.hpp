@@ -0,0 +1,168 @@
+#ifndef TRANSITION_TABLE_HPP
+#define TRANSITION_TABLE_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @struct Transition
+ * @brief One row of a state transition table.
+ *
+ * The guard is a const member function, so evaluating it cannot change the
+ * owner; the action runs once the transition is taken.
+ *
+ * @tparam State Enum class of the states, numbered from 0.
+ * @tparam Owner Class the guards and actions are members of.
+ */
+template <typename State, typename Owner>
+struct Transition {
+    State from; ///< State the transition leaves
+    bool (Owner::*guard)() const; ///< Condition for the transition
+    void (Owner::*action)(); ///< Run after the transition, nullptr for none
+    State to; ///< State the transition enters
+    const char* name; ///< Name for logs
+};
+
+/**
+ * @struct TransitionIndex
+ * @brief Where the transitions of each state start in a table grouped by state.
+ *
+ * The transitions of state s are rows first[s] to first[s + 1] - 1, so
+ * finding them is a lookup rather than a search of the table.
+ *
+ * @tparam NumStates Number of states.
+ */
+template <size_t NumStates>
+struct TransitionIndex {
+    uint8_t first[NumStates + 1]; ///< First row of each state, then the table length
+};
+
+/**
+ * Compile-time checks of a transition table, for use in static_assert.
+ */
+namespace TransitionTable {
+
+    /**
+     * @brief Check a per-state table has one row per state, in state order,
+     * so it can be indexed by state.
+     *
+     * @tparam Row Row type with a `state` member.
+     */
+    template <typename Row>
+    constexpr bool isIndexedByState(const Row* table, size_t size, size_t numStates) {
+        if (size != numStates) {
+            return false;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            if (static_cast<size_t>(table[i].state) != i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Check every row names valid states.
+     */
+    template <typename State, typename Owner>
+    constexpr bool statesInRange(const Transition<State, Owner>* table, size_t size, size_t numStates) {
+        for (size_t i = 0; i < size; ++i) {
+            if (static_cast<size_t>(table[i].from) >= numStates || static_cast<size_t>(table[i].to) >= numStates) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Check the rows of each state are together and in state order,
+     * which the index relies on.
+     */
+    template <typename State, typename Owner>
+    constexpr bool isGroupedByState(const Transition<State, Owner>* table, size_t size) {
+        for (size_t i = 1; i < size; ++i) {
+            if (static_cast<size_t>(table[i].from) < static_cast<size_t>(table[i - 1].from)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Check every row has a guard and leaves its state.
+     */
+    template <typename State, typename Owner>
+    constexpr bool isWellFormed(const Transition<State, Owner>* table, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            if (table[i].guard == nullptr || table[i].from == table[i].to) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Check every state can be reached from the initial state.
+     */
+    template <typename State, typename Owner>
+    constexpr bool allReachable(const Transition<State, Owner>* table, size_t size, size_t numStates, State initial) {
+        bool reached[64] = {};
+        if (numStates > 64) {
+            return false;
+        }
+        reached[static_cast<size_t>(initial)] = true;
+        // Each pass reaches at least one more state, or nothing changes
+        for (size_t pass = 0; pass < numStates; ++pass) {
+            for (size_t i = 0; i < size; ++i) {
+                if (reached[static_cast<size_t>(table[i].from)]) {
+                    reached[static_cast<size_t>(table[i].to)] = true;
+                }
+            }
+        }
+        for (size_t s = 0; s < numStates; ++s) {
+            if (!reached[s]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Build the index of a table grouped by state.
+     */
+    template <size_t NumStates, typename State, typename Owner>
+    constexpr TransitionIndex<NumStates> makeIndex(const Transition<State, Owner>* table, size_t size) {
+        TransitionIndex<NumStates> index = {};
+        size_t row = 0;
+        for (size_t s = 0; s <= NumStates; ++s) {
+            while (row < size && static_cast<size_t>(table[row].from) < s) {
+                ++row;
+            }
+            index.first[s] = static_cast<uint8_t>(row);
+        }
+        return index;
+    }
+
+    /**
+     * @brief Find the first transition out of a state whose guard passes.
+     *
+     * @param owner Object the guards are evaluated on.
+     * @param table The transition table.
+     * @param index Index of the table.
+     * @param state Current state.
+     * @return Row of the transition, -1 if no guard passes.
+     */
+    template <size_t NumStates, typename State, typename Owner>
+    int findTransition(const Owner& owner, const Transition<State, Owner>* table,
+                       const TransitionIndex<NumStates>& index, State state) {
+        size_t s = static_cast<size_t>(state);
+        for (size_t i = index.first[s]; i < index.first[s + 1]; ++i) {
+            if ((owner.*table[i].guard)()) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+}
+
+#endif // TRANSITION_TABLE_HPP
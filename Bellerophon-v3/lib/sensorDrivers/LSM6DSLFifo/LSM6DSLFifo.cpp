@@ -0,0 +1,260 @@
+#include "LSM6DSLFifo.hpp"
+
+namespace {
+    // Output data rate of each rate code, from the datasheet (Hz)
+    constexpr float DATA_RATES[] = {0, 12.5f, 26, 52, 104, 208, 416, 833, 1666, 3332, 6664};
+
+    /**
+     * @brief A full scale setting, its control register bits and its scale.
+     */
+    struct FullScale {
+        uint16_t range;
+        uint8_t bits;
+        float scale;
+    };
+
+    // Accelerometer full scales, FS_XL in CTRL1_XL bits 3:2 (g, g per LSB)
+    constexpr FullScale ACCEL_SCALES[] = {
+        {2, 0x00, 0.061e-3f}, {4, 0x08, 0.122e-3f}, {8, 0x0C, 0.244e-3f}, {16, 0x04, 0.488e-3f}};
+
+    // Gyroscope full scales, FS_125 in CTRL2_G bit 1 and FS_G in bits 3:2 (deg/s, deg/s per LSB)
+    constexpr FullScale GYRO_SCALES[] = {
+        {125, 0x02, 4.375e-3f}, {250, 0x00, 8.75e-3f}, {500, 0x04, 17.5e-3f},
+        {1000, 0x08, 35e-3f}, {2000, 0x0C, 70e-3f}};
+
+    constexpr size_t BYTES_PER_WORD = 2;
+    constexpr size_t BYTES_PER_SAMPLE = LSM6DSLFifo::WORDS_PER_SAMPLE * BYTES_PER_WORD;
+    constexpr int64_t PHASE_GAIN_SHIFT = 3; // Phase error corrected by 1/8 per drain
+    constexpr float FREQUENCY_GAIN = 1.0f / 256; // Fraction of the phase error per sample fed into the period
+    constexpr float MAX_CLOCK_ERROR = 0.05f; // Largest accepted deviation from the nominal period
+
+    /**
+     * @brief Find the smallest full scale covering a range, or the largest.
+     */
+    template <size_t N>
+    const FullScale& selectScale(const FullScale (&scales)[N], uint16_t range) {
+        for (size_t i = 0; i < N; ++i) {
+            if (scales[i].range >= range) {
+                return scales[i];
+            }
+        }
+        return scales[N - 1];
+    }
+}
+
+LSM6DSLFifo::LSM6DSLFifo(RegisterBus& bus, uint8_t address)
+    : bus_(bus), address_(address), requested_(false), configured_(false), dataRateCode_(0), accelControl_(0),
+      gyroControl_(0), accelScale_(0), gyroScale_(0), dataRate_(0), nominalPeriod_(0), period_(0), anchored_(false),
+      anchorTime_(0), sampleIndex_(0), samples_{}, numSamples_(0), errorCount_(0), overrunCount_(0) {}
+
+void LSM6DSLFifo::configure(uint8_t dataRateCode, uint8_t accelRange, uint16_t gyroRange) {
+    const FullScale& accel = selectScale(ACCEL_SCALES, accelRange);
+    const FullScale& gyro = selectScale(GYRO_SCALES, gyroRange);
+    accelControl_ = accel.bits;
+    accelScale_ = accel.scale;
+    gyroControl_ = gyro.bits;
+    gyroScale_ = gyro.scale;
+
+    configured_ = false;
+    requested_ = true;
+    setDataRate(dataRateCode);
+}
+
+bool LSM6DSLFifo::begin(uint8_t dataRateCode, uint8_t accelRange, uint16_t gyroRange) {
+    configure(dataRateCode, accelRange, gyroRange);
+    return setup();
+}
+
+bool LSM6DSLFifo::setup() {
+    uint8_t id = 0;
+    if (!bus_.readRegisters(address_, WHO_AM_I, &id, 1) || id != WHO_AM_I_VALUE) {
+        errorCount_++;
+        return false;
+    }
+
+    if (!bus_.writeRegister(address_, CTRL3_C, CTRL3_C_BDU | CTRL3_C_IF_INC) ||
+        !bus_.writeRegister(address_, FIFO_CTRL3, FIFO_CTRL3_NO_DECIMATION)) {
+        errorCount_++;
+        return false;
+    }
+    configured_ = writeDataRate();
+    return configured_;
+}
+
+bool LSM6DSLFifo::setDataRate(uint8_t dataRateCode) {
+    if (dataRateCode < 1) {
+        dataRateCode = 1;
+    }
+    if (dataRateCode > MAX_DATA_RATE_CODE) {
+        dataRateCode = MAX_DATA_RATE_CODE;
+    }
+    dataRateCode_ = dataRateCode;
+    dataRate_ = DATA_RATES[dataRateCode];
+    nominalPeriod_ = 1e6f / dataRate_;
+
+    // Applied by setup() once the part is found
+    return configured_ ? writeDataRate() : true;
+}
+
+bool LSM6DSLFifo::writeDataRate() {
+    // Bypass mode clears the FIFO before continuous mode restarts it at the new rate
+    if (!bus_.writeRegister(address_, CTRL1_XL, (dataRateCode_ << 4) | accelControl_) ||
+        !bus_.writeRegister(address_, CTRL2_G, (dataRateCode_ << 4) | gyroControl_) ||
+        !bus_.writeRegister(address_, FIFO_CTRL5, FIFO_MODE_BYPASS) ||
+        !bus_.writeRegister(address_, FIFO_CTRL5, (dataRateCode_ << 3) | FIFO_MODE_CONTINUOUS)) {
+        errorCount_++;
+        return false;
+    }
+
+    period_ = nominalPeriod_;
+    anchored_ = false;
+    return true;
+}
+
+bool LSM6DSLFifo::isConfigured() const {
+    return configured_;
+}
+
+size_t LSM6DSLFifo::drain(uint64_t now) {
+    numSamples_ = 0;
+    if (!configured_) {
+        // Retry until the part is found, the FIFO starts empty once it is set up
+        if (requested_) {
+            setup();
+        }
+        return 0;
+    }
+
+    // FIFO_STATUS1 to FIFO_STATUS4: unread words, overrun flag and pattern
+    uint8_t status[4];
+    if (!bus_.readRegisters(address_, FIFO_STATUS1, status, sizeof(status))) {
+        errorCount_++;
+        return 0;
+    }
+    size_t words = status[0] | (static_cast<size_t>(status[1] & 0x07) << 8);
+    uint16_t pattern = status[2] | (static_cast<uint16_t>(status[3] & 0x03) << 8);
+
+    if (status[1] & FIFO_STATUS2_OVER_RUN) {
+        // Samples were lost, the index no longer matches time
+        overrunCount_++;
+        anchored_ = false;
+    }
+
+    if (pattern != 0) {
+        size_t skipped = WORDS_PER_SAMPLE - pattern;
+        if (words < skipped || !align(pattern)) {
+            return 0;
+        }
+        words -= skipped;
+        anchored_ = false;
+    }
+
+    size_t available = words / WORDS_PER_SAMPLE;
+    if (available == 0) {
+        return 0;
+    }
+    if (anchored_) {
+        trackPhase(now, available);
+    } else {
+        anchor(now, available);
+    }
+
+    size_t count = (available < MAX_SAMPLES_PER_DRAIN) ? available : MAX_SAMPLES_PER_DRAIN;
+    uint8_t data[SAMPLES_PER_BURST * BYTES_PER_SAMPLE];
+    while (numSamples_ < count) {
+        size_t burst = count - numSamples_;
+        if (burst > SAMPLES_PER_BURST) {
+            burst = SAMPLES_PER_BURST;
+        }
+        if (!bus_.readRegisters(address_, FIFO_DATA_OUT_L, data, burst * BYTES_PER_SAMPLE)) {
+            // The FIFO may now be misaligned, the pattern resynchronises it next drain
+            errorCount_++;
+            anchored_ = false;
+            break;
+        }
+
+        for (size_t s = 0; s < burst; ++s) {
+            const uint8_t* bytes = data + s * BYTES_PER_SAMPLE;
+            LSM6DSLSample& sample = samples_[numSamples_++];
+            for (size_t axis = 0; axis < 3; ++axis) {
+                sample.gyro[axis] = static_cast<int16_t>(bytes[2 * axis] | bytes[2 * axis + 1] << 8);
+                sample.accel[axis] = static_cast<int16_t>(bytes[2 * axis + 6] | bytes[2 * axis + 7] << 8);
+            }
+            sample.timestamp = timestampOf(sampleIndex_++);
+        }
+    }
+    return numSamples_;
+}
+
+bool LSM6DSLFifo::align(uint16_t pattern) {
+    uint8_t discard[BYTES_PER_WORD];
+    for (size_t word = pattern; word < WORDS_PER_SAMPLE; ++word) {
+        if (!bus_.readRegisters(address_, FIFO_DATA_OUT_L, discard, BYTES_PER_WORD)) {
+            errorCount_++;
+            return false;
+        }
+    }
+    return true;
+}
+
+void LSM6DSLFifo::anchor(uint64_t now, size_t available) {
+    // The newest sample in the FIFO arrived just before now
+    uint64_t offset = static_cast<uint64_t>((available - 1) * static_cast<double>(period_));
+    anchorTime_ = (now > offset) ? now - offset : 0;
+    sampleIndex_ = 0;
+    anchored_ = true;
+}
+
+void LSM6DSLFifo::trackPhase(uint64_t now, size_t available) {
+    // Move the anchor to the next sample so a period change does not shift earlier samples
+    anchorTime_ = timestampOf(sampleIndex_);
+    sampleIndex_ = 0;
+
+    // Expected between 0 and one period after the newest sample, half a period on average
+    int64_t error = static_cast<int64_t>(now - timestampOf(available - 1));
+    int64_t period = static_cast<int64_t>(period_);
+    if (error < -period || error > 2 * period) {
+        anchor(now, available); // Too far off to track, start again
+        return;
+    }
+
+    // Correct the phase, and the period to follow the part's clock
+    int64_t phaseError = error - period / 2;
+    anchorTime_ += phaseError / (1 << PHASE_GAIN_SHIFT);
+    period_ += FREQUENCY_GAIN * static_cast<float>(phaseError) / static_cast<float>(available);
+    float minPeriod = nominalPeriod_ * (1.0f - MAX_CLOCK_ERROR);
+    float maxPeriod = nominalPeriod_ * (1.0f + MAX_CLOCK_ERROR);
+    period_ = (period_ < minPeriod) ? minPeriod : (period_ > maxPeriod) ? maxPeriod : period_;
+}
+
+uint64_t LSM6DSLFifo::timestampOf(uint32_t index) const {
+    return anchorTime_ + static_cast<uint64_t>(index * static_cast<double>(period_));
+}
+
+size_t LSM6DSLFifo::getNumSamples() const {
+    return numSamples_;
+}
+
+const LSM6DSLSample& LSM6DSLFifo::getSample(size_t index) const {
+    return samples_[index];
+}
+
+float LSM6DSLFifo::getDataRate() const {
+    return dataRate_;
+}
+
+float LSM6DSLFifo::getAccelScale() const {
+    return accelScale_;
+}
+
+float LSM6DSLFifo::getGyroScale() const {
+    return gyroScale_;
+}
+
+uint32_t LSM6DSLFifo::getErrorCount() const {
+    return errorCount_;
+}
+
+uint32_t LSM6DSLFifo::getOverrunCount() const {
+    return overrunCount_;
+}
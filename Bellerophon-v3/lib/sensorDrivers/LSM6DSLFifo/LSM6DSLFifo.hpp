@@ -0,0 +1,243 @@
+#ifndef LSM6DSL_FIFO_HPP
+#define LSM6DSL_FIFO_HPP
+
+#include <cstddef>
+#include <stdint.h>
+#include "registerBus.hpp"
+
+/**
+ * @struct LSM6DSLSample
+ * @brief One gyroscope and accelerometer sample read from the FIFO.
+ */
+struct LSM6DSLSample {
+    int16_t gyro[3];    ///< Raw angular rate (LSB)
+    int16_t accel[3];   ///< Raw specific force (LSB)
+    uint64_t timestamp; ///< Acquisition time derived from the sample index (us)
+};
+
+/**
+ * @class LSM6DSLFifo
+ * @brief LSM6DSL driver that buffers samples in the part's FIFO.
+ *
+ * The gyroscope and accelerometer run at the same output data rate and
+ * the FIFO stores every sample in continuous mode. drain() reads
+ * the FIFO status once and then reads whole samples in bursts from
+ * FIFO_DATA_OUT. Burst reads past FIFO_DATA_OUT_H roll back to
+ * FIFO_DATA_OUT_L. No sample is lost between loop passes as long as the
+ * FIFO is drained before it fills.
+ *
+ * Timestamps come from the sample index and the sample period, so they
+ * are free of loop jitter. The newest sample in the FIFO should have arrived
+ * within one period of the drain. The phase and period are nudged towards
+ * that, which follows the part's clock tolerance of a few percent. The phase is re-anchored to
+ * the drain time at startup and after an overrun or a misaligned FIFO.
+ *
+ * configure() only records the settings, so it is safe before the bus is
+ * started. Until the part has been found and set up, every drain() retries
+ * the setup and returns no samples.
+ */
+class LSM6DSLFifo {
+public:
+    static constexpr uint8_t DEFAULT_ADDRESS = 0x6A;  ///< 7-bit I2C address with SA0 low
+    static constexpr uint8_t WHO_AM_I_VALUE = 0x6A;   ///< Device identifier
+    static constexpr size_t WORDS_PER_SAMPLE = 6;     ///< Gyroscope then accelerometer, x y z
+    static constexpr size_t MAX_SAMPLES_PER_DRAIN = 32; ///< Samples read by one drain()
+    static constexpr size_t SAMPLES_PER_BURST = 2;    ///< Samples per transaction, within the Wire buffer
+
+    /**
+     * @enum Register
+     * @brief Registers used by the driver.
+     */
+    enum Register : uint8_t {
+        FIFO_CTRL3 = 0x08,      ///< FIFO decimation of each sensor
+        FIFO_CTRL5 = 0x0A,      ///< FIFO data rate and mode
+        WHO_AM_I = 0x0F,        ///< Device identifier
+        CTRL1_XL = 0x10,        ///< Accelerometer data rate and full scale
+        CTRL2_G = 0x11,         ///< Gyroscope data rate and full scale
+        CTRL3_C = 0x12,         ///< Block data update and address increment
+        FIFO_STATUS1 = 0x3A,    ///< First of 4 FIFO level and pattern registers
+        FIFO_DATA_OUT_L = 0x3E  ///< FIFO output, low byte first
+    };
+
+    static constexpr uint8_t CTRL3_C_BDU = 1 << 6;        ///< Block data update
+    static constexpr uint8_t CTRL3_C_IF_INC = 1 << 2;     ///< Auto increment the register address
+    static constexpr uint8_t FIFO_CTRL3_NO_DECIMATION = 0x09; ///< Gyroscope and accelerometer in every set
+    static constexpr uint8_t FIFO_MODE_BYPASS = 0x00;     ///< FIFO disabled and cleared
+    static constexpr uint8_t FIFO_MODE_CONTINUOUS = 0x06; ///< Oldest samples overwritten when full
+    static constexpr uint8_t FIFO_STATUS2_OVER_RUN = 1 << 6; ///< Samples were overwritten
+    static constexpr uint8_t MAX_DATA_RATE_CODE = 10;     ///< 6664 Hz
+
+    /**
+     * @brief Constructor for LSM6DSLFifo.
+     * 
+     * @param bus The bus the part is on.
+     * @param address 7-bit I2C address.
+     */
+    explicit LSM6DSLFifo(RegisterBus& bus, uint8_t address = DEFAULT_ADDRESS);
+
+    /**
+     * @brief Record the sensor and FIFO settings without touching the bus.
+     * The part is set up by the next drain().
+     * 
+     * @param dataRateCode Output data rate code from 1 (12.5 Hz) to 10 (6664 Hz).
+     * @param accelRange Accelerometer full scale (g), rounded up to 2, 4, 8 or 16.
+     * @param gyroRange Gyroscope full scale (deg/s), rounded up to 125, 250, 500, 1000 or 2000.
+     */
+    void configure(uint8_t dataRateCode, uint8_t accelRange, uint16_t gyroRange);
+
+    /**
+     * @brief Record the settings, then check the device and configure the sensors and FIFO.
+     * If the device is not found, drain() keeps retrying.
+     * 
+     * @param dataRateCode Output data rate code from 1 (12.5 Hz) to 10 (6664 Hz).
+     * @param accelRange Accelerometer full scale (g), rounded up to 2, 4, 8 or 16.
+     * @param gyroRange Gyroscope full scale (deg/s), rounded up to 125, 250, 500, 1000 or 2000.
+     * @return True if the device was found and configured.
+     */
+    bool begin(uint8_t dataRateCode, uint8_t accelRange, uint16_t gyroRange);
+
+    /**
+     * @brief Change the output data rate, clearing the FIFO. Before the part
+     * is set up the rate is only recorded.
+     * 
+     * @param dataRateCode Output data rate code from 1 (12.5 Hz) to 10 (6664 Hz).
+     * @return False if the part failed to be reconfigured.
+     */
+    bool setDataRate(uint8_t dataRateCode);
+
+    /**
+     * @brief Check whether the part has been found and set up.
+     * 
+     * @return True once the sensors and FIFO are running.
+     */
+    bool isConfigured() const;
+
+    /**
+     * @brief Read the samples buffered in the FIFO.
+     * 
+     * @param now Current time (us).
+     * @return Number of samples read, available through getSample().
+     */
+    size_t drain(uint64_t now);
+
+    /**
+     * @brief Get the number of samples read by the last drain().
+     * 
+     * @return Number of samples.
+     */
+    size_t getNumSamples() const;
+
+    /**
+     * @brief Get a sample read by the last drain(), oldest first.
+     * 
+     * @param index Sample index, below getNumSamples().
+     * @return The sample.
+     */
+    const LSM6DSLSample& getSample(size_t index) const;
+
+    /**
+     * @brief Get the output data rate.
+     * 
+     * @return Output data rate (Hz), 0 before configure() or begin().
+     */
+    float getDataRate() const;
+
+    /**
+     * @brief Get the accelerometer scale at the configured full scale.
+     * 
+     * @return Scale (g per LSB).
+     */
+    float getAccelScale() const;
+
+    /**
+     * @brief Get the gyroscope scale at the configured full scale.
+     * 
+     * @return Scale (deg/s per LSB).
+     */
+    float getGyroScale() const;
+
+    /**
+     * @brief Get the number of failed transactions.
+     * 
+     * @return Number of errors.
+     */
+    uint32_t getErrorCount() const;
+
+    /**
+     * @brief Get the number of times the FIFO filled and samples were lost.
+     * 
+     * @return Number of overruns.
+     */
+    uint32_t getOverrunCount() const;
+
+private:
+    RegisterBus& bus_; ///< The bus the part is on
+    uint8_t address_; ///< 7-bit I2C address
+    bool requested_; ///< True once the settings have been recorded
+    bool configured_; ///< True once the part has been set up
+    uint8_t dataRateCode_; ///< Output data rate code
+    uint8_t accelControl_; ///< CTRL1_XL full scale bits
+    uint8_t gyroControl_; ///< CTRL2_G full scale bits
+    float accelScale_; ///< Accelerometer scale (g per LSB)
+    float gyroScale_; ///< Gyroscope scale (deg/s per LSB)
+    float dataRate_; ///< Output data rate (Hz)
+    float nominalPeriod_; ///< Time between samples at the nominal data rate (us)
+    float period_; ///< Time between samples measured against the part's clock (us)
+
+    bool anchored_; ///< True once the index phase has been set
+    uint64_t anchorTime_; ///< Time of sample index 0 (us)
+    uint32_t sampleIndex_; ///< Index of the next sample to be read
+
+    LSM6DSLSample samples_[MAX_SAMPLES_PER_DRAIN]; ///< Samples read by the last drain
+    size_t numSamples_; ///< Number of samples read by the last drain
+    uint32_t errorCount_; ///< Failed transactions
+    uint32_t overrunCount_; ///< FIFO overruns
+
+    /**
+     * @brief Check the device and write the recorded settings.
+     * 
+     * @return True if the device was found and configured.
+     */
+    bool setup();
+
+    /**
+     * @brief Write the recorded data rate and restart the FIFO.
+     * 
+     * @return True if the part was reconfigured.
+     */
+    bool writeDataRate();
+
+    /**
+     * @brief Discard FIFO words until the next word starts a sample.
+     * 
+     * @param pattern Index of the next word within a sample.
+     * @return True if the FIFO is aligned.
+     */
+    bool align(uint16_t pattern);
+
+    /**
+     * @brief Set the index phase so the newest sample in the FIFO is at now.
+     * 
+     * @param now Current time (us).
+     * @param available Samples in the FIFO.
+     */
+    void anchor(uint64_t now, size_t available);
+
+    /**
+     * @brief Nudge the index phase and sample period towards the drain time.
+     * 
+     * @param now Current time (us).
+     * @param available Samples in the FIFO.
+     */
+    void trackPhase(uint64_t now, size_t available);
+
+    /**
+     * @brief Get the timestamp of a sample index.
+     * 
+     * @param index Sample index since the anchor.
+     * @return Timestamp (us).
+     */
+    uint64_t timestampOf(uint32_t index) const;
+};
+
+#endif // LSM6DSL_FIFO_HPP
@@ -0,0 +1,125 @@
+#include "MPL3115A2Driver.hpp"
+
+namespace {
+    // Minimum time between samples for each oversample setting, from the datasheet (us)
+    constexpr uint32_t CONVERSION_TIMES[] = {6000, 10000, 18000, 34000, 66000, 130000, 258000, 512000};
+    constexpr uint32_t TIMEOUT_FACTOR = 2; // Conversion times before a conversion has timed out
+    constexpr uint8_t OUTPUT_LENGTH = 5; // 3 pressure and 2 temperature registers
+}
+
+MPL3115A2Driver::MPL3115A2Driver(RegisterBus& bus, uint8_t oversampleRate, uint8_t address)
+    : bus_(bus), address_(address), control_(0), conversionTime_(0), state_(State::IDLE),
+      conversionStart_(0), pressure_(0), temperature_(0), timestamp_(0), errorCount_(0) {
+    if (oversampleRate > MAX_OVERSAMPLE_RATE) {
+        oversampleRate = MAX_OVERSAMPLE_RATE;
+    }
+    // Barometer mode (ALT = 0), standby (SBYB = 0)
+    control_ = oversampleRate << CTRL_REG1_OS_SHIFT;
+    conversionTime_ = CONVERSION_TIMES[oversampleRate];
+}
+
+bool MPL3115A2Driver::begin(uint64_t now) {
+    uint8_t id = 0;
+    if (!bus_.readRegisters(address_, WHO_AM_I, &id, 1) || id != WHO_AM_I_VALUE) {
+        errorCount_++;
+        return false;
+    }
+    if (!bus_.writeRegister(address_, CTRL_REG1, control_) ||
+        !bus_.writeRegister(address_, PT_DATA_CFG, PT_DATA_CFG_ALL)) {
+        errorCount_++;
+        return false;
+    }
+    startConversion(now);
+    return true;
+}
+
+bool MPL3115A2Driver::poll(uint64_t now) {
+    switch (state_) {
+        case State::IDLE:
+            // Not found yet, retry the setup
+            begin(now);
+            return false;
+
+        case State::START:
+            startConversion(now);
+            return false;
+
+        case State::CONVERTING:
+            break;
+    }
+
+    uint64_t elapsed = now - conversionStart_;
+    if (elapsed < conversionTime_) {
+        return false; // Not due yet, leave the bus alone
+    }
+
+    uint8_t status = 0;
+    if (!bus_.readRegisters(address_, STATUS, &status, 1)) {
+        errorCount_++;
+        return false; // Poll again next tick
+    }
+    if (!(status & STATUS_PTDR)) {
+        if (elapsed > TIMEOUT_FACTOR * conversionTime_) {
+            errorCount_++;
+            startConversion(now);
+        }
+        return false;
+    }
+
+    uint8_t data[OUTPUT_LENGTH];
+    if (!bus_.readRegisters(address_, OUT_P_MSB, data, OUTPUT_LENGTH)) {
+        errorCount_++;
+        startConversion(now);
+        return false;
+    }
+    decode(data);
+    // The sample averages over the conversion, stamp it in the middle
+    timestamp_ = conversionStart_ + elapsed / 2;
+
+    startConversion(now);
+    return true;
+}
+
+void MPL3115A2Driver::startConversion(uint64_t now) {
+    if (!bus_.writeRegister(address_, CTRL_REG1, control_ | CTRL_REG1_OST)) {
+        errorCount_++;
+        state_ = State::START; // Retry on the next poll
+        return;
+    }
+    conversionStart_ = now;
+    state_ = State::CONVERTING;
+}
+
+void MPL3115A2Driver::decode(const uint8_t* data) {
+    // Pressure is unsigned Q18.2 Pa, left aligned in 20 bits
+    uint32_t rawPressure = (static_cast<uint32_t>(data[0]) << 16 | static_cast<uint32_t>(data[1]) << 8 | data[2]) >> 4;
+    pressure_ = rawPressure * 0.25f;
+
+    // Temperature is signed Q8.4 degrees C, left aligned in 12 bits
+    int16_t rawTemperature = static_cast<int16_t>(static_cast<uint16_t>(data[3]) << 8 | data[4]);
+    temperature_ = rawTemperature / 256.0f;
+}
+
+float MPL3115A2Driver::getPressure() const {
+    return pressure_;
+}
+
+float MPL3115A2Driver::getTemperature() const {
+    return temperature_;
+}
+
+uint64_t MPL3115A2Driver::getTimestamp() const {
+    return timestamp_;
+}
+
+uint32_t MPL3115A2Driver::getConversionTime() const {
+    return conversionTime_;
+}
+
+uint32_t MPL3115A2Driver::getErrorCount() const {
+    return errorCount_;
+}
+
+bool MPL3115A2Driver::isRunning() const {
+    return state_ != State::IDLE;
+}
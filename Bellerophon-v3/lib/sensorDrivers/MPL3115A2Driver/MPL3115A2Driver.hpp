@@ -0,0 +1,150 @@
+#ifndef MPL3115A2_DRIVER_HPP
+#define MPL3115A2_DRIVER_HPP
+
+#include <stdint.h>
+#include "registerBus.hpp"
+
+/**
+ * @class MPL3115A2Driver
+ * @brief Non-blocking driver for the MPL3115A2 barometer.
+ *
+ * The part is kept in standby and run in one-shot mode. poll() is called
+ * once per tick and never waits. It does nothing until the expected
+ * conversion time has passed, then reads STATUS once. When pressure and
+ * temperature are ready they are read in a single 5-byte burst and the next
+ * conversion is started straight away.
+ *
+ * If the part is not found, poll() keeps retrying the setup. A failed
+ * transaction or a conversion that does not complete within twice
+ * its expected time is counted as an error and the conversion restarted.
+ * Times are passed in by the caller (us), so the driver runs unchanged on the
+ * host against a fake RegisterBus.
+ */
+class MPL3115A2Driver {
+public:
+    static constexpr uint8_t DEFAULT_ADDRESS = 0x60; ///< 7-bit I2C address
+    static constexpr uint8_t WHO_AM_I_VALUE = 0xC4;  ///< Device identifier
+
+    /**
+     * @enum Register
+     * @brief Registers used by the driver.
+     */
+    enum Register : uint8_t {
+        STATUS = 0x00,      ///< Data ready flags
+        OUT_P_MSB = 0x01,   ///< First of 3 pressure and 2 temperature output registers
+        WHO_AM_I = 0x0C,    ///< Device identifier
+        PT_DATA_CFG = 0x13, ///< Data ready event flags
+        CTRL_REG1 = 0x26    ///< Mode, oversample rate and one-shot trigger
+    };
+
+    static constexpr uint8_t STATUS_PTDR = 1 << 3;     ///< Pressure and temperature data ready
+    static constexpr uint8_t CTRL_REG1_OST = 1 << 1;   ///< One-shot trigger, clears on completion
+    static constexpr uint8_t CTRL_REG1_OS_SHIFT = 3;   ///< Position of the oversample rate bits
+    static constexpr uint8_t PT_DATA_CFG_ALL = 0x07;   ///< Enable the data ready flags
+    static constexpr uint8_t MAX_OVERSAMPLE_RATE = 7;  ///< 2^7 = 128 samples
+
+    /**
+     * @brief Constructor for MPL3115A2Driver.
+     * 
+     * @param bus The bus the part is on.
+     * @param oversampleRate Oversample setting from 0 (1 sample) to 7 (128 samples).
+     * @param address 7-bit I2C address.
+     */
+    MPL3115A2Driver(RegisterBus& bus, uint8_t oversampleRate, uint8_t address = DEFAULT_ADDRESS);
+
+    /**
+     * @brief Check the device, configure it and start the first conversion.
+     * 
+     * @param now Current time (us).
+     * @return True if the device was found and configured.
+     */
+    bool begin(uint64_t now);
+
+    /**
+     * @brief Advance the driver by one tick without blocking.
+     * 
+     * @param now Current time (us).
+     * @return True if a new pressure and temperature were read.
+     */
+    bool poll(uint64_t now);
+
+    /**
+     * @brief Get the latest pressure.
+     * 
+     * @return Pressure (Pa).
+     */
+    float getPressure() const;
+
+    /**
+     * @brief Get the latest temperature.
+     * 
+     * @return Temperature (degrees C).
+     */
+    float getTemperature() const;
+
+    /**
+     * @brief Get the time the latest sample was acquired, the middle of its conversion.
+     * 
+     * @return Acquisition timestamp (us).
+     */
+    uint64_t getTimestamp() const;
+
+    /**
+     * @brief Get the expected conversion time at the oversample rate.
+     * 
+     * @return Conversion time (us), from the datasheet.
+     */
+    uint32_t getConversionTime() const;
+
+    /**
+     * @brief Get the number of failed transactions and timed out conversions.
+     * 
+     * @return Number of errors.
+     */
+    uint32_t getErrorCount() const;
+
+    /**
+     * @brief Check if begin() succeeded and conversions are running.
+     * 
+     * @return True if running.
+     */
+    bool isRunning() const;
+
+private:
+    /**
+     * @enum State
+     * @brief Driver states.
+     */
+    enum class State : uint8_t {
+        IDLE,       ///< Not started, poll() retries begin()
+        START,      ///< Start a conversion on the next poll
+        CONVERTING  ///< Waiting for a conversion to complete
+    };
+
+    RegisterBus& bus_; ///< The bus the part is on
+    uint8_t address_; ///< 7-bit I2C address
+    uint8_t control_; ///< CTRL_REG1 value without the one-shot trigger
+    uint32_t conversionTime_; ///< Expected conversion time (us)
+    State state_; ///< Current driver state
+    uint64_t conversionStart_; ///< Time the current conversion was started (us)
+    float pressure_; ///< Latest pressure (Pa)
+    float temperature_; ///< Latest temperature (degrees C)
+    uint64_t timestamp_; ///< Acquisition time of the latest sample (us)
+    uint32_t errorCount_; ///< Failed transactions and timed out conversions
+
+    /**
+     * @brief Trigger a one-shot conversion.
+     * 
+     * @param now Current time (us).
+     */
+    void startConversion(uint64_t now);
+
+    /**
+     * @brief Decode a burst of the pressure and temperature output registers.
+     * 
+     * @param data OUT_P_MSB to OUT_T_LSB.
+     */
+    void decode(const uint8_t* data);
+};
+
+#endif // MPL3115A2_DRIVER_HPP
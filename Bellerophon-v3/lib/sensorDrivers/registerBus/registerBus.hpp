@@ -0,0 +1,44 @@
+#ifndef REGISTER_BUS_HPP
+#define REGISTER_BUS_HPP
+
+#include <cstddef>
+#include <stdint.h>
+
+/**
+ * @class RegisterBus
+ * @brief Abstract interface to a bus of devices with 8-bit register maps.
+ *
+ * Drivers written against this interface do not depend on Wire, so they can
+ * run on the host against a fake device. Every call is a single bus
+ * transaction.
+ */
+class RegisterBus {
+public:
+    /**
+     * @brief Virtual destructor for proper cleanup.
+     */
+    virtual ~RegisterBus() = default;
+
+    /**
+     * @brief Burst read consecutive registers.
+     * 
+     * @param address 7-bit device address.
+     * @param reg First register to read.
+     * @param data Buffer for the register values.
+     * @param length Number of registers to read.
+     * @return True if every byte was read.
+     */
+    virtual bool readRegisters(uint8_t address, uint8_t reg, uint8_t* data, size_t length) = 0;
+
+    /**
+     * @brief Write a single register.
+     * 
+     * @param address 7-bit device address.
+     * @param reg Register to write.
+     * @param value Value to write.
+     * @return True if the device acknowledged the write.
+     */
+    virtual bool writeRegister(uint8_t address, uint8_t reg, uint8_t value) = 0;
+};
+
+#endif // REGISTER_BUS_HPP
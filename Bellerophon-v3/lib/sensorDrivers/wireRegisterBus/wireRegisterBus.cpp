@@ -0,0 +1,26 @@
+#include "wireRegisterBus.hpp"
+
+WireRegisterBus::WireRegisterBus(TwoWire& wire) : wire_(wire) {}
+
+bool WireRegisterBus::readRegisters(uint8_t address, uint8_t reg, uint8_t* data, size_t length) {
+    wire_.beginTransmission(address);
+    wire_.write(reg);
+    // Repeated start so the register pointer is not lost between the write and the read
+    if (wire_.endTransmission(false) != 0) {
+        return false;
+    }
+    if (wire_.requestFrom(address, static_cast<uint8_t>(length)) != length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = wire_.read();
+    }
+    return true;
+}
+
+bool WireRegisterBus::writeRegister(uint8_t address, uint8_t reg, uint8_t value) {
+    wire_.beginTransmission(address);
+    wire_.write(reg);
+    wire_.write(value);
+    return wire_.endTransmission() == 0;
+}
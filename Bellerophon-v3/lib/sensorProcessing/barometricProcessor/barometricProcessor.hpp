@@ -5,6 +5,8 @@
 #include "sensorProcessor.hpp"
 #include "pressureSensor.hpp"
 #include "configKeys.hpp"
+#include "altitudeTable.hpp"
+#include "constants.hpp"
 
 /**
  * @class BarometricProcessor
@@ -20,15 +22,26 @@ public:
      * @param historySize The size of the history buffer for smoothing 
      *        and differentiation.
      * @param outlierThreshold The threshold for detecting outliers.
+     * @param method The method used to estimate vertical velocity.
      */
     BarometricProcessor(size_t historySize, 
-                        float outlierThreshold = 10.0);
+                        float outlierThreshold = 10.0,
+                        DifferentiationMethod method = DifferentiationMethod::LEAST_SQUARES);
 
     /**
-     * @brief Update the pressure sensor data and process it.
+     * @brief Process every pressure reading queued since the last update.
      */
     void update() override;
 
+    /**
+     * @brief Poll the pressure sensor on a sampling tick.
+     * 
+     * @param now Current time (us).
+     */
+    void acquire(uint64_t now) override {
+        pressureSensor_.acquire(now);
+    }
+
     /**
      * @brief Get the raw data from the pressure sensor, wrapper of getAllData()
      * 
@@ -50,6 +63,98 @@ public:
      */
     std::string getSensorNames() const override;
 
+    /**
+     * @brief Check which estimates the barometer provides. Altitude and vertical
+     *        velocity are available once the ground altitude has been calibrated
+     *        and the buffer has stabilized again. Acceleration is the second 
+     *        derivative of the same altitude data, so it is never reported as an
+     *        independent estimate.
+     * 
+     * @param output The output to check.
+     * @return True if the estimate is available.
+     */
+    bool hasEstimate(SensorOutput output) const override;
+
+    /**
+     * @brief Get the noise variance of an output. Altitude uses the residual 
+     *        variance measured from the sample window and velocity the variance 
+     *        of the least-squares slope. Altitude falls back to SIGMA_S until
+     *        measured, velocity is infinite until the slope variance is known.
+     * 
+     * @param output The output to query.
+     * @return Variance, infinite for acceleration.
+     */
+    float getVariance(SensorOutput output) const override;
+
+    /**
+     * @brief Get the number of failed pressure reads.
+     * 
+     * @return Number of failed reads.
+     */
+    uint32_t getErrorCount() const override {
+        return pressureSensor_.getErrorCount();
+    }
+
+    /**
+     * @brief Get the recent fraction of altitude samples rejected as outliers.
+     * 
+     * @return Rejection ratio, 0 to 1.
+     */
+    float getOutlierRatio() const override {
+        return getOutlierStatistics().rejectionRate;
+    }
+
+    /**
+     * @brief Get the time between new pressure samples at the oversample rate.
+     * 
+     * @return Update period (us).
+     */
+    uint32_t getUpdatePeriod() const override {
+        return pressureSensor_.getSamplePeriod();
+    }
+
+    /**
+     * @brief Get a counter that changes whenever a new altitude sample is buffered.
+     * 
+     * @return Sample epoch of the altitude buffer.
+     */
+    uint32_t getUpdateCount() const override;
+
+    /**
+     * @brief Get the latest unsmoothed measurement of an output. Altitude is
+     *        the newest accepted sample rather than the smoothed value.
+     * 
+     * @param output The output to measure.
+     * @return Latest measurement.
+     */
+    float getMeasurement(SensorOutput output) const override;
+
+    /**
+     * @brief Get the number of altitude samples buffered by the last update().
+     * 
+     * @return Number of new measurements.
+     */
+    size_t getNumNewMeasurements() const override {
+        return numNewSamples_;
+    }
+
+    /**
+     * @brief Get an altitude sample buffered by the last update().
+     * 
+     * @param output The output to measure.
+     * @param index Sample index, below getNumNewMeasurements(), oldest first.
+     * @return The unsmoothed altitude, or the output's getter for other outputs.
+     */
+    float getNewMeasurement(SensorOutput output, size_t index) const override;
+
+    /**
+     * @brief Get the acquisition time of an altitude sample buffered by the last update().
+     * 
+     * @param index Sample index, below getNumNewMeasurements(), oldest first.
+     * @return Acquisition time (us).
+     */
+    uint64_t getNewMeasurementTime(size_t index) const override;
+
     /**
      * @brief Get the estimated altitude.
      * 
@@ -86,13 +191,13 @@ public:
     float getGroundAltitude() const override;
 
     /**
-     * @brief Override of virtual method. Barometer not able to calculate 
-     *        acceleration.
+     * @brief Get the estimated vertical acceleration. Only available when 
+     *        the processor uses DifferentiationMethod::QUADRATIC.
      * 
-     * @return 0
+     * @return Estimated vertical acceleration, 0 if unavailable.
      */
     float getAcceleration() const override {
-        return 0;
+        return getSecondDifferentiatedValue();
     }
 
     /**
@@ -110,6 +215,8 @@ private:
     float maxAltitude_; ///< Maximum recorded altitude
     float maxVelocity_; ///< Maximum recorded vertical velocity
     float groundAltitude_; ///< Ground altitude
+    size_t numNewSamples_; ///< Samples buffered by the last update, the newest in the buffer
+    AltitudeTable altitudeTable_; ///< Pressure to altitude conversion table
 
     /**
      * @brief Helper function to calculate altitude from pressure.
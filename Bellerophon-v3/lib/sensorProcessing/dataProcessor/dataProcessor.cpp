@@ -1,38 +1,99 @@
 #include "dataProcessor.hpp"
+#include <cassert>
 
-DataProcessor::DataProcessor(size_t historySize, float outlierThreshold)
-    : currentIndex(0), currentSize(0), historySize(historySize), outlierThreshold(outlierThreshold),
-      stabilizationPhase(true), stabilizationCount(0), stabilizationLimit(historySize), outlierCount(0) {
-    values = new float[historySize]();
-    timestamps = new unsigned long[historySize]();
+namespace {
+    constexpr float MAD_TO_SIGMA = 1.4826f; // Standard deviation per MAD for normal noise
+    constexpr size_t MIN_HAMPEL_SAMPLES = 5; // Samples needed before the filter rejects anything
+    constexpr size_t DEFAULT_HAMPEL_WINDOW = 15; // Samples in the median window
+    constexpr size_t MIN_RESIDUAL_SAMPLES = 10; // Samples in the line fit before residuals are measured
 }
 
-DataProcessor::~DataProcessor() {
-    delete[] values;
-    delete[] timestamps;
+DataProcessor::DataProcessor(size_t historySize, float outlierThreshold, DifferentiationMethod method)
+    : samples(historySize), historySize(samples.capacity()), outlierThreshold(outlierThreshold),
+      stabilizationPhase(true), stabilizationCount(0), stabilizationLimit(historySize), outlierCount(0),
+      outlierStatistics{}, hampelWindow(std::min(DEFAULT_HAMPEL_WINDOW, this->historySize)),
+      differentiationMethod(method), rejectionSide(0), recovering(false), sampleEpoch(0),
+      smoothedCache{UINT32_MAX, 0.0f}, integralCache{UINT32_MAX, 0.0f}, derivativeCache{UINT32_MAX, 0.0f},
+      secondDerivativeCache{UINT32_MAX, 0.0f}, regressionSums{}, regressionOrigin(0), samplesSinceResync(0),
+      residualVariance(0), residualCount(0) {
+    // The buffer is sized at compile time, a larger history would silently be cut to it
+    assert(historySize <= MAX_HISTORY_SIZE && "historySize exceeds MAX_HISTORY_SIZE");
 }
 
-void DataProcessor::updateBuffer(float value) {
+void DataProcessor::updateBuffer(float value, uint64_t timestamp) {
     if (!isStabilized()) {
-        stabilize(value);
+        stabilize(value, timestamp);
         return;
     }
-    
+
     if (isOutlier(value)) {
-        outlierCount++;
-        return; // Skip adding this value if it's an outlier
+        // While recovering from a shift, the window lags behind the new level
+        bool followsShift = recovering && (value > orderedValues.median()) == (rejectionSide > 0.0f);
+        if (!followsShift) {
+            rejectSample(value, timestamp);
+            return; // Skip adding this value if it's an outlier
+        }
+    } else {
+        recovering = false;
     }
- 
-    values[currentIndex] = value;
-    timestamps[currentIndex] = Timer::currentTime();
-    currentIndex = (currentIndex + 1) % historySize;
-    
-    if (currentSize < historySize) {
-        ++currentSize;
+
+    // Any run of rejections was transient, drop the held back samples
+    outlierStatistics.consecutive = 0;
+    pendingSamples.clear();
+    recordDecision(false);
+    acceptSample(value, timestamp);
+}
+
+void DataProcessor::rejectSample(float value, uint64_t timestamp) {
+    outlierCount++;
+    outlierStatistics.rejected++;
+    recordDecision(true);
+
+    // A run of rejections only counts as a shift while it stays on one side of the median
+    float side = (value > orderedValues.median()) ? 1.0f : -1.0f;
+    if (outlierStatistics.consecutive == 0 || side != rejectionSide) {
+        recovering = false;
+        outlierStatistics.consecutive = 0;
+        pendingSamples.clear();
+        rejectionSide = side;
     }
+    outlierStatistics.consecutive++;
+    pendingSamples.push(value, timestamp);
 
-    updateSlidingWindow(value);
-    
+    if (outlierStatistics.consecutive < recoveryLimit) {
+        return;
+    }
+
+    // Sustained shift: the data really moved, so accept the held back samples in order
+    for (size_t i = 0; i < pendingSamples.size(); ++i) {
+        acceptSample(pendingSamples.value[i], pendingSamples.timestamp[i]);
+    }
+    outlierStatistics.recoveries++;
+    outlierStatistics.consecutive = 0;
+    pendingSamples.clear();
+    recovering = true;
+}
+
+void DataProcessor::acceptSample(float value, uint64_t timestamp) {
+    outlierStatistics.accepted++;
+
+    // Only samples added after stabilization enter the least-squares sums, and they are
+    // always the most recent regressionSums.count entries. The oldest sample is therefore
+    // part of the sums only once they span the full buffer.
+    if (regressionSums.count == historySize) {
+        accumulateRegression(samples.value.front(), samples.timestamp.front(), -1.0f);
+    }
+    if (regressionSums.count == 0) {
+        regressionOrigin = timestamp;
+    }
+
+    updateResidualVariance(value, timestamp);
+    pushSample(value, timestamp);
+
+    accumulateRegression(value, timestamp, 1.0f);
+    if (++samplesSinceResync >= historySize) {
+        resyncRegression();
+    }
 }
 
 
@@ -40,21 +101,38 @@ float DataProcessor::getIntegratedValue() const {
     if (stabilizationPhase) {
         return 0.0;
     }
-    return calculateIntegratedValue();
+    return memoise(integralCache, &DataProcessor::calculateIntegratedValue);
 }
 
 float DataProcessor::getDifferentiatedValue() const {
     if (stabilizationPhase) {
         return 0.0;
     }
-    return calculateDifferentiatedValue();
+    return memoise(derivativeCache, &DataProcessor::calculateDifferentiatedValue);
+}
+
+float DataProcessor::getSecondDifferentiatedValue() const {
+    if (stabilizationPhase) {
+        return 0.0;
+    }
+    return memoise(secondDerivativeCache, &DataProcessor::calculateSecondDifferentiatedValue);
+}
+
+void DataProcessor::setDifferentiationMethod(DifferentiationMethod method) {
+    // The least-squares sums are maintained for every method, so switching is free
+    differentiationMethod = method;
+    advanceEpoch();
+}
+
+DifferentiationMethod DataProcessor::getDifferentiationMethod() const {
+    return differentiationMethod;
 }
 
 float DataProcessor::getSmoothedValue() const {
     if (stabilizationPhase) {
         return 0.0;
     }
-    return calculateSmoothedValue();
+    return memoise(smoothedCache, &DataProcessor::calculateSmoothedValue);
 }
 
 bool DataProcessor::isOutlier(float value) const {
@@ -65,11 +143,58 @@ size_t DataProcessor::getOutlierCount() const {
     return outlierCount;
 }
 
+uint32_t DataProcessor::getSampleEpoch() const {
+    return sampleEpoch;
+}
+
+float DataProcessor::memoise(CachedValue& cache, float (DataProcessor::*compute)() const) const {
+    if (cache.epoch != sampleEpoch) {
+        cache.value = (this->*compute)();
+        cache.epoch = sampleEpoch;
+    }
+    return cache.value;
+}
+
+void DataProcessor::advanceEpoch() {
+    ++sampleEpoch;
+}
+
+const OutlierStatistics& DataProcessor::getOutlierStatistics() const {
+    return outlierStatistics;
+}
+
+void DataProcessor::setOutlierPolicy(float sigmas, size_t window, size_t recoveryLimit) {
+    hampelSigmas = sigmas;
+    hampelWindow = std::min({std::max(window, MIN_HAMPEL_SAMPLES), MAX_HAMPEL_WINDOW, historySize});
+    this->recoveryLimit = std::min(std::max(recoveryLimit, static_cast<size_t>(1)), MAX_RECOVERY_SAMPLES);
+
+    // Rebuild the ordered values from the newest samples of the resized window
+    orderedValues.clear();
+    for (size_t i = 0; i < std::min(hampelWindow, samples.size()); ++i) {
+        orderedValues.insert(samples.value.fromNewest(i));
+    }
+}
+
+void DataProcessor::pushSample(float value, uint64_t timestamp) {
+    // Keep the ordered values mirroring the newest hampelWindow samples
+    if (samples.size() >= hampelWindow) {
+        orderedValues.erase(samples.value.fromNewest(hampelWindow - 1));
+    }
+    samples.push(value, timestamp);
+    orderedValues.insert(value);
+    advanceEpoch();
+}
+
+void DataProcessor::recordDecision(bool rejected) {
+    float alpha = 1.0f / static_cast<float>(historySize);
+    outlierStatistics.rejectionRate += alpha * ((rejected ? 1.0f : 0.0f) - outlierStatistics.rejectionRate);
+}
+
 bool DataProcessor::isStabilized() const {
     return !stabilizationPhase;
 }
 
-void DataProcessor::stabilize(float value) {
+void DataProcessor::stabilize(float value, uint64_t timestamp) {
     
     // Wait a period of time before beginning stabilization
     stabilizationTimer.start(stabilizationWaitTime);
@@ -78,12 +203,8 @@ void DataProcessor::stabilize(float value) {
         return;
     }
     
-    // During the stabilization phase, we update the buffer without timestamps and check for stabilization
-    values[currentIndex] = value;
-    currentIndex = (currentIndex + 1) % historySize;
-    if (currentSize < historySize) {
-        ++currentSize;
-    }
+    // During the stabilization phase, we update the buffer and check for stabilization
+    pushSample(value, timestamp);
     
     if (++stabilizationCount >= stabilizationLimit) {
         stabilizationPhase = false; // Exit stabilization phase
@@ -91,29 +212,26 @@ void DataProcessor::stabilize(float value) {
 }
 
 float DataProcessor::calculateSmoothedValue() const {
-    if (currentSize == 0) {
+    if (samples.size() == 0) {
         return 0.0;
     }
 
     float sum = 0.0;
-    for (size_t i = 0; i < currentSize; ++i) {
-        sum += values[i];
+    for (size_t i = 0; i < samples.size(); ++i) {
+        sum += samples.value[i];
     }
-    return sum / static_cast<float>(currentSize);
+    return sum / static_cast<float>(samples.size());
 }
 
 float DataProcessor::calculateIntegratedValue() const {
-    if (currentSize < 2) {
+    if (samples.size() < 2) {
         return 0.0;
     }
 
     float sum = 0.0;
-    for (size_t i = 1; i < currentSize; ++i) {
-        size_t currentIndex = (this->currentIndex + historySize - i) % historySize;
-        size_t previousIndex = (currentIndex + historySize - 1) % historySize;
-
-        float deltaValue = values[currentIndex] - values[previousIndex];
-        float deltaTime = (timestamps[currentIndex] - timestamps[previousIndex]) / 1000.0; // Convert to seconds
+    for (size_t i = 1; i < samples.size(); ++i) {
+        float deltaValue = samples.value[i] - samples.value[i - 1];
+        float deltaTime = (samples.timestamp[i] - samples.timestamp[i - 1]) * 1e-6f; // Convert to seconds
 
         sum += deltaValue * deltaTime;
     }
@@ -122,23 +240,43 @@ float DataProcessor::calculateIntegratedValue() const {
 }
 
 float DataProcessor::calculateDifferentiatedValue() const {
-    if (currentSize < 2) {
-        return 0.0;
+    switch (differentiationMethod) {
+        case DifferentiationMethod::LEAST_SQUARES:
+            return calculateLinearFitDerivative();
+        case DifferentiationMethod::QUADRATIC: {
+            float b, c;
+            if (!solveQuadraticFit(b, c)) {
+                return 0.0;
+            }
+            // Evaluate the fitted slope at the newest sample rather than the window centre
+            return b + 2.0f * c * newestSampleTime();
+        }
+        case DifferentiationMethod::ENDPOINT:
+        default:
+            return calculateEndpointDerivative();
     }
+}
 
-    float sumDeltaValue = 0.0;
-    float sumDeltaTime = 0.0;
-    for (size_t i = 1; i < currentSize; ++i) {
-        size_t currentIndex = (this->currentIndex + historySize - i) % historySize;
-        size_t previousIndex = (currentIndex + historySize - 1) % historySize;
-
-        float deltaValue = values[currentIndex] - values[previousIndex];
-        float deltaTime = (timestamps[currentIndex] - timestamps[previousIndex]) / 1000.0; // Convert to seconds
+float DataProcessor::calculateSecondDifferentiatedValue() const {
+    if (differentiationMethod != DifferentiationMethod::QUADRATIC) {
+        return 0.0;
+    }
+    float b, c;
+    if (!solveQuadraticFit(b, c)) {
+        return 0.0;
+    }
+    return 2.0f * c;
+}
 
-        sumDeltaValue += deltaValue;
-        sumDeltaTime += deltaTime;
+float DataProcessor::calculateEndpointDerivative() const {
+    if (samples.size() < 2) {
+        return 0.0;
     }
 
+    // The sum of successive deltas telescopes to the difference between the endpoints
+    float sumDeltaValue = samples.value.back() - samples.value.front();
+    float sumDeltaTime = (samples.timestamp.back() - samples.timestamp.front()) * 1e-6f; // Convert to seconds
+
     // Avoid division by zero
     if (sumDeltaTime == 0.0) {
         return 0.0;
@@ -147,66 +285,165 @@ float DataProcessor::calculateDifferentiatedValue() const {
     return sumDeltaValue / sumDeltaTime;
 }
 
-bool DataProcessor::detectOutlier(float value) const {
-    // If the sliding window has fewer than 2 elements, there isn't enough data to compare,
-    // so we cannot determine if the value is an outlier. In this case, return false.
-    if (slidingWindow.size() < 2) {
+float DataProcessor::calculateLinearFitDerivative() const {
+    float intercept;
+    float slope;
+    if (!fitLine(intercept, slope)) {
+        return 0.0;
+    }
+    return slope;
+}
+
+bool DataProcessor::fitLine(float& intercept, float& slope) const {
+    const RegressionSums& s = regressionSums;
+    if (s.count < 2) {
+        return false;
+    }
+
+    float n = static_cast<float>(s.count);
+    float denominator = n * s.t2 - s.t * s.t;
+    // Avoid division by zero when all samples share a timestamp
+    if (denominator <= 0.0f) {
         return false;
     }
+    slope = (n * s.tv - s.t * s.v) / denominator;
+    intercept = (s.v - slope * s.t) / n;
+    return true;
+}
 
-    // Get the last value in the sliding window, which is the most recent value added.
-    float lastValue = slidingWindow.back();
+void DataProcessor::updateResidualVariance(float value, uint64_t timestamp) {
+    float intercept;
+    float slope;
+    if (regressionSums.count < MIN_RESIDUAL_SAMPLES || !fitLine(intercept, slope)) {
+        return;
+    }
 
-    // Calculate the rate of change between the new value and the last value in the sliding window.
-    // The rate of change is the absolute difference between these two values.
-    float rateOfChange = std::abs(value - lastValue);
+    // Residual of the new sample against the line fitted to the samples before it
+    float t = static_cast<int64_t>(timestamp - regressionOrigin) * 1e-6f;
+    float residual = value - (intercept + slope * t);
 
-    // Determine if the rate of change exceeds the outlier threshold. If it does, the value is
-    // considered an outlier, so return true. Otherwise, return false.
-    return rateOfChange > outlierThreshold;
+    // Exact mean until a window of residuals is seen, then a moving average over one window
+    residualCount++;
+    float alpha = 1.0f / static_cast<float>(std::min(residualCount, historySize));
+    residualVariance += alpha * (residual * residual - residualVariance);
 }
 
-void DataProcessor::updateSlidingWindow(float value) {
-    // If the sliding window has reached its maximum size (historySize), remove the oldest value
-    // from the front to make room for the new value.
-    if (slidingWindow.size() >= historySize) {
-        slidingWindow.pop_front();
+float DataProcessor::getResidualVariance() const {
+    return residualVariance;
+}
+
+float DataProcessor::getSlopeVariance() const {
+    const RegressionSums& s = regressionSums;
+    float n = static_cast<float>(s.count);
+    float denominator = n * s.t2 - s.t * s.t;
+    if (residualVariance <= 0.0f || denominator <= 0.0f) {
+        return 0.0f;
     }
+    // Var(slope) = sigma^2 / sum((t - mean t)^2)
+    return residualVariance * n / denominator;
+}
 
-    // Add the new value to the back of the sliding window.
-    slidingWindow.push_back(value);
+bool DataProcessor::solveQuadraticFit(float& b, float& c) const {
+    const RegressionSums& s = regressionSums;
+    if (s.count < 3) {
+        return false;
+    }
 
-    // If the rate of change window has reached its maximum size (historySize), remove the oldest
-    // rate of change value from the front to maintain a consistent window size.
-    if (rateOfChangeWindow.size() >= historySize) {
-        rateOfChangeWindow.pop_front();
+    // Normal equations for v = a + b*t + c*t^2, solved with Cramer's rule:
+    // | n   t   t2 | |a|   | v   |
+    // | t   t2  t3 | |b| = | tv  |
+    // | t2  t3  t4 | |c|   | t2v |
+    float n = static_cast<float>(s.count);
+    float m00 = s.t2 * s.t4 - s.t3 * s.t3;
+    float m01 = s.t * s.t4 - s.t3 * s.t2;
+    float m02 = s.t * s.t3 - s.t2 * s.t2;
+    float det = n * m00 - s.t * m01 + s.t2 * m02;
+    if (std::abs(det) <= std::numeric_limits<float>::epsilon()) {
+        return false;
     }
 
-    // Calculate the rate of change if there is more than one value in the sliding window.
-    if (slidingWindow.size() > 1) {
-        // The rate of change is the absolute difference between the most recent value and the
-        // second most recent value in the sliding window.
-        rateOfChangeWindow.push_back(std::abs(slidingWindow.back() - slidingWindow[slidingWindow.size() - 2]));
+    float detB = n * (s.tv * s.t4 - s.t3 * s.t2v)
+               - s.v * m01
+               + s.t2 * (s.t * s.t2v - s.tv * s.t2);
+    float detC = n * (s.t2 * s.t2v - s.tv * s.t3)
+               - s.t * (s.t * s.t2v - s.tv * s.t2)
+               + s.v * m02;
+
+    b = detB / det;
+    c = detC / det;
+    return true;
+}
+
+float DataProcessor::newestSampleTime() const {
+    return static_cast<int64_t>(samples.timestamp.back() - regressionOrigin) * 1e-6f;
+}
+
+void DataProcessor::accumulateRegression(float value, uint64_t timestamp, float sign) {
+    // Signed difference keeps samples older than the origin negative
+    float t = static_cast<int64_t>(timestamp - regressionOrigin) * 1e-6f; // Convert to seconds
+    float t2 = t * t;
+
+    RegressionSums& s = regressionSums;
+    s.t += sign * t;
+    s.t2 += sign * t2;
+    s.t3 += sign * t2 * t;
+    s.t4 += sign * t2 * t2;
+    s.v += sign * value;
+    s.tv += sign * t * value;
+    s.t2v += sign * t2 * value;
+    s.count = sign > 0 ? s.count + 1 : s.count - 1;
+}
+
+void DataProcessor::resyncRegression() {
+    size_t count = regressionSums.count;
+    regressionSums = RegressionSums{};
+    samplesSinceResync = 0;
+    if (count == 0) {
+        return;
+    }
+
+    // Centre time on the newest sample so |t| stays within one window span
+    regressionOrigin = samples.timestamp.back();
+    for (size_t i = 0; i < count; ++i) {
+        accumulateRegression(samples.value.fromNewest(i), samples.timestamp.fromNewest(i), 1.0f);
     }
 }
 
-void DataProcessor::clearBuffer() {
-    // Reset the index and size counters
-    currentIndex = 0;
-    currentSize = 0;
+bool DataProcessor::detectOutlier(float value) const {
+    // With too few samples the median and MAD are not meaningful,
+    // so we cannot determine if the value is an outlier. In this case, return false.
+    if (orderedValues.size() < MIN_HAMPEL_SAMPLES) {
+        return false;
+    }
 
-    // Clear the values and timestamps arrays
-    std::fill(values, values + historySize, 0.0f);
-    std::fill(timestamps, timestamps + historySize, 0);
+    float median = orderedValues.median();
+    float mad = orderedValues.medianAbsoluteDeviation(median);
 
-    // Clear the sliding window and rate of change window
-    slidingWindow.clear();
-    rateOfChangeWindow.clear();
+    // Scale the MAD to a standard deviation estimate for normally distributed noise,
+    // and never reject within outlierThreshold of the median, e.g. on a quiet pad.
+    float limit = std::max(hampelSigmas * MAD_TO_SIGMA * mad, outlierThreshold);
+    return std::abs(value - median) > limit;
+}
+
+void DataProcessor::clearBuffer() {
+    // Clear every column of the sample store
+    samples.clear();
+    advanceEpoch();
 
     // Reset the stabilization phase and counter
     stabilizationPhase = true;
     stabilizationCount = 0;
 
-    // Reset outlier count
+    // Reset outlier count and filter state
     outlierCount = 0;
+    orderedValues.clear();
+    pendingSamples.clear();
+    recovering = false;
+    outlierStatistics = OutlierStatistics{};
+
+    // Reset the least-squares sums and the noise estimate
+    regressionSums = RegressionSums{};
+    samplesSinceResync = 0;
+    residualVariance = 0;
+    residualCount = 0;
 }
\ No newline at end of file
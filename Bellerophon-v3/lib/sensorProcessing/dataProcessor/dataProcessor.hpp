@@ -7,7 +7,39 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
-#include <deque>   // Include for the sliding window
+#include "sampleStore.hpp"
+#include "orderStatisticTree.hpp"
+
+/// Compile-time capacity of every DataProcessor sample window
+constexpr size_t MAX_HISTORY_SIZE = 256;
+
+/// Maximum number of recent samples the Hampel outlier filter takes its median over
+constexpr size_t MAX_HAMPEL_WINDOW = 64;
+
+/// Maximum number of rejected samples held back for the outlier recovery policy
+constexpr size_t MAX_RECOVERY_SAMPLES = 16;
+
+/**
+ * @struct OutlierStatistics
+ * @brief Per-processor record of the outlier filter's decisions.
+ */
+struct OutlierStatistics {
+    uint32_t accepted;    ///< Samples accepted into the buffer
+    uint32_t rejected;    ///< Samples rejected as outliers
+    uint32_t consecutive; ///< Current run of consecutive rejections
+    uint32_t recoveries;  ///< Sustained shifts accepted by the recovery policy
+    float rejectionRate;  ///< Moving average of the rejection ratio over roughly one window
+};
+
+/**
+ * @enum DifferentiationMethod
+ * @brief Selects how a DataProcessor estimates the rate of change of its buffer.
+ */
+enum class DifferentiationMethod {
+    ENDPOINT,      ///< (last - first) / (t_last - t_first) across the whole buffer
+    LEAST_SQUARES, ///< Slope of a sliding linear least-squares fit, O(1) per sample
+    QUADRATIC      ///< Sliding quadratic least-squares fit, also provides the second derivative
+};
 
 /**
  * @class DataProcessor
@@ -21,15 +53,19 @@ public:
     /**
      * @brief Constructor for DataProcessor.
      * 
-     * @param historySize The size of the history buffer.
-     * @param outlierThreshold The threshold for detecting outliers.
+     * @param historySize The size of the history buffer, at most MAX_HISTORY_SIZE.
+     *        A larger size fails an assertion.
+     * @param outlierThreshold Minimum deviation from the rolling median for a 
+     *        sample to be rejected as an outlier.
+     * @param method The method used to differentiate the buffered data.
      */
-    DataProcessor(size_t historySize, float outlierThreshold = 10.0);
+    DataProcessor(size_t historySize, float outlierThreshold = 10.0,
+                  DifferentiationMethod method = DifferentiationMethod::ENDPOINT);
 
     /**
      * @brief Virtual destructor for DataProcessor.
      */
-    virtual ~DataProcessor();
+    virtual ~DataProcessor() = default;
 
     /**
      * @brief Pure virtual function for updating sensor data.
@@ -54,6 +90,29 @@ public:
      */
     float getDifferentiatedValue() const;
 
+    /**
+     * @brief Get the second derivative of the sensor data.
+     * 
+     * Only available with DifferentiationMethod::QUADRATIC, returns 0 otherwise.
+     * 
+     * @return The second differentiated value.
+     */
+    float getSecondDifferentiatedValue() const;
+
+    /**
+     * @brief Select the method used to differentiate the buffered data.
+     * 
+     * @param method The differentiation method to use.
+     */
+    void setDifferentiationMethod(DifferentiationMethod method);
+
+    /**
+     * @brief Get the method used to differentiate the buffered data.
+     * 
+     * @return The current differentiation method.
+     */
+    DifferentiationMethod getDifferentiationMethod() const;
+
     /**
      * @brief Get the smoothed value of the sensor data.
      * 
@@ -83,29 +142,84 @@ public:
      */
     size_t getOutlierCount() const;
 
+    /**
+     * @brief Get the statistics of the outlier filter.
+     * 
+     * @return Accepted, rejected and recovered sample counts and the recent rejection rate.
+     */
+    const OutlierStatistics& getOutlierStatistics() const;
+
+    /**
+     * @brief Configure the Hampel outlier filter.
+     * 
+     * A sample is rejected if it deviates from the median of the last window
+     * samples by more than sigmas robust standard deviations (1.4826 * MAD), and
+     * by more than the outlier threshold. If recoveryLimit consecutive samples
+     * are rejected on the same side, the shift is treated as real: the held back
+     * samples are accepted, and so are further samples on that side until the
+     * window has caught up.
+     * 
+     * @param sigmas Rejection threshold in robust standard deviations.
+     * @param window Samples in the median window, at most MAX_HAMPEL_WINDOW.
+     * @param recoveryLimit Consecutive rejections before recovery, at most MAX_RECOVERY_SAMPLES.
+     */
+    void setOutlierPolicy(float sigmas, size_t window, size_t recoveryLimit);
+
+    /**
+     * @brief Get the measured noise variance of the buffered data.
+     * 
+     * Each accepted sample is compared with the least-squares line fitted to 
+     * the samples before it, and the squared residuals are averaged over 
+     * roughly one window. This costs O(1) per sample and stays numerically 
+     * stable in single precision. Trends the line can not follow, such as 
+     * strong acceleration, raise the variance.
+     * 
+     * @return Residual variance, 0 until enough samples have been fitted.
+     */
+    float getResidualVariance() const;
+
+    /**
+     * @brief Get the variance of the least-squares slope, from the residual variance.
+     * 
+     * @return Slope variance (per second squared), 0 if unknown.
+     */
+    float getSlopeVariance() const;
+
+    /**
+     * @brief Get the sample epoch, incremented whenever the buffer changes.
+     * 
+     * Derived values are memoised against this epoch, so repeated reads between
+     * two samples cost a comparison and a load.
+     * 
+     * @return The current sample epoch.
+     */
+    uint32_t getSampleEpoch() const;
+
 protected:
-    float* values;              ///< Array to store sensor values.
-    unsigned long* timestamps;  ///< Array to store timestamps of the sensor values.
-    size_t currentIndex;        ///< Current index in the history buffer.
-    size_t currentSize;         ///< Current size of the history buffer.
+    SampleStore<MAX_HISTORY_SIZE> samples; ///< Timestamped sample window shared by all estimators.
     const size_t historySize;   ///< Maximum size of the history buffer.
     const float outlierThreshold; ///< Threshold for detecting outliers.
     bool stabilizationPhase;    ///< Flag indicating if the processor is in the stabilization phase.
     size_t stabilizationCount;  ///< Counter for the stabilization phase.
     const size_t stabilizationLimit; ///< Limit for the stabilization phase.
-    std::deque<float> slidingWindow; ///< Sliding window for robust outlier detection
-    std::deque<float> rateOfChangeWindow; ///< Sliding window for rate of change
     size_t outlierCount; ///< Counter for the number of detected outliers
+    OrderStatisticTree<MAX_HAMPEL_WINDOW> orderedValues; ///< Recent sample values ordered for median and MAD
+    OutlierStatistics outlierStatistics; ///< Statistics of the outlier filter
+    float hampelSigmas = 3.0; ///< Rejection threshold in robust standard deviations
+    size_t hampelWindow; ///< Number of recent samples in the median window
+    size_t recoveryLimit = 5; ///< Consecutive same-side rejections treated as a real shift
+    DifferentiationMethod differentiationMethod; ///< Method used for differentiation
 
     Timer stabilizationTimer; ///< Timer instance for stabilization
     int stabilizationWaitTime = 3000; ///< Time to wait before starting stabilization sequence
 
     /**
-     * @brief Update the internal buffer with new data and record the current timestamp.
+     * @brief Update the internal buffer with new data and its acquisition timestamp.
      * 
      * @param value The new sensor data value.
+     * @param timestamp Time the sensor acquired the value, from Timer::currentTimeMicros() (us).
      */
-    void updateBuffer(float value);
+    void updateBuffer(float value, uint64_t timestamp);
 
     /**
      * @brief Calculate the smoothed value of the sensor data.
@@ -128,11 +242,21 @@ protected:
      */
     virtual float calculateDifferentiatedValue() const;
 
+    /**
+     * @brief Calculate the second derivative of the sensor data.
+     * 
+     * @return The second differentiated value.
+     */
+    virtual float calculateSecondDifferentiatedValue() const;
+
     /**
      * @brief Detect if a value is an outlier.
      * 
-     * This method determines if a given value is an outlier based on the rate of change compared
-     * to the last value in the sliding window.
+     * Hampel filter: the value is an outlier if it deviates from the median of the
+     * recent samples by more than hampelSigmas robust standard deviations, estimated
+     * from the median absolute deviation, and by more than outlierThreshold.
+     * The median and MAD come from an order-statistics tree, so the test costs
+     * O(log^2 n) rather than a sort of the window.
      *
      * @param value The value to check.
      * @return True if the value is an outlier, false otherwise.
@@ -143,8 +267,9 @@ protected:
      * @brief Validate the data during the stabilization phase.
      * 
      * @param value The new sensor data value.
+     * @param timestamp The acquisition timestamp (us).
      */
-    void stabilize(float value);
+    void stabilize(float value, uint64_t timestamp);
 
     /**
      * @brief Clear the buffer and reset the processor.
@@ -153,15 +278,156 @@ protected:
 
 
 private:
+    SampleStore<MAX_RECOVERY_SAMPLES> pendingSamples; ///< Rejected samples held back for recovery
+    float rejectionSide; ///< Sign of the current run of rejections relative to the median
+    bool recovering; ///< True while accepting a recovered shift until the window catches up
+
     /**
-     * @brief Update the sliding window with a new value.
+     * @brief Add a sample to the buffer, the ordered values and the least-squares sums.
      * 
-     * This method adds a new value to the sliding window, ensuring that the window size does not
-     * exceed the history size. It also updates the rate of change window accordingly.
-     *
-     * @param value The new sensor data value to add to the sliding window.
+     * @param value The sample value.
+     * @param timestamp The sample timestamp (us).
+     */
+    void acceptSample(float value, uint64_t timestamp);
+
+    /**
+     * @brief Record a rejected sample and apply the recovery policy.
+     * 
+     * @param value The sample value.
+     * @param timestamp The sample timestamp (us).
+     */
+    void rejectSample(float value, uint64_t timestamp);
+
+    /**
+     * @brief Push a sample into the sample store and ordered values, evicting the oldest.
+     * 
+     * @param value The sample value.
+     * @param timestamp The sample timestamp (us).
+     */
+    void pushSample(float value, uint64_t timestamp);
+
+    /**
+     * @brief Update the moving rejection rate with a filter decision.
+     * 
+     * @param rejected True if the sample was rejected.
+     */
+    void recordDecision(bool rejected);
+
+    /**
+     * @struct CachedValue
+     * @brief A derived value memoised for the sample epoch it was computed in.
+     */
+    struct CachedValue {
+        uint32_t epoch; ///< Sample epoch the value belongs to
+        float value;    ///< Memoised value
+    };
+
+    uint32_t sampleEpoch; ///< Incremented whenever the buffer contents change
+    mutable CachedValue smoothedCache; ///< Memoised smoothed value
+    mutable CachedValue integralCache; ///< Memoised integrated value
+    mutable CachedValue derivativeCache; ///< Memoised differentiated value
+    mutable CachedValue secondDerivativeCache; ///< Memoised second differentiated value
+
+    /**
+     * @brief Return the cached value if it belongs to the current sample epoch,
+     *        otherwise compute, store and return it.
+     * 
+     * @param cache The cache slot for the derived value.
+     * @param compute The (virtual) method computing the derived value.
+     * @return The derived value for the current sample epoch.
+     */
+    float memoise(CachedValue& cache, float (DataProcessor::*compute)() const) const;
+
+    /**
+     * @brief Mark every memoised value as stale.
+     */
+    void advanceEpoch();
+
+    /**
+     * @struct RegressionSums
+     * @brief Running sums of the timestamped samples used by the least-squares 
+     *        estimators. Time is in seconds relative to regressionOrigin.
+     */
+    struct RegressionSums {
+        size_t count; ///< Number of samples included in the sums
+        float t;      ///< Sum of t
+        float t2;     ///< Sum of t^2
+        float t3;     ///< Sum of t^3
+        float t4;     ///< Sum of t^4
+        float v;      ///< Sum of v
+        float tv;     ///< Sum of t*v
+        float t2v;    ///< Sum of t^2*v
+    };
+
+    RegressionSums regressionSums; ///< Running least-squares sums over the buffer
+    uint64_t regressionOrigin; ///< Timestamp (us) used as t = 0 in the sums
+    size_t samplesSinceResync; ///< Samples added since the sums were last rebuilt
+    float residualVariance; ///< Moving variance of samples about the line fitted before them
+    size_t residualCount; ///< Residuals included in residualVariance
+
+    /**
+     * @brief Add or remove a sample from the running least-squares sums.
+     * 
+     * @param value The sample value.
+     * @param timestamp The sample timestamp (us).
+     * @param sign +1 to add the sample, -1 to remove it.
+     */
+    void accumulateRegression(float value, uint64_t timestamp, float sign);
+
+    /**
+     * @brief Rebuild the running sums from the buffer around a new time origin.
+     * 
+     * Bounds the rounding error accumulated by repeated add/remove and keeps
+     * the powers of t small. Called once per historySize samples.
+     */
+    void resyncRegression();
+
+    /**
+     * @brief Slope between the first and last buffered samples.
+     * 
+     * @return The endpoint differentiated value.
+     */
+    float calculateEndpointDerivative() const;
+
+    /**
+     * @brief Slope of the linear least-squares fit over the buffer.
+     * 
+     * @return The least-squares differentiated value.
+     */
+    float calculateLinearFitDerivative() const;
+
+    /**
+     * @brief Linear least-squares fit v = intercept + slope * t over the buffer.
+     * 
+     * @param intercept Output value at regressionOrigin.
+     * @param slope Output rate of change (per second).
+     * @return True if the fit exists, false with fewer than two distinct timestamps.
+     */
+    bool fitLine(float& intercept, float& slope) const;
+
+    /**
+     * @brief Update the residual variance with a sample before it enters the sums.
+     * 
+     * @param value The sample value.
+     * @param timestamp The sample timestamp (us).
+     */
+    void updateResidualVariance(float value, uint64_t timestamp);
+
+    /**
+     * @brief Solve the quadratic least-squares fit v = a + b*t + c*t^2.
+     * 
+     * @param b Linear coefficient of the fit.
+     * @param c Quadratic coefficient of the fit.
+     * @return True if the fit is well defined, false otherwise.
+     */
+    bool solveQuadraticFit(float& b, float& c) const;
+
+    /**
+     * @brief Time of the most recent sample relative to regressionOrigin.
+     * 
+     * @return Time of the newest sample in seconds.
      */
-    void updateSlidingWindow(float value);
+    float newestSampleTime() const;
 };
 
 #endif // DATAPROCESSOR_HPP
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "fusedExtremes.hpp"
+#include <cmath>
+
+FusedExtremes::FusedExtremes()
+    : ground_(), maxAltitude_(), maxVelocity_(), maxAcceleration_(), latchedGround_(0), latchedMaxAltitude_(0),
+      latchedMaxVelocity_(0), latchedMaxAcceleration_(0) {}
+
+void FusedExtremes::begin() {
+    ground_ = Average();
+    maxAltitude_ = Average();
+    maxVelocity_ = Average();
+    maxAcceleration_ = Average();
+}
+
+void FusedExtremes::add(const SensorProcessor& sensor) {
+    // Ground and maximum altitude are only known to sensors that have calibrated an altitude
+    if (sensor.hasEstimate(SensorOutput::ALTITUDE)) {
+        float variance = sensor.getVariance(SensorOutput::ALTITUDE);
+        ground_.add(sensor.getGroundAltitude(), variance);
+        maxAltitude_.add(sensor.getMaxAltitude(), variance);
+    }
+    if (sensor.hasEstimate(SensorOutput::VERTICAL_VELOCITY)) {
+        maxVelocity_.add(sensor.getMaxVelocity(), sensor.getVariance(SensorOutput::VERTICAL_VELOCITY));
+    }
+    if (sensor.hasEstimate(SensorOutput::ACCELERATION)) {
+        maxAcceleration_.add(sensor.getMaxAcceleration(), sensor.getVariance(SensorOutput::ACCELERATION));
+    }
+}
+
+void FusedExtremes::latch() {
+    if (ground_.isValid()) {
+        latchedGround_ = ground_.get();
+    }
+    if (maxAltitude_.isValid() && maxAltitude_.get() > latchedMaxAltitude_) {
+        latchedMaxAltitude_ = maxAltitude_.get();
+    }
+    if (maxVelocity_.isValid() && maxVelocity_.get() > latchedMaxVelocity_) {
+        latchedMaxVelocity_ = maxVelocity_.get();
+    }
+    if (maxAcceleration_.isValid() && maxAcceleration_.get() > latchedMaxAcceleration_) {
+        latchedMaxAcceleration_ = maxAcceleration_.get();
+    }
+}
+
+float FusedExtremes::getGroundAltitude() const {
+    return latchedGround_;
+}
+
+float FusedExtremes::getMaxAltitude() const {
+    return latchedMaxAltitude_;
+}
+
+float FusedExtremes::getMaxVelocity() const {
+    return latchedMaxVelocity_;
+}
+
+float FusedExtremes::getMaxAcceleration() const {
+    return latchedMaxAcceleration_;
+}
+
+void FusedExtremes::Average::add(float value, float variance) {
+    // No variance, or an infinite one, gets zero weight
+    if (!(variance > 0.0f) || std::isinf(variance)) {
+        return;
+    }
+    float weight = 1.0f / variance;
+    weightedTotal += weight * value;
+    totalWeight += weight;
+}
+
+bool FusedExtremes::Average::isValid() const {
+    return totalWeight > 0;
+}
+
+float FusedExtremes::Average::get() const {
+    return weightedTotal / totalWeight;
+}
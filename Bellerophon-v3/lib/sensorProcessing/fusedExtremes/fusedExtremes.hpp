@@ -0,0 +1,94 @@
+#ifndef FUSED_EXTREMES_HPP
+#define FUSED_EXTREMES_HPP
+
+#include "sensorProcessor.hpp"
+
+/**
+ * @class FusedExtremes
+ * @brief Ground altitude and maximum values across sensors, latched so a
+ * sensor dropping out of fusion can not lower them.
+ *
+ * Each check is an inverse-variance weighted average over the healthy
+ * sensors that provide the estimate, as the fused filter weights them. When
+ * no healthy sensor provides it, the last value is kept, so a barometer
+ * excluded for going stale or sticking mid-flight leaves the ground and
+ * maximum altitude where they were instead of dropping them to 0. The
+ * maxima only ever rise.
+ */
+class FusedExtremes {
+public:
+    /**
+     * @brief Constructor for FusedExtremes. Everything starts at 0.
+     */
+    FusedExtremes();
+
+    /**
+     * @brief Start a check, clearing the averages of the last one.
+     */
+    void begin();
+
+    /**
+     * @brief Add a healthy sensor to the check.
+     *
+     * @param sensor The sensor, weighted by the variance it reports for each estimate.
+     */
+    void add(const SensorProcessor& sensor);
+
+    /**
+     * @brief End the check, latching the averages of the sensors added.
+     */
+    void latch();
+
+    /**
+     * @brief Get the last ground altitude a healthy sensor provided.
+     *
+     * @return Ground altitude (m).
+     */
+    float getGroundAltitude() const;
+
+    /**
+     * @brief Get the highest maximum altitude seen.
+     *
+     * @return Maximum altitude (m).
+     */
+    float getMaxAltitude() const;
+
+    /**
+     * @brief Get the highest maximum vertical velocity seen.
+     *
+     * @return Maximum vertical velocity (m/s).
+     */
+    float getMaxVelocity() const;
+
+    /**
+     * @brief Get the highest maximum vertical acceleration seen.
+     *
+     * @return Maximum vertical acceleration (m/s^2).
+     */
+    float getMaxAcceleration() const;
+
+private:
+    /**
+     * @struct Average
+     * @brief Running inverse-variance weighted average.
+     */
+    struct Average {
+        float weightedTotal; ///< Sum of weight * value
+        float totalWeight; ///< Sum of weights, 0 if nothing was added
+
+        void add(float value, float variance);
+        bool isValid() const;
+        float get() const;
+    };
+
+    Average ground_; ///< Ground altitude of the current check
+    Average maxAltitude_; ///< Maximum altitude of the current check
+    Average maxVelocity_; ///< Maximum velocity of the current check
+    Average maxAcceleration_; ///< Maximum acceleration of the current check
+    float latchedGround_; ///< Last ground altitude (m)
+    float latchedMaxAltitude_; ///< Highest maximum altitude (m)
+    float latchedMaxVelocity_; ///< Highest maximum velocity (m/s)
+    float latchedMaxAcceleration_; ///< Highest maximum acceleration (m/s^2)
+};
+
+#endif // FUSED_EXTREMES_HPP
@@ -0,0 +1,97 @@
+#include "inertialEstimator.hpp"
+#include <cmath>
+
+namespace {
+    constexpr float STANDARD_GRAVITY_F = 9.80665f;
+    constexpr float CALIBRATION_RATE_LIMIT = 0.2f; // Raw rate above which the pad calibration restarts (rad/s)
+    constexpr float STATIONARY_RATE = 0.05f; // Rate below which the vehicle may be stationary (rad/s)
+    constexpr float STATIONARY_ACCELERATION = 0.5f; // Specific force error from 1 g to be stationary (m/s^2)
+    constexpr float STATIONARY_TIME = 0.5f; // Time stationary before velocity is reset (s)
+    // Steady descent under a parachute also measures 1 g, so only small velocities are reset
+    constexpr float STATIONARY_VELOCITY_LIMIT = 3.0f; // (m/s)
+    constexpr float ACCELERATION_BIAS_SIGMA = 0.05f; // Accelerometer bias left after pad calibration (m/s^2)
+    constexpr float VELOCITY_VARIANCE_FLOOR = 0.01f; // Velocity variance at rest (m^2/s^2)
+}
+
+InertialEstimator::InertialEstimator(size_t calibrationSamples)
+    : calibrationLimit_(calibrationSamples > 0 ? calibrationSamples : 1), calibrationCount_(0), rateSum_{0, 0, 0},
+      accelerationSum_{0, 0, 0}, calibrated_(false), gravity_(STANDARD_GRAVITY_F), gyroBias_{0, 0, 0},
+      accelerationScale_(1.0f), lastTimestamp_(0), bodyAcceleration_{0, 0, 0}, verticalAcceleration_(0),
+      verticalVelocity_(0), stationaryTime_(0), timeSinceRest_(0) {}
+
+void InertialEstimator::setGravity(float gravity) {
+    gravity_ = gravity;
+    attitudeEstimator_.setGravity(gravity);
+}
+
+void InertialEstimator::update(uint64_t timestamp, const Vector3& rate, const Vector3& acceleration) {
+    // Step between the sensor's acquisition times, free of loop jitter.
+    // The FIFO timestamps restart after an overrun, so a step back is skipped
+    float dt = (lastTimestamp_ == 0 || timestamp <= lastTimestamp_) ? 0.0f : (timestamp - lastTimestamp_) * 1e-6f;
+    lastTimestamp_ = timestamp;
+
+    if (!calibrated_) {
+        calibrate(rate, acceleration);
+        return;
+    }
+
+    bodyAcceleration_ = acceleration * accelerationScale_;
+
+    if (dt <= 0) {
+        return;
+    }
+
+    attitudeEstimator_.update(rate - gyroBias_, bodyAcceleration_, dt);
+    verticalAcceleration_ = attitudeEstimator_.getAttitude().rotate(bodyAcceleration_).z - gravity_;
+
+    updateVelocity(dt);
+}
+
+float InertialEstimator::getVelocityVariance() const {
+    // Integrated velocity error is dominated by the residual bias, growing linearly in time
+    float drift = ACCELERATION_BIAS_SIGMA * timeSinceRest_;
+    return VELOCITY_VARIANCE_FLOOR + drift * drift;
+}
+
+void InertialEstimator::calibrate(const Vector3& rate, const Vector3& acceleration) {
+    // Restart if the vehicle is moved, so the bias is only averaged at rest
+    bool moving = rate.norm() > CALIBRATION_RATE_LIMIT 
+        || std::abs(acceleration.norm() - gravity_) > gravity_ * 0.2f;
+    if (moving) {
+        calibrationCount_ = 0;
+        rateSum_ = {0, 0, 0};
+        accelerationSum_ = {0, 0, 0};
+        return;
+    }
+
+    rateSum_ = rateSum_ + rate;
+    accelerationSum_ = accelerationSum_ + acceleration;
+    if (++calibrationCount_ < calibrationLimit_) {
+        return;
+    }
+
+    float inverseCount = 1.0f / static_cast<float>(calibrationCount_);
+    gyroBias_ = rateSum_ * inverseCount;
+    Vector3 gravity = accelerationSum_ * inverseCount;
+
+    // Scale so that 1 g reads gravity_ and vertical acceleration is 0 on the pad
+    accelerationScale_ = gravity_ / gravity.norm();
+    attitudeEstimator_.reset(Quaternion::fromUpVector(gravity));
+    calibrated_ = true;
+}
+
+void InertialEstimator::updateVelocity(float dt) {
+    bool stationary = attitudeEstimator_.getBodyRate().norm() < STATIONARY_RATE
+        && std::abs(bodyAcceleration_.norm() - gravity_) < STATIONARY_ACCELERATION;
+    stationaryTime_ = stationary ? stationaryTime_ + dt : 0.0f;
+
+    if (stationaryTime_ >= STATIONARY_TIME && std::abs(verticalVelocity_) < STATIONARY_VELOCITY_LIMIT) {
+        // Zero velocity update: remove integration drift
+        verticalVelocity_ = 0;
+        timeSinceRest_ = 0;
+        return;
+    }
+
+    verticalVelocity_ += verticalAcceleration_ * dt;
+    timeSinceRest_ += dt;
+}
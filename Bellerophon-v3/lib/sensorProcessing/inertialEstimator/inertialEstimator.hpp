@@ -0,0 +1,157 @@
+#ifndef INERTIAL_ESTIMATOR_HPP
+#define INERTIAL_ESTIMATOR_HPP
+
+#include <cstddef>
+#include <stdint.h>
+#include "quaternion.hpp"
+#include "attitudeEstimator.hpp"
+
+/**
+ * @class InertialEstimator
+ * @brief Vertical acceleration and velocity from timestamped IMU samples.
+ *
+ * While stationary on the pad it averages the gyroscope bias, scales the
+ * accelerometer so it reads 1 g, and aligns the attitude with gravity. The
+ * calibration restarts whenever the vehicle is moved. It then tracks the
+ * attitude with a gravity-corrected AttitudeEstimator, rotates the specific
+ * force into the world frame and subtracts gravity to give vertical
+ * acceleration, which is integrated to vertical velocity. Once the vehicle
+ * has been still for a while at a small velocity, a zero velocity update
+ * removes the integration drift.
+ *
+ * Hardware independent, so it is fed by IMUProcessor on target and by
+ * synthetic samples in native tests.
+ */
+class InertialEstimator {
+public:
+    /**
+     * @brief Constructor for InertialEstimator.
+     * 
+     * @param calibrationSamples Stationary samples averaged for the pad calibration.
+     */
+    explicit InertialEstimator(size_t calibrationSamples);
+
+    /**
+     * @brief Set the magnitude of gravity measured by the accelerometer at rest.
+     * 
+     * @param gravity Gravity in the accelerometer's units (m/s^2).
+     */
+    void setGravity(float gravity);
+
+    /**
+     * @brief Process one IMU sample.
+     * 
+     * @param timestamp Acquisition time of the sample (us).
+     * @param rate Raw body angular rate (rad/s).
+     * @param acceleration Raw body specific force (m/s^2).
+     */
+    void update(uint64_t timestamp, const Vector3& rate, const Vector3& acceleration);
+
+    /**
+     * @brief Check if the pad calibration has completed.
+     * 
+     * @return True if calibrated.
+     */
+    bool isCalibrated() const {
+        return calibrated_;
+    }
+
+    /**
+     * @brief Get the vertical acceleration.
+     * 
+     * @return World frame vertical acceleration, excluding gravity (m/s^2).
+     */
+    float getVerticalAcceleration() const {
+        return verticalAcceleration_;
+    }
+
+    /**
+     * @brief Get the vertical velocity.
+     * 
+     * @return Vertical velocity integrated since the last zero velocity update (m/s).
+     */
+    float getVerticalVelocity() const {
+        return verticalVelocity_;
+    }
+
+    /**
+     * @brief Get the variance of the vertical velocity. It grows from a small
+     *        floor at the last zero velocity update with the residual
+     *        accelerometer bias.
+     * 
+     * @return Velocity variance (m^2/s^2).
+     */
+    float getVelocityVariance() const;
+
+    /**
+     * @brief Get the calibrated specific force in the body frame.
+     * 
+     * @return Body frame acceleration (m/s^2).
+     */
+    const Vector3& getBodyAcceleration() const {
+        return bodyAcceleration_;
+    }
+
+    /**
+     * @brief Get the bias-corrected angular rate in the body frame.
+     * 
+     * @return Body angular rate (rad/s).
+     */
+    const Vector3& getBodyRate() const {
+        return attitudeEstimator_.getBodyRate();
+    }
+
+    /**
+     * @brief Get the attitude of the vehicle.
+     * 
+     * @return Rotation from the body frame to the z-up world frame.
+     */
+    const Quaternion& getAttitude() const {
+        return attitudeEstimator_.getAttitude();
+    }
+
+    /**
+     * @brief Get the tilt of the vehicle from vertical.
+     * 
+     * @return Tilt angle (rad), 0 when upright.
+     */
+    float getTilt() const {
+        return attitudeEstimator_.getTilt();
+    }
+
+private:
+    const size_t calibrationLimit_; ///< Stationary samples averaged for calibration
+    size_t calibrationCount_; ///< Stationary samples averaged so far
+    Vector3 rateSum_; ///< Sum of raw angular rates during calibration
+    Vector3 accelerationSum_; ///< Sum of raw specific forces during calibration
+    bool calibrated_; ///< True once the pad calibration has completed
+
+    float gravity_; ///< Specific force magnitude at rest (m/s^2)
+    Vector3 gyroBias_; ///< Gyroscope bias (rad/s)
+    float accelerationScale_; ///< Accelerometer scale factor so that 1 g reads gravity_
+    uint64_t lastTimestamp_; ///< Acquisition time of the previous sample (us)
+
+    AttitudeEstimator attitudeEstimator_; ///< Attitude from the gyroscope, corrected by gravity
+    Vector3 bodyAcceleration_; ///< Calibrated body frame specific force (m/s^2)
+    float verticalAcceleration_; ///< World frame vertical acceleration, excluding gravity (m/s^2)
+    float verticalVelocity_; ///< Integrated vertical velocity (m/s)
+    float stationaryTime_; ///< Time the vehicle has been continuously stationary (s)
+    float timeSinceRest_; ///< Time since the last zero velocity update (s)
+
+    /**
+     * @brief Accumulate a stationary sample and complete the calibration once enough are collected.
+     * 
+     * @param rate Raw body angular rate (rad/s).
+     * @param acceleration Raw body specific force (m/s^2).
+     */
+    void calibrate(const Vector3& rate, const Vector3& acceleration);
+
+    /**
+     * @brief Integrate vertical velocity, resetting it while the vehicle is stationary.
+     * 
+     * @param dt Time step (s).
+     */
+    void updateVelocity(float dt);
+};
+
+#endif // INERTIAL_ESTIMATOR_HPP
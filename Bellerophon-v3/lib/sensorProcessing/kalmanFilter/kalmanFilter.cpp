@@ -0,0 +1,119 @@
+#include "kalmanFilter.hpp"
+
+namespace {
+    constexpr float INITIAL_VELOCITY_VARIANCE = 1.0f; // Vehicle starts at rest on the pad (m^2/s^2)
+    constexpr float INITIAL_ACCELERATION_VARIANCE = 1.0f; // (m^2/s^4)
+}
+
+KalmanFilter::KalmanFilter(float modelSigma, float altitudeSigma, float accelerationSigma)
+    : jerkVariance_(modelSigma * modelSigma), altitudeVariance_(altitudeSigma * altitudeSigma),
+      accelerationVariance_(accelerationSigma * accelerationSigma), initialised_(false) {
+    state_.Fill(0);
+    covariance_.Fill(0);
+}
+
+void KalmanFilter::reset(float altitude) {
+    state_.Fill(0);
+    state_(ALTITUDE) = altitude;
+
+    covariance_.Fill(0);
+    covariance_(ALTITUDE, ALTITUDE) = altitudeVariance_;
+    covariance_(VELOCITY, VELOCITY) = INITIAL_VELOCITY_VARIANCE;
+    covariance_(ACCELERATION, ACCELERATION) = INITIAL_ACCELERATION_VARIANCE;
+
+    initialised_ = true;
+}
+
+bool KalmanFilter::isInitialised() const {
+    return initialised_;
+}
+
+void KalmanFilter::predict(float dt) {
+    if (!initialised_ || dt <= 0) {
+        return;
+    }
+
+    float dt2 = dt * dt;
+    float dt3 = dt2 * dt;
+
+    // Constant acceleration transition
+    BLA::Matrix<NUM_STATES, NUM_STATES> transition;
+    transition.Fill(0);
+    transition(0, 0) = 1;
+    transition(0, 1) = dt;
+    transition(0, 2) = 0.5f * dt2;
+    transition(1, 1) = 1;
+    transition(1, 2) = dt;
+    transition(2, 2) = 1;
+
+    // Process noise of white jerk integrated over the step
+    BLA::Matrix<NUM_STATES, NUM_STATES> processNoise;
+    processNoise(0, 0) = dt3 * dt2 / 20.0f;
+    processNoise(0, 1) = dt2 * dt2 / 8.0f;
+    processNoise(0, 2) = dt3 / 6.0f;
+    processNoise(1, 0) = processNoise(0, 1);
+    processNoise(1, 1) = dt3 / 3.0f;
+    processNoise(1, 2) = dt2 / 2.0f;
+    processNoise(2, 0) = processNoise(0, 2);
+    processNoise(2, 1) = processNoise(1, 2);
+    processNoise(2, 2) = dt;
+
+    state_ = transition * state_;
+    covariance_ = transition * covariance_ * ~transition + processNoise * jerkVariance_;
+}
+
+void KalmanFilter::updateAltitude(float altitude) {
+    correct(ALTITUDE, altitude, altitudeVariance_);
+}
+
+void KalmanFilter::updateAcceleration(float acceleration) {
+    correct(ACCELERATION, acceleration, accelerationVariance_);
+}
+
+void KalmanFilter::updateAltitude(float altitude, float variance) {
+    correct(ALTITUDE, altitude, variance);
+}
+
+void KalmanFilter::updateAcceleration(float acceleration, float variance) {
+    correct(ACCELERATION, acceleration, variance);
+}
+
+float KalmanFilter::getAltitude() const {
+    return state_(ALTITUDE);
+}
+
+float KalmanFilter::getVelocity() const {
+    return state_(VELOCITY);
+}
+
+float KalmanFilter::getAcceleration() const {
+    return state_(ACCELERATION);
+}
+
+float KalmanFilter::getVariance(State state) const {
+    return covariance_(state, state);
+}
+
+void KalmanFilter::correct(State state, float measurement, float variance) {
+    // A measurement without a usable variance carries no information
+    if (!initialised_ || !(variance > 0.0f) || std::isinf(variance)) {
+        return;
+    }
+
+    // The measurement matrix selects one state, so the innovation covariance is a scalar
+    float innovationVariance = covariance_(state, state) + variance;
+    float innovation = measurement - state_(state);
+
+    BLA::Matrix<NUM_STATES, 1> gain;
+    BLA::Matrix<1, NUM_STATES> observedRow;
+    for (int i = 0; i < NUM_STATES; ++i) {
+        gain(i) = covariance_(i, state) / innovationVariance;
+        observedRow(0, i) = covariance_(state, i);
+    }
+
+    state_ += gain * innovation;
+    covariance_ -= gain * observedRow;
+
+    // Keep the covariance symmetric against rounding
+    covariance_ = (covariance_ + ~covariance_) * 0.5f;
+}
@@ -0,0 +1,142 @@
+#ifndef KALMAN_FILTER_HPP
+#define KALMAN_FILTER_HPP
+
+#include <BasicLinearAlgebra.h>
+#include <cmath>
+
+/**
+ * @class KalmanFilter
+ * @brief Three state (altitude, vertical velocity, vertical acceleration) Kalman filter.
+ *
+ * The process model is constant acceleration driven by white jerk noise, so
+ * the filter tracks the changes in thrust and drag through the flight.
+ * Altitude and acceleration are measured directly. Each measurement
+ * observes a single state, so an update is a scalar correction with no
+ * matrix inversion, and sensors can be applied at their own rates between
+ * predictions. All matrices are fixed size, so predict and update run in
+ * constant time without allocation.
+ */
+class KalmanFilter {
+public:
+    static constexpr int NUM_STATES = 3; ///< Altitude, velocity and acceleration
+
+    /**
+     * @enum State
+     * @brief Index of each state in the state vector.
+     */
+    enum State {
+        ALTITUDE = 0,     ///< Altitude (m)
+        VELOCITY = 1,     ///< Vertical velocity (m/s)
+        ACCELERATION = 2  ///< Vertical acceleration (m/s^2)
+    };
+
+    /**
+     * @brief Constructor for KalmanFilter.
+     * 
+     * @param modelSigma Standard deviation of the model, as jerk noise density (m/s^3).
+     * @param altitudeSigma Standard deviation of altitude measurements (m).
+     * @param accelerationSigma Standard deviation of acceleration measurements (m/s^2).
+     */
+    KalmanFilter(float modelSigma, float altitudeSigma, float accelerationSigma);
+
+    /**
+     * @brief Initialise the filter at rest at the given altitude.
+     * 
+     * @param altitude Initial altitude (m).
+     */
+    void reset(float altitude);
+
+    /**
+     * @brief Check if the filter has been initialised with reset().
+     * 
+     * @return True if initialised.
+     */
+    bool isInitialised() const;
+
+    /**
+     * @brief Propagate the state and covariance forward in time.
+     * 
+     * @param dt Time since the last prediction (s).
+     */
+    void predict(float dt);
+
+    /**
+     * @brief Correct the state with an altitude measurement.
+     * 
+     * @param altitude Measured altitude (m).
+     */
+    void updateAltitude(float altitude);
+
+    /**
+     * @brief Correct the state with an altitude measurement of known variance.
+     * 
+     * @param altitude Measured altitude (m).
+     * @param variance Variance of the measurement (m^2). Non-positive or 
+     *        infinite variances are ignored.
+     */
+    void updateAltitude(float altitude, float variance);
+
+    /**
+     * @brief Correct the state with a vertical acceleration measurement.
+     * 
+     * @param acceleration Measured vertical acceleration, excluding gravity (m/s^2).
+     */
+    void updateAcceleration(float acceleration);
+
+    /**
+     * @brief Correct the state with a vertical acceleration measurement of known variance.
+     * 
+     * @param acceleration Measured vertical acceleration, excluding gravity (m/s^2).
+     * @param variance Variance of the measurement (m^2/s^4). Non-positive or 
+     *        infinite variances are ignored.
+     */
+    void updateAcceleration(float acceleration, float variance);
+
+    /**
+     * @brief Get the estimated altitude.
+     * 
+     * @return Altitude (m).
+     */
+    float getAltitude() const;
+
+    /**
+     * @brief Get the estimated vertical velocity.
+     * 
+     * @return Vertical velocity (m/s).
+     */
+    float getVelocity() const;
+
+    /**
+     * @brief Get the estimated vertical acceleration.
+     * 
+     * @return Vertical acceleration (m/s^2).
+     */
+    float getAcceleration() const;
+
+    /**
+     * @brief Get the variance of a state estimate.
+     * 
+     * @param state The state.
+     * @return Variance of the estimate, in the state's units squared.
+     */
+    float getVariance(State state) const;
+
+private:
+    BLA::Matrix<NUM_STATES, 1> state_; ///< State estimate
+    BLA::Matrix<NUM_STATES, NUM_STATES> covariance_; ///< Covariance of the state estimate
+    const float jerkVariance_; ///< Process noise density (m^2/s^5)
+    const float altitudeVariance_; ///< Altitude measurement variance (m^2)
+    const float accelerationVariance_; ///< Acceleration measurement variance (m^2/s^4)
+    bool initialised_; ///< True once reset() has been called
+
+    /**
+     * @brief Scalar measurement update of a single state.
+     * 
+     * @param state The state measured.
+     * @param measurement The measured value.
+     * @param variance Variance of the measurement.
+     */
+    void correct(State state, float measurement, float variance);
+};
+
+#endif // KALMAN_FILTER_HPP
@@ -0,0 +1,154 @@
+#ifndef QUATERNION_HPP
+#define QUATERNION_HPP
+
+#include <cmath>
+
+/**
+ * @struct Vector3
+ * @brief Three component single-precision vector.
+ */
+struct Vector3 {
+    float x; ///< X component
+    float y; ///< Y component
+    float z; ///< Z component
+
+    Vector3 operator+(const Vector3& other) const { return {x + other.x, y + other.y, z + other.z}; }
+    Vector3 operator-(const Vector3& other) const { return {x - other.x, y - other.y, z - other.z}; }
+    Vector3 operator*(float scale) const { return {x * scale, y * scale, z * scale}; }
+
+    /**
+     * @brief Dot product with another vector.
+     */
+    float dot(const Vector3& other) const { return x * other.x + y * other.y + z * other.z; }
+
+    /**
+     * @brief Cross product with another vector.
+     */
+    Vector3 cross(const Vector3& other) const {
+        return {y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x};
+    }
+
+    /**
+     * @brief Euclidean length of the vector.
+     */
+    float norm() const { return sqrtf(dot(*this)); }
+};
+
+/**
+ * @struct Quaternion
+ * @brief Unit quaternion representing the rotation from the body frame to the world frame.
+ *
+ * Allocation-free single-precision operations for attitude propagation.
+ * The world frame is z-up, so a vehicle standing on the pad measures a
+ * specific force of (0, 0, +g) once rotated into the world frame.
+ */
+struct Quaternion {
+    float w; ///< Scalar part
+    float x; ///< Vector part, x
+    float y; ///< Vector part, y
+    float z; ///< Vector part, z
+
+    /**
+     * @brief The identity rotation.
+     */
+    static Quaternion identity() { return {1.0f, 0.0f, 0.0f, 0.0f}; }
+
+    /**
+     * @brief Hamilton product, applying other first and then this rotation.
+     */
+    Quaternion operator*(const Quaternion& other) const {
+        return {w * other.w - x * other.x - y * other.y - z * other.z,
+                w * other.x + x * other.w + y * other.z - z * other.y,
+                w * other.y - x * other.z + y * other.w + z * other.x,
+                w * other.z + x * other.y - y * other.x + z * other.w};
+    }
+
+    /**
+     * @brief Inverse of a unit quaternion.
+     */
+    Quaternion conjugate() const { return {w, -x, -y, -z}; }
+
+    /**
+     * @brief Rescale to unit length, resetting to identity if degenerate.
+     */
+    void normalise() {
+        float length = sqrtf(w * w + x * x + y * y + z * z);
+        if (length < 1e-6f) {
+            *this = identity();
+            return;
+        }
+        float inverse = 1.0f / length;
+        w *= inverse;
+        x *= inverse;
+        y *= inverse;
+        z *= inverse;
+    }
+
+    /**
+     * @brief Rotate a body frame vector into the world frame.
+     * 
+     * @param v Vector in the body frame.
+     * @return Vector in the world frame.
+     */
+    Vector3 rotate(const Vector3& v) const {
+        // v' = v + 2w(q x v) + 2 q x (q x v), cheaper than two Hamilton products
+        Vector3 q = {x, y, z};
+        Vector3 t = q.cross(v) * 2.0f;
+        return v + t * w + q.cross(t);
+    }
+
+    /**
+     * @brief Rotate a world frame vector into the body frame.
+     * 
+     * @param v Vector in the world frame.
+     * @return Vector in the body frame.
+     */
+    Vector3 rotateInverse(const Vector3& v) const { return conjugate().rotate(v); }
+
+    /**
+     * @brief Propagate the attitude by a body frame angular rate over a time step.
+     * 
+     * Uses the first-order update q += 0.5 * q * (0, omega) * dt followed by
+     * renormalisation, which is accurate while the rotation per step is small.
+     * 
+     * @param rate Body angular rate (rad/s).
+     * @param dt Time step (s).
+     */
+    void integrate(const Vector3& rate, float dt) {
+        float half = 0.5f * dt;
+        Quaternion delta = *this * Quaternion{0.0f, rate.x, rate.y, rate.z};
+        w += delta.w * half;
+        x += delta.x * half;
+        y += delta.y * half;
+        z += delta.z * half;
+        normalise();
+    }
+
+    /**
+     * @brief Shortest rotation taking the body frame vector onto world +z.
+     * 
+     * With the measured specific force on the pad this gives an attitude
+     * aligned with gravity. Heading about the vertical is unobservable and is
+     * left at zero.
+     * 
+     * @param up Vector in the body frame pointing up, e.g. the measured specific force.
+     * @return Attitude rotating up onto (0, 0, 1), identity if up is zero.
+     */
+    static Quaternion fromUpVector(const Vector3& up) {
+        float length = up.norm();
+        if (length < 1e-6f) {
+            return identity();
+        }
+        Vector3 u = up * (1.0f / length);
+        // Half-way quaternion between u and +z: (1 + u.z, u x z), normalised
+        Quaternion q = {1.0f + u.z, u.y, -u.x, 0.0f};
+        if (q.w < 1e-6f) {
+            // Upside down, rotate half a turn about x
+            return {0.0f, 1.0f, 0.0f, 0.0f};
+        }
+        q.normalise();
+        return q;
+    }
+};
+
+#endif // QUATERNION_HPP
@@ -0,0 +1,71 @@
+#ifndef SAMPLE_STORE_HPP
+#define SAMPLE_STORE_HPP
+
+#include <cstddef>
+#include <stdint.h>
+#include "ringBuffer.hpp"
+
+/**
+ * @class SampleStore
+ * @brief Struct-of-arrays window of timestamped sensor samples.
+ *
+ * Each column is a RingBuffer advanced in lockstep, so index i refers to the
+ * same sample in every column. All storage is sized at compile time and the
+ * store never allocates after construction.
+ *
+ * @tparam N Compile-time capacity of every column.
+ */
+template <size_t N>
+class SampleStore {
+public:
+    RingBuffer<float, N> value;        ///< Sample values
+    RingBuffer<uint64_t, N> timestamp; ///< Sample acquisition timestamps (us)
+    RingBuffer<float, N> rateOfChange; ///< Absolute change from the previous sample
+
+    /**
+     * @brief Constructor for SampleStore.
+     * 
+     * @param limit Number of samples held before the oldest is overwritten, at most N.
+     */
+    explicit SampleStore(size_t limit = N)
+        : value(limit), timestamp(limit), rateOfChange(limit) {}
+
+    /**
+     * @brief Append a sample to every column.
+     * 
+     * @param sampleValue The sample value.
+     * @param sampleTime The sample timestamp (us).
+     */
+    void push(float sampleValue, uint64_t sampleTime) {
+        float change = value.empty() ? 0.0f : sampleValue - value.back();
+        rateOfChange.push(change < 0 ? -change : change);
+        value.push(sampleValue);
+        timestamp.push(sampleTime);
+    }
+
+    /**
+     * @brief Get the number of samples held.
+     */
+    size_t size() const { return value.size(); }
+
+    /**
+     * @brief Get the maximum number of samples held.
+     */
+    size_t capacity() const { return value.capacity(); }
+
+    /**
+     * @brief Check if the next push will overwrite the oldest sample.
+     */
+    bool full() const { return value.full(); }
+
+    /**
+     * @brief Remove all samples.
+     */
+    void clear() {
+        value.clear();
+        timestamp.clear();
+        rateOfChange.clear();
+    }
+};
+
+#endif // SAMPLE_STORE_HPP
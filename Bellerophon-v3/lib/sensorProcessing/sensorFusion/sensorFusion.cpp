@@ -4,7 +4,8 @@
 // prevent data logging or processing until initilisation complete
 
 
-SensorFusion::SensorFusion(DataLogger& logger) : logger_(logger), numFusedDataPoints_(3), numSensorValues_(0),
+SensorFusion::SensorFusion(DataLogger& logger) : filter_(SIGMA_M, SIGMA_S, SIGMA_A),
+logger_(logger), numFusedDataPoints_(3), numSensorValues_(0),
 dataHeaderString_(""), fusedAltitude_(0), fusedVerticalVelocity_(0), fusedAcceleration_(0) {}
 
 void SensorFusion::updateSensorInformation() {
@@ -15,7 +16,10 @@ void SensorFusion::updateSensorInformation() {
 bool SensorFusion::addSensor(const std::shared_ptr<SensorProcessor>& sensor) {
     // Check if the argument is a valid SensorProcessor
     if (sensor && dynamic_cast<SensorProcessor*>(sensor.get())) {
-        sensors.push_back(sensor);
+        if (!sampler_.addSource(*sensor)) {
+            return false;
+        }
+        sensors.push_back({sensor, sensor->getUpdateCount(), SensorHealthMonitor()});
         updateSensorInformation();
         return true;
     }
@@ -23,9 +27,11 @@ bool SensorFusion::addSensor(const std::shared_ptr<SensorProcessor>& sensor) {
 }
 
 bool SensorFusion::removeSensor(const std::shared_ptr<SensorProcessor>& sensor) {
-    auto it = std::find(sensors.begin(), sensors.end(), sensor);
+    auto it = std::find_if(sensors.begin(), sensors.end(),
+        [&sensor](const SensorSlot& slot) { return slot.sensor == sensor; });
     // remove sensor and return true if found
     if (it != sensors.end()) {
+        sampler_.removeSource(*sensor);
         sensors.erase(it);
         updateSensorInformation();
         return true;
@@ -35,20 +41,75 @@ bool SensorFusion::removeSensor(const std::shared_ptr<SensorProcessor>& sensor)
 }
 
 void SensorFusion::update() {
-    updateSensors();
-    updateFusedData();
+    PROFILE_SCOPE(SENSOR_FUSION);
+    bool newData = updateSensors();
+    checkSensorHealth();
+    if (newData) {
+        updateFusedData();
+    }
+    updateExtremes();
+}
+
+bool SensorFusion::startSampling(uint32_t periodMicros) {
+    return sampler_.start(periodMicros);
 }
 
-void SensorFusion::updateSensors() {
-    for (auto& sensor : sensors) {
-        sensor->update();
+void SensorFusion::stopSampling() {
+    sampler_.stop();
+}
+
+bool SensorFusion::sampleSensors() {
+    return sampler_.service(Timer::currentTimeMicros());
+}
+
+bool SensorFusion::updateSensors() {
+    bool newData = false;
+    for (auto& slot : sensors) {
+        slot.sensor->update();
+        newData |= (slot.sensor->getUpdateCount() != slot.lastUpdateCount);
+    }
+    return newData;
+}
+
+void SensorFusion::checkSensorHealth() {
+    uint64_t now = Timer::currentTimeMicros();
+    for (auto& slot : sensors) {
+        if (slot.health.update(*slot.sensor, now)) {
+            char diagnostics[128];
+            slot.health.formatDiagnostics(diagnostics, sizeof(diagnostics), *slot.sensor);
+            logger_.logEvent(diagnostics);
+        }
+    }
+}
+
+void SensorFusion::logSchedulerStatistics() {
+    char summary[96];
+    snprintf(summary, sizeof(summary), "SAMPLER ticks=%lu coalesced=%lu",
+             static_cast<unsigned long>(sampler_.getTickCount()),
+             static_cast<unsigned long>(sampler_.getCoalescedCount()));
+    logger_.logEvent(summary);
+    for (size_t i = 0; i < sampler_.getNumSources(); ++i) {
+        const SensorSchedule& schedule = sampler_.getSchedule(i);
+        char message[128];
+        snprintf(message, sizeof(message), "SCHEDULE %s: period=%luus performed=%lu skipped=%lu",
+                 sampler_.getSource(i).getSensorNames().c_str(),
+                 static_cast<unsigned long>(schedule.getPeriod()),
+                 static_cast<unsigned long>(schedule.getPerformedCount()),
+                 static_cast<unsigned long>(schedule.getSkippedCount()));
+        logger_.logEvent(message);
     }
 }
 
 void SensorFusion::updateFusedData() {
-    updateFusedAltitude();
-    updateFusedVerticalVelocity();
-    updateFusedAcceleration();
+    filter_.begin();
+    for (auto& slot : sensors) {
+        queueMeasurements(slot);
+    }
+    filter_.fuse(Timer::currentTimeMicros());
+
+    fusedAltitude_ = filter_.getAltitude();
+    fusedVerticalVelocity_ = filter_.getVelocity();
+    fusedAcceleration_ = filter_.getAcceleration();
 }
 
 float SensorFusion::getFusedAltitude() const {
@@ -67,12 +128,17 @@ size_t SensorFusion::getNumSensorValues() const {
     return numSensorValues_;
 }
 
-void SensorFusion::logSensorData() {
+size_t SensorFusion::getNumHealthySensors() const {
+    return std::count_if(sensors.begin(), sensors.end(),
+        [](const SensorSlot& slot) { return slot.health.isHealthy(); });
+}
+
+void SensorFusion::logSensorData(uint32_t deadlineMisses, uint32_t pyroStates) {
     
     // Write title for logging file
-    logger_.addDataFileHeading(dataHeaderString_);
+    logger_.addDataFileHeading(dataHeaderString_.c_str());
 
-    size_t combinedDataLength = numSensorValues_+ numFusedDataPoints_;
+    size_t combinedDataLength = numSensorValues_+ numFusedDataPoints_ + 2;
 
     float combinedData[combinedDataLength];
 
@@ -82,95 +148,80 @@ void SensorFusion::logSensorData() {
 
     // Copy data from each sensor into the combined array
     size_t offset = numFusedDataPoints_;
-    for (const auto& sensor : sensors) {
-        float* sensorData = sensor->getRawData();
-        size_t sensorDataSize = sensor->getNumSensorValues();
+    for (const auto& slot : sensors) {
+        float* sensorData = slot.sensor->getRawData();
+        size_t sensorDataSize = slot.sensor->getNumSensorValues();
         std::memcpy(combinedData + offset, sensorData, sensorDataSize * sizeof(float));
         offset += sensorDataSize;
     }
+    combinedData[offset] = deadlineMisses;
+    combinedData[offset + 1] = pyroStates;
     // Log the combined array
     logger_.logData(combinedData, combinedDataLength);
 }
 
 
-void SensorFusion::updateFusedAltitude() {
-    float totalAltitude = 0.0;
-    for (const auto& sensor : sensors) {
-        totalAltitude += sensor->getAltitude();
+void SensorFusion::queueMeasurements(SensorSlot& slot) {
+    uint32_t updateCount = slot.sensor->getUpdateCount();
+    if (updateCount == slot.lastUpdateCount) {
+        return; // Nothing new since the last correction
     }
-    // Simple averaging for now
-    fusedAltitude_ = totalAltitude / sensors.size(); 
-}
+    slot.lastUpdateCount = updateCount;
 
-void SensorFusion::updateFusedVerticalVelocity() {
-    float totalVelocity = 0.0;
-    for (const auto& sensor : sensors) {
-        totalVelocity += sensor->getVerticalVelocity();
+    if (!slot.health.isHealthy()) {
+        return; // Excluded until the sensor recovers
     }
-    // Simple averaging for now
-    fusedVerticalVelocity_ = totalVelocity / sensors.size(); 
+    // addSensor() holds no more sensors than the sampler, which the filter can always queue
+    filter_.queue(*slot.sensor);
 }
 
-void SensorFusion::updateFusedAcceleration() {
-    float totalAcceleration = 0.0;
-    for (const auto& sensor : sensors) {
-        totalAcceleration += sensor->getAcceleration();
+void SensorFusion::updateExtremes() {
+    extremes_.begin();
+    for (const auto& slot : sensors) {
+        if (slot.health.isHealthy()) {
+            extremes_.add(*slot.sensor);
+        }
     }
-    // Simple averaging for now
-    fusedAcceleration_ = totalAcceleration / sensors.size(); 
+    // With no healthy sensor the last values are kept
+    extremes_.latch();
 }
 
 float SensorFusion::getGroundAltitude() const {
-    float groundAltitude = 0;
-    for (const auto& sensor : sensors) {
-        groundAltitude += sensor->getGroundAltitude();
-    }
-    return groundAltitude / sensors.size(); // Simple averaging for now
+    return extremes_.getGroundAltitude();
 }
 
 float SensorFusion::getMaxVelocity() const {
-    float maxVelocity = 0;
-    for (const auto& sensor : sensors) {
-        maxVelocity += sensor->getMaxVelocity();
-    }
-    return maxVelocity / sensors.size(); // Simple averaging for now
+    return extremes_.getMaxVelocity();
 }
 
 float SensorFusion::getMaxAltitude() const {
-    float maxAltitude = 0;
-    for (const auto& sensor : sensors) {
-        maxAltitude += sensor->getMaxAltitude();
-    }
-    return maxAltitude / sensors.size(); // Simple averaging for now
+    return extremes_.getMaxAltitude();
 }
 
 float SensorFusion::getMaxAcceleration() const {
-    float maxAcceleration = 0;
-    for (const auto& sensor : sensors) {
-        maxAcceleration += sensor->getMaxAcceleration();
-    }
-    return maxAcceleration / sensors.size(); // Simple averaging for now
+    return extremes_.getMaxAcceleration();
 }
 
 void SensorFusion::calculateNumSensorValues() {
     size_t totalSize = 0;
-    for (const auto& sensor : sensors) {
-        totalSize += sensor->getNumSensorValues();
+    for (const auto& slot : sensors) {
+        totalSize += slot.sensor->getNumSensorValues();
     }
     // assign to private member variable
     numSensorValues_ = totalSize;
 }
 
 void SensorFusion::writeDataHeaderString() {
-    std::string header = "time";
+    std::string header = "time_us";
     header+= "," + getFusedDataString();
-    for (const auto& sensor : sensors) {
-        std::string names = sensor->getSensorNames();
+    for (const auto& slot : sensors) {
+        std::string names = slot.sensor->getSensorNames();
         if (!names.empty()) {
             header += "," + names;
         }
     }
-    dataHeaderString_ = header.c_str();
+    header += ",deadline_misses,pyro_states";
+    dataHeaderString_ = header;
 }
 
 std::string SensorFusion::getFusedDataString() {
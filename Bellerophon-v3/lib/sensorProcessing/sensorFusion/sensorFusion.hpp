@@ -5,23 +5,63 @@
 #include <memory>
 #include <algorithm>
 #include <cstring>
+#include <cmath>
 #include "sensorProcessor.hpp"
 #include "dataLogger.hpp"
+#include "timeOrderedFilter.hpp"
+#include "sensorHealthMonitor.hpp"
+#include "fusedExtremes.hpp"
+#include "sensorSampler.hpp"
+#include "constants.hpp"
+#include "timer.hpp"
+#include "profiler.hpp"
 
 /**
  * @class SensorFusion
  * @brief Combines data from multiple sensor processors to produce fused estimates of altitude, velocity, and acceleration.
+ *
+ * The fused estimates come from a TimeOrderedFilter. Each update feeds it the
+ * measurements every healthy sensor made since the last one, which it
+ * predicts to and corrects with in acquisition order. Ground and maximum values
+ * are inverse-variance weighted averages, so a sensor without an estimate, or
+ * with an infinite variance, gets zero weight. They are latched every update,
+ * so a sensor leaving fusion keeps the last ground altitude and can never
+ * lower a maximum.
+ *
+ * Sensors are acquired through a SensorSampler on a timer tick, each once
+ * the period it declares has passed. update() processes the queued samples
+ * and the filter only runs when there was new data.
+ *
+ * Each sensor has a health monitor. A sensor that goes stale, sticks, floods
+ * outliers or bus errors is left out of fusion until it recovers, and every
+ * change in health is written to the log.
  */
 class SensorFusion {
+    static_assert(TimeOrderedFilter::MAX_SOURCES >= SensorSampler::MAX_SOURCES,
+                  "Every sampled sensor must fit in one fusion pass");
+
 private:
-    std::vector<std::shared_ptr<SensorProcessor>> sensors; ///< Vector of shared pointers to sensor processors
+    /**
+     * @struct SensorSlot
+     * @brief A sensor processor, the update count last fused from it and its health.
+     */
+    struct SensorSlot {
+        std::shared_ptr<SensorProcessor> sensor; ///< The sensor processor
+        uint32_t lastUpdateCount; ///< Update count of the sensor when last fused
+        SensorHealthMonitor health; ///< Health of the sensor
+    };
+
+    std::vector<SensorSlot> sensors; ///< Sensor processors and their fusion state
+    SensorSampler sampler_; ///< Acquires the sensors on a timer tick
+    TimeOrderedFilter filter_; ///< Fuses the measurements in acquisition order
     DataLogger& logger_; ///< Reference to the DataLogger instance
     size_t numFusedDataPoints_; ///< Number of fused data points (e.g., altitude, velocity, acceleration)
     size_t numSensorValues_; ///< Total number of sensor values
-    const char* dataHeaderString_; ///< Header string for the logged data
+    std::string dataHeaderString_; ///< Header string for the logged data
     float fusedAltitude_; ///< Fused altitude value
     float fusedVerticalVelocity_; ///< Fused vertical velocity value
     float fusedAcceleration_; ///< Fused acceleration value
+    FusedExtremes extremes_; ///< Latched ground and maximum values of the healthy sensors
 
     /**
      * @brief Calculates the total number of sensor values.
@@ -35,19 +75,15 @@ private:
     void updateSensorInformation();
 
     /**
-     * @brief Updates the fused altitude from all sensors.
+     * @brief Queues the new measurements of a healthy sensor for fusion.
+     * @param slot The sensor slot to read from.
      */
-    void updateFusedAltitude();
-    
-    /**
-     * @brief Updates the fused vertical velocity from all sensors.
-     */
-    void updateFusedVerticalVelocity();
+    void queueMeasurements(SensorSlot& slot);
 
     /**
-     * @brief Updates the fused acceleration from all sensors.
+     * @brief Latches the ground and maximum values of the healthy sensors.
      */
-    void updateFusedAcceleration();
+    void updateExtremes();
 
     /**
      * @brief Updates all fused data values.
@@ -55,9 +91,15 @@ private:
     void updateFusedData();
 
     /**
-     * @brief Updates all sensors in the fusion system.
+     * @brief Processes the samples queued by every sensor.
+     * @return true if any sensor produced new data.
      */
-    void updateSensors();
+    bool updateSensors();
+
+    /**
+     * @brief Checks the health of every sensor, logging any change.
+     */
+    void checkSensorHealth();
 
     /**
      * @brief Generates a string representing the fused data headers.
@@ -66,6 +108,8 @@ private:
     std::string getFusedDataString();
 
 public:
+    static constexpr uint32_t DEFAULT_SAMPLING_PERIOD = 1000; ///< 1 kHz sampling tick (us)
+
     /**
      * @brief Constructor for the SensorFusion class.
      * @param logger Reference to the DataLogger instance.
@@ -87,7 +131,28 @@ public:
     bool removeSensor(const std::shared_ptr<SensorProcessor>& sensor);
 
     /**
-     * @brief Updates the fusion system by updating all sensors and fused data.
+     * @brief Starts the sampling tick. The sensors are then read by sampleSensors().
+     * @param periodMicros Time between sampling ticks (us).
+     * @return true if sampling started.
+     */
+    bool startSampling(uint32_t periodMicros = DEFAULT_SAMPLING_PERIOD);
+
+    /**
+     * @brief Stops acquiring the sensors.
+     */
+    void stopSampling();
+
+    /**
+     * @brief Reads the sensors that are due if a sampling tick has passed.
+     * Runs the bus transactions, so call it from the control loop task rather
+     * than an interrupt, as often as the task runs.
+     * @return true if a tick was serviced.
+     */
+    bool sampleSensors();
+
+    /**
+     * @brief Updates the fusion system by processing the queued sensor samples
+     * and, if there were any, the fused data.
      */
     void update();
 
@@ -142,8 +207,10 @@ public:
 
     /**
      * @brief Logs sensor data by combining fused data and individual sensor data.
+     * @param deadlineMisses Control loop deadline misses so far.
+     * @param pyroStates Pyro channel states as a bitfield, see PyroScheduler::getChannelStates(), logged as the last column.
      */
-    void logSensorData();
+    void logSensorData(uint32_t deadlineMisses = 0, uint32_t pyroStates = 0);
 
     /**
      * @brief Writes the data header string for logging.
@@ -155,6 +222,17 @@ public:
      * @return Total number of sensor values.
      */
     size_t getNumSensorValues() const;
+
+    /**
+     * @brief Gets the number of sensors currently used in fusion.
+     * @return Number of healthy sensors.
+     */
+    size_t getNumHealthySensors() const;
+
+    /**
+     * @brief Logs how many updates of each sensor were performed and skipped.
+     */
+    void logSchedulerStatistics();
 };
 
 #endif // SENSOR_FUSION_HPP
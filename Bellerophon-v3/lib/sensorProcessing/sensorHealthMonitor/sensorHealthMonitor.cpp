@@ -0,0 +1,106 @@
+#include "sensorHealthMonitor.hpp"
+#include <cstdio>
+
+SensorHealthMonitor::SensorHealthMonitor(const SensorHealthLimits& limits)
+    : limits_(limits), faults_(NONE), windowFaults_(NONE), started_(false), lastUpdateCount_(0),
+      lastNewDataTime_(0), windowStart_(0), windowUpdates_(0), windowStartErrors_(0), updateRate_(0),
+      lastRawValues_{}, identicalUpdates_(0) {}
+
+bool SensorHealthMonitor::update(const SensorProcessor& sensor, uint64_t now) {
+    uint8_t previousFaults = faults_;
+
+    if (!started_) {
+        // Start the clocks on the first check so startup time is not counted as stale
+        started_ = true;
+        lastUpdateCount_ = sensor.getUpdateCount();
+        lastNewDataTime_ = now;
+        windowStart_ = now;
+        windowStartErrors_ = sensor.getErrorCount();
+        rawValuesUnchanged(sensor);
+        return false;
+    }
+
+    uint32_t updateCount = sensor.getUpdateCount();
+    if (updateCount != lastUpdateCount_) {
+        lastUpdateCount_ = updateCount;
+        lastNewDataTime_ = now;
+        windowUpdates_++;
+        identicalUpdates_ = rawValuesUnchanged(sensor) ? identicalUpdates_ + 1 : 0;
+    }
+
+    // Immediate checks, latched until the end of the window
+    uint8_t detected = NONE;
+    if (now - lastNewDataTime_ > limits_.staleMicros) {
+        detected |= STALE;
+    }
+    if (identicalUpdates_ >= limits_.stuckLimit) {
+        detected |= STUCK;
+    }
+    if (sensor.getOutlierRatio() > limits_.maxOutlierRatio) {
+        detected |= OUTLIERS;
+    }
+    if (sensor.getErrorCount() - windowStartErrors_ > limits_.maxErrorsPerWindow) {
+        detected |= BUS_ERRORS;
+    }
+    windowFaults_ |= detected;
+    faults_ |= detected;
+
+    if (now - windowStart_ >= limits_.windowMicros) {
+        closeWindow(sensor, now);
+    }
+
+    return faults_ != previousFaults;
+}
+
+void SensorHealthMonitor::closeWindow(const SensorProcessor& sensor, uint64_t now) {
+    updateRate_ = windowUpdates_ * 1e6f / static_cast<float>(now - windowStart_);
+    if (updateRate_ < limits_.minUpdateRate) {
+        windowFaults_ |= LOW_RATE;
+    }
+
+    // Only faults seen during this window stay active
+    faults_ = windowFaults_;
+
+    windowFaults_ = NONE;
+    windowStart_ = now;
+    windowUpdates_ = 0;
+    windowStartErrors_ = sensor.getErrorCount();
+}
+
+bool SensorHealthMonitor::rawValuesUnchanged(const SensorProcessor& sensor) {
+    size_t count = sensor.getNumSensorValues();
+    if (count > MAX_RAW_VALUES) {
+        count = MAX_RAW_VALUES;
+    }
+
+    float* values = sensor.getRawData();
+    bool unchanged = true;
+    for (size_t i = 0; i < count; ++i) {
+        if (values[i] != lastRawValues_[i]) {
+            unchanged = false;
+        }
+        lastRawValues_[i] = values[i];
+    }
+    return unchanged;
+}
+
+bool SensorHealthMonitor::isHealthy() const {
+    return faults_ == NONE;
+}
+
+uint8_t SensorHealthMonitor::getFaults() const {
+    return faults_;
+}
+
+float SensorHealthMonitor::getUpdateRate() const {
+    return updateRate_;
+}
+
+int SensorHealthMonitor::formatDiagnostics(char* buffer, size_t size, const SensorProcessor& sensor) const {
+    return snprintf(buffer, size, "HEALTH %s: %s faults=0x%02X%s%s%s%s%s rate=%.1fHz outliers=%.2f errors=%lu",
+                    sensor.getSensorNames().c_str(), isHealthy() ? "OK" : "EXCLUDED", faults_,
+                    (faults_ & STALE) ? " stale" : "", (faults_ & LOW_RATE) ? " low_rate" : "",
+                    (faults_ & STUCK) ? " stuck" : "", (faults_ & OUTLIERS) ? " outliers" : "",
+                    (faults_ & BUS_ERRORS) ? " bus_errors" : "", updateRate_, sensor.getOutlierRatio(),
+                    static_cast<unsigned long>(sensor.getErrorCount()));
+}
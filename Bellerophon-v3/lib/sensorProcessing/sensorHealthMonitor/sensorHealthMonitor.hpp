@@ -0,0 +1,129 @@
+#ifndef SENSOR_HEALTH_MONITOR_HPP
+#define SENSOR_HEALTH_MONITOR_HPP
+
+#include <cstddef>
+#include <stdint.h>
+#include "sensorProcessor.hpp"
+
+/**
+ * @struct SensorHealthLimits
+ * @brief Thresholds beyond which a sensor is considered unhealthy.
+ */
+struct SensorHealthLimits {
+    uint32_t windowMicros = 1000000;    ///< Length of a rate, outlier and error window (us)
+    uint32_t staleMicros = 500000;      ///< Time without new data before the sensor is stale (us)
+    float minUpdateRate = 10.0f;        ///< Minimum new data rate over a window (Hz)
+    uint32_t stuckLimit = 50;           ///< Consecutive identical updates before the sensor is stuck
+    float maxOutlierRatio = 0.5f;       ///< Maximum recent fraction of rejected samples
+    uint32_t maxErrorsPerWindow = 5;    ///< Maximum bus errors within a window
+};
+
+/**
+ * @class SensorHealthMonitor
+ * @brief Tracks the health of one sensor processor from its observable behaviour.
+ *
+ * Watches the new data rate, time since the last new data, raw values that
+ * stop changing, the outlier rejection ratio and the bus error count. Faults
+ * are latched for the rest of a window and cleared once a full window
+ * passes without them, so a flickering sensor does not toggle in and out of
+ * fusion. The monitor does not touch the sensor; the sensor keeps updating
+ * while unhealthy so it can recover.
+ */
+class SensorHealthMonitor {
+public:
+    /**
+     * @enum Fault
+     * @brief Bit flags of the detected faults.
+     */
+    enum Fault : uint8_t {
+        NONE = 0,
+        STALE = 1 << 0,      ///< No new data within the stale timeout
+        LOW_RATE = 1 << 1,   ///< New data rate below the minimum over the last window
+        STUCK = 1 << 2,      ///< Raw values identical across many updates
+        OUTLIERS = 1 << 3,   ///< Too many samples rejected as outliers
+        BUS_ERRORS = 1 << 4  ///< Too many failed bus transactions in the last window
+    };
+
+    static constexpr size_t MAX_RAW_VALUES = 8; ///< Raw values compared for stuck detection
+
+    /**
+     * @brief Constructor for SensorHealthMonitor.
+     * 
+     * @param limits Thresholds for each fault.
+     */
+    explicit SensorHealthMonitor(const SensorHealthLimits& limits = SensorHealthLimits());
+
+    /**
+     * @brief Check the sensor after it has been updated.
+     * 
+     * @param sensor The sensor processor to check.
+     * @param now Current time from Timer::currentTimeMicros() (us).
+     * @return True if the health of the sensor changed.
+     */
+    bool update(const SensorProcessor& sensor, uint64_t now);
+
+    /**
+     * @brief Check if the sensor is healthy enough to fuse.
+     * 
+     * @return True if no faults are active.
+     */
+    bool isHealthy() const;
+
+    /**
+     * @brief Get the active faults.
+     * 
+     * @return Bitwise OR of Fault flags.
+     */
+    uint8_t getFaults() const;
+
+    /**
+     * @brief Get the new data rate measured over the last complete window.
+     * 
+     * @return Update rate (Hz).
+     */
+    float getUpdateRate() const;
+
+    /**
+     * @brief Format a one line diagnostics record for the log.
+     * 
+     * @param buffer The buffer to write into.
+     * @param size The size of the buffer.
+     * @param sensor The sensor the record describes.
+     * @return The number of characters written, as snprintf.
+     */
+    int formatDiagnostics(char* buffer, size_t size, const SensorProcessor& sensor) const;
+
+private:
+    SensorHealthLimits limits_; ///< Fault thresholds
+    uint8_t faults_; ///< Active faults
+    uint8_t windowFaults_; ///< Faults seen during the current window
+    bool started_; ///< True once the first check has run
+
+    uint32_t lastUpdateCount_; ///< Sensor update count at the last check
+    uint64_t lastNewDataTime_; ///< Time new data was last seen (us)
+    uint64_t windowStart_; ///< Start of the current window (us)
+    uint32_t windowUpdates_; ///< New data seen during the current window
+    uint32_t windowStartErrors_; ///< Sensor error count at the start of the window
+    float updateRate_; ///< Update rate over the last complete window (Hz)
+
+    float lastRawValues_[MAX_RAW_VALUES]; ///< Raw values at the last new data
+    uint32_t identicalUpdates_; ///< Consecutive updates with identical raw values
+
+    /**
+     * @brief Compare new raw values with the previous ones.
+     * 
+     * @param sensor The sensor to read.
+     * @return True if every compared value is unchanged.
+     */
+    bool rawValuesUnchanged(const SensorProcessor& sensor);
+
+    /**
+     * @brief Close the current window, measuring its rate and settling faults.
+     * 
+     * @param sensor The sensor being checked.
+     * @param now Current time (us).
+     */
+    void closeWindow(const SensorProcessor& sensor, uint64_t now);
+};
+
+#endif // SENSOR_HEALTH_MONITOR_HPP
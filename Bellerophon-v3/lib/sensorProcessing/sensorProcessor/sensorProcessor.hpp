@@ -3,8 +3,19 @@
 #define SENSOR_PROCESSOR_HPP
 
 #include <cstddef>
+#include <stdint.h>
 #include <string>
 
+/**
+ * @enum SensorOutput
+ * @brief Estimates a sensor processor can provide to sensor fusion.
+ */
+enum class SensorOutput {
+    ALTITUDE,          ///< Altitude above ground (m)
+    VERTICAL_VELOCITY, ///< Vertical velocity (m/s)
+    ACCELERATION       ///< Vertical acceleration, excluding gravity (m/s^2)
+};
+
 /**
  * @class SensorProcessor
  * @brief Abstract base class for sensor data processing.
@@ -28,6 +39,142 @@ public:
      */
     virtual void update() = 0;
 
+    /**
+     * @brief Read the sensor hardware into a queue for update().
+     *
+     * Called by SensorSampler from the control loop when the sensor is due
+     * on a sampling tick, and shares state with update() through a lock-free
+     * queue. Defaults to nothing for sensors read directly in update().
+     * 
+     * @param now Current time (us).
+     */
+    virtual void acquire(uint64_t /* now */) {}
+
+    /**
+     * @brief Check if the sensor currently provides an estimate of an output.
+     *
+     * Sensors that can not measure an output, or are not yet calibrated,
+     * return false and their getter for that output must be ignored.
+     * 
+     * @param output The output to check.
+     * @return True if the estimate is available.
+     */
+    virtual bool hasEstimate(SensorOutput output) const = 0;
+
+    /**
+     * @brief Get the noise variance of an output's measurement.
+     *
+     * Measured online where the sensor can, otherwise from a configured noise
+     * model. Used to weight the sensor against others in fusion, so outputs
+     * without an estimate should return infinity.
+     * 
+     * @param output The output to query.
+     * @return Variance, in the output's units squared.
+     */
+    virtual float getVariance(SensorOutput output) const = 0;
+
+    /**
+     * @brief Get a counter that changes whenever the sensor has new data.
+     *
+     * Lets consumers running faster than the sensor skip repeated samples.
+     * 
+     * @return Update counter.
+     */
+    virtual uint32_t getUpdateCount() const = 0;
+
+    /**
+     * @brief Get the number of communication errors since startup.
+     *
+     * Defaults to 0 for sensors that can not detect errors.
+     * 
+     * @return Number of failed bus transactions.
+     */
+    virtual uint32_t getErrorCount() const {
+        return 0;
+    }
+
+    /**
+     * @brief Get the recent fraction of samples rejected as outliers.
+     *
+     * Defaults to 0 for sensors without outlier rejection.
+     * 
+     * @return Rejection ratio, 0 to 1.
+     */
+    virtual float getOutlierRatio() const {
+        return 0;
+    }
+
+    /**
+     * @brief Get the time between new samples from the sensor.
+     *
+     * SensorSampler only calls acquire() once this period has passed since
+     * the last call. Defaults to 0 to acquire on every tick.
+     * 
+     * @return Update period (us).
+     */
+    virtual uint32_t getUpdatePeriod() const {
+        return 0;
+    }
+
+    /**
+     * @brief Get the latest unsmoothed measurement of an output.
+     *
+     * For consumers that do their own filtering, such as a Kalman filter.
+     * Defaults to the output's getter.
+     * 
+     * @param output The output to measure.
+     * @return Latest measurement.
+     */
+    virtual float getMeasurement(SensorOutput output) const {
+        switch (output) {
+            case SensorOutput::ALTITUDE:
+                return getAltitude();
+            case SensorOutput::VERTICAL_VELOCITY:
+                return getVerticalVelocity();
+            case SensorOutput::ACCELERATION:
+                return getAcceleration();
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Get the number of measurements made by the last update().
+     *
+     * Fusion corrects with each of them in acquisition order. Defaults to
+     * one, the latest measurement.
+     * 
+     * @return Number of new measurements.
+     */
+    virtual size_t getNumNewMeasurements() const {
+        return 1;
+    }
+
+    /**
+     * @brief Get an unsmoothed measurement made by the last update().
+     *
+     * Defaults to the latest measurement.
+     * 
+     * @param output The output to measure.
+     * @param index Measurement index, below getNumNewMeasurements(), oldest first.
+     * @return The measurement.
+     */
+    virtual float getNewMeasurement(SensorOutput output, size_t /* index */) const {
+        return getMeasurement(output);
+    }
+
+    /**
+     * @brief Get the acquisition time of a measurement made by the last update().
+     *
+     * Defaults to 0 for sensors that do not timestamp their samples, which
+     * fusion takes as the processing time.
+     * 
+     * @param index Measurement index, below getNumNewMeasurements(), oldest first.
+     * @return Acquisition time (us), 0 if unknown.
+     */
+    virtual uint64_t getNewMeasurementTime(size_t /* index */) const {
+        return 0;
+    }
+
     /**
      * @brief Get the current altitude from the sensor.
      *
@@ -0,0 +1,137 @@
+#include "sensorSampler.hpp"
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+
+namespace {
+    IntervalTimer tickTimer; // Hardware timer driving the tick
+}
+#else
+#include <chrono>
+#endif
+
+std::atomic<SensorSampler*> SensorSampler::active_(nullptr);
+
+SensorSampler::SensorSampler()
+    : numSources_(0), periodMicros_(0), running_(false), tickCount_(0), servicedTicks_(0), coalescedCount_(0) {}
+
+SensorSampler::~SensorSampler() {
+    stop();
+}
+
+bool SensorSampler::addSource(SensorProcessor& source) {
+    if (numSources_ >= MAX_SOURCES) {
+        return false;
+    }
+    sources_[numSources_++] = {&source, SensorSchedule(source.getUpdatePeriod())};
+    return true;
+}
+
+bool SensorSampler::removeSource(SensorProcessor& source) {
+    for (size_t i = 0; i < numSources_; ++i) {
+        if (sources_[i].processor != &source) {
+            continue;
+        }
+        for (size_t j = i + 1; j < numSources_; ++j) {
+            sources_[j - 1] = sources_[j];
+        }
+        numSources_--;
+        return true;
+    }
+    return false;
+}
+
+bool SensorSampler::start(uint32_t periodMicros) {
+    SensorSampler* expected = nullptr;
+    if (!active_.compare_exchange_strong(expected, this)) {
+        return expected == this; // Already running, or another sampler owns the tick
+    }
+    periodMicros_ = periodMicros;
+    running_ = true;
+
+#if defined(ARDUINO)
+    if (!tickTimer.begin(onTick, periodMicros)) {
+        running_ = false;
+        active_ = nullptr;
+        return false;
+    }
+#else
+    thread_ = std::thread([this]() {
+        auto next = std::chrono::steady_clock::now();
+        while (running_) {
+            onTick();
+            next += std::chrono::microseconds(periodMicros_);
+            std::this_thread::sleep_until(next);
+        }
+    });
+#endif
+    return true;
+}
+
+void SensorSampler::stop() {
+    if (active_ != this) {
+        return;
+    }
+#if defined(ARDUINO)
+    tickTimer.end();
+#endif
+    running_ = false;
+#if !defined(ARDUINO)
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+#endif
+    active_ = nullptr;
+}
+
+bool SensorSampler::isRunning() const {
+    return running_;
+}
+
+void SensorSampler::onTick() {
+    SensorSampler* sampler = active_.load();
+    if (sampler == nullptr) {
+        return;
+    }
+    // Only count the tick, the bus is read by service() in the control loop
+    sampler->tickCount_.store(sampler->tickCount_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+bool SensorSampler::service(uint64_t now) {
+    uint32_t ticks = tickCount_.load(std::memory_order_acquire);
+    if (ticks == servicedTicks_) {
+        return false;
+    }
+    coalescedCount_ += ticks - servicedTicks_ - 1;
+    servicedTicks_ = ticks;
+    sample(now);
+    return true;
+}
+
+void SensorSampler::sample(uint64_t now) {
+    for (size_t i = 0; i < numSources_; ++i) {
+        if (sources_[i].schedule.isDue(now)) {
+            sources_[i].processor->acquire(now);
+        }
+    }
+}
+
+size_t SensorSampler::getNumSources() const {
+    return numSources_;
+}
+
+const SensorProcessor& SensorSampler::getSource(size_t index) const {
+    return *sources_[index].processor;
+}
+
+const SensorSchedule& SensorSampler::getSchedule(size_t index) const {
+    return sources_[index].schedule;
+}
+
+uint32_t SensorSampler::getTickCount() const {
+    return tickCount_.load(std::memory_order_relaxed);
+}
+
+uint32_t SensorSampler::getCoalescedCount() const {
+    return coalescedCount_;
+}
@@ -0,0 +1,165 @@
+#ifndef SENSOR_SAMPLER_HPP
+#define SENSOR_SAMPLER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+#include "sensorProcessor.hpp"
+#include "sensorScheduler.hpp"
+
+#if !defined(ARDUINO)
+#include <thread>
+#endif
+
+/**
+ * @class SensorSampler
+ * @brief Acquires sensor data on a periodic timer tick.
+ *
+ * The tick interrupt only counts the tick. service(), called from the
+ * control loop task, then calls SensorProcessor::acquire() on the sources
+ * that are due by their declared update period, so the blocking bus
+ * transactions never run inside the interrupt. The sources queue their
+ * samples for update(). Ticks that pass while the loop is busy are
+ * serviced once, and counted as coalesced.
+ *
+ * On the Teensy the tick is an IntervalTimer. The host build runs the same
+ * tick on a thread so the tick count is exercised concurrently.
+ */
+class SensorSampler {
+public:
+    static constexpr size_t MAX_SOURCES = 4; ///< Sources a sampler can hold
+
+    /**
+     * @brief Constructor for SensorSampler.
+     */
+    SensorSampler();
+
+    /**
+     * @brief Destructor, stops sampling.
+     */
+    ~SensorSampler();
+
+    SensorSampler(const SensorSampler&) = delete;
+    SensorSampler& operator=(const SensorSampler&) = delete;
+
+    /**
+     * @brief Add a source. Not called from the tick, so sampling keeps running.
+     * 
+     * @param source The sensor processor to acquire, which must outlive the sampler or be removed.
+     * @return True if added, false if the sampler is full.
+     */
+    bool addSource(SensorProcessor& source);
+
+    /**
+     * @brief Remove a source.
+     * 
+     * @param source The sensor processor to remove.
+     * @return True if the source was found and removed.
+     */
+    bool removeSource(SensorProcessor& source);
+
+    /**
+     * @brief Start the periodic tick.
+     * 
+     * @param periodMicros Time between ticks (us).
+     * @return True if started, false if another sampler already owns the tick.
+     */
+    bool start(uint32_t periodMicros);
+
+    /**
+     * @brief Stop the periodic tick.
+     */
+    void stop();
+
+    /**
+     * @brief Check if the tick is running.
+     * 
+     * @return True if running.
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Acquire from the due sources if a tick has passed since the last call.
+     *
+     * Called from the control loop task, never from an interrupt.
+     * 
+     * @param now Current time (us).
+     * @return True if a tick was serviced.
+     */
+    bool service(uint64_t now);
+
+    /**
+     * @brief Acquire from every source that is due.
+     * 
+     * @param now Current time (us).
+     */
+    void sample(uint64_t now);
+
+    /**
+     * @brief Get the number of sources.
+     * 
+     * @return Number of sources.
+     */
+    size_t getNumSources() const;
+
+    /**
+     * @brief Get a source.
+     * 
+     * @param index Source index, below getNumSources().
+     * @return The sensor processor.
+     */
+    const SensorProcessor& getSource(size_t index) const;
+
+    /**
+     * @brief Get the schedule of a source, with its performed and skipped counts.
+     * 
+     * @param index Source index, below getNumSources().
+     * @return The schedule.
+     */
+    const SensorSchedule& getSchedule(size_t index) const;
+
+    /**
+     * @brief Get the number of ticks run.
+     * 
+     * @return Number of ticks.
+     */
+    uint32_t getTickCount() const;
+
+    /**
+     * @brief Get the number of ticks merged into a later service() because the loop was busy.
+     * 
+     * @return Number of coalesced ticks.
+     */
+    uint32_t getCoalescedCount() const;
+
+private:
+    /**
+     * @struct Source
+     * @brief A sensor processor and when it is next due.
+     */
+    struct Source {
+        SensorProcessor* processor = nullptr; ///< The sensor processor
+        SensorSchedule schedule; ///< When the processor is next due
+    };
+
+    Source sources_[MAX_SOURCES]; ///< Sources acquired by the tick
+    size_t numSources_; ///< Number of sources
+    uint32_t periodMicros_; ///< Time between ticks (us)
+    std::atomic<bool> running_; ///< True while the tick is running
+    std::atomic<uint32_t> tickCount_; ///< Ticks run, written only by the tick
+    uint32_t servicedTicks_; ///< Tick count at the last service()
+    uint32_t coalescedCount_; ///< Ticks merged into a later service()
+
+    static std::atomic<SensorSampler*> active_; ///< Sampler that owns the tick
+
+#if !defined(ARDUINO)
+    std::thread thread_; ///< Thread standing in for the timer interrupt on the host
+#endif
+
+    /**
+     * @brief Timer interrupt handler, counts a tick of the active sampler.
+     */
+    static void onTick();
+};
+
+#endif // SENSOR_SAMPLER_HPP
@@ -0,0 +1,38 @@
+#include "sensorScheduler.hpp"
+
+SensorSchedule::SensorSchedule(uint32_t periodMicros)
+    : period_(periodMicros), nextDue_(0), performed_(0), skipped_(0) {}
+
+bool SensorSchedule::isDue(uint64_t now) {
+    if (now < nextDue_) {
+        skipped_++;
+        return false;
+    }
+
+    performed_++;
+    if (nextDue_ == 0 || now - nextDue_ >= period_) {
+        // First or more than a period late, restart from now rather than catching up
+        nextDue_ = now + period_;
+    } else {
+        // Keep the phase so small delays do not accumulate
+        nextDue_ += period_;
+    }
+    return true;
+}
+
+void SensorSchedule::setPeriod(uint32_t periodMicros) {
+    period_ = periodMicros;
+    nextDue_ = 0;
+}
+
+uint32_t SensorSchedule::getPeriod() const {
+    return period_;
+}
+
+uint32_t SensorSchedule::getPerformedCount() const {
+    return performed_;
+}
+
+uint32_t SensorSchedule::getSkippedCount() const {
+    return skipped_;
+}
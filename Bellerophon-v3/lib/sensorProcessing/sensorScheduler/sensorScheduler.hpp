@@ -0,0 +1,70 @@
+#ifndef SENSOR_SCHEDULER_HPP
+#define SENSOR_SCHEDULER_HPP
+
+#include <stdint.h>
+
+/**
+ * @class SensorSchedule
+ * @brief Decides when a sensor is due to be sampled.
+ *
+ * A sensor declares the period at which it produces new data. Reading it
+ * more often only repeats bus transactions that return the same sample, so
+ * passes before the next due time are skipped. A late pass samples
+ * immediately and the next due time is taken from it, so a stalled loop does
+ * not cause a burst of back to back reads. A period of 0 samples every pass.
+ *
+ * Performed and skipped passes are counted to measure the saving.
+ */
+class SensorSchedule {
+public:
+    /**
+     * @brief Constructor for SensorSchedule.
+     * 
+     * @param periodMicros Time between new sensor data (us), 0 for every pass.
+     */
+    explicit SensorSchedule(uint32_t periodMicros = 0);
+
+    /**
+     * @brief Check if the sensor is due, advancing the schedule if it is.
+     * 
+     * @param now Current time from Timer::currentTimeMicros() (us).
+     * @return True if the sensor should be sampled on this pass.
+     */
+    bool isDue(uint64_t now);
+
+    /**
+     * @brief Change the sampling period, sampling on the next pass.
+     * 
+     * @param periodMicros Time between new sensor data (us), 0 for every pass.
+     */
+    void setPeriod(uint32_t periodMicros);
+
+    /**
+     * @brief Get the sampling period.
+     * 
+     * @return Time between samples (us).
+     */
+    uint32_t getPeriod() const;
+
+    /**
+     * @brief Get the number of passes the sensor was sampled on.
+     * 
+     * @return Number of performed samples.
+     */
+    uint32_t getPerformedCount() const;
+
+    /**
+     * @brief Get the number of passes skipped because the sensor was not due.
+     * 
+     * @return Number of skipped samples.
+     */
+    uint32_t getSkippedCount() const;
+
+private:
+    uint32_t period_; ///< Time between samples (us)
+    uint64_t nextDue_; ///< Time the sensor is next due (us)
+    uint32_t performed_; ///< Passes the sensor was sampled on
+    uint32_t skipped_; ///< Passes skipped before the due time
+};
+
+#endif // SENSOR_SCHEDULER_HPP
@@ -0,0 +1,75 @@
+#include "timeOrderedFilter.hpp"
+
+TimeOrderedFilter::TimeOrderedFilter(float modelSigma, float altitudeSigma, float accelerationSigma)
+    : filter_(modelSigma, altitudeSigma, accelerationSigma), lastPredictTime_(0), queued_{}, numQueued_(0) {}
+
+void TimeOrderedFilter::begin() {
+    numQueued_ = 0;
+}
+
+bool TimeOrderedFilter::queue(const SensorProcessor& sensor) {
+    if (numQueued_ >= MAX_SOURCES) {
+        return false;
+    }
+    queued_[numQueued_++] = {&sensor, sensor.getNumNewMeasurements(), 0};
+    return true;
+}
+
+void TimeOrderedFilter::fuse(uint64_t now) {
+    QueuedSensor* queued;
+    while ((queued = findNextMeasurement(now)) != nullptr) {
+        size_t index = queued->measurementIndex++;
+        correct(*queued->sensor, index, measurementTime(*queued, index, now));
+    }
+}
+
+TimeOrderedFilter::QueuedSensor* TimeOrderedFilter::findNextMeasurement(uint64_t now) {
+    QueuedSensor* next = nullptr;
+    uint64_t nextTime = 0;
+    for (size_t i = 0; i < numQueued_; ++i) {
+        QueuedSensor& queued = queued_[i];
+        if (queued.measurementIndex >= queued.numMeasurements) {
+            continue;
+        }
+        uint64_t time = measurementTime(queued, queued.measurementIndex, now);
+        if (next == nullptr || time < nextTime) {
+            next = &queued;
+            nextTime = time;
+        }
+    }
+    return next;
+}
+
+uint64_t TimeOrderedFilter::measurementTime(const QueuedSensor& queued, size_t index, uint64_t now) {
+    uint64_t time = queued.sensor->getNewMeasurementTime(index);
+    return (time != 0) ? time : now;
+}
+
+void TimeOrderedFilter::predict(uint64_t time) {
+    if (time <= lastPredictTime_) {
+        return; // Late measurements correct the current state
+    }
+    filter_.predict((time - lastPredictTime_) * 1e-6f);
+    lastPredictTime_ = time;
+}
+
+void TimeOrderedFilter::correct(const SensorProcessor& sensor, size_t index, uint64_t time) {
+    if (!filter_.isInitialised()) {
+        // The first altitude measurement initialises the filter, at the time it was made
+        if (sensor.hasEstimate(SensorOutput::ALTITUDE)) {
+            filter_.reset(sensor.getNewMeasurement(SensorOutput::ALTITUDE, index));
+            lastPredictTime_ = time;
+        }
+        return;
+    }
+
+    predict(time);
+    if (sensor.hasEstimate(SensorOutput::ALTITUDE)) {
+        filter_.updateAltitude(sensor.getNewMeasurement(SensorOutput::ALTITUDE, index),
+                               sensor.getVariance(SensorOutput::ALTITUDE));
+    }
+    if (sensor.hasEstimate(SensorOutput::ACCELERATION)) {
+        filter_.updateAcceleration(sensor.getNewMeasurement(SensorOutput::ACCELERATION, index),
+                                   sensor.getVariance(SensorOutput::ACCELERATION));
+    }
+}
@@ -0,0 +1,155 @@
+#ifndef TIME_ORDERED_FILTER_HPP
+#define TIME_ORDERED_FILTER_HPP
+
+#include <cstddef>
+#include <stdint.h>
+#include "sensorProcessor.hpp"
+#include "kalmanFilter.hpp"
+
+/**
+ * @class TimeOrderedFilter
+ * @brief Kalman filter fed with the new measurements of several sensors in acquisition order.
+ *
+ * Each pass queues the sensors with new measurements, then walks every
+ * queued measurement oldest first, predicting the filter to the
+ * measurement's timestamp before correcting it with the altitude or
+ * acceleration, weighted by the variance the sensor reports. Each sensor's
+ * measurements are already oldest first, so taking the oldest next one of
+ * all sensors merges them in time order without sorting. A measurement
+ * older than the filter, from a sensor with more latency, corrects the
+ * current state. The filter starts at the first altitude measurement and
+ * its time.
+ *
+ * Hardware independent, so the ordering can be tested natively with fake
+ * sensor processors.
+ */
+class TimeOrderedFilter {
+public:
+    static constexpr size_t MAX_SOURCES = 4; ///< Sensors a pass can queue, as many as a SensorSampler holds
+
+    /**
+     * @brief Constructor for TimeOrderedFilter.
+     * 
+     * @param modelSigma Standard deviation of the model, as jerk noise density (m/s^3).
+     * @param altitudeSigma Standard deviation of altitude measurements (m).
+     * @param accelerationSigma Standard deviation of acceleration measurements (m/s^2).
+     */
+    TimeOrderedFilter(float modelSigma, float altitudeSigma, float accelerationSigma);
+
+    /**
+     * @brief Start a pass, forgetting the sensors queued by the last one.
+     */
+    void begin();
+
+    /**
+     * @brief Queue the new measurements of a sensor for this pass.
+     * 
+     * @param sensor The sensor, which must outlive the pass.
+     * @return False if MAX_SOURCES sensors are already queued.
+     */
+    bool queue(const SensorProcessor& sensor);
+
+    /**
+     * @brief Predict and correct the filter with every queued measurement in time order.
+     * 
+     * @param now Processing time, used for measurements without a timestamp (us).
+     */
+    void fuse(uint64_t now);
+
+    /**
+     * @brief Check if an altitude measurement has started the filter.
+     * 
+     * @return True once the filter is initialised.
+     */
+    bool isInitialised() const {
+        return filter_.isInitialised();
+    }
+
+    /**
+     * @brief Get the time the filter state belongs to.
+     * 
+     * @return Time of the newest measurement predicted to (us), 0 before the first.
+     */
+    uint64_t getStateTime() const {
+        return lastPredictTime_;
+    }
+
+    /**
+     * @brief Get the filtered altitude.
+     * 
+     * @return Altitude (m).
+     */
+    float getAltitude() const {
+        return filter_.getAltitude();
+    }
+
+    /**
+     * @brief Get the filtered vertical velocity.
+     * 
+     * @return Vertical velocity (m/s).
+     */
+    float getVelocity() const {
+        return filter_.getVelocity();
+    }
+
+    /**
+     * @brief Get the filtered vertical acceleration.
+     * 
+     * @return Vertical acceleration (m/s^2).
+     */
+    float getAcceleration() const {
+        return filter_.getAcceleration();
+    }
+
+private:
+    /**
+     * @struct QueuedSensor
+     * @brief A sensor with measurements waiting to be fused this pass.
+     */
+    struct QueuedSensor {
+        const SensorProcessor* sensor; ///< The sensor processor
+        size_t numMeasurements; ///< New measurements to fuse this pass
+        size_t measurementIndex; ///< Index of the next measurement to fuse
+    };
+
+    KalmanFilter filter_; ///< Altitude, velocity and acceleration filter
+    uint64_t lastPredictTime_; ///< Time the filter state belongs to (us)
+    QueuedSensor queued_[MAX_SOURCES]; ///< Sensors queued this pass
+    size_t numQueued_; ///< Number of sensors queued this pass
+
+    /**
+     * @brief Find the sensor whose next queued measurement is the oldest.
+     * 
+     * @param now Processing time, used for measurements without a timestamp (us).
+     * @return The queued sensor, nullptr once every measurement has been fused.
+     */
+    QueuedSensor* findNextMeasurement(uint64_t now);
+
+    /**
+     * @brief Get the acquisition time of a queued measurement.
+     * 
+     * @param queued The queued sensor.
+     * @param index Measurement index.
+     * @param now Processing time, used for measurements without a timestamp (us).
+     * @return Acquisition time (us).
+     */
+    static uint64_t measurementTime(const QueuedSensor& queued, size_t index, uint64_t now);
+
+    /**
+     * @brief Predict the filter forward to a measurement's time.
+     * 
+     * @param time Acquisition time of the measurement (us).
+     */
+    void predict(uint64_t time);
+
+    /**
+     * @brief Correct the filter with one measurement from a sensor.
+     * 
+     * @param sensor The sensor to read from.
+     * @param index Measurement index.
+     * @param time Acquisition time of the measurement (us).
+     */
+    void correct(const SensorProcessor& sensor, size_t index, uint64_t time);
+};
+
+#endif // TIME_ORDERED_FILTER_HPP
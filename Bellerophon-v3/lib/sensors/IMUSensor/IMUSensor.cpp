@@ -1,123 +1,101 @@
 #include "IMUSensor.hpp"
 
+namespace {
+    constexpr uint8_t DEFAULT_POLL_RATE = 4; // 104 Hz until setPollRate() is called
+}
+
 IMUSensor::IMUSensor(TwoWire* i2c, uint8_t addr, uint8_t accelRange, uint16_t gyroRange)
-    : imu(i2c,addr), accelRange(accelRange), gyroRange(gyroRange) {
+    : bus_(*i2c), imu(bus_, addr), batch_{}, batchSize_(0), accelRange(accelRange), gyroRange(gyroRange),
+      gyroData_{0, 0, 0}, accelData_{0, 0, 0}, timestamp_(0) {
 
     initialize();        
 }
 
-// Initialize the IMU sensor
+// Record the ranges and FIFO rate, the driver sets up the part from the first acquire() once the bus is running
 void IMUSensor::initialize() {
-    imu.begin();
-    enable();
-    
-    // check sensitivity values, unusued for now
-    LSM6DSLStatusTypeDef status = imu.Get_X_Sensitivity(&accelSense);
-    if (status != LSM6DSL_STATUS_OK) {
-        Serial.println("Error retrieving accelerometer sensitivity.");
-        return;
-    }
-    status = imu.Get_G_Sensitivity(&gyroSense);
-    if (status != LSM6DSL_STATUS_OK) {
-        Serial.println("Error retrieving gyroscope sensitivity.");
-        return;
-    }
+    imu.configure(DEFAULT_POLL_RATE, accelRange, gyroRange);
 }
 
-// Enable the IMU sensor
-void IMUSensor::enable() {
-    imu.Enable_X();
-    imu.Enable_G();
-    imu.Set_X_FS(accelRange);
-    imu.Set_G_FS(gyroRange);
+// Get the newest accelerometer data as an array, in m/s^2
+float* IMUSensor::getAccelerometerData() {
+    return accelData_;
 }
 
-// Get accelerometer data as an array
-// TODO: adjust for gravity, currently g = 1. Weird...
-float* IMUSensor::getAccelerometerData() {
-    static float accelData[3]; // Array to hold accelerometer data: [accel_x, accel_y, accel_z]
+// Get the newest gyroscope data as an array, in deg/s
+float* IMUSensor::getGyroscopeData() {
+    return gyroData_;
+}
 
-    // Convert raw accelerometer data to physical units and store in the accelData array
-    // divide by 1000 to convert from milli g, to g
-    accelData[0] = static_cast<float>(accelArray_[0]) / 1000.0f;
-    accelData[1] = static_cast<float>(accelArray_[1]) / 1000.0f;
-    accelData[2] = static_cast<float>(accelArray_[2]) / 1000.0f;
+size_t IMUSensor::getNumSamples() const {
+    return batchSize_;
+}
 
-    return accelData;
+uint64_t IMUSensor::getSample(size_t index, float* accel, float* gyro) const {
+    const LSM6DSLSample& sample = batch_[index];
+    convert(sample, accel, gyro);
+    return sample.timestamp;
 }
 
-// Get gyroscope data as an array
-float* IMUSensor::getGyroscopeData() {
-    static float gyroData[3]; // Array to hold gyroscope data: [gyro_x, gyro_y, gyro_z]
-    
-    // Convert raw gyroscope data to physical units and store in the gyroData array
-    // Divide by 1000 to convert from milli degrees per second
-    gyroData[0] = static_cast<float>(gyroArray_[0]) / 1000.0f;
-    gyroData[1] = static_cast<float>(gyroArray_[1]) / 1000.0f;
-    gyroData[2] = static_cast<float>(gyroArray_[2]) / 1000.0f;
-
-    return gyroData;
+void IMUSensor::convert(const LSM6DSLSample& sample, float* accel, float* gyro) const {
+    // Scale raw counts by the full scale sensitivity, then g to m/s^2
+    const float accelScale = imu.getAccelScale() * STANDARD_GRAVITY;
+    const float gyroScale = imu.getGyroScale();
+    for (int i = 0; i < 3; ++i) {
+        accel[i] = static_cast<float>(sample.accel[i]) * accelScale;
+        gyro[i] = static_cast<float>(sample.gyro[i]) * gyroScale;
+    }
 }
 
-// configure polling rate for gyroscope and accelerometer on a scale of 1 to 10 (1.6 - 6664 Hz)
+// configure polling rate for gyroscope and accelerometer on a scale of 1 to 10 (12.5 - 6664 Hz)
 void IMUSensor::setPollRate(char rate) {
-// Define the mapping of input byte values to output data rates
-    // Corresponding output data rates in Hz
-    const float dataRates[] = {12.5, 26, 52, 104, 208, 416, 833, 1666, 3332, 6664}; 
-    const int numRates = sizeof(dataRates) / sizeof(dataRates[0]);
-
-    // Ensure the rate value is within the valid range
+    // Rate values map directly to the ODR codes, the driver clamps them to the valid range
     if (rate < 1) {
         rate = 1;
     }
-    if(rate > numRates) {
-        rate = numRates;
+    if (!imu.setDataRate(static_cast<uint8_t>(rate))) {
+        Serial.println("Error setting IMU polling rate.");
     }
-
-    // Convert the byte input to an index for dataRates array
-    int index = rate - 1; // Adjust to 0-based index
-
-    // Set the output data rates for both gyroscope and accelerometer
-    imu.Set_X_ODR(dataRates[index]);
-    imu.Set_G_ODR(dataRates[index]);
-
 }
 
-// Wrapper method to get the polling rate (ODR) of the accelerometer
+// Get the polling rate (ODR) of the accelerometer
 float IMUSensor::getAccelPollRate() {
-    float accelPollRate;
-    LSM6DSLStatusTypeDef accelStatus = imu.Get_X_ODR(&accelPollRate);
-    if (accelStatus != LSM6DSL_STATUS_OK) {
-        Serial.println("Error retrieving accelerometer polling rate.");
-        return -1.0f; // Return a negative value to indicate error
+    return imu.getDataRate();
+}
+
+void IMUSensor::acquire(uint64_t now) {
+    size_t numSamples = imu.drain(now);
+    for (size_t i = 0; i < numSamples; ++i) {
+        queue_.push(imu.getSample(i));
     }
-    return accelPollRate;
 }
 
 void IMUSensor::update() {
-    imu.Get_G_Axes(gyroArray_);
-    imu.Get_X_Axes(accelArray_);
+    batchSize_ = 0;
+    while (batchSize_ < LSM6DSLFifo::MAX_SAMPLES_PER_DRAIN && queue_.pop(batch_[batchSize_])) {
+        batchSize_++;
+    }
+    if (batchSize_ == 0) {
+        return; // Keep the newest data and timestamp
+    }
+    timestamp_ = getSample(batchSize_ - 1, accelData_, gyroData_);
 }
 
-// Wrapper method to get the polling rate (ODR) of the gyroscope
+// Get the polling rate (ODR) of the gyroscope, the same as the accelerometer
 float IMUSensor::getGyroPollRate() {
-    float gyroPollRate;
-    LSM6DSLStatusTypeDef gyroStatus = imu.Get_G_ODR(&gyroPollRate);
-    if (gyroStatus != LSM6DSL_STATUS_OK) {
-        Serial.println("Error retrieving gyroscope polling rate.");
-        return -1.0f; // Return a negative value to indicate error
-    }
-    return gyroPollRate;
+    return imu.getDataRate();
+}
+
+uint32_t IMUSensor::getSamplePeriod() const {
+    float rate = imu.getDataRate();
+    return (rate > 0) ? static_cast<uint32_t>(1e6f / rate) : 0;
 }
 
 float* IMUSensor::getAllData() {
     static float allData[6];
-    float* accelData = getAccelerometerData();
-    float* gyroData = getGyroscopeData();
 
     for (int i = 0; i < 3; ++i) {
-        allData[i] = accelData[i];
-        allData[i + 3] = gyroData[i];
+        allData[i] = accelData_[i];
+        allData[i + 3] = gyroData_[i];
     }
 
     return allData;
@@ -2,40 +2,59 @@
 #define IMU_SENSOR_HPP
 
 #include <Wire.h>
-#include <LSM6DSLSensor.h>
 #include "sensor.hpp"
+#include "timer.hpp"
+#include "LSM6DSLFifo.hpp"
+#include "wireRegisterBus.hpp"
+#include "spscQueue.hpp"
+
+/// Standard gravity, used to convert the accelerometer output from g (m/s^2)
+constexpr float STANDARD_GRAVITY = 9.80665f;
 
 /**
  * @class IMUSensor
- * @brief Wrapper class for the LSM6DSLSensor to provide IMU data.
+ * @brief Wrapper class for the LSM6DSL to provide IMU data.
  *
  * This class provides an interface for initializing, enabling, and retrieving
- * data from the LSM6DSLSensor. It implements the Sensor interface to 
+ * data from the LSM6DSL. It implements the Sensor interface to 
  * ensure compatibility with the SensorFusion system.
+ *
+ * The part buffers every sample in its FIFO at the output data rate.
+ * acquire(), called on each sampling tick, drains the FIFO in bursts
+ * into a lock-free queue. update() takes a batch of samples from the queue
+ * in the main loop. Each sample in the batch is available through
+ * getSample() with its index-derived timestamp. The single value getters
+ * return the newest sample.
  */
 class IMUSensor: public Sensor {
 private:
     // ------------------------- MEMBERS ------------------------- //
-    LSM6DSLSensor imu; ///< LSM6DSLSensor object
-    TwoWire* wire; ///< Pointer to the I2C bus
-    uint8_t address; ///< I2C address of the sensor
+    WireRegisterBus bus_; ///< I2C bus the sensor is on
+    LSM6DSLFifo imu; ///< FIFO driver for the LSM6DSL
+    SpscQueue<LSM6DSLSample, 128> queue_; ///< Samples from acquire() waiting for update()
+    LSM6DSLSample batch_[LSM6DSLFifo::MAX_SAMPLES_PER_DRAIN]; ///< Samples taken by the last update
+    size_t batchSize_; ///< Number of samples taken by the last update
     uint8_t accelRange; ///< Accelerometer range
     uint16_t gyroRange; ///< Gyroscope range
-    float accelSense; ///< Accelerometer sensitivity
-    float gyroSense; ///< Gyroscope sensitivity
 
-    int32_t gyroArray_[3]; ///< Array to store raw gyroscope data
-    int32_t accelArray_[3]; ///< Array to store raw accelerometer data
+    float gyroData_[3]; ///< Newest gyroscope data (deg/s)
+    float accelData_[3]; ///< Newest accelerometer data (m/s^2)
+    uint64_t timestamp_; ///< Acquisition time of the newest data (us)
 
     /**
-     * @brief Initialize the IMU sensor.
+     * @brief Initialize the IMU sensor. No bus access, the part is set up
+     * by the first acquire() and retried until it is found.
      */
     void initialize() override;
-    
+
     /**
-     * @brief Enable the IMU sensor.
+     * @brief Convert a raw sample to physical units.
+     * 
+     * @param sample The raw sample.
+     * @param accel Output accelerometer data (m/s^2).
+     * @param gyro Output gyroscope data (deg/s).
      */
-    void enable();
+    void convert(const LSM6DSLSample& sample, float* accel, float* gyro) const;
 
 public:
     // ------------------------- METHODS ------------------------- //
@@ -43,31 +62,48 @@ public:
      * @brief Constructor for IMUSensor class.
      * 
      * @param i2c Pointer to the I2C bus.
-     * @param addr I2C address of the sensor.
-     * @param accelRange Accelerometer range.
-     * @param gyroRange Gyroscope range.
+     * @param addr 7-bit I2C address of the sensor.
+     * @param accelRange Accelerometer range (g).
+     * @param gyroRange Gyroscope range (deg/s).
      */
     IMUSensor(TwoWire* i2c, uint8_t addr, uint8_t accelRange, 
               uint16_t gyroRange);
     
     /**
-     * @brief Get accelerometer data as an array.
+     * @brief Get the newest accelerometer data as an array.
      * 
-     * @return Pointer to the array of accelerometer data.
+     * @return Pointer to the array of accelerometer data (m/s^2).
      */
     float* getAccelerometerData();
     
     /**
-     * @brief Get gyroscope data as an array.
+     * @brief Get the newest gyroscope data as an array.
      * 
-     * @return Pointer to the array of gyroscope data.
+     * @return Pointer to the array of gyroscope data (deg/s).
      */
     float* getGyroscopeData();
+
+    /**
+     * @brief Get the number of samples taken by the last update.
+     * 
+     * @return Number of samples.
+     */
+    size_t getNumSamples() const;
+
+    /**
+     * @brief Get a sample taken by the last update, oldest first.
+     * 
+     * @param index Sample index, below getNumSamples().
+     * @param accel Output accelerometer data (m/s^2).
+     * @param gyro Output gyroscope data (deg/s).
+     * @return Acquisition timestamp of the sample (us).
+     */
+    uint64_t getSample(size_t index, float* accel, float* gyro) const;
     
     /**
      * @brief Adjust polling rate (ODR).
      * 
-     * @param rate Rate value from 1 to 10 (1.6 - 6664 Hz).
+     * @param rate Rate value from 1 to 10 (12.5 - 6664 Hz).
      */
     void setPollRate(char rate);
     
@@ -85,20 +121,72 @@ public:
      */
     float getGyroPollRate();
 
+    /**
+     * @brief Get the time between new samples at the configured output data rate.
+     * 
+     * @return Sample period (us), 0 if the rate has not been set.
+     */
+    uint32_t getSamplePeriod() const;
+
     /**
      * @brief Get the current sensor data.
      * 
      * @return Current sensor data.
      */
     float getData() override {
-        return accelArray_[0];
+        return accelData_[0];
     }
 
     /**
-     * @brief Update the sensor data.
+     * @brief Take the next batch of queued samples, oldest first.
      */
     void update() override;
 
+    /**
+     * @brief Drain the FIFO into the sample queue.
+     *
+     * Called by the sensor sampler from the control loop, never from an interrupt.
+     * 
+     * @param now Current time (us).
+     */
+    void acquire(uint64_t now);
+
+    /**
+     * @brief Get the time the newest gyroscope and accelerometer data was acquired.
+     * 
+     * @return Acquisition timestamp (us).
+     */
+    uint64_t getTimestamp() override {
+        return timestamp_;
+    }
+
+    /**
+     * @brief Get the number of failed register reads since startup.
+     * 
+     * @return Number of failed reads.
+     */
+    uint32_t getErrorCount() const {
+        return imu.getErrorCount();
+    }
+
+    /**
+     * @brief Get the number of times the FIFO filled and samples were lost.
+     * 
+     * @return Number of overruns.
+     */
+    uint32_t getOverrunCount() const {
+        return imu.getOverrunCount();
+    }
+
+    /**
+     * @brief Get the number of samples dropped because update() fell behind.
+     * 
+     * @return Number of dropped samples.
+     */
+    uint32_t getDroppedCount() const {
+        return queue_.getDroppedCount();
+    }
+
     /**
      * @brief Get all unique data values available by the sensor.
      * 
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <vector>
+#include <stdint.h>
 
 /**
  * @class Sensor
@@ -69,6 +70,18 @@ public:
      */
     virtual size_t getNumValues() = 0;
 
+    /**
+     * @brief Get the time the current sensor data was acquired.
+     *
+     * This method should return the Timer::currentTimeMicros() time at which
+     * the sensor produced the data returned by getData(), taken as close to
+     * the acquisition as the driver allows rather than when it is processed.
+     * It must be implemented by the derived sensor class.
+     * 
+     * @return Acquisition timestamp (us).
+     */
+    virtual uint64_t getTimestamp() = 0;
+
      /**
      * @brief Get all unique name values from a sensor
      *
@@ -1,24 +1,42 @@
 #include "pressureSensor.hpp"
 
 // Constructor with oversample rate as argument
-PressureSensor::PressureSensor(byte rate) : oversampleRate_(rate) {
+PressureSensor::PressureSensor(byte rate) : pressure_(0), temp_(0), timestamp_(0), oversampleRate_(rate),
+    bus_(Wire), baro_(bus_, rate) {
     // Initialize the sensor with the provided oversample rate
     initialize();
 }
 
-// Initialize the sensor
+// Initialize the sensor and start the first conversion
 void PressureSensor::initialize() {
-    baro_.begin();
-    baro_.setModeActive();
-    baro_.setOversampleRate(oversampleRate_); // Set oversample rate
-    baro_.enableEventFlags(); 
-    baro_.setModeBarometer(); 
+    if (!baro_.begin(Timer::currentTimeMicros())) {
+        Serial.println("Error initializing pressure sensor.");
+    }
 }
 
-// Read and update pressure from the sensor
+// Poll the sensor and queue a reading once a conversion completes
+void PressureSensor::acquire(uint64_t now) {
+    if (baro_.poll(now)) {
+        readings_.push({baro_.getPressure(), baro_.getTemperature(), baro_.getTimestamp()});
+    }
+}
+
+// Take every queued reading, keeping the newest
 void PressureSensor::update() {
-    pressure_ = baro_.readPressure();
-    temp_ = baro_.readTemp();
+    while (readNext()) {
+    }
+}
+
+bool PressureSensor::readNext() {
+    PressureReading reading;
+    if (!readings_.pop(reading)) {
+        // Keep the previous data and timestamp until new data arrives
+        return false;
+    }
+    pressure_ = reading.pressure;
+    temp_ = reading.temperature;
+    timestamp_ = reading.timestamp;
+    return true;
 }
 
 // Get pressure data
@@ -31,3 +49,6 @@ float PressureSensor::getTemperature() {
     return temp_;
 }
 
+uint32_t PressureSensor::getSamplePeriod() const {
+    return baro_.getConversionTime();
+}
@@ -1,10 +1,23 @@
 #ifndef PRESSURE_SENSOR_HPP
 #define PRESSURE_SENSOR_HPP
 
-#include "SparkFunMPL3115A2.h"
+#include "MPL3115A2Driver.hpp"
+#include "wireRegisterBus.hpp"
 #include "sensor.hpp"
 #include "constants.hpp"
 #include "configKeys.hpp"
+#include "timer.hpp"
+#include "spscQueue.hpp"
+
+/**
+ * @struct PressureReading
+ * @brief A pressure and temperature sample passed from acquire() to update().
+ */
+struct PressureReading {
+    float pressure;     ///< Pressure (Pa)
+    float temperature;  ///< Temperature (degrees C)
+    uint64_t timestamp; ///< Acquisition time (us)
+};
 
 /**
  * @class PressureSensor
@@ -14,6 +27,10 @@
  * implements the specific functionalities for a pressure sensor.
  * It interfaces with the MPL3115A2 pressure sensor to retrieve 
  * pressure and temperature data.
+ *
+ * The sensor is read through a non-blocking driver from acquire(), called on
+ * each sampling tick, which queues each completed conversion. update()
+ * and readNext() take readings from the queue in the main loop.
  */
 class PressureSensor : public Sensor {
 public:
@@ -30,11 +47,36 @@ public:
     /**
      * @brief Update the pressure sensor data.
      *
-     * This method reads the latest data from the pressure sensor and 
-     * updates the internal state with the new pressure and temperature values.
+     * This method takes every queued reading, leaving the newest pressure
+     * and temperature values as the current data.
      */
     void update() override;
 
+    /**
+     * @brief Take the oldest queued reading as the current data.
+     * 
+     * @return True if a reading was taken, false if none were queued.
+     */
+    bool readNext();
+
+    /**
+     * @brief Poll the sensor without blocking, queueing a completed conversion.
+     *
+     * Called by the sensor sampler from the control loop, never from an interrupt.
+     * 
+     * @param now Current time (us).
+     */
+    void acquire(uint64_t now);
+
+    /**
+     * @brief Get the number of readings dropped because update() fell behind.
+     * 
+     * @return Number of dropped readings.
+     */
+    uint32_t getDroppedCount() const {
+        return readings_.getDroppedCount();
+    }
+
     /**
      * @brief Get the current pressure sensor data.
      *
@@ -44,6 +86,15 @@ public:
      */
     float getData() override;
 
+    /**
+     * @brief Get the time the current pressure was acquired.
+     * 
+     * @return Acquisition timestamp (us).
+     */
+    uint64_t getTimestamp() override {
+        return timestamp_;
+    }
+
     /**
      * @brief Get all data values from the sensor.
      *
@@ -92,11 +143,33 @@ public:
      */
     float getTemperature();
 
+    /**
+     * @brief Get the number of failed reads since startup.
+     *
+     * A read fails when the sensor does not respond over I2C or a
+     * conversion times out.
+     * 
+     * @return Number of failed reads.
+     */
+    uint32_t getErrorCount() const {
+        return baro_.getErrorCount();
+    }
+
+    /**
+     * @brief Get the minimum time between new samples at the oversample rate.
+     * 
+     * @return Sample period (us).
+     */
+    uint32_t getSamplePeriod() const;
+
 private:
     float pressure_;       ///< Current pressure value
     float temp_;           ///< Current temperature value
+    uint64_t timestamp_;   ///< Acquisition time of the current pressure (us)
     byte oversampleRate_;  ///< Oversample rate for the sensor
-    MPL3115A2 baro_;       ///< Instance of the pressure sensor library
+    WireRegisterBus bus_;  ///< I2C bus the sensor is on
+    MPL3115A2Driver baro_; ///< Non-blocking pressure sensor driver
+    SpscQueue<PressureReading, 8> readings_; ///< Readings from acquire() waiting for update()
 
     /**
      * @brief Initialize the pressure sensor.
@@ -0,0 +1,94 @@
+#include "controlLoop.hpp"
+
+ControlLoop::ControlLoop(uint32_t periodMicros)
+    : period_(periodMicros), release_(0), started_(false), ticks_(0), overruns_(0),
+      skipped_(0), lastOverrunTime_(0), lastOverrunLength_(0), maxResponseTime_(0),
+      maxJitter_(0) {}
+
+bool ControlLoop::isDue(uint64_t now) {
+    if (!started_) {
+        // The first tick is released as soon as the loop is polled
+        release_ = now;
+        started_ = true;
+    }
+    if (now < release_) {
+        return false;
+    }
+
+    uint64_t late = now - release_;
+    if (period_ > 0 && late >= period_) {
+        // Held past this tick's deadline, skip to the newest release on the grid
+        recordOverrun(now, late - period_);
+        uint64_t missed = late / period_;
+        skipped_ += missed;
+        release_ += missed * period_;
+        late -= missed * period_;
+    }
+
+    if (late > maxJitter_) {
+        maxJitter_ = late;
+    }
+    ticks_++;
+    return true;
+}
+
+void ControlLoop::endTick(uint64_t now) {
+    uint64_t deadline = release_ + period_;
+    if (now > release_ && now - release_ > maxResponseTime_) {
+        maxResponseTime_ = now - release_;
+    }
+    if (now > deadline) {
+        recordOverrun(now, now - deadline);
+    }
+    release_ = deadline;
+}
+
+void ControlLoop::setPeriod(uint32_t periodMicros) {
+    period_ = periodMicros;
+    started_ = false;
+}
+
+uint32_t ControlLoop::getPeriod() const {
+    return period_;
+}
+
+uint32_t ControlLoop::getSpareTime(uint64_t now) const {
+    if (!started_ || now >= release_) {
+        return 0;
+    }
+    return release_ - now;
+}
+
+uint32_t ControlLoop::getTickCount() const {
+    return ticks_;
+}
+
+uint32_t ControlLoop::getOverrunCount() const {
+    return overruns_;
+}
+
+uint32_t ControlLoop::getSkippedCount() const {
+    return skipped_;
+}
+
+uint64_t ControlLoop::getLastOverrunTime() const {
+    return lastOverrunTime_;
+}
+
+uint32_t ControlLoop::getLastOverrunLength() const {
+    return lastOverrunLength_;
+}
+
+uint32_t ControlLoop::getMaxResponseTime() const {
+    return maxResponseTime_;
+}
+
+uint32_t ControlLoop::getMaxJitter() const {
+    return maxJitter_;
+}
+
+void ControlLoop::recordOverrun(uint64_t now, uint64_t length) {
+    overruns_++;
+    lastOverrunTime_ = now;
+    lastOverrunLength_ = length;
+}
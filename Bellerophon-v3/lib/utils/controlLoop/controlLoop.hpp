@@ -0,0 +1,136 @@
+#ifndef CONTROL_LOOP_HPP
+#define CONTROL_LOOP_HPP
+
+#include <stdint.h>
+
+/**
+ * @class ControlLoop
+ * @brief Releases the control tick at a fixed rate and checks its deadlines.
+ *
+ * Ticks are released on a fixed grid of period multiples, so the rate does
+ * not drift with how long the background work between ticks takes. Each tick
+ * must finish before the next release. A tick that runs past it, or that
+ * starts a whole period late because the background work held the loop, is
+ * an overrun. Releases that were missed entirely are skipped rather than run
+ * back to back, and the grid phase is kept.
+ *
+ * Overruns are counted and the newest is kept with its time, so it can be
+ * logged later from the background instead of inside the tick.
+ */
+class ControlLoop {
+public:
+    /**
+     * @brief Constructor for ControlLoop.
+     *
+     * @param periodMicros Time between control ticks (us).
+     */
+    explicit ControlLoop(uint32_t periodMicros);
+
+    /**
+     * @brief Check if the next tick has been released, starting it if it has.
+     *
+     * @param now Current time from Timer::currentTimeMicros() (us).
+     * @return True if the control tick should run now.
+     */
+    bool isDue(uint64_t now);
+
+    /**
+     * @brief Mark the end of the tick started by isDue().
+     *
+     * @param now Current time from Timer::currentTimeMicros() (us).
+     */
+    void endTick(uint64_t now);
+
+    /**
+     * @brief Change the tick period, releasing the next tick immediately.
+     *
+     * @param periodMicros Time between control ticks (us).
+     */
+    void setPeriod(uint32_t periodMicros);
+
+    /**
+     * @brief Get the tick period.
+     *
+     * @return Time between control ticks (us).
+     */
+    uint32_t getPeriod() const;
+
+    /**
+     * @brief Get the time left before the next tick is released.
+     *
+     * @param now Current time (us).
+     * @return Time until the next release (us), 0 if it is already due.
+     */
+    uint32_t getSpareTime(uint64_t now) const;
+
+    /**
+     * @brief Get the number of ticks run.
+     *
+     * @return Number of ticks.
+     */
+    uint32_t getTickCount() const;
+
+    /**
+     * @brief Get the number of ticks that missed their deadline.
+     *
+     * @return Number of overruns.
+     */
+    uint32_t getOverrunCount() const;
+
+    /**
+     * @brief Get the number of releases skipped because the loop was held past them.
+     *
+     * @return Number of skipped ticks.
+     */
+    uint32_t getSkippedCount() const;
+
+    /**
+     * @brief Get the time the newest overrun was detected.
+     *
+     * @return Overrun timestamp (us), 0 if there has been none.
+     */
+    uint64_t getLastOverrunTime() const;
+
+    /**
+     * @brief Get how far the newest overrun ran past its deadline.
+     *
+     * @return Overrun length (us).
+     */
+    uint32_t getLastOverrunLength() const;
+
+    /**
+     * @brief Get the longest time from release to the end of a tick.
+     *
+     * @return Worst case response time (us).
+     */
+    uint32_t getMaxResponseTime() const;
+
+    /**
+     * @brief Get the longest delay from release to the start of a tick.
+     *
+     * @return Worst case release jitter (us).
+     */
+    uint32_t getMaxJitter() const;
+
+private:
+    uint32_t period_; ///< Time between control ticks (us)
+    uint64_t release_; ///< Release time of the running or next tick (us)
+    bool started_; ///< True once the first tick has been released
+    uint32_t ticks_; ///< Ticks run
+    uint32_t overruns_; ///< Ticks that missed their deadline
+    uint32_t skipped_; ///< Releases skipped entirely
+    uint64_t lastOverrunTime_; ///< Time the newest overrun was detected (us)
+    uint32_t lastOverrunLength_; ///< Time the newest overrun ran past its deadline (us)
+    uint32_t maxResponseTime_; ///< Longest release to tick end (us)
+    uint32_t maxJitter_; ///< Longest release to tick start (us)
+
+    /**
+     * @brief Count an overrun of the running tick.
+     *
+     * @param now Time it was detected (us).
+     * @param length Time past the deadline (us).
+     */
+    void recordOverrun(uint64_t now, uint64_t length);
+};
+
+#endif // CONTROL_LOOP_HPP
@@ -0,0 +1,73 @@
+#ifndef INTERRUPT_GUARD_HPP
+#define INTERRUPT_GUARD_HPP
+
+#include <stdint.h>
+
+/**
+ * @class InterruptGuard
+ * @brief Masks interrupts for its lifetime and restores the previous mask.
+ *
+ * Unlike a noInterrupts()/interrupts() pair, the guard leaves interrupts
+ * masked on exit if they were masked on entry, so it is safe inside
+ * interrupt handlers and nested critical sections.
+ *
+ * On the target the mask is the Cortex-M PRIMASK register. On the host it
+ * is a per-thread flag, so tests can check a section runs masked.
+ */
+class InterruptGuard {
+public:
+    /**
+     * @brief Save the interrupt mask and mask interrupts.
+     */
+    InterruptGuard() : wasMasked_(isMasked()) {
+#if defined(ARDUINO)
+        __asm__ volatile("cpsid i" ::: "memory");
+#else
+        hostMasked() = true;
+#endif
+    }
+
+    /**
+     * @brief Restore the interrupt mask saved at construction.
+     */
+    ~InterruptGuard() {
+        if (wasMasked_) {
+            return;
+        }
+#if defined(ARDUINO)
+        __asm__ volatile("cpsie i" ::: "memory");
+#else
+        hostMasked() = false;
+#endif
+    }
+
+    InterruptGuard(const InterruptGuard&) = delete;
+    InterruptGuard& operator=(const InterruptGuard&) = delete;
+
+    /**
+     * @brief Check if interrupts are masked.
+     *
+     * @return True if masked.
+     */
+    static bool isMasked() {
+#if defined(ARDUINO)
+        uint32_t primask;
+        __asm__ volatile("mrs %0, primask" : "=r"(primask));
+        return (primask & 1) != 0;
+#else
+        return hostMasked();
+#endif
+    }
+
+private:
+    bool wasMasked_; ///< True if interrupts were masked on entry
+
+#if !defined(ARDUINO)
+    static bool& hostMasked() {
+        static thread_local bool masked = false;
+        return masked;
+    }
+#endif
+};
+
+#endif // INTERRUPT_GUARD_HPP
@@ -0,0 +1,272 @@
+#ifndef ORDER_STATISTIC_TREE_HPP
+#define ORDER_STATISTIC_TREE_HPP
+
+#include <cstddef>
+#include <stdint.h>
+
+/**
+ * @class OrderStatisticTree
+ * @brief Fixed-capacity multiset of floats with rank and selection queries.
+ *
+ * Implemented as a treap (randomised binary search tree) whose nodes live in a
+ * statically allocated pool, with subtree sizes kept in every node. Insert,
+ * erase, rank and select are O(log n) expected and never allocate, which makes
+ * it suitable for rolling median and MAD statistics over a sliding window.
+ *
+ * @tparam N Maximum number of values held.
+ */
+template <size_t N>
+class OrderStatisticTree {
+    static_assert(N > 0 && N < 0xFFFF, "OrderStatisticTree capacity must fit 16-bit node indices");
+
+public:
+    /**
+     * @brief Constructor for OrderStatisticTree.
+     */
+    OrderStatisticTree() : seed_(0x9E3779B9u) { clear(); }
+
+    /**
+     * @brief Insert a value.
+     * 
+     * @param value The value to insert.
+     * @return True if inserted, false if the tree is full.
+     */
+    bool insert(float value) {
+        if (freeHead_ == NIL) {
+            return false;
+        }
+        uint16_t node = freeHead_;
+        freeHead_ = nodes_[node].left;
+        nodes_[node] = Node{value, nextPriority(), NIL, NIL, 1};
+
+        uint16_t less, notLess;
+        split(root_, value, less, notLess);
+        root_ = merge(merge(less, node), notLess);
+        return true;
+    }
+
+    /**
+     * @brief Erase one instance of a value.
+     * 
+     * @param value The value to erase.
+     * @return True if an instance was found and erased, false otherwise.
+     */
+    bool erase(float value) {
+        uint16_t less, notLess;
+        split(root_, value, less, notLess);
+
+        // Everything in notLess is >= value, so an equal value is its minimum
+        uint16_t* link = &notLess;
+        while (*link != NIL && nodes_[*link].left != NIL) {
+            --nodes_[*link].size;
+            link = &nodes_[*link].left;
+        }
+
+        bool found = *link != NIL && nodes_[*link].key == value;
+        if (found) {
+            uint16_t node = *link;
+            *link = nodes_[node].right;
+            nodes_[node].left = freeHead_;
+            freeHead_ = node;
+        } else {
+            // Undo the size adjustments made on the way down
+            for (uint16_t n = notLess; n != NIL && nodes_[n].left != NIL; n = nodes_[n].left) {
+                ++nodes_[n].size;
+            }
+        }
+        root_ = merge(less, notLess);
+        return found;
+    }
+
+    /**
+     * @brief Get the k-th smallest value (0-based). Undefined if k >= size().
+     * 
+     * @param k Rank of the value to select.
+     * @return The k-th smallest value.
+     */
+    float select(size_t k) const {
+        uint16_t node = root_;
+        while (node != NIL) {
+            size_t leftSize = sizeOf(nodes_[node].left);
+            if (k < leftSize) {
+                node = nodes_[node].left;
+            } else if (k == leftSize) {
+                return nodes_[node].key;
+            } else {
+                k -= leftSize + 1;
+                node = nodes_[node].right;
+            }
+        }
+        return 0.0f;
+    }
+
+    /**
+     * @brief Count the values strictly less than a key.
+     * 
+     * @param key The key to rank.
+     * @return Number of values less than key.
+     */
+    size_t rank(float key) const {
+        size_t count = 0;
+        uint16_t node = root_;
+        while (node != NIL) {
+            if (nodes_[node].key < key) {
+                count += sizeOf(nodes_[node].left) + 1;
+                node = nodes_[node].right;
+            } else {
+                node = nodes_[node].left;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Get the median of the values held. Returns 0 if empty.
+     */
+    float median() const {
+        size_t n = size();
+        if (n == 0) {
+            return 0.0f;
+        }
+        if (n % 2 == 1) {
+            return select(n / 2);
+        }
+        return 0.5f * (select(n / 2 - 1) + select(n / 2));
+    }
+
+    /**
+     * @brief Get the median absolute deviation about a centre value.
+     * 
+     * The deviations below and above the centre form two sorted sequences,
+     * so their median is found by a k-th element search across both in
+     * O(log^2 n) without materialising them.
+     * 
+     * @param centre The centre value, normally the median.
+     * @return The median absolute deviation. Returns 0 if empty.
+     */
+    float medianAbsoluteDeviation(float centre) const {
+        size_t n = size();
+        if (n == 0) {
+            return 0.0f;
+        }
+        size_t below = rank(centre);
+        if (n % 2 == 1) {
+            return kthDeviation(n / 2, centre, below);
+        }
+        return 0.5f * (kthDeviation(n / 2 - 1, centre, below) + kthDeviation(n / 2, centre, below));
+    }
+
+    /**
+     * @brief Get the number of values held.
+     */
+    size_t size() const { return sizeOf(root_); }
+
+    /**
+     * @brief Check if the tree is full.
+     */
+    bool full() const { return freeHead_ == NIL; }
+
+    /**
+     * @brief Remove all values.
+     */
+    void clear() {
+        root_ = NIL;
+        for (size_t i = 0; i < N; ++i) {
+            nodes_[i].left = (i + 1 < N) ? static_cast<uint16_t>(i + 1) : NIL;
+        }
+        freeHead_ = 0;
+    }
+
+private:
+    static constexpr uint16_t NIL = 0xFFFF;
+
+    /**
+     * @struct Node
+     * @brief Treap node. The left link doubles as the free list link.
+     */
+    struct Node {
+        float key;         ///< Stored value
+        uint32_t priority; ///< Heap priority
+        uint16_t left;     ///< Left child
+        uint16_t right;    ///< Right child
+        uint16_t size;     ///< Number of nodes in this subtree
+    };
+
+    Node nodes_[N];     ///< Node pool
+    uint16_t root_;     ///< Root node
+    uint16_t freeHead_; ///< First unused node
+    uint32_t seed_;     ///< xorshift state for priorities
+
+    size_t sizeOf(uint16_t node) const { return node == NIL ? 0 : nodes_[node].size; }
+
+    void refresh(uint16_t node) {
+        nodes_[node].size = static_cast<uint16_t>(1 + sizeOf(nodes_[node].left) + sizeOf(nodes_[node].right));
+    }
+
+    uint32_t nextPriority() {
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 17;
+        seed_ ^= seed_ << 5;
+        return seed_;
+    }
+
+    // Split into values < key and values >= key
+    void split(uint16_t node, float key, uint16_t& less, uint16_t& notLess) {
+        if (node == NIL) {
+            less = notLess = NIL;
+            return;
+        }
+        if (nodes_[node].key < key) {
+            split(nodes_[node].right, key, nodes_[node].right, notLess);
+            less = node;
+        } else {
+            split(nodes_[node].left, key, less, nodes_[node].left);
+            notLess = node;
+        }
+        refresh(node);
+    }
+
+    // Merge two treaps where every value in a is <= every value in b
+    uint16_t merge(uint16_t a, uint16_t b) {
+        if (a == NIL) {
+            return b;
+        }
+        if (b == NIL) {
+            return a;
+        }
+        if (nodes_[a].priority > nodes_[b].priority) {
+            nodes_[a].right = merge(nodes_[a].right, b);
+            refresh(a);
+            return a;
+        }
+        nodes_[b].left = merge(a, nodes_[b].left);
+        refresh(b);
+        return b;
+    }
+
+    // k-th smallest deviation from centre, where `below` values are < centre
+    float kthDeviation(size_t k, float centre, size_t below) const {
+        size_t above = size() - below;
+        // Deviations below the centre, ascending: centre - select(below - 1 - i)
+        // Deviations above the centre, ascending: select(below + j) - centre
+        size_t lo = k + 1 > above ? k + 1 - above : 0;
+        size_t hi = k + 1 < below ? k + 1 : below;
+        // Binary search for the number i of below-deviations among the k + 1 smallest
+        while (lo < hi) {
+            size_t i = (lo + hi) / 2;
+            size_t j = k - i; // index of the above-deviation competing with below-deviation i
+            if (centre - select(below - 1 - i) < select(below + j) - centre) {
+                lo = i + 1;
+            } else {
+                hi = i;
+            }
+        }
+        size_t i = lo;
+        size_t j = k + 1 - i;
+        float fromBelow = i > 0 ? centre - select(below - i) : -1.0f;
+        float fromAbove = j > 0 ? select(below + j - 1) - centre : -1.0f;
+        return fromBelow > fromAbove ? fromBelow : fromAbove;
+    }
+};
+
+#endif // ORDER_STATISTIC_TREE_HPP
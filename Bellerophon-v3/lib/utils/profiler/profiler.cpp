@@ -0,0 +1,149 @@
+#include "profiler.hpp"
+#include <stdio.h>
+
+namespace {
+    constexpr int FIRST_BUCKET_BITS = 8; // 256 ns, bucket 0 upper bound
+    constexpr uint32_t NANOS_PER_SECOND = 1000000000UL;
+
+    const char* const SECTION_NAMES[] = {
+        "serial_mode",
+        "flight_state",
+        "sensor_fusion",
+        "log_data",
+        "file_print",
+        "peripherals",
+    };
+    static_assert(sizeof(SECTION_NAMES) / sizeof(SECTION_NAMES[0]) ==
+                  static_cast<size_t>(ProfileSection::NUM_SECTIONS), "Every section needs a name");
+}
+
+// ------------------------- LatencyHistogram ------------------------- //
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::record(uint32_t nanos) {
+    buckets_[bucketOf(nanos)]++;
+    count_++;
+    total_ += nanos;
+    if (nanos > max_) {
+        max_ = nanos;
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+        buckets_[i] = 0;
+    }
+    count_ = 0;
+    total_ = 0;
+    max_ = 0;
+}
+
+size_t LatencyHistogram::bucketOf(uint32_t nanos) {
+    if (nanos < FIRST_BUCKET_NANOS) {
+        return 0;
+    }
+    // Bit width of the duration selects the power of two bucket
+    size_t bucket = (32 - __builtin_clz(nanos)) - FIRST_BUCKET_BITS;
+    return (bucket < NUM_BUCKETS) ? bucket : NUM_BUCKETS - 1;
+}
+
+uint32_t LatencyHistogram::bucketLimit(size_t bucket) {
+    if (bucket >= NUM_BUCKETS - 1) {
+        return UINT32_MAX;
+    }
+    return FIRST_BUCKET_NANOS << bucket;
+}
+
+uint32_t LatencyHistogram::getBucketCount(size_t bucket) const {
+    return (bucket < NUM_BUCKETS) ? buckets_[bucket] : 0;
+}
+
+uint32_t LatencyHistogram::getCount() const {
+    return count_;
+}
+
+uint32_t LatencyHistogram::getMean() const {
+    return (count_ > 0) ? static_cast<uint32_t>(total_ / count_) : 0;
+}
+
+uint32_t LatencyHistogram::getMax() const {
+    return max_;
+}
+
+size_t LatencyHistogram::format(char* buffer, size_t size) const {
+    if (size == 0) {
+        return 0;
+    }
+    int written = snprintf(buffer, size, "n=%lu mean=%.2fus max=%.2fus",
+                           static_cast<unsigned long>(count_), getMean() * 1e-3f, max_ * 1e-3f);
+    size_t offset = (written < 0) ? 0 : static_cast<size_t>(written);
+
+    for (size_t i = 0; i < NUM_BUCKETS && offset < size; ++i) {
+        if (buckets_[i] == 0) {
+            continue;
+        }
+        if (i == NUM_BUCKETS - 1) {
+            written = snprintf(buffer + offset, size - offset, " >%.1f:%lu",
+                               bucketLimit(i - 1) * 1e-3f, static_cast<unsigned long>(buckets_[i]));
+        } else {
+            written = snprintf(buffer + offset, size - offset, " <%.1f:%lu",
+                               bucketLimit(i) * 1e-3f, static_cast<unsigned long>(buckets_[i]));
+        }
+        offset += (written < 0) ? 0 : static_cast<size_t>(written);
+    }
+    return (offset < size) ? offset : size - 1;
+}
+
+// ------------------------- Profiler ------------------------- //
+
+LatencyHistogram Profiler::histograms_[static_cast<size_t>(ProfileSection::NUM_SECTIONS)];
+
+void Profiler::begin() {
+#ifdef ARDUINO
+    // The Teensy startup code enables the counter too, this keeps it independent of that
+    ARM_DEMCR |= ARM_DEMCR_TRCENA;
+    ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+#endif
+}
+
+uint32_t Profiler::ticksToNanos(uint32_t ticks) {
+#ifdef ARDUINO
+    uint64_t nanos = static_cast<uint64_t>(ticks) * NANOS_PER_SECOND / F_CPU_ACTUAL;
+    return (nanos > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(nanos);
+#else
+    return ticks;
+#endif
+}
+
+void Profiler::record(ProfileSection section, uint32_t ticks) {
+    histograms_[static_cast<size_t>(section)].record(ticksToNanos(ticks));
+}
+
+const LatencyHistogram& Profiler::getHistogram(ProfileSection section) {
+    return histograms_[static_cast<size_t>(section)];
+}
+
+const char* Profiler::getName(ProfileSection section) {
+    return SECTION_NAMES[static_cast<size_t>(section)];
+}
+
+size_t Profiler::format(ProfileSection section, char* buffer, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    int written = snprintf(buffer, size, "PROFILE %s: ", getName(section));
+    size_t offset = (written < 0) ? 0 : static_cast<size_t>(written);
+    if (offset >= size) {
+        return size - 1;
+    }
+    return offset + getHistogram(section).format(buffer + offset, size - offset);
+}
+
+void Profiler::reset() {
+    for (auto& histogram : histograms_) {
+        histogram.reset();
+    }
+}
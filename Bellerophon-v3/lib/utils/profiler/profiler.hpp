@@ -0,0 +1,245 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+/**
+ * @enum ProfileSection
+ * @brief Parts of the loop timed by profiling scopes.
+ *
+ * Scopes nest, so a section includes the time of any section it calls
+ * (FLIGHT_STATE includes SENSOR_FUSION, LOG_DATA includes FILE_PRINT).
+ */
+enum class ProfileSection : uint8_t {
+    SERIAL_MODE,   ///< SerialAction::update
+    FLIGHT_STATE,  ///< FlightStateMachine control tick
+    SENSOR_FUSION, ///< SensorFusion::update
+    LOG_DATA,      ///< DataLogger::logData
+    FILE_PRINT,    ///< FileManager::print
+    PERIPHERALS,   ///< Buzzer and LED updates
+    NUM_SECTIONS
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief Fixed-bucket histogram of durations.
+ *
+ * Bucket 0 holds durations below 256 ns and each following bucket is twice
+ * as wide as the one before, so the buckets cover 256 ns to 67 ms at a
+ * constant relative resolution. The last bucket also holds everything longer.
+ * Recording is a count leading zeros and a few adds.
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t NUM_BUCKETS = 20;      ///< Number of buckets
+    static constexpr uint32_t FIRST_BUCKET_NANOS = 256; ///< Upper bound of bucket 0 (ns)
+
+    /**
+     * @brief Constructor for LatencyHistogram, starting empty.
+     */
+    LatencyHistogram();
+
+    /**
+     * @brief Add a duration.
+     *
+     * @param nanos Duration (ns).
+     */
+    void record(uint32_t nanos);
+
+    /**
+     * @brief Empty the histogram.
+     */
+    void reset();
+
+    /**
+     * @brief Get the bucket a duration falls in.
+     *
+     * @param nanos Duration (ns).
+     * @return Bucket index.
+     */
+    static size_t bucketOf(uint32_t nanos);
+
+    /**
+     * @brief Get the exclusive upper bound of a bucket.
+     *
+     * @param bucket Bucket index.
+     * @return Upper bound (ns), UINT32_MAX for the last bucket.
+     */
+    static uint32_t bucketLimit(size_t bucket);
+
+    /**
+     * @brief Get the number of durations in a bucket.
+     *
+     * @param bucket Bucket index.
+     * @return Count.
+     */
+    uint32_t getBucketCount(size_t bucket) const;
+
+    /**
+     * @brief Get the number of durations recorded.
+     *
+     * @return Count.
+     */
+    uint32_t getCount() const;
+
+    /**
+     * @brief Get the mean duration.
+     *
+     * @return Mean (ns), 0 if empty.
+     */
+    uint32_t getMean() const;
+
+    /**
+     * @brief Get the longest duration.
+     *
+     * @return Maximum (ns).
+     */
+    uint32_t getMax() const;
+
+    /**
+     * @brief Format the statistics and non-empty buckets as one line of text.
+     *
+     * Buckets are written as upper bound in us and count, e.g. "<8:120".
+     *
+     * @param buffer The buffer to write into.
+     * @param size The size of the buffer.
+     * @return The number of characters written, truncated to the buffer.
+     */
+    size_t format(char* buffer, size_t size) const;
+
+private:
+    uint32_t buckets_[NUM_BUCKETS]; ///< Durations in each bucket
+    uint32_t count_; ///< Durations recorded
+    uint64_t total_; ///< Sum of durations (ns)
+    uint32_t max_; ///< Longest duration (ns)
+};
+
+/**
+ * @class Profiler
+ * @brief Latency histograms of each ProfileSection.
+ *
+ * Time is read from the Cortex-M7 DWT cycle counter on target and from a
+ * steady clock on the host. Profiling scopes are only compiled in when the
+ * build defines PROFILING; otherwise PROFILE_SCOPE expands to nothing and
+ * nothing here is referenced.
+ */
+class Profiler {
+public:
+    /**
+     * @brief Start the cycle counter. Call once from setup().
+     */
+    static void begin();
+
+    /**
+     * @brief Read the profiling clock.
+     *
+     * @return Clock ticks, CPU cycles on target and ns on the host.
+     */
+    static inline uint32_t now() {
+#ifdef ARDUINO
+        return ARM_DWT_CYCCNT;
+#else
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Convert a clock tick count to nanoseconds.
+     *
+     * @param ticks Elapsed clock ticks.
+     * @return Elapsed time (ns), saturated.
+     */
+    static uint32_t ticksToNanos(uint32_t ticks);
+
+    /**
+     * @brief Add a duration to a section.
+     *
+     * @param section The section.
+     * @param ticks Elapsed clock ticks.
+     */
+    static void record(ProfileSection section, uint32_t ticks);
+
+    /**
+     * @brief Get the histogram of a section.
+     *
+     * @param section The section.
+     * @return The histogram.
+     */
+    static const LatencyHistogram& getHistogram(ProfileSection section);
+
+    /**
+     * @brief Get the name of a section.
+     *
+     * @param section The section.
+     * @return Name for logs.
+     */
+    static const char* getName(ProfileSection section);
+
+    /**
+     * @brief Format a section as "PROFILE <name>: <histogram>".
+     *
+     * @param section The section.
+     * @param buffer The buffer to write into.
+     * @param size The size of the buffer.
+     * @return The number of characters written, truncated to the buffer.
+     */
+    static size_t format(ProfileSection section, char* buffer, size_t size);
+
+    /**
+     * @brief Empty every histogram.
+     */
+    static void reset();
+
+private:
+    static LatencyHistogram histograms_[static_cast<size_t>(ProfileSection::NUM_SECTIONS)]; ///< Histogram of each section
+};
+
+/**
+ * @class ProfileScope
+ * @brief Times its own lifetime into a section. Use through PROFILE_SCOPE.
+ */
+class ProfileScope {
+public:
+    /**
+     * @brief Start timing.
+     *
+     * @param section The section to record into.
+     */
+    explicit ProfileScope(ProfileSection section) : section_(section), start_(Profiler::now()) {}
+
+    /**
+     * @brief Stop timing and record the duration.
+     */
+    ~ProfileScope() {
+        Profiler::record(section_, Profiler::now() - start_);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileSection section_; ///< Section the duration is recorded into
+    uint32_t start_; ///< Clock at construction
+};
+
+/**
+ * @def PROFILE_SCOPE
+ * @brief Time the rest of the enclosing block into a ProfileSection.
+ *
+ * Compiles to nothing unless PROFILING is defined.
+ */
+#ifdef PROFILING
+#define PROFILE_SCOPE(section) ProfileScope profileScope_(ProfileSection::section)
+#else
+#define PROFILE_SCOPE(section) do {} while (0)
+#endif
+
+#endif // PROFILER_HPP
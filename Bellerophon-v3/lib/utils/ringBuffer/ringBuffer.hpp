@@ -0,0 +1,117 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <cstddef>
+
+/**
+ * @class RingBuffer
+ * @brief Fixed-capacity circular buffer with storage allocated at compile time.
+ *
+ * Pushing into a full buffer overwrites the oldest element, so inserts are
+ * constant time and never allocate. The usable length can be limited at
+ * construction to anything up to the compile-time capacity N.
+ *
+ * @tparam T Element type.
+ * @tparam N Compile-time storage capacity.
+ */
+template <typename T, size_t N>
+class RingBuffer {
+    static_assert(N > 0, "RingBuffer capacity must be greater than zero");
+
+public:
+    /**
+     * @brief Constructor for RingBuffer.
+     * 
+     * @param limit Maximum number of elements held, clamped to [1, N].
+     */
+    explicit RingBuffer(size_t limit = N)
+        : limit_(limit == 0 ? 1 : (limit > N ? N : limit)), head_(0), size_(0), data_{} {}
+
+    /**
+     * @brief Append an element, overwriting the oldest one if the buffer is full.
+     * 
+     * @param value The element to append.
+     */
+    void push(const T& value) {
+        data_[(head_ + size_) % limit_] = value;
+        if (size_ < limit_) {
+            ++size_;
+        } else {
+            head_ = (head_ + 1) % limit_;
+        }
+    }
+
+    /**
+     * @brief Remove the oldest element. Does nothing if the buffer is empty.
+     */
+    void pop() {
+        if (size_ == 0) {
+            return;
+        }
+        head_ = (head_ + 1) % limit_;
+        --size_;
+    }
+
+    /**
+     * @brief Access an element by age.
+     * 
+     * @param i Index from the oldest element (0) to the newest (size() - 1).
+     * @return Reference to the element.
+     */
+    T& operator[](size_t i) { return data_[(head_ + i) % limit_]; }
+    const T& operator[](size_t i) const { return data_[(head_ + i) % limit_]; }
+
+    /**
+     * @brief Access an element counting back from the newest.
+     * 
+     * @param i Index from the newest element (0) to the oldest (size() - 1).
+     * @return Reference to the element.
+     */
+    const T& fromNewest(size_t i) const { return (*this)[size_ - 1 - i]; }
+
+    /**
+     * @brief Get the oldest element. Undefined if the buffer is empty.
+     */
+    const T& front() const { return data_[head_]; }
+
+    /**
+     * @brief Get the newest element. Undefined if the buffer is empty.
+     */
+    const T& back() const { return fromNewest(0); }
+
+    /**
+     * @brief Get the number of elements currently held.
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Get the maximum number of elements held.
+     */
+    size_t capacity() const { return limit_; }
+
+    /**
+     * @brief Check if the buffer holds no elements.
+     */
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief Check if the next push will overwrite the oldest element.
+     */
+    bool full() const { return size_ == limit_; }
+
+    /**
+     * @brief Remove all elements. Storage is retained.
+     */
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    size_t limit_; ///< Usable length of the buffer, at most N
+    size_t head_;  ///< Index of the oldest element
+    size_t size_;  ///< Number of elements held
+    T data_[N];    ///< Element storage
+};
+
+#endif // RING_BUFFER_HPP
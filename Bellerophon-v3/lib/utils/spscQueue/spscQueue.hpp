@@ -0,0 +1,117 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+
+/**
+ * @class SpscQueue
+ * @brief Lock-free single-producer, single-consumer queue.
+ *
+ * Passes samples from an interrupt (or, on the host, a thread) to the main
+ * loop without disabling interrupts. Only the producer writes the tail and
+ * only the consumer writes the head. Each side publishes its index with
+ * release ordering after touching the slot, and reads the other side's
+ * index with acquire ordering, so a slot is never read before it is written
+ * or overwritten before it is read.
+ *
+ * Pushing into a full queue drops the new element and counts it, so the
+ * producer never waits on the consumer.
+ *
+ * @tparam T Element type, copied in and out.
+ * @tparam N Capacity, a power of two.
+ */
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert(N > 1 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    /**
+     * @brief Constructor for SpscQueue.
+     */
+    SpscQueue() : head_(0), tail_(0), dropped_(0), data_{} {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Append an element. Producer only.
+     * 
+     * @param value The element to append.
+     * @return True if appended, false if the queue was full and the element dropped.
+     */
+    bool push(const T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == N) {
+            dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        data_[tail & (N - 1)] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element. Consumer only.
+     * 
+     * @param value Output for the removed element.
+     * @return True if an element was removed, false if the queue was empty.
+     */
+    bool pop(T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = data_[head & (N - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Get the number of queued elements. Either side may change it
+     * straight after, so it is only a snapshot.
+     * 
+     * @return Number of elements.
+     */
+    size_t size() const {
+        // Head first, so the tail read after it can not be behind it
+        size_t head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+
+    /**
+     * @brief Check if the queue is empty.
+     * 
+     * @return True if empty.
+     */
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Get the number of elements dropped because the queue was full.
+     * 
+     * @return Number of dropped elements.
+     */
+    uint32_t getDroppedCount() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the capacity of the queue.
+     * 
+     * @return Capacity N.
+     */
+    static constexpr size_t capacity() {
+        return N;
+    }
+
+private:
+    std::atomic<size_t> head_; ///< Index of the next element to pop, written by the consumer
+    std::atomic<size_t> tail_; ///< Index of the next element to push, written by the producer
+    std::atomic<uint32_t> dropped_; ///< Elements dropped while full, written by the producer
+    T data_[N]; ///< Element storage
+};
+
+#endif // SPSC_QUEUE_HPP
@@ -0,0 +1,86 @@
+#include "taskScheduler.hpp"
+
+TaskScheduler::TaskScheduler(uint64_t (*clock)())
+    : tasks_(), order_(), numTasks_(0), clock_(clock) {}
+
+int TaskScheduler::addTask(const char* name, TaskFunction run, TaskPriority priority,
+                           uint32_t periodMicros, uint32_t deadlineMicros) {
+    if (numTasks_ >= MAX_TASKS || run == nullptr) {
+        return -1;
+    }
+    int id = static_cast<int>(numTasks_);
+    tasks_[id] = {name, run, priority, periodMicros, deadlineMicros, true, 0, 0, 0, 0};
+
+    // Insert after every task of the same or higher priority
+    size_t position = numTasks_;
+    while (position > 0 && tasks_[order_[position - 1]].priority > priority) {
+        order_[position] = order_[position - 1];
+        position--;
+    }
+    order_[position] = static_cast<uint8_t>(id);
+    numTasks_++;
+    return id;
+}
+
+void TaskScheduler::setEnabled(int id, bool enabled) {
+    if (id < 0 || static_cast<size_t>(id) >= numTasks_) {
+        return;
+    }
+    Task& task = tasks_[id];
+    if (enabled && !task.enabled) {
+        task.release = 0; // Released on the next pass
+    }
+    task.enabled = enabled;
+}
+
+bool TaskScheduler::runPass() {
+    uint64_t now = clock_();
+    for (size_t i = 0; i < numTasks_; ++i) {
+        Task& task = tasks_[order_[i]];
+        if (!task.enabled || now < task.release) {
+            continue;
+        }
+        if (runTask(task, now)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::runTask(Task& task, uint64_t now) {
+    if (task.period == 0 || task.release == 0) {
+        // Polled, or the first release of a periodic task, released by this pass
+        task.release = now;
+    } else if (now - task.release >= task.period) {
+        // Held past whole periods, skip to the newest release rather than run each one
+        task.release += ((now - task.release) / task.period) * task.period;
+    }
+    uint64_t release = task.release;
+    uint64_t start = clock_();
+
+    bool didWork = task.run();
+
+    uint64_t end = clock_();
+    if (didWork) {
+        task.runs++;
+    }
+    if (end - start > task.maxRunTime) {
+        task.maxRunTime = end - start;
+    }
+    if (task.deadline > 0 && end > release + task.deadline) {
+        task.deadlineMisses++;
+    }
+
+    if (task.period > 0) {
+        task.release = release + task.period;
+    }
+    return didWork;
+}
+
+size_t TaskScheduler::getNumTasks() const {
+    return numTasks_;
+}
+
+const Task& TaskScheduler::getTask(int id) const {
+    return tasks_[id];
+}
@@ -0,0 +1,132 @@
+#ifndef TASK_SCHEDULER_HPP
+#define TASK_SCHEDULER_HPP
+
+#include <cstddef>
+#include <stdint.h>
+
+/**
+ * @enum TaskPriority
+ * @brief Priority classes, most urgent first.
+ *
+ * Every flight task outranks every ground-support task, so ground work only
+ * runs in passes where no flight task had anything to do.
+ */
+enum class TaskPriority : uint8_t {
+    FLIGHT_CRITICAL, ///< Sensing, flight state and pyro decisions
+    FLIGHT,          ///< Flight data logging and reports
+    PERIPHERAL,      ///< Buzzer and LEDs
+    GROUND           ///< Serial commands, file transfer, config, servo jog
+};
+
+/**
+ * @brief A task step. Must return quickly rather than wait.
+ *
+ * @return True if the step did work, false if it had nothing to do.
+ */
+typedef bool (*TaskFunction)();
+
+/**
+ * @struct Task
+ * @brief A statically allocated task and its run statistics.
+ */
+struct Task {
+    const char* name;       ///< Name for reports
+    TaskFunction run;       ///< Step function
+    TaskPriority priority;  ///< Priority class
+    uint32_t period;        ///< Time between releases (us), 0 to poll on every pass
+    uint32_t deadline;      ///< Time after release the step must finish by (us), 0 for none
+    bool enabled;           ///< Disabled tasks are not run
+    uint64_t release;       ///< Next release time (us)
+    uint32_t runs;          ///< Steps that did work
+    uint32_t deadlineMisses; ///< Steps that finished after their deadline
+    uint32_t maxRunTime;    ///< Longest step (us)
+};
+
+/**
+ * @class TaskScheduler
+ * @brief Cooperative fixed-priority scheduler for the main loop.
+ *
+ * Each pass walks the tasks from the highest priority down and runs every
+ * enabled task that is released, stopping after the first one that did work
+ * so the next pass starts from the top again. Within a priority class tasks
+ * run in the order they were added. A polled task (period 0) is released on
+ * every pass; a periodic task is released on a fixed grid of its period,
+ * skipping releases it was held past rather than running them back to back.
+ *
+ * Steps are never interrupted, so the response of a high priority task is
+ * bounded by the longest single step of any task. Tasks must therefore do
+ * one bounded piece of work per call and keep their progress in their own
+ * state.
+ */
+class TaskScheduler {
+public:
+    static constexpr size_t MAX_TASKS = 10; ///< Tasks a scheduler can hold
+
+    /**
+     * @brief Constructor for TaskScheduler.
+     *
+     * @param clock Function returning the current time (us) used to time
+     *        steps, normally Timer::currentTimeMicros.
+     */
+    explicit TaskScheduler(uint64_t (*clock)());
+
+    /**
+     * @brief Add an enabled task.
+     *
+     * @param name Name for reports, which must outlive the scheduler.
+     * @param run Step function.
+     * @param priority Priority class.
+     * @param periodMicros Time between releases (us), 0 to poll on every pass.
+     * @param deadlineMicros Time after release each step must finish by (us), 0 for none.
+     * @return Task id, or -1 if the scheduler is full or run is null.
+     */
+    int addTask(const char* name, TaskFunction run, TaskPriority priority,
+                uint32_t periodMicros = 0, uint32_t deadlineMicros = 0);
+
+    /**
+     * @brief Enable or disable a task. An enabled periodic task is released straight away.
+     *
+     * @param id Task id from addTask().
+     * @param enabled True to run the task.
+     */
+    void setEnabled(int id, bool enabled);
+
+    /**
+     * @brief Run one scheduling pass.
+     *
+     * @return True if a task did work.
+     */
+    bool runPass();
+
+    /**
+     * @brief Get the number of tasks.
+     *
+     * @return Number of tasks.
+     */
+    size_t getNumTasks() const;
+
+    /**
+     * @brief Get a task by id.
+     *
+     * @param id Task id from addTask().
+     * @return The task.
+     */
+    const Task& getTask(int id) const;
+
+private:
+    Task tasks_[MAX_TASKS]; ///< Tasks by id
+    uint8_t order_[MAX_TASKS]; ///< Task ids from highest priority down
+    size_t numTasks_; ///< Number of tasks
+    uint64_t (*clock_)(); ///< Clock used to time steps
+
+    /**
+     * @brief Run a released task and update its statistics and next release.
+     *
+     * @param task The task.
+     * @param now Time of the pass (us).
+     * @return True if the step did work.
+     */
+    bool runTask(Task& task, uint64_t now);
+};
+
+#endif // TASK_SCHEDULER_HPP
@@ -1,4 +1,21 @@
 #include "timer.hpp"
+#include "interruptGuard.hpp"
+
+#ifndef ARDUINO
+#include <chrono>
+#include <cstdio>
+
+namespace {
+    // Host stand-ins for the Arduino clocks, from the first call, wrapping as they do
+    uint64_t hostMicros() {
+        static const auto start = std::chrono::steady_clock::now();
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+    uint32_t millis() { return static_cast<uint32_t>(hostMicros() / 1000); }
+    uint32_t micros() { return static_cast<uint32_t>(hostMicros()); }
+}
+#endif
 
 // Constructor to initialize the Timer
 Timer::Timer() : _startTime(0), _duration(0), _running(false) {}
@@ -31,4 +48,30 @@ void Timer::reset() {
 // Gets the current time in milliseconds
 uint32_t Timer::currentTime() {
     return millis();
+}
+
+// Gets the current time in microseconds, extended to 64 bits
+uint64_t Timer::currentTimeMicros() {
+    static uint32_t lastMicros = 0;
+    static uint32_t wraps = 0;
+
+    // Read and extend atomically, so a call from an interrupt can not count a wrap twice.
+    // The guard restores the caller's mask, so interrupts stay off inside handlers and critical sections
+    InterruptGuard guard;
+    uint32_t now = micros();
+    if (now < lastMicros) {
+        wraps++;
+    }
+    lastMicros = now;
+    return (static_cast<uint64_t>(wraps) << 32) | now;
+}
+
+// Formats a microsecond timestamp without a 64-bit printf conversion
+int Timer::formatMicros(char* buffer, size_t size, uint64_t micros) {
+    unsigned long seconds = static_cast<unsigned long>(micros / 1000000);
+    unsigned long remainder = static_cast<unsigned long>(micros % 1000000);
+    if (seconds == 0) {
+        return snprintf(buffer, size, "%lu", remainder);
+    }
+    return snprintf(buffer, size, "%lu%06lu", seconds, remainder);
 }
\ No newline at end of file
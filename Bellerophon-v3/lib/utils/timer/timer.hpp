@@ -1,13 +1,19 @@
 #ifndef TIMER_HPP
 #define TIMER_HPP
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
 
 /**
  * @class Timer
  * @brief A simple class for handling non-blocking delays.
  *
  * This class provides functionality to handle non-blocking delays using the Arduino `millis()` function.
+ * Host builds use a steady clock instead, so code that keeps time can be unit tested natively.
  */
 class Timer {
 public:
@@ -40,6 +46,26 @@ public:
      */
     static uint32_t currentTime();
 
+    /**
+     * @brief Gets the current time in microseconds as a 64-bit value.
+     * Extends Arduino micros() past its 71 minute wrap, so it must be called
+     * at least once per wrap period. Safe to call from interrupts and critical
+     * sections: the interrupt mask is restored as it was, never turned on.
+     * This is the shared time base for sample timestamps, logs and telemetry.
+     * @return The current time in microseconds.
+     */
+    static uint64_t currentTimeMicros();
+
+    /**
+     * @brief Formats a microsecond timestamp as decimal text.
+     * Avoids 64-bit printf conversions, which embedded printf does not always support.
+     * @param buffer The buffer to write into.
+     * @param size The size of the buffer.
+     * @param micros The timestamp in microseconds.
+     * @return The number of characters written, as snprintf.
+     */
+    static int formatMicros(char* buffer, size_t size, uint64_t micros);
+
 private:
     uint32_t _startTime; // The start time of the timer
     uint32_t _duration;  // The duration for which the timer should run
@@ -15,11 +15,12 @@
 #include "configKeys.hpp"
 #include "constants.hpp"
 #include "serialAction.hpp"
-#include "pyroController.hpp"
 #include "LEDController.hpp"
 #include "buzzerFunctions.hpp"
 #include "LEDManager.hpp"
 #include "flightStateMachine.hpp"
+#include "profiler.hpp"
+#include "taskScheduler.hpp"
 
 size_t buzzerQueueLimit = 20;
 // Class Declarations
@@ -34,11 +35,99 @@ DataLogger logger(serialComm, fm);
 ConfigFileManager config(fm);
 SerialAction serialAction(serialComm, config, logger, controlFins, buzzerFunc, LED);
 
-Timer testTimer;
-FlightStateMachine flightState(buzzerFunc, logger);
+FlightStateMachine flightState(buzzerFunc, logger, controlFins);
+
+TaskScheduler scheduler(Timer::currentTimeMicros);
+int standbyTaskId = -1;
+int dataLoggingTaskId = -1;
+// False if sensor sampling or the pyro timer failed to start, the computer then stays in standby
+bool flightReady = false;
+
+// keep track of previous tones
+int previousMode = -1;  
+
+// TASKS
+// Each task does one bounded step and returns whether it did any work.
+
+// Sensors, sensor fusion, flight state and pyros, at the fixed control rate
+bool flightTask() {
+    if (!flightState.update()) {
+        return false;
+    }
+    // File transfer, purge, config changes and fin control are refused once the rocket leaves the ground
+    serialAction.setBlockingActionsAllowed(flightState.isOnGround());
+    return true;
+}
+
+// Flight data logging and overrun reports
+bool flightLoggingTask() {
+    return flightState.updateBackground();
+}
+
+bool peripheralTask() {
+    PROFILE_SCOPE(PERIPHERALS);
+    buzzerFunc.update();
+    LED.updateAllLEDS();
+    return true;
+}
+
+// Mode changes and the serial commands of the current mode
+bool serialTask() {
+    // Read serial monitor and change mode if input is given as:
+    // mode:MODE_NUM
+    bool handled = serialAction.update();
+
+    if (!flightReady && mode != STANDBY_MODE) {
+        Serial.println("Flight system failed to start, staying in standby.");
+        buzzerFunc.failure();
+        mode = STANDBY_MODE;
+    }
+
+    if (mode != previousMode) {
+        // Play a tone to indicate mode of operation
+        buzzerFunc.modeSelect(mode);
+        // Only the current mode's own tasks run
+        scheduler.setEnabled(standbyTaskId, mode == STANDBY_MODE);
+        scheduler.setEnabled(dataLoggingTaskId, mode == LOGGING_MODE);
+        previousMode = mode;
+    }
+    return handled;
+}
+
+bool standbyTask() {
+    if (!flightReady) {
+        // Blink red until the computer is restarted with a working flight system
+        LED.blink(R_LED, 1000);
+        return true;
+    }
+    LED.cycleLEDs(5000);
+    return true;
+}
+
+bool dataLoggingTask() {
+    // log data to data file
+    flightState.logSensorData();
+    return true;
+}
+
+void addTasks() {
+    // Flight tasks outrank every ground task, whatever the mode
+    scheduler.addTask("flight", flightTask, TaskPriority::FLIGHT_CRITICAL);
+    scheduler.addTask("flight_logging", flightLoggingTask, TaskPriority::FLIGHT);
+    scheduler.addTask("peripherals", peripheralTask, TaskPriority::PERIPHERAL, 1000, 1000);
+    scheduler.addTask("serial", serialTask, TaskPriority::GROUND);
+    // Mode tasks, enabled by serialTask() for their mode
+    standbyTaskId = scheduler.addTask("standby", standbyTask, TaskPriority::GROUND, 10000);
+    dataLoggingTaskId = scheduler.addTask("data_logging", dataLoggingTask, TaskPriority::GROUND, 1000000);
+    scheduler.setEnabled(standbyTaskId, false);
+    scheduler.setEnabled(dataLoggingTaskId, false);
+}
 
 void setup() {
 
+#ifdef PROFILING
+    Profiler::begin();
+#endif
     Wire.begin(); // Join i2c bus
     serialComm.begin();
     // initilize classes
@@ -48,64 +137,22 @@ void setup() {
     config.initialize();
     logger.initialize();
     controlFins.initialize();
+    // Sensors are read on the sampling tick from here on, by the flight task
+    flightReady = flightState.begin();
+    addTasks();
     // play start up sequence
     LED.startUp();
-    buzzerFunc.startUp();
+    if (flightReady) {
+        buzzerFunc.startUp();
+    } else {
+        Serial.println("Flight system failed to start.");
+        buzzerFunc.failure();
+    }
 
 }
-// keep track of previous tones
-int previousMode = -1;  
-int time1 = 0;
-int time2 = 0;
-
 // MAIN LOOP
 
 void loop()
 {
-    // Read serial monitor and change mode if input is given as:
-    // mode:MODE_NUM
-    serialAction.checkSerialForMode();
-    // Play a tone to indicate mode of opera tion
-    if (mode != previousMode) {
-        buzzerFunc.modeSelect(mode);
-        previousMode = mode;
-    }
-
-    buzzerFunc.update();
-    LED.updateAllLEDS();
-   
-    flightState.update();
-
-    switch (mode) {
-        
-        case STANDBY_MODE: {
-            // do nothing
-            LED.cycleLEDs(5000);
-            //controlFins.continuousDeflect(250, 15);
-            break;
-        }    
-        case READING_MODE: {
-            // communicate with python serial to download flash data
-            serialAction.serialFileTransfer();
-            break;
-        } 
-        case PURGE_MODE: {
-            // delete all files from flash memory
-            serialAction.purgeDataFromSerial();
-            break;
-        }
-        case LOGGING_MODE: {
-            // log data to data file
-            flightState.logSensorData(1000);
-            break;
-        }
-        case FIN_CONTROL_MODE: {
-            serialAction.moveServosFromSerial();
-            break;
-        }
-        case CONFIG_MODE: {
-            serialAction.processAndChangeConfig();
-            break;
-        }
-    }
-}
\ No newline at end of file
+    scheduler.runPass();
+}
@@ -0,0 +1,113 @@
+#include <unity.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "altitudeTable.hpp"
+
+// Documented worst-case error of the table across 0 - 30 km (m)
+const float MAX_TABLE_ERROR = 0.003f;
+const double SEA_LEVEL_PRESSURE = 101325.0;
+
+AltitudeTable table;
+
+// Pressure at a given altitude according to the reference formula
+double pressureAtAltitude(double altitude, double referencePressure) {
+    return referencePressure * pow(1.0 - altitude / 44330.77, 1.0 / 0.1902632);
+}
+
+// Largest absolute error of the table between two altitudes (m)
+double maxTableError(double fromAltitude, double toAltitude, double referencePressure) {
+    double maxError = 0;
+    for (double altitude = fromAltitude; altitude <= toAltitude; altitude += 0.25) {
+        // Compare against the formula at the float pressure the table actually sees
+        float pressure = static_cast<float>(pressureAtAltitude(altitude, referencePressure));
+        double error = fabs(table.altitude(pressure) - AltitudeTable::referenceAltitude(pressure, referencePressure));
+        if (error > maxError) {
+            maxError = error;
+        }
+    }
+    return maxError;
+}
+
+// Setup function runs before each test
+void setUp(void) {
+    table.setReferencePressure(SEA_LEVEL_PRESSURE);
+}
+
+// Teardown function runs after each test
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+// Test case for accuracy against the reference formula from 0 to 30 km
+void test_matches_reference_formula(void) {
+    double maxError = maxTableError(-500.0, 30000.0, SEA_LEVEL_PRESSURE);
+
+    char message[60];
+    snprintf(message, sizeof(message), "Worst-case error 0 - 30 km: %.4f m", maxError);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE_MESSAGE(maxError <= MAX_TABLE_ERROR, "Table error exceeds documented bound.");
+}
+
+// Test case for regeneration when the reference pressure changes
+void test_rebuilds_on_reference_change(void) {
+    const double referencePressure = 98000.0;
+    table.setReferencePressure(referencePressure);
+
+    TEST_ASSERT_EQUAL_FLOAT(referencePressure, table.getReferencePressure());
+    TEST_ASSERT_FLOAT_WITHIN(MAX_TABLE_ERROR, 0.0f, table.altitude(referencePressure));
+    TEST_ASSERT_TRUE(maxTableError(0.0, 30000.0, referencePressure) <= MAX_TABLE_ERROR);
+}
+
+// Test case for pressures outside the table falling back to the formula
+void test_out_of_range_fallback(void) {
+    const float lowPressure = 200.0f;
+    const float highPressure = 140000.0f;
+
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, AltitudeTable::referenceAltitude(lowPressure, SEA_LEVEL_PRESSURE),
+                             table.altitude(lowPressure));
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, AltitudeTable::referenceAltitude(highPressure, SEA_LEVEL_PRESSURE),
+                             table.altitude(highPressure));
+}
+
+// Benchmark of the table against the pow() formula it replaces
+void test_benchmark_against_pow(void) {
+    const int iterations = 1000000;
+    volatile float sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        float pressure = 1000.0f + (i % 100000);
+        sink = sink + table.altitude(pressure);
+    }
+    auto tableTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        float pressure = 1000.0f + (i % 100000);
+        sink = sink + 44330.77 * (1 - pow(pressure / SEA_LEVEL_PRESSURE, 0.1902632));
+    }
+    auto powTime = std::chrono::steady_clock::now() - start;
+
+    double tableNs = std::chrono::duration<double, std::nano>(tableTime).count() / iterations;
+    double powNs = std::chrono::duration<double, std::nano>(powTime).count() / iterations;
+
+    char message[80];
+    snprintf(message, sizeof(message), "table: %.2f ns/call, pow: %.2f ns/call", tableNs, powNs);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_FALSE(std::isnan(sink));
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_matches_reference_formula);
+    RUN_TEST(test_rebuilds_on_reference_change);
+    RUN_TEST(test_out_of_range_fallback);
+    RUN_TEST(test_benchmark_against_pow);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,130 @@
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "apogeeDetector.hpp"
+
+const float VELOCITY_THRESHOLD = 0.5f; // m/s
+const float ALTITUDE_DROP = 1.0f;      // m
+const uint32_t HOLD = 100000;          // APOGEE_TIMER default (us)
+const uint32_t PERIOD = 2000;          // 500 Hz control tick (us)
+
+ApogeeDetector makeDetector() {
+    ApogeeDetector detector;
+    detector.configure(VELOCITY_THRESHOLD, ALTITUDE_DROP, HOLD, 2);
+    return detector;
+}
+
+void setUp(void) {
+    // Any setup code can go here
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_unconfigured_never_detects(void) {
+    ApogeeDetector detector;
+    TEST_ASSERT_FALSE(detector.update(0, -10, -10, 0));
+    TEST_ASSERT_FALSE(detector.update(1000000, -10, -10, -100));
+}
+
+void test_condition_must_hold_for_the_timer(void) {
+    ApogeeDetector detector = makeDetector();
+    detector.update(0, 50, 50, 100);
+    TEST_ASSERT_FALSE(detector.update(10000, 0, 0, 100));
+    TEST_ASSERT_FALSE(detector.update(108000, 0, 0, 100));
+    TEST_ASSERT_TRUE(detector.update(110000, 0, 0, 100));
+    TEST_ASSERT_EQUAL(110000, detector.getDetectionTime());
+    TEST_ASSERT_TRUE(detector.isContributing(ApogeeSignal::KALMAN_VELOCITY));
+    TEST_ASSERT_TRUE(detector.isContributing(ApogeeSignal::IMU_VELOCITY));
+    TEST_ASSERT_FALSE(detector.isContributing(ApogeeSignal::ALTITUDE_FALLING));
+    TEST_ASSERT_EQUAL(10000, detector.getSignalTime(ApogeeSignal::KALMAN_VELOCITY));
+    TEST_ASSERT_EQUAL(10000, detector.getSignalTime(ApogeeSignal::IMU_VELOCITY));
+
+    // Latched once detected
+    TEST_ASSERT_TRUE(detector.update(120000, 50, 50, 200));
+    TEST_ASSERT_EQUAL(110000, detector.getDetectionTime());
+}
+
+void test_noise_spike_restarts_the_hold(void) {
+    ApogeeDetector detector = makeDetector();
+    TEST_ASSERT_FALSE(detector.update(0, 0, 0, 100));
+    TEST_ASSERT_FALSE(detector.update(90000, 0, 0, 100));
+    // One sample above the threshold breaks both holds
+    TEST_ASSERT_FALSE(detector.update(92000, 5, 5, 100));
+    TEST_ASSERT_FALSE(detector.update(94000, 0, 0, 100));
+    TEST_ASSERT_FALSE(detector.update(150000, 0, 0, 100));
+    TEST_ASSERT_TRUE(detector.update(194000, 0, 0, 100));
+}
+
+void test_one_signal_is_not_enough(void) {
+    ApogeeDetector detector = makeDetector();
+    // Kalman velocity spikes low while the IMU still sees the climb
+    for (uint64_t now = 0; now <= 500000; now += PERIOD) {
+        TEST_ASSERT_FALSE(detector.update(now, -3, 40, 100 + now * 1e-5f));
+    }
+    TEST_ASSERT_FALSE(detector.isApogee());
+}
+
+void test_altitude_falling_backs_up_missing_imu(void) {
+    ApogeeDetector detector = makeDetector();
+    detector.update(0, 5, NAN, 300);
+    TEST_ASSERT_FALSE(detector.update(2000, 0, NAN, 300));
+    TEST_ASSERT_FALSE(detector.update(150000, 0, NAN, 299.5f));
+    TEST_ASSERT_FALSE(detector.update(160000, 0, NAN, 298.9f));
+    TEST_ASSERT_TRUE(detector.update(260000, 0, NAN, 298));
+    TEST_ASSERT_FALSE(detector.isContributing(ApogeeSignal::IMU_VELOCITY));
+    TEST_ASSERT_TRUE(detector.isContributing(ApogeeSignal::ALTITUDE_FALLING));
+    TEST_ASSERT_EQUAL(160000, detector.getSignalTime(ApogeeSignal::ALTITUDE_FALLING));
+    TEST_ASSERT_EQUAL_FLOAT(300, detector.getMaxAltitude());
+
+    detector.reset();
+    TEST_ASSERT_FALSE(detector.isApogee());
+    TEST_ASSERT_EQUAL(0, detector.getSignalTime(ApogeeSignal::KALMAN_VELOCITY));
+}
+
+void test_simulated_coast_latency(void) {
+    // Coast to apogee at t = 3 s with +-1.5 m/s velocity noise and a 10 m/s
+    // single sample dropout in the Kalman velocity half way up
+    srand(1);
+    ApogeeDetector detector = makeDetector();
+    const float apogeeTime = 3.0f;
+    const float g = 9.81f;
+    for (uint64_t now = 0; now < 5000000 && !detector.isApogee(); now += PERIOD) {
+        float t = now * 1e-6f;
+        float velocity = g * (apogeeTime - t);
+        float altitude = 500 - 0.5f * g * (apogeeTime - t) * (apogeeTime - t);
+        float kalman = velocity + (rand() % 300 - 150) * 0.01f;
+        float imu = velocity + (rand() % 300 - 150) * 0.01f;
+        if (now == 1500000) {
+            kalman = -10;
+        }
+        detector.update(now, kalman, imu, altitude);
+    }
+    TEST_ASSERT_TRUE(detector.isApogee());
+
+    float latency = detector.getDetectionTime() * 1e-3f - apogeeTime * 1e3f;
+    char message[64];
+    snprintf(message, sizeof(message), "apogee detected %.1f ms after true apogee", latency);
+    TEST_MESSAGE(message);
+    // Never before apogee, and within the hold plus the noise band
+    TEST_ASSERT_TRUE(latency > 0);
+    TEST_ASSERT_TRUE(latency < HOLD * 1e-3f + 250);
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_unconfigured_never_detects);
+    RUN_TEST(test_condition_must_hold_for_the_timer);
+    RUN_TEST(test_noise_spike_restarts_the_hold);
+    RUN_TEST(test_one_signal_is_not_enough);
+    RUN_TEST(test_altitude_falling_backs_up_missing_imu);
+    RUN_TEST(test_simulated_coast_latency);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,144 @@
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "apogeePredictor.hpp"
+
+const float G = 9.81f;
+const uint32_t PERIOD = 2000; // 500 Hz control tick (us)
+
+/**
+ * Simulated flight: 2 s burn at 60 m/s^2 net, then a coast with quadratic drag.
+ * Integrated at the control tick, with optional noise on the fused state.
+ */
+struct SimulatedFlight {
+    float drag;
+    float noise;
+    float altitude = 0;
+    float velocity = 0;
+    float acceleration = 0;
+
+    SimulatedFlight(float dragFactor, float noiseLevel) : drag(dragFactor), noise(noiseLevel) {}
+
+    void step(uint64_t now) {
+        float dt = PERIOD * 1e-6f;
+        acceleration = now < 2000000 ? 60.0f : -G - drag * velocity * std::fabs(velocity);
+        velocity += acceleration * dt;
+        altitude += velocity * dt;
+    }
+
+    float sample(float value, float scale) const {
+        return value + (rand() % 2001 - 1000) * 1e-3f * noise * scale;
+    }
+};
+
+void setUp(void) {
+    // Any setup code can go here
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_no_prediction_under_thrust(void) {
+    ApogeePredictor predictor(G);
+    for (uint64_t now = 0; now < 1000000; now += PERIOD) {
+        TEST_ASSERT_FALSE(predictor.update(now, now * 1e-4f, 50, 60));
+    }
+    TEST_ASSERT_FALSE(predictor.hasPrediction());
+    TEST_ASSERT_EQUAL(0, predictor.getPredictedTime());
+}
+
+void test_vacuum_coast_is_ballistic(void) {
+    ApogeePredictor predictor(G);
+    // Decelerating at exactly g: no drag, t = v/g, h = v^2/(2g)
+    for (uint64_t now = 0; now < 20 * PERIOD; now += PERIOD) {
+        predictor.update(now, 1000, 98.1f, -G);
+    }
+    TEST_ASSERT_TRUE(predictor.hasPrediction());
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0, predictor.getDragFactor());
+    TEST_ASSERT_FLOAT_WITHIN(1000, 19 * PERIOD + 10000000, predictor.getPredictedTime());
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1490.5f, predictor.getPredictedAltitude());
+}
+
+void test_measures_quadratic_drag(void) {
+    ApogeePredictor predictor(G);
+    const float k = 0.002f;
+    float velocity = 150;
+    for (uint64_t now = 0; now < 50 * PERIOD; now += PERIOD) {
+        predictor.update(now, 1000, velocity, -G - k * velocity * velocity);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, k, predictor.getDragFactor());
+
+    // Closed form: t = atan(v sqrt(k/g)) / sqrt(g k), h = ln(1 + k v^2 / g) / (2k)
+    float time = std::atan(velocity * std::sqrt(k / G)) / std::sqrt(G * k);
+    float height = std::log(1 + k * velocity * velocity / G) / (2 * k);
+    TEST_ASSERT_FLOAT_WITHIN(1000, 49 * PERIOD + time * 1e6f, predictor.getPredictedTime());
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1000 + height, predictor.getPredictedAltitude());
+}
+
+void test_tracks_peak(void) {
+    ApogeePredictor predictor(G);
+    predictor.update(1000, 10, 5, 0);
+    predictor.update(2000, 12, 0, 0);
+    predictor.update(3000, 11, -5, 0);
+    TEST_ASSERT_EQUAL_FLOAT(12, predictor.getPeakAltitude());
+    TEST_ASSERT_EQUAL(2000, predictor.getPeakTime());
+
+    predictor.reset();
+    TEST_ASSERT_EQUAL(0, predictor.getPeakTime());
+    TEST_ASSERT_FALSE(predictor.hasPrediction());
+}
+
+void test_simulated_flight_prediction(void) {
+    const float k = 0.0015f;
+
+    // Find the true apogee first
+    SimulatedFlight truth(k, 0);
+    uint64_t trueTime = 0;
+    for (uint64_t now = 0; now < 30000000 && trueTime == 0; now += PERIOD) {
+        truth.step(now);
+        if (truth.velocity <= 0) {
+            trueTime = now;
+        }
+    }
+    TEST_ASSERT_TRUE(trueTime > 0);
+
+    // Fly again with noise, taking the prediction one second before apogee,
+    // when the drogue is armed
+    srand(1);
+    SimulatedFlight flight(k, 1.0f);
+    ApogeePredictor predictor(G);
+    for (uint64_t now = 0; now <= trueTime - 1000000; now += PERIOD) {
+        flight.step(now);
+        predictor.update(now, flight.sample(flight.altitude, 1.0f), flight.sample(flight.velocity, 0.5f),
+                         flight.sample(flight.acceleration, 2.0f));
+    }
+    TEST_ASSERT_TRUE(predictor.hasPrediction());
+
+    float timeError = (static_cast<int64_t>(predictor.getPredictedTime()) - static_cast<int64_t>(trueTime)) * 1e-3f;
+    float altitudeError = predictor.getPredictedAltitude() - truth.altitude;
+    char message[96];
+    snprintf(message, sizeof(message), "apogee %.1f m, predicted 1 s ahead %.1f ms and %.2f m off, drag %.5f",
+             truth.altitude, timeError, altitudeError, predictor.getDragFactor());
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_FLOAT_WITHIN(k * 0.1f, k, predictor.getDragFactor());
+    TEST_ASSERT_FLOAT_WITHIN(50, 0, timeError);
+    TEST_ASSERT_FLOAT_WITHIN(3, 0, altitudeError);
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_no_prediction_under_thrust);
+    RUN_TEST(test_vacuum_coast_is_ballistic);
+    RUN_TEST(test_measures_quadratic_drag);
+    RUN_TEST(test_tracks_peak);
+    RUN_TEST(test_simulated_flight_prediction);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,142 @@
+#include <unity.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "attitudeEstimator.hpp"
+
+const float GRAVITY = 9.80665f;
+const float DEG = 0.0174532925f;
+
+// Update rates the estimator must support: the current 104 Hz ODR and 1.6 kHz
+const float SLOW_PERIOD = 1.0f / 104.0f;
+const float FAST_PERIOD = 1.0f / 1666.0f;
+
+AttitudeEstimator estimator;
+
+// Specific force measured at rest by a body with the given attitude
+Vector3 restingSpecificForce(const Quaternion& attitude) {
+    return attitude.rotateInverse({0, 0, GRAVITY});
+}
+
+// Attitude tilted about the body x axis by an angle
+Quaternion tiltedAboutX(float angle) {
+    return {cosf(0.5f * angle), sinf(0.5f * angle), 0, 0};
+}
+
+// Setup function runs before each test
+void setUp(void) {
+    estimator.reset(Quaternion::identity());
+}
+
+// Teardown function runs after each test
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_tilt_of_known_attitudes() {
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, estimator.getTilt());
+
+    estimator.reset(tiltedAboutX(30 * DEG));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 30 * DEG, estimator.getTilt());
+
+    estimator.reset(tiltedAboutX(180 * DEG));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 180 * DEG, estimator.getTilt());
+}
+
+void test_converges_to_gravity_at_rest() {
+    // Truth is upright; the estimate starts 20 degrees off
+    estimator.reset(tiltedAboutX(20 * DEG));
+    Vector3 force = restingSpecificForce(Quaternion::identity());
+
+    for (int i = 0; i < 5 * 104; ++i) {
+        estimator.update({0, 0, 0}, force, SLOW_PERIOD);
+    }
+    TEST_ASSERT_TRUE(estimator.isAccelerometerTrusted());
+    TEST_ASSERT_TRUE(estimator.getTilt() < 0.5f * DEG);
+}
+
+void test_estimates_gyro_bias() {
+    Vector3 bias = {0.01f, -0.02f, 0.0f};
+    Vector3 force = restingSpecificForce(Quaternion::identity());
+
+    for (int i = 0; i < 60 * 104; ++i) {
+        estimator.update(bias, force, SLOW_PERIOD);
+    }
+
+    // Heading bias is unobservable from gravity, so only check x and y
+    Vector3 estimatedBias = estimator.getGyroBias();
+    TEST_ASSERT_FLOAT_WITHIN(0.002f, bias.x, estimatedBias.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.002f, bias.y, estimatedBias.y);
+    TEST_ASSERT_TRUE(estimator.getTilt() < 0.1f * DEG);
+}
+
+void test_gates_accelerometer_under_thrust() {
+    // Upright boost at 6 g with a 1 g sideways component, e.g. from thrust misalignment
+    Vector3 boost = {GRAVITY, 0, 6 * GRAVITY};
+    AttitudeEstimator ungated(2.0f, 0.1f, 100.0f);
+    ungated.reset(Quaternion::identity());
+
+    for (int i = 0; i < 3 * 1666; ++i) {
+        estimator.update({0, 0, 0}, boost, FAST_PERIOD);
+        ungated.update({0, 0, 0}, boost, FAST_PERIOD);
+    }
+
+    TEST_ASSERT_FALSE(estimator.isAccelerometerTrusted());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, estimator.getTilt());
+    // Without the gate the sideways thrust is taken for gravity
+    TEST_ASSERT_TRUE(ungated.getTilt() > 5 * DEG);
+}
+
+void test_follows_rotation_on_gyro() {
+    // Roll through 90 degrees in one second with the accelerometer reading the boost
+    Vector3 rate = {90 * DEG, 0, 0};
+    Vector3 boost = {0, 0, 6 * GRAVITY};
+
+    for (int i = 0; i < 1666; ++i) {
+        estimator.update(rate, boost, FAST_PERIOD);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.2f * DEG, 90 * DEG, estimator.getTilt());
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, rate.x, estimator.getBodyRate().x);
+}
+
+void test_benchmark_update() {
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    const int samples = 4096;
+    Vector3 rates[samples];
+    Vector3 forces[samples];
+    for (int i = 0; i < samples; ++i) {
+        rates[i] = {noise(rng), noise(rng), noise(rng)};
+        forces[i] = {noise(rng), noise(rng), GRAVITY + noise(rng)};
+    }
+
+    const int iterations = 500000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        estimator.update(rates[i % samples], forces[i % samples], FAST_PERIOD);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+
+    char message[80];
+    snprintf(message, sizeof(message), "update: %.2f ns/sample", ns);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_FALSE(std::isnan(estimator.getTilt()));
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_tilt_of_known_attitudes);
+    RUN_TEST(test_converges_to_gravity_at_rest);
+    RUN_TEST(test_estimates_gyro_bias);
+    RUN_TEST(test_gates_accelerometer_under_thrust);
+    RUN_TEST(test_follows_rotation_on_gyro);
+    RUN_TEST(test_benchmark_update);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
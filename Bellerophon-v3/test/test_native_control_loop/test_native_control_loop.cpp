@@ -0,0 +1,118 @@
+#include <unity.h>
+#include "controlLoop.hpp"
+
+const uint32_t CONTROL_PERIOD = 2000; // 500 Hz control tick (us)
+
+void setUp(void) {
+    // Any setup code can go here
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_ticks_at_fixed_rate(void) {
+    ControlLoop loop(CONTROL_PERIOD);
+    int ticks = 0;
+    // Loop polled every 70 us for one second, each tick taking 300 us
+    for (uint64_t now = 0; now < 1000000; now += 70) {
+        if (loop.isDue(now)) {
+            ticks++;
+            now += 300;
+            loop.endTick(now);
+        }
+    }
+    TEST_ASSERT_EQUAL(500, ticks);
+    TEST_ASSERT_EQUAL(500, loop.getTickCount());
+    TEST_ASSERT_EQUAL(0, loop.getOverrunCount());
+    TEST_ASSERT_EQUAL(0, loop.getSkippedCount());
+    // Polling granularity bounds the release jitter
+    TEST_ASSERT_TRUE(loop.getMaxJitter() < 70);
+}
+
+void test_does_not_drift_with_background_work(void) {
+    ControlLoop loop(CONTROL_PERIOD);
+    TEST_ASSERT_TRUE(loop.isDue(0));
+    loop.endTick(500);
+    // Background work delays the poll but releases stay on the grid
+    TEST_ASSERT_FALSE(loop.isDue(1999));
+    TEST_ASSERT_TRUE(loop.isDue(2600));
+    loop.endTick(2900);
+    TEST_ASSERT_FALSE(loop.isDue(3999));
+    TEST_ASSERT_TRUE(loop.isDue(4000));
+    loop.endTick(4100);
+    TEST_ASSERT_EQUAL(0, loop.getOverrunCount());
+    TEST_ASSERT_EQUAL(900, loop.getMaxResponseTime());
+}
+
+void test_long_tick_is_an_overrun(void) {
+    ControlLoop loop(CONTROL_PERIOD);
+    TEST_ASSERT_TRUE(loop.isDue(0));
+    loop.endTick(2500);
+    TEST_ASSERT_EQUAL(1, loop.getOverrunCount());
+    TEST_ASSERT_EQUAL(2500, loop.getLastOverrunTime());
+    TEST_ASSERT_EQUAL(500, loop.getLastOverrunLength());
+
+    // The next release has passed, so it runs straight away
+    TEST_ASSERT_TRUE(loop.isDue(2500));
+    loop.endTick(2600);
+    TEST_ASSERT_FALSE(loop.isDue(3999));
+    TEST_ASSERT_EQUAL(1, loop.getOverrunCount());
+    TEST_ASSERT_EQUAL(0, loop.getSkippedCount());
+}
+
+void test_stalled_loop_skips_missed_ticks(void) {
+    ControlLoop loop(CONTROL_PERIOD);
+    TEST_ASSERT_TRUE(loop.isDue(0));
+    loop.endTick(100);
+
+    // A flash write holds the loop past five releases
+    TEST_ASSERT_TRUE(loop.isDue(12500));
+    loop.endTick(12600);
+    TEST_ASSERT_EQUAL(1, loop.getOverrunCount());
+    TEST_ASSERT_EQUAL(12500, loop.getLastOverrunTime());
+    TEST_ASSERT_EQUAL(5, loop.getSkippedCount());
+
+    // Missed ticks are not run back to back and the phase is kept
+    TEST_ASSERT_FALSE(loop.isDue(12700));
+    TEST_ASSERT_FALSE(loop.isDue(13999));
+    TEST_ASSERT_TRUE(loop.isDue(14000));
+    TEST_ASSERT_EQUAL(3, loop.getTickCount());
+}
+
+void test_spare_time(void) {
+    ControlLoop loop(CONTROL_PERIOD);
+    TEST_ASSERT_EQUAL(0, loop.getSpareTime(0));
+    TEST_ASSERT_TRUE(loop.isDue(0));
+    loop.endTick(600);
+    TEST_ASSERT_EQUAL(1400, loop.getSpareTime(600));
+    TEST_ASSERT_EQUAL(0, loop.getSpareTime(2000));
+}
+
+void test_set_period_releases_next_tick(void) {
+    ControlLoop loop(CONTROL_PERIOD);
+    TEST_ASSERT_TRUE(loop.isDue(0));
+    loop.endTick(100);
+    loop.setPeriod(1000);
+    TEST_ASSERT_EQUAL(1000, loop.getPeriod());
+    TEST_ASSERT_TRUE(loop.isDue(150));
+    loop.endTick(200);
+    TEST_ASSERT_FALSE(loop.isDue(1149));
+    TEST_ASSERT_TRUE(loop.isDue(1150));
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_ticks_at_fixed_rate);
+    RUN_TEST(test_does_not_drift_with_background_work);
+    RUN_TEST(test_long_tick_is_an_overrun);
+    RUN_TEST(test_stalled_loop_skips_missed_ticks);
+    RUN_TEST(test_spare_time);
+    RUN_TEST(test_set_period_releases_next_tick);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
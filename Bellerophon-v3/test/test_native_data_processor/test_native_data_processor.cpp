@@ -0,0 +1,201 @@
+#include <unity.h>
+#include <cmath>
+#include "dataProcessor.hpp"
+
+const size_t HISTORY = 20;
+const uint64_t PERIOD = 10000; // Sample period (us)
+const uint64_t START = 5000000; // First timestamp, away from zero (us)
+
+// Processor fed directly by the test, without the stabilization wait
+class TestProcessor : public DataProcessor {
+public:
+    TestProcessor(size_t historySize, DifferentiationMethod method = DifferentiationMethod::ENDPOINT)
+        : DataProcessor(historySize, 10.0, method) {
+        stabilizationWaitTime = 0;
+    }
+
+    void update() override {}
+
+    void add(float value, uint64_t timestamp) {
+        updateBuffer(value, timestamp);
+    }
+
+    size_t bufferedSamples() const {
+        return samples.size();
+    }
+
+    size_t bufferCapacity() const {
+        return samples.capacity();
+    }
+};
+
+// Small deterministic noise, well inside the outlier filter
+float noise(size_t i) {
+    return 0.05f * std::sin(1.7f * static_cast<float>(i));
+}
+
+// Time of sample i (us)
+uint64_t sampleTime(size_t i) {
+    return START + i * PERIOD;
+}
+
+// Setup function runs before each test
+void setUp(void) {
+    // Any setup code can go here
+}
+
+// Teardown function runs after each test
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_least_squares_derivative_of_known_slope() {
+    TestProcessor processor(HISTORY, DifferentiationMethod::LEAST_SQUARES);
+    const float slope = 2.5f;
+
+    // Many windows, so the sums slide and resync repeatedly
+    for (size_t i = 0; i < 50 * HISTORY; ++i) {
+        float t = static_cast<float>(i * PERIOD) * 1e-6f;
+        processor.add(3.0f + slope * t, sampleTime(i));
+        if (processor.isStabilized() && i > 2 * HISTORY) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-3f, slope, processor.getDifferentiatedValue());
+        }
+    }
+
+    // Endpoint and least squares agree on a straight line
+    processor.setDifferentiationMethod(DifferentiationMethod::ENDPOINT);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, slope, processor.getDifferentiatedValue());
+}
+
+void test_sliding_fit_matches_a_fit_of_the_window() {
+    TestProcessor processor(HISTORY, DifferentiationMethod::LEAST_SQUARES);
+    const size_t count = 17 * HISTORY + 7; // Between two resyncs
+    for (size_t i = 0; i < count; ++i) {
+        float t = static_cast<float>(i * PERIOD) * 1e-6f;
+        processor.add(-1.0f * t + noise(i), sampleTime(i));
+    }
+
+    // Reference fit over the newest HISTORY samples, in double precision
+    double n = 0, st = 0, st2 = 0, sv = 0, stv = 0;
+    for (size_t i = count - HISTORY; i < count; ++i) {
+        double t = static_cast<double>(i * PERIOD) * 1e-6;
+        double v = -1.0 * t + noise(i);
+        n += 1;
+        st += t;
+        st2 += t * t;
+        sv += v;
+        stv += t * v;
+    }
+    double expected = (n * stv - st * sv) / (n * st2 - st * st);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, static_cast<float>(expected), processor.getDifferentiatedValue());
+    TEST_ASSERT_TRUE(processor.getResidualVariance() > 0.0f);
+    TEST_ASSERT_TRUE(processor.getSlopeVariance() > 0.0f);
+}
+
+void test_quadratic_fit_of_constant_acceleration() {
+    TestProcessor processor(HISTORY, DifferentiationMethod::QUADRATIC);
+    const float acceleration = 4.0f;
+    const size_t count = 3 * HISTORY;
+    for (size_t i = 0; i < count; ++i) {
+        float t = static_cast<float>(i * PERIOD) * 1e-6f;
+        processor.add(0.5f * acceleration * t * t, sampleTime(i));
+    }
+
+    // The slope is taken at the newest sample
+    float newest = static_cast<float>((count - 1) * PERIOD) * 1e-6f;
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, acceleration, processor.getSecondDifferentiatedValue());
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, acceleration * newest, processor.getDifferentiatedValue());
+}
+
+void test_memo_invalidated_by_push() {
+    TestProcessor processor(HISTORY);
+    for (size_t i = 0; i < HISTORY; ++i) {
+        processor.add(10.0f, sampleTime(i));
+    }
+    TEST_ASSERT_TRUE(processor.isStabilized());
+
+    // Repeated reads between samples reuse the memoised value
+    uint32_t epoch = processor.getSampleEpoch();
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, processor.getSmoothedValue());
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, processor.getSmoothedValue());
+    TEST_ASSERT_EQUAL(epoch, processor.getSampleEpoch());
+
+    // An accepted sample starts a new epoch, so the next read is recomputed
+    processor.add(15.0f, sampleTime(HISTORY));
+    TEST_ASSERT_TRUE(processor.getSampleEpoch() != epoch);
+    TEST_ASSERT_EQUAL_FLOAT(10.25f, processor.getSmoothedValue());
+
+    // A rejected sample leaves the buffer and the memoised values as they were
+    epoch = processor.getSampleEpoch();
+    processor.add(1000.0f, sampleTime(HISTORY + 1));
+    TEST_ASSERT_EQUAL(1, processor.getOutlierStatistics().rejected);
+    TEST_ASSERT_EQUAL(epoch, processor.getSampleEpoch());
+    TEST_ASSERT_EQUAL_FLOAT(10.25f, processor.getSmoothedValue());
+}
+
+void test_outlier_rejected_then_recovered() {
+    TestProcessor processor(HISTORY);
+    const size_t recoveryLimit = 5;
+    processor.setOutlierPolicy(3.0f, 15, recoveryLimit);
+    size_t i = 0;
+    for (; i < 2 * HISTORY; ++i) {
+        processor.add(100.0f + noise(i), sampleTime(i));
+    }
+
+    // A single spike is rejected and the run of rejections ends with the next good sample
+    processor.add(200.0f, sampleTime(i++));
+    TEST_ASSERT_EQUAL(1, processor.getOutlierStatistics().rejected);
+    TEST_ASSERT_EQUAL(1, processor.getOutlierStatistics().consecutive);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 100.0f, processor.getSmoothedValue());
+    processor.add(100.0f, sampleTime(i++));
+    TEST_ASSERT_EQUAL(0, processor.getOutlierStatistics().consecutive);
+
+    // A sustained step is rejected until the recovery limit, then accepted in order
+    for (size_t step = 0; step < recoveryLimit; ++step) {
+        TEST_ASSERT_EQUAL(0, processor.getOutlierStatistics().recoveries);
+        processor.add(150.0f + noise(i), sampleTime(i));
+        i++;
+    }
+    TEST_ASSERT_EQUAL(1, processor.getOutlierStatistics().recoveries);
+    TEST_ASSERT_EQUAL(1 + recoveryLimit, processor.getOutlierStatistics().rejected);
+    TEST_ASSERT_EQUAL(0, processor.getOutlierStatistics().consecutive);
+
+    // Samples at the new level keep being accepted while the window catches up
+    uint32_t rejected = processor.getOutlierStatistics().rejected;
+    for (size_t n = 0; n < 2 * HISTORY; ++n, ++i) {
+        processor.add(150.0f + noise(i), sampleTime(i));
+    }
+    TEST_ASSERT_EQUAL(rejected, processor.getOutlierStatistics().rejected);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 150.0f, processor.getSmoothedValue());
+    TEST_ASSERT_TRUE(processor.getOutlierStatistics().rejectionRate > 0.0f);
+}
+
+void test_history_size_up_to_the_compile_time_capacity() {
+    // Sizes above MAX_HISTORY_SIZE fail an assertion in the constructor, which can not be caught here
+    TestProcessor largest(MAX_HISTORY_SIZE);
+    TEST_ASSERT_EQUAL(MAX_HISTORY_SIZE, largest.bufferCapacity());
+    for (size_t i = 0; i < MAX_HISTORY_SIZE + 10; ++i) {
+        largest.add(1.0f, sampleTime(i));
+    }
+    TEST_ASSERT_TRUE(largest.isStabilized());
+    TEST_ASSERT_EQUAL(MAX_HISTORY_SIZE, largest.bufferedSamples());
+
+    TestProcessor smaller(HISTORY);
+    TEST_ASSERT_EQUAL(HISTORY, smaller.bufferCapacity());
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_least_squares_derivative_of_known_slope);
+    RUN_TEST(test_sliding_fit_matches_a_fit_of_the_window);
+    RUN_TEST(test_quadratic_fit_of_constant_acceleration);
+    RUN_TEST(test_memo_invalidated_by_push);
+    RUN_TEST(test_outlier_rejected_then_recovered);
+    RUN_TEST(test_history_size_up_to_the_compile_time_capacity);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
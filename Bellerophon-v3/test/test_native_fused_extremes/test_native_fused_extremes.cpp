@@ -0,0 +1,178 @@
+#include <unity.h>
+#include <cmath>
+#include <limits>
+#include "fusedExtremes.hpp"
+#include "sensorHealthMonitor.hpp"
+#include "pyroScheduler.hpp"
+
+const uint32_t TICK = 2000;              // 500 Hz control tick (us)
+const int BARO_DIVIDER = 10;             // Barometer sample every 10 ticks, 50 Hz
+const float GROUND = 250.0f;             // Ground altitude above sea level (m)
+const float MINIMUM_APOGEE = 100.0f;     // Altitude the pyros arm at (m)
+const uint32_t HOLD = 2000000;           // Pyro hold time (us)
+
+/**
+ * Altitude sensor whose readings are set directly by the test, tracking its
+ * own maximum as the barometric processor does.
+ */
+class FakeAltimeter : public SensorProcessor {
+public:
+    uint32_t updates = 0;
+    float altitude = 0;
+    float maxAltitude = 0;
+    float ground = GROUND;
+    float variance = 1.0f;
+    mutable float raw[1] = {0};
+
+    void newSample(float value) {
+        altitude = value;
+        raw[0] = value;
+        maxAltitude = (value > maxAltitude) ? value : maxAltitude;
+        updates++;
+    }
+
+    void update() override {}
+    bool hasEstimate(SensorOutput output) const override { return output != SensorOutput::ACCELERATION; }
+    float getVariance(SensorOutput) const override { return variance; }
+    uint32_t getUpdateCount() const override { return updates; }
+    float getAltitude() const override { return altitude; }
+    float getVerticalVelocity() const override { return 0; }
+    float getAcceleration() const override { return 0; }
+    float getGroundAltitude() const override { return ground; }
+    float getMaxAltitude() const override { return maxAltitude; }
+    float getMaxVelocity() const override { return 0; }
+    float getMaxAcceleration() const override { return 0; }
+    float* getRawData() const override { return raw; }
+    size_t getNumSensorValues() const override { return 1; }
+    std::string getSensorNames() const override { return "altitude"; }
+};
+
+uint64_t fakeTime = 0;
+
+uint64_t fakeClock() {
+    return fakeTime;
+}
+
+void noWrite(uint8_t, bool) {}
+
+/**
+ * @brief Latch the extremes of the healthy sensors, as SensorFusion does every update.
+ */
+void latch(FusedExtremes& extremes, FakeAltimeter* const* sensors, const SensorHealthMonitor* health, size_t count) {
+    extremes.begin();
+    for (size_t i = 0; i < count; ++i) {
+        if (health[i].isHealthy()) {
+            extremes.add(*sensors[i]);
+        }
+    }
+    extremes.latch();
+}
+
+void setUp(void) {
+    // Any setup code can go here
+    fakeTime = 0;
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_excluded_sensor_keeps_last_values(void) {
+    FakeAltimeter baro;
+    FakeAltimeter* sensors[] = {&baro};
+    SensorHealthMonitor health[1];
+    FusedExtremes extremes;
+
+    baro.newSample(180.0f);
+    latch(extremes, sensors, health, 1);
+    TEST_ASSERT_EQUAL_FLOAT(GROUND, extremes.getGroundAltitude());
+    TEST_ASSERT_EQUAL_FLOAT(180.0f, extremes.getMaxAltitude());
+
+    // No healthy sensor provides the estimate: nothing drops to 0
+    baro.variance = std::numeric_limits<float>::infinity();
+    latch(extremes, sensors, health, 1);
+    TEST_ASSERT_EQUAL_FLOAT(GROUND, extremes.getGroundAltitude());
+    TEST_ASSERT_EQUAL_FLOAT(180.0f, extremes.getMaxAltitude());
+}
+
+void test_maximum_never_drops_when_a_sensor_leaves(void) {
+    FakeAltimeter high;
+    FakeAltimeter low;
+    FakeAltimeter* sensors[] = {&high, &low};
+    SensorHealthMonitor health[2];
+    FusedExtremes extremes;
+
+    high.newSample(200.0f);
+    low.newSample(100.0f);
+    latch(extremes, sensors, health, 2);
+    TEST_ASSERT_EQUAL_FLOAT(150.0f, extremes.getMaxAltitude());
+
+    // Only the lower sensor is left; its maximum is averaged in but can not lower the latch
+    high.variance = std::numeric_limits<float>::infinity();
+    latch(extremes, sensors, health, 2);
+    TEST_ASSERT_EQUAL_FLOAT(150.0f, extremes.getMaxAltitude());
+
+    low.newSample(170.0f);
+    latch(extremes, sensors, health, 2);
+    TEST_ASSERT_EQUAL_FLOAT(170.0f, extremes.getMaxAltitude());
+}
+
+void test_barometer_fault_in_ascent_still_deploys_drogue(void) {
+    FakeAltimeter baro;
+    FakeAltimeter* sensors[] = {&baro};
+    SensorHealthMonitor health[1];
+    FusedExtremes extremes;
+
+    PyroScheduler scheduler(noWrite, fakeClock);
+    int drogue = scheduler.addChannel("drogue", 15, HOLD);
+    int event = scheduler.addStateEvent("drogue", drogue, FlightState::APOGEE, 0);
+
+    // Ascent at 100 m/s with the barometer healthy, then it stops updating at 200 m
+    float altitude = 0;
+    bool faulted = false;
+    for (int tick = 0; tick < 1500; ++tick) {
+        fakeTime += TICK;
+        altitude += 100.0f * TICK * 1e-6f;
+        if (altitude < 200.0f && tick % BARO_DIVIDER == 0) {
+            baro.newSample(altitude);
+        }
+        health[0].update(baro, fakeTime);
+        faulted |= !health[0].isHealthy();
+        latch(extremes, sensors, health, 1);
+
+        // As FlightStateMachine::updatePyros arms
+        if (!scheduler.isArmed() && extremes.getMaxAltitude() >= MINIMUM_APOGEE) {
+            scheduler.setArmed(true);
+        }
+        scheduler.service(fakeTime);
+        scheduler.update(fakeTime, FlightState::ASCENT, altitude, 100.0f);
+    }
+    TEST_ASSERT_TRUE(faulted);
+    TEST_ASSERT_FALSE(health[0].isHealthy());
+    TEST_ASSERT_TRUE(scheduler.isArmed());
+    TEST_ASSERT_FLOAT_WITHIN(2.5f, 200.0f, extremes.getMaxAltitude());
+    TEST_ASSERT_EQUAL_FLOAT(GROUND, extremes.getGroundAltitude());
+
+    // Apogee from the remaining signals; the maximum still clears FlightStateMachine::isBelowMinimumApogee
+    TEST_ASSERT_FALSE(extremes.getMaxAltitude() < MINIMUM_APOGEE);
+    scheduler.update(fakeTime, FlightState::APOGEE, altitude, 0);
+    TEST_ASSERT_TRUE(scheduler.getEventState(event) == PyroEventState::SCHEDULED);
+    for (int tick = 0; tick <= static_cast<int>(HOLD / TICK); ++tick) {
+        fakeTime += TICK;
+        scheduler.service(fakeTime);
+    }
+    TEST_ASSERT_TRUE(scheduler.isEventComplete(event));
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_excluded_sensor_keeps_last_values);
+    RUN_TEST(test_maximum_never_drops_when_a_sensor_leaves);
+    RUN_TEST(test_barometer_fault_in_ascent_still_deploys_drogue);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,127 @@
+#include <unity.h>
+#include <cmath>
+#include "inertialEstimator.hpp"
+
+const float GRAVITY = 9.81f;
+const uint64_t PERIOD = 1200; // 833 Hz FIFO rate (us)
+const size_t CALIBRATION_SAMPLES = 150;
+
+// A mounting a few degrees off vertical and a gyroscope with a constant bias
+const Vector3 GYRO_BIAS = {0.01f, -0.02f, 0.005f};
+// Accelerometer reading 1 g as a little under 9.7 m/s^2
+const Vector3 RESTING_FORCE = {0.3f, -0.4f, 9.68f};
+
+uint64_t now;
+
+// Small deterministic noise
+float noise(uint64_t time, float phase) {
+    return 0.02f * std::sin(0.0037f * static_cast<float>(time) + phase);
+}
+
+// Feed stationary samples for a duration, checking vertical acceleration and velocity stay near zero
+void feedStationary(InertialEstimator& estimator, float duration, bool check) {
+    for (uint64_t end = now + static_cast<uint64_t>(duration * 1e6f); now < end; now += PERIOD) {
+        Vector3 rate = GYRO_BIAS + Vector3{noise(now, 0), noise(now, 1), noise(now, 2)} * 0.1f;
+        Vector3 force = RESTING_FORCE + Vector3{noise(now, 3), noise(now, 4), noise(now, 5)};
+        estimator.update(now, rate, force);
+        if (check && estimator.isCalibrated()) {
+            TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, estimator.getVerticalAcceleration());
+            TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, estimator.getVerticalVelocity());
+        }
+    }
+}
+
+// Setup function runs before each test
+void setUp(void) {
+    now = 1000000;
+}
+
+// Teardown function runs after each test
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_stationary_one_g_stays_at_rest() {
+    InertialEstimator estimator(CALIBRATION_SAMPLES);
+    estimator.setGravity(GRAVITY);
+
+    feedStationary(estimator, 0.1f, false);
+    TEST_ASSERT_FALSE(estimator.isCalibrated());
+
+    // The gyroscope bias is removed as soon as the calibration completes
+    feedStationary(estimator, 0.1f, true);
+    TEST_ASSERT_TRUE(estimator.isCalibrated());
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 0.0f, estimator.getBodyRate().norm());
+
+    // A minute on the pad: gravity is removed and velocity does not drift
+    feedStationary(estimator, 60.0f, true);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, GRAVITY, estimator.getBodyAcceleration().norm());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, estimator.getBodyRate().norm());
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.01f, estimator.getVelocityVariance());
+}
+
+void test_calibration_restarts_when_moved() {
+    InertialEstimator estimator(CALIBRATION_SAMPLES);
+    estimator.setGravity(GRAVITY);
+
+    feedStationary(estimator, 0.1f, false);
+    // Picked up and turned: the samples so far are discarded
+    estimator.update(now, {1.0f, 0, 0}, RESTING_FORCE);
+    now += PERIOD;
+    feedStationary(estimator, 0.1f, false);
+    TEST_ASSERT_FALSE(estimator.isCalibrated());
+
+    feedStationary(estimator, 0.1f, false);
+    TEST_ASSERT_TRUE(estimator.isCalibrated());
+}
+
+void test_zero_velocity_update_removes_drift() {
+    InertialEstimator estimator(CALIBRATION_SAMPLES);
+    estimator.setGravity(GRAVITY);
+    feedStationary(estimator, 1.0f, true);
+
+    // A bump along the body axis leaves a velocity that the integration alone keeps
+    Vector3 up = RESTING_FORCE * (1.0f / RESTING_FORCE.norm());
+    for (uint64_t end = now + 100000; now < end; now += PERIOD) {
+        estimator.update(now, GYRO_BIAS, RESTING_FORCE + up * 2.0f);
+    }
+    float velocity = estimator.getVerticalVelocity();
+    TEST_ASSERT_TRUE(velocity > 0.1f);
+    TEST_ASSERT_TRUE(estimator.getVelocityVariance() > 0.01f);
+
+    // Still again: velocity is held until the vehicle has been stationary long enough, then reset
+    feedStationary(estimator, 0.4f, false);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, velocity, estimator.getVerticalVelocity());
+    feedStationary(estimator, 0.2f, false);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, estimator.getVerticalVelocity());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.01f, estimator.getVelocityVariance());
+}
+
+void test_thrust_integrates_to_velocity() {
+    InertialEstimator estimator(CALIBRATION_SAMPLES);
+    estimator.setGravity(GRAVITY);
+    feedStationary(estimator, 1.0f, true);
+
+    // 3 g of thrust along the body axis for a second
+    Vector3 up = RESTING_FORCE * (1.0f / RESTING_FORCE.norm());
+    Vector3 thrust = RESTING_FORCE + up * (3.0f * RESTING_FORCE.norm());
+    for (uint64_t end = now + 1000000; now < end; now += PERIOD) {
+        estimator.update(now, GYRO_BIAS, thrust);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 3.0f * GRAVITY, estimator.getVerticalAcceleration());
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, 3.0f * GRAVITY, estimator.getVerticalVelocity());
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_stationary_one_g_stays_at_rest);
+    RUN_TEST(test_calibration_restarts_when_moved);
+    RUN_TEST(test_zero_velocity_update_removes_drift);
+    RUN_TEST(test_thrust_integrates_to_velocity);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,51 @@
+#include <unity.h>
+#include <thread>
+#include "interruptGuard.hpp"
+
+void setUp(void) {
+    // Any setup code can go here
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_guard_masks_and_restores(void) {
+    TEST_ASSERT_FALSE(InterruptGuard::isMasked());
+    {
+        InterruptGuard guard;
+        TEST_ASSERT_TRUE(InterruptGuard::isMasked());
+    }
+    TEST_ASSERT_FALSE(InterruptGuard::isMasked());
+}
+
+void test_nested_guard_leaves_outer_section_masked(void) {
+    InterruptGuard outer;
+    {
+        // As Timer::currentTimeMicros() called from a critical section or handler
+        InterruptGuard inner;
+        TEST_ASSERT_TRUE(InterruptGuard::isMasked());
+    }
+    TEST_ASSERT_TRUE(InterruptGuard::isMasked());
+}
+
+void test_host_mask_is_per_thread(void) {
+    InterruptGuard guard;
+    bool otherMasked = true;
+    std::thread other([&otherMasked]() { otherMasked = InterruptGuard::isMasked(); });
+    other.join();
+    TEST_ASSERT_FALSE(otherMasked);
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_guard_masks_and_restores);
+    RUN_TEST(test_nested_guard_leaves_outer_section_masked);
+    RUN_TEST(test_host_mask_is_per_thread);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,213 @@
+#include <unity.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "kalmanFilter.hpp"
+
+// Noise of the simulated sensors, matching SIGMA_M, SIGMA_S and SIGMA_A
+const float MODEL_SIGMA = 10.0f;
+const float ALTITUDE_SIGMA = 3.0f;
+const float ACCELERATION_SIGMA = 2.0f;
+
+const float GRAVITY = 9.81f;
+const float FILTER_PERIOD = 0.005f; // 200 Hz accelerometer and filter rate
+const int BAROMETER_DIVIDER = 4;    // 50 Hz barometer
+
+/**
+ * Simulated single stage flight: 1 s on the pad, a 3 s motor burn, then a
+ * ballistic coast with quadratic drag until 2 s after apogee.
+ */
+struct Flight {
+    float altitude = 0;
+    float velocity = 0;
+    float acceleration = 0;
+    float time = 0;
+
+    void step(float dt) {
+        // Integrate the truth in fine steps so it is independent of the filter model
+        const int substeps = 10;
+        float h = dt / substeps;
+        for (int i = 0; i < substeps; ++i) {
+            float thrust = (time >= 1.0f && time < 4.0f) ? 70.0f : 0.0f;
+            float drag = 0.0015f * velocity * std::fabs(velocity);
+            acceleration = (time < 1.0f) ? 0.0f : thrust - GRAVITY - drag;
+            velocity += acceleration * h;
+            altitude += velocity * h;
+            time += h;
+        }
+    }
+};
+
+struct FlightErrors {
+    double altitudeRms;
+    double velocityRms;
+    float apogeeTimeError;
+};
+
+// Fly the simulated flight through the filter and measure its errors against the truth
+FlightErrors flyThroughFilter(bool useAccelerometer) {
+    KalmanFilter filter(MODEL_SIGMA, ALTITUDE_SIGMA, ACCELERATION_SIGMA);
+    Flight flight;
+    std::mt19937 rng(42);
+    std::normal_distribution<float> altitudeNoise(0.0f, ALTITUDE_SIGMA);
+    std::normal_distribution<float> accelerationNoise(0.0f, ACCELERATION_SIGMA);
+
+    filter.reset(altitudeNoise(rng));
+
+    double altitudeSquares = 0;
+    double velocitySquares = 0;
+    int count = 0;
+    float trueApogeeTime = -1;
+    float estimatedApogeeTime = -1;
+
+    for (int step = 1; flight.time < 20.0f; ++step) {
+        float previousVelocity = flight.velocity;
+        flight.step(FILTER_PERIOD);
+        filter.predict(FILTER_PERIOD);
+
+        if (useAccelerometer) {
+            filter.updateAcceleration(flight.acceleration + accelerationNoise(rng));
+        }
+        if (step % BAROMETER_DIVIDER == 0) {
+            filter.updateAltitude(flight.altitude + altitudeNoise(rng));
+        }
+
+        if (trueApogeeTime < 0 && previousVelocity > 0 && flight.velocity <= 0) {
+            trueApogeeTime = flight.time;
+        }
+        if (estimatedApogeeTime < 0 && flight.time > 4.0f && filter.getVelocity() <= 0) {
+            estimatedApogeeTime = flight.time;
+        }
+
+        altitudeSquares += pow(filter.getAltitude() - flight.altitude, 2);
+        velocitySquares += pow(filter.getVelocity() - flight.velocity, 2);
+        count++;
+    }
+
+    return {sqrt(altitudeSquares / count), sqrt(velocitySquares / count),
+            std::fabs(estimatedApogeeTime - trueApogeeTime)};
+}
+
+// Setup function runs before each test
+void setUp(void) {
+    // Any setup code can go here
+}
+
+// Teardown function runs after each test
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_tracks_simulated_flight() {
+    FlightErrors errors = flyThroughFilter(true);
+
+    char message[100];
+    snprintf(message, sizeof(message), "altitude rms %.2f m, velocity rms %.2f m/s, apogee time error %.3f s",
+             errors.altitudeRms, errors.velocityRms, errors.apogeeTimeError);
+    TEST_MESSAGE(message);
+
+    // Better than the raw barometer, and apogee found within a few filter steps
+    TEST_ASSERT_TRUE(errors.altitudeRms < 1.0f);
+    TEST_ASSERT_TRUE(errors.velocityRms < 1.0f);
+    TEST_ASSERT_TRUE(errors.apogeeTimeError < 0.1f);
+}
+
+void test_tracks_with_barometer_only() {
+    FlightErrors withAccelerometer = flyThroughFilter(true);
+    FlightErrors barometerOnly = flyThroughFilter(false);
+
+    // Still usable without the accelerometer, but the accelerometer must help
+    TEST_ASSERT_TRUE(barometerOnly.altitudeRms < ALTITUDE_SIGMA);
+    TEST_ASSERT_TRUE(barometerOnly.apogeeTimeError < 0.5f);
+    TEST_ASSERT_TRUE(withAccelerometer.velocityRms < barometerOnly.velocityRms);
+}
+
+void test_ignores_input_until_reset() {
+    KalmanFilter filter(MODEL_SIGMA, ALTITUDE_SIGMA, ACCELERATION_SIGMA);
+    TEST_ASSERT_FALSE(filter.isInitialised());
+
+    filter.predict(FILTER_PERIOD);
+    filter.updateAltitude(100.0f);
+    filter.updateAcceleration(10.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, filter.getAltitude());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, filter.getAcceleration());
+
+    filter.reset(100.0f);
+    TEST_ASSERT_TRUE(filter.isInitialised());
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, filter.getAltitude());
+    TEST_ASSERT_EQUAL_FLOAT(ALTITUDE_SIGMA * ALTITUDE_SIGMA, filter.getVariance(KalmanFilter::ALTITUDE));
+}
+
+void test_weights_measurements_by_variance() {
+    KalmanFilter trusted(MODEL_SIGMA, ALTITUDE_SIGMA, ACCELERATION_SIGMA);
+    KalmanFilter doubtful(MODEL_SIGMA, ALTITUDE_SIGMA, ACCELERATION_SIGMA);
+    trusted.reset(0.0f);
+    doubtful.reset(0.0f);
+
+    trusted.updateAltitude(10.0f, 0.01f);
+    doubtful.updateAltitude(10.0f, 10000.0f);
+    TEST_ASSERT_TRUE(trusted.getAltitude() > 9.0f);
+    TEST_ASSERT_TRUE(doubtful.getAltitude() < 0.1f);
+
+    // Measurements without a usable variance are ignored
+    doubtful.updateAltitude(10.0f, INFINITY);
+    doubtful.updateAcceleration(10.0f, 0.0f);
+    TEST_ASSERT_TRUE(doubtful.getAltitude() < 0.1f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, doubtful.getAcceleration());
+}
+
+void test_covariance_stays_bounded() {
+    KalmanFilter filter(MODEL_SIGMA, ALTITUDE_SIGMA, ACCELERATION_SIGMA);
+    filter.reset(0.0f);
+
+    // A long stationary run must converge rather than grow or go negative
+    for (int step = 1; step <= 100000; ++step) {
+        filter.predict(FILTER_PERIOD);
+        filter.updateAcceleration(0.0f);
+        if (step % BAROMETER_DIVIDER == 0) {
+            filter.updateAltitude(0.0f);
+        }
+    }
+    for (int state = 0; state < KalmanFilter::NUM_STATES; ++state) {
+        float variance = filter.getVariance(static_cast<KalmanFilter::State>(state));
+        TEST_ASSERT_TRUE(variance > 0.0f);
+        TEST_ASSERT_TRUE(variance < ALTITUDE_SIGMA * ALTITUDE_SIGMA);
+    }
+}
+
+void test_benchmark_predict_and_update() {
+    KalmanFilter filter(MODEL_SIGMA, ALTITUDE_SIGMA, ACCELERATION_SIGMA);
+    filter.reset(0.0f);
+    const int iterations = 200000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        filter.predict(FILTER_PERIOD);
+        filter.updateAcceleration(static_cast<float>(i & 7));
+        filter.updateAltitude(static_cast<float>(i & 15));
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+
+    char message[80];
+    snprintf(message, sizeof(message), "predict + 2 updates: %.2f ns/step", ns);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_FALSE(std::isnan(filter.getAltitude()));
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_tracks_simulated_flight);
+    RUN_TEST(test_tracks_with_barometer_only);
+    RUN_TEST(test_ignores_input_until_reset);
+    RUN_TEST(test_weights_measurements_by_variance);
+    RUN_TEST(test_covariance_stays_bounded);
+    RUN_TEST(test_benchmark_predict_and_update);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,177 @@
+#include <unity.h>
+#include <cstdio>
+#include <cstdlib>
+#include "launchDetector.hpp"
+
+// Config defaults
+const float LAUNCH_ACC_THRESHOLD = 60.0f;      // m/s^2
+const uint32_t LAUNCH_ACC_DURATION = 50000;    // us
+const float LAUNCH_VEL_THRESHOLD = 15.0f;      // m/s
+const float LAUNCH_ALTITUDE_THRESHOLD = 30.0f; // m
+
+const uint32_t CONTROL_PERIOD = 2000;   // 500 Hz control tick (us)
+const uint32_t BARO_PERIOD = 6000;      // MPL3115A2 sample period (us)
+const size_t BARO_WINDOW = 150;         // Barometric smoothing window (samples)
+const uint64_t IGNITION = 2000000;      // Ignition time in the simulation (us)
+
+/**
+ * Simulated flight from the pad: IMU vertical acceleration at every control
+ * tick and a barometric velocity that is the mean over the smoothing window,
+ * like the moving average in the barometric processor.
+ */
+struct SimulatedFlight {
+    float altitude = 0;
+    float velocity = 0;
+    float history[BARO_WINDOW] = {};
+    size_t historyIndex = 0;
+    uint64_t nextBaroSample = 0;
+    float baroVelocity = 0;
+    float baroAltitude = 0;
+
+    // Thrust ramps up over 30 ms to 110 m/s^2 net, with +-5 m/s^2 vibration
+    static float acceleration(uint64_t now) {
+        float noise = (rand() % 1000 - 500) * 0.01f;
+        if (now < IGNITION) {
+            return noise * 0.1f;
+        }
+        float ramp = (now - IGNITION) / 30000.0f;
+        return 110.0f * (ramp < 1.0f ? ramp : 1.0f) + noise;
+    }
+
+    float step(uint64_t now) {
+        float accel = acceleration(now);
+        if (now >= IGNITION) {
+            velocity += accel * CONTROL_PERIOD * 1e-6f;
+            altitude += velocity * CONTROL_PERIOD * 1e-6f;
+        }
+        if (now >= nextBaroSample) {
+            nextBaroSample += BARO_PERIOD;
+            float oldest = history[historyIndex];
+            history[historyIndex] = altitude;
+            historyIndex = (historyIndex + 1) % BARO_WINDOW;
+            baroVelocity = (altitude - oldest) / (BARO_WINDOW * BARO_PERIOD * 1e-6f);
+            baroAltitude = altitude;
+        }
+        return accel;
+    }
+};
+
+/**
+ * @brief Fly the simulation until the detector triggers.
+ *
+ * @param useAcceleration Feed the IMU acceleration to the detector.
+ * @param bumpAt Time of a 20 ms, 80 m/s^2 knock on the pad, 0 for none (us).
+ */
+LaunchDetector fly(bool useAcceleration, uint64_t bumpAt = 0) {
+    srand(1);
+    SimulatedFlight flight;
+    LaunchDetector detector;
+    detector.setAccelerationTest(LAUNCH_ACC_THRESHOLD, LAUNCH_ACC_DURATION);
+    detector.setBarometricTest(LAUNCH_VEL_THRESHOLD, LAUNCH_ALTITUDE_THRESHOLD);
+
+    for (uint64_t now = 0; now < IGNITION + 5000000 && !detector.isLaunched(); now += CONTROL_PERIOD) {
+        float accel = flight.step(now);
+        if (bumpAt != 0 && now >= bumpAt && now < bumpAt + 20000) {
+            accel = 80.0f;
+        }
+        if (useAcceleration) {
+            detector.updateAcceleration(now, accel);
+        }
+        detector.updateBarometric(now, flight.baroVelocity, flight.baroAltitude);
+    }
+    return detector;
+}
+
+void setUp(void) {
+    // Any setup code can go here
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_needs_sustained_acceleration(void) {
+    LaunchDetector detector;
+    detector.setAccelerationTest(LAUNCH_ACC_THRESHOLD, LAUNCH_ACC_DURATION);
+    TEST_ASSERT_FALSE(detector.updateAcceleration(0, 70));
+    TEST_ASSERT_FALSE(detector.updateAcceleration(40000, 70));
+    // A dip below the threshold restarts the run
+    TEST_ASSERT_FALSE(detector.updateAcceleration(42000, 50));
+    TEST_ASSERT_FALSE(detector.updateAcceleration(44000, 70));
+    TEST_ASSERT_FALSE(detector.updateAcceleration(90000, 70));
+    TEST_ASSERT_TRUE(detector.updateAcceleration(94000, 70));
+    TEST_ASSERT_TRUE(detector.getTrigger() == LaunchTrigger::ACCELERATION);
+    TEST_ASSERT_EQUAL(94000, detector.getDetectionTime());
+    TEST_ASSERT_EQUAL(44000, detector.getIgnitionTime());
+    TEST_ASSERT_EQUAL_FLOAT(70, detector.getTriggerValue());
+}
+
+void test_barometric_tests_back_up_acceleration(void) {
+    LaunchDetector detector;
+    detector.setAccelerationTest(LAUNCH_ACC_THRESHOLD, LAUNCH_ACC_DURATION);
+    detector.setBarometricTest(LAUNCH_VEL_THRESHOLD, LAUNCH_ALTITUDE_THRESHOLD);
+    TEST_ASSERT_FALSE(detector.updateBarometric(1000, 10, 5));
+    TEST_ASSERT_TRUE(detector.updateBarometric(2000, 10, 31));
+    TEST_ASSERT_TRUE(detector.getTrigger() == LaunchTrigger::ALTITUDE);
+    // Ignition is unknown without an acceleration run
+    TEST_ASSERT_EQUAL(0, detector.getIgnitionTime());
+
+    // Once detected, later samples change nothing
+    TEST_ASSERT_TRUE(detector.updateBarometric(3000, 20, 40));
+    TEST_ASSERT_TRUE(detector.getTrigger() == LaunchTrigger::ALTITUDE);
+
+    detector.reset();
+    TEST_ASSERT_FALSE(detector.isLaunched());
+    TEST_ASSERT_TRUE(detector.updateBarometric(4000, 16, 0));
+    TEST_ASSERT_TRUE(detector.getTrigger() == LaunchTrigger::VELOCITY);
+}
+
+void test_unconfigured_tests_never_trigger(void) {
+    LaunchDetector detector;
+    TEST_ASSERT_FALSE(detector.updateAcceleration(0, 1000));
+    TEST_ASSERT_FALSE(detector.updateAcceleration(1000000, 1000));
+    TEST_ASSERT_FALSE(detector.updateBarometric(1000000, 1000, 1000));
+}
+
+void test_knock_on_the_pad_is_ignored(void) {
+    LaunchDetector detector = fly(true, 1000000);
+    TEST_ASSERT_TRUE(detector.isLaunched());
+    TEST_ASSERT_TRUE(detector.getDetectionTime() > IGNITION);
+}
+
+void test_simulated_flight_latency(void) {
+    LaunchDetector withImu = fly(true);
+    LaunchDetector baroOnly = fly(false);
+
+    TEST_ASSERT_TRUE(withImu.getTrigger() == LaunchTrigger::ACCELERATION);
+    TEST_ASSERT_TRUE(baroOnly.getTrigger() == LaunchTrigger::VELOCITY ||
+                     baroOnly.getTrigger() == LaunchTrigger::ALTITUDE);
+
+    uint64_t imuLatency = withImu.getDetectionTime() - IGNITION;
+    uint64_t baroLatency = baroOnly.getDetectionTime() - IGNITION;
+    char message[96];
+    snprintf(message, sizeof(message), "launch detected %.1f ms after ignition, %.1f ms from baro alone",
+             imuLatency * 1e-3f, baroLatency * 1e-3f);
+    TEST_MESSAGE(message);
+
+    // The run starts as the thrust ramp crosses the threshold
+    TEST_ASSERT_TRUE(withImu.getIgnitionTime() >= IGNITION);
+    TEST_ASSERT_TRUE(withImu.getIgnitionTime() < IGNITION + 30000);
+    TEST_ASSERT_TRUE(imuLatency < LAUNCH_ACC_DURATION + 30000);
+    TEST_ASSERT_TRUE(baroLatency > imuLatency + 200000);
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_needs_sustained_acceleration);
+    RUN_TEST(test_barometric_tests_back_up_acceleration);
+    RUN_TEST(test_unconfigured_tests_never_trigger);
+    RUN_TEST(test_knock_on_the_pad_is_ignored);
+    RUN_TEST(test_simulated_flight_latency);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
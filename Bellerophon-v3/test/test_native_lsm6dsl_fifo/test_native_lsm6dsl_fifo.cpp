@@ -0,0 +1,294 @@
+#include <unity.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include "LSM6DSLFifo.hpp"
+
+/**
+ * Register-level model of the LSM6DSL FIFO. Samples arrive on the part's own
+ * clock, which may run off nominal, as a gyroscope set then an accelerometer
+ * set. Each sample's values encode its sequence number so lost or reordered
+ * samples can be detected. Burst reads of FIFO_DATA_OUT roll back to
+ * FIFO_DATA_OUT_L.
+ */
+class FakeLSM6DSL : public RegisterBus {
+public:
+    static constexpr size_t CAPACITY = 2048; // words
+
+    uint8_t registers[0x80];
+    std::deque<int16_t> fifo;
+    uint64_t now = 0;
+    double period = 0;       // true sample period (us), 0 when stopped
+    double clockError = 0;   // fractional error of the part's clock
+    double nextSample = 0;   // true time of the next sample (us)
+    uint32_t sequence = 0;   // sequence number of the next sample
+    bool overrun = false;
+    bool highByteNext = false;
+    int16_t currentWord = 0;
+
+    FakeLSM6DSL() {
+        memset(registers, 0, sizeof(registers));
+        registers[LSM6DSLFifo::WHO_AM_I] = LSM6DSLFifo::WHO_AM_I_VALUE;
+    }
+
+    static int16_t valueOf(uint32_t sequence, size_t word) {
+        return static_cast<int16_t>((sequence * 8 + word) & 0x7FFF);
+    }
+
+    // Time the sample with a sequence number was acquired (us)
+    double trueTime(uint32_t index) const {
+        return firstSample + index * period;
+    }
+
+    double firstSample = 0;
+
+    void advance() {
+        if (period <= 0) {
+            return;
+        }
+        while (nextSample <= now) {
+            for (size_t word = 0; word < LSM6DSLFifo::WORDS_PER_SAMPLE; ++word) {
+                if (fifo.size() >= CAPACITY) {
+                    fifo.pop_front();
+                    overrun = true;
+                }
+                fifo.push_back(valueOf(sequence, word));
+            }
+            sequence++;
+            nextSample += period;
+        }
+    }
+
+    uint16_t pattern() const {
+        // Words are dropped a sample at a time except when a test drops single words
+        return static_cast<uint16_t>((LSM6DSLFifo::WORDS_PER_SAMPLE - fifo.size() % LSM6DSLFifo::WORDS_PER_SAMPLE)
+                                     % LSM6DSLFifo::WORDS_PER_SAMPLE);
+    }
+
+    uint8_t readByte(uint8_t reg) {
+        switch (reg) {
+            case 0x3A:
+                return fifo.size() & 0xFF;
+            case 0x3B:
+                return ((fifo.size() >> 8) & 0x07) | (overrun ? LSM6DSLFifo::FIFO_STATUS2_OVER_RUN : 0);
+            case 0x3C:
+                return pattern() & 0xFF;
+            case 0x3D:
+                return pattern() >> 8;
+            case 0x3E:
+            case 0x3F: {
+                if (!highByteNext) {
+                    currentWord = fifo.empty() ? 0 : fifo.front();
+                    if (!fifo.empty()) {
+                        fifo.pop_front();
+                    }
+                    highByteNext = true;
+                    return currentWord & 0xFF;
+                }
+                highByteNext = false;
+                return (currentWord >> 8) & 0xFF;
+            }
+            default:
+                return registers[reg];
+        }
+    }
+
+    bool readRegisters(uint8_t address, uint8_t reg, uint8_t* data, size_t length) override {
+        if (address != LSM6DSLFifo::DEFAULT_ADDRESS) {
+            return false;
+        }
+        advance();
+        bool fifoStatus = (reg == 0x3A);
+        for (size_t i = 0; i < length; ++i) {
+            uint8_t r = (reg >= 0x3E) ? 0x3E + ((reg - 0x3E + i) & 1) : reg + i;
+            data[i] = readByte(r);
+        }
+        if (fifoStatus) {
+            overrun = false;
+        }
+        return true;
+    }
+
+    bool writeRegister(uint8_t address, uint8_t reg, uint8_t value) override {
+        if (address != LSM6DSLFifo::DEFAULT_ADDRESS) {
+            return false;
+        }
+        registers[reg] = value;
+        if (reg == LSM6DSLFifo::FIFO_CTRL5) {
+            fifo.clear();
+            uint8_t code = (value >> 3) & 0x0F;
+            const double rates[] = {0, 12.5, 26, 52, 104, 208, 416, 833, 1666, 3332, 6664};
+            if ((value & 0x07) == LSM6DSLFifo::FIFO_MODE_CONTINUOUS && code > 0) {
+                period = 1e6 / (rates[code] * (1.0 + clockError));
+                firstSample = now + period;
+                nextSample = firstSample;
+                sequence = 0;
+            } else {
+                period = 0;
+            }
+        }
+        return true;
+    }
+};
+
+FakeLSM6DSL* bus;
+LSM6DSLFifo* fifo;
+uint32_t expectedSequence;
+
+void setUp(void) {
+    bus = new FakeLSM6DSL();
+    fifo = new LSM6DSLFifo(*bus);
+    expectedSequence = 0;
+}
+
+void tearDown(void) {
+    delete fifo;
+    delete bus;
+}
+
+// Check the drained samples continue the sequence
+void checkSequence(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const LSM6DSLSample& sample = fifo->getSample(i);
+        TEST_ASSERT_EQUAL(FakeLSM6DSL::valueOf(expectedSequence, 0), sample.gyro[0]);
+        TEST_ASSERT_EQUAL(FakeLSM6DSL::valueOf(expectedSequence, 5), sample.accel[2]);
+        expectedSequence++;
+    }
+}
+
+void test_begin_configures_part(void) {
+    TEST_ASSERT_TRUE(fifo->begin(7, 16, 1000));
+    TEST_ASSERT_EQUAL(0x74, bus->registers[LSM6DSLFifo::CTRL1_XL]);
+    TEST_ASSERT_EQUAL(0x78, bus->registers[LSM6DSLFifo::CTRL2_G]);
+    TEST_ASSERT_EQUAL(0x3E, bus->registers[LSM6DSLFifo::FIFO_CTRL5]);
+    TEST_ASSERT_EQUAL(0x44, bus->registers[LSM6DSLFifo::CTRL3_C]);
+    TEST_ASSERT_EQUAL_FLOAT(833.0f, fifo->getDataRate());
+    TEST_ASSERT_EQUAL_FLOAT(0.488e-3f, fifo->getAccelScale());
+    TEST_ASSERT_EQUAL_FLOAT(35e-3f, fifo->getGyroScale());
+}
+
+void test_begin_fails_without_part(void) {
+    bus->registers[LSM6DSLFifo::WHO_AM_I] = 0;
+    TEST_ASSERT_FALSE(fifo->begin(7, 16, 1000));
+    TEST_ASSERT_EQUAL(0, fifo->drain(1000));
+}
+
+void test_drain_retries_setup_until_part_found(void) {
+    // Settings recorded before the bus is running are not written
+    fifo->configure(7, 16, 1000);
+    TEST_ASSERT_EQUAL(0, bus->registers[LSM6DSLFifo::FIFO_CTRL5]);
+    TEST_ASSERT_EQUAL_FLOAT(833.0f, fifo->getDataRate());
+    TEST_ASSERT_TRUE(fifo->setDataRate(8));
+    TEST_ASSERT_EQUAL(0, bus->registers[LSM6DSLFifo::CTRL1_XL]);
+
+    bus->registers[LSM6DSLFifo::WHO_AM_I] = 0;
+    bus->now = 1000;
+    TEST_ASSERT_EQUAL(0, fifo->drain(bus->now));
+    TEST_ASSERT_FALSE(fifo->isConfigured());
+    TEST_ASSERT_EQUAL(1, fifo->getErrorCount());
+
+    // The part answers, the next drain sets it up with the recorded settings
+    bus->registers[LSM6DSLFifo::WHO_AM_I] = LSM6DSLFifo::WHO_AM_I_VALUE;
+    bus->now = 2000;
+    TEST_ASSERT_EQUAL(0, fifo->drain(bus->now));
+    TEST_ASSERT_TRUE(fifo->isConfigured());
+    TEST_ASSERT_EQUAL(0x84, bus->registers[LSM6DSLFifo::CTRL1_XL]);
+    TEST_ASSERT_EQUAL(0x46, bus->registers[LSM6DSLFifo::FIFO_CTRL5]);
+
+    bus->now = 12000;
+    size_t count = fifo->drain(bus->now);
+    TEST_ASSERT_TRUE(count > 0);
+    checkSequence(count);
+}
+
+void test_drains_every_sample_in_order(void) {
+    fifo->begin(7, 16, 1000);
+    // Jittery loop between 1 and 9 ms
+    srand(1);
+    for (int i = 0; i < 2000; ++i) {
+        bus->now += 1000 + rand() % 8000;
+        checkSequence(fifo->drain(bus->now));
+    }
+    TEST_ASSERT_TRUE(expectedSequence > 8000);
+    TEST_ASSERT_EQUAL(0, fifo->getOverrunCount());
+    TEST_ASSERT_EQUAL(0, fifo->getErrorCount());
+}
+
+void test_timestamps_follow_part_clock(void) {
+    bus->clockError = 0.015; // 1.5% fast, the datasheet tolerance
+    fifo->begin(7, 16, 1000);
+    srand(2);
+    double maxError = 0;
+    uint64_t lastTimestamp = 0;
+    for (int i = 0; i < 5000; ++i) {
+        bus->now += 2000 + rand() % 6000;
+        size_t count = fifo->drain(bus->now);
+        for (size_t s = 0; s < count; ++s) {
+            uint64_t timestamp = fifo->getSample(s).timestamp;
+            TEST_ASSERT_TRUE(timestamp > lastTimestamp);
+            lastTimestamp = timestamp;
+            // Skip the start while the phase settles
+            if (expectedSequence > 1000) {
+                double error = std::abs(static_cast<double>(timestamp) - bus->trueTime(expectedSequence));
+                maxError = error > maxError ? error : maxError;
+            }
+            expectedSequence++;
+        }
+    }
+    char message[64];
+    snprintf(message, sizeof(message), "max timestamp error %.0f us", maxError);
+    TEST_MESSAGE(message);
+    // Within a third of a sample period of the true acquisition time, 352 us with this seed
+    TEST_ASSERT_TRUE(maxError < 400.0);
+}
+
+void test_limits_samples_per_drain(void) {
+    fifo->begin(7, 16, 1000);
+    bus->now += 100000; // About 83 samples
+    TEST_ASSERT_EQUAL(LSM6DSLFifo::MAX_SAMPLES_PER_DRAIN, fifo->drain(bus->now));
+    checkSequence(LSM6DSLFifo::MAX_SAMPLES_PER_DRAIN);
+    TEST_ASSERT_EQUAL(LSM6DSLFifo::MAX_SAMPLES_PER_DRAIN, fifo->drain(bus->now));
+    checkSequence(LSM6DSLFifo::MAX_SAMPLES_PER_DRAIN);
+    size_t rest = fifo->drain(bus->now);
+    checkSequence(rest);
+    TEST_ASSERT_EQUAL(83, expectedSequence);
+}
+
+void test_counts_overrun(void) {
+    fifo->begin(7, 16, 1000);
+    bus->now += 500000; // Over 341 samples fill the FIFO
+    fifo->drain(bus->now);
+    TEST_ASSERT_EQUAL(1, fifo->getOverrunCount());
+}
+
+void test_realigns_partial_sample(void) {
+    fifo->begin(7, 16, 1000);
+    bus->now += 10000;
+    bus->advance();
+    // Drop two words so the FIFO starts mid-sample
+    bus->fifo.pop_front();
+    bus->fifo.pop_front();
+    size_t count = fifo->drain(bus->now);
+    TEST_ASSERT_TRUE(count > 0);
+    expectedSequence = 1;
+    checkSequence(count);
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_begin_configures_part);
+    RUN_TEST(test_begin_fails_without_part);
+    RUN_TEST(test_drain_retries_setup_until_part_found);
+    RUN_TEST(test_drains_every_sample_in_order);
+    RUN_TEST(test_timestamps_follow_part_clock);
+    RUN_TEST(test_limits_samples_per_drain);
+    RUN_TEST(test_counts_overrun);
+    RUN_TEST(test_realigns_partial_sample);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,206 @@
+#include <unity.h>
+#include <cstring>
+#include "MPL3115A2Driver.hpp"
+
+/**
+ * Register-level model of the MPL3115A2. Writing OST to CTRL_REG1 starts a
+ * conversion that completes 5.5 ms x 2^OS later, inside the datasheet time,
+ * setting the data ready flags and loading the output registers. Reading the outputs clears the flags.
+ */
+class FakeMPL3115A2 : public RegisterBus {
+public:
+    uint8_t registers[0x30];
+    uint64_t now = 0;
+    uint64_t conversionEnd = 0;
+    bool converting = false;
+    bool failNext = false;
+    bool hung = false;
+    int reads = 0;
+    int writes = 0;
+    int conversions = 0;
+
+    uint32_t rawPressure = 0;     // Q18.2 Pa
+    int16_t rawTemperature = 0;   // Q8.4 degrees C
+
+    FakeMPL3115A2() {
+        memset(registers, 0, sizeof(registers));
+        registers[MPL3115A2Driver::WHO_AM_I] = MPL3115A2Driver::WHO_AM_I_VALUE;
+    }
+
+    void setSample(float pressure, float temperature) {
+        rawPressure = static_cast<uint32_t>(pressure * 4.0f);
+        rawTemperature = static_cast<int16_t>(temperature * 16.0f);
+    }
+
+    void advance() {
+        if (converting && !hung && now >= conversionEnd) {
+            converting = false;
+            uint32_t p = rawPressure << 4;
+            registers[0x01] = p >> 16;
+            registers[0x02] = p >> 8;
+            registers[0x03] = p;
+            uint16_t t = static_cast<uint16_t>(rawTemperature) << 4;
+            registers[0x04] = t >> 8;
+            registers[0x05] = t;
+            registers[MPL3115A2Driver::STATUS] |= 0x0E;
+            registers[MPL3115A2Driver::CTRL_REG1] &= ~MPL3115A2Driver::CTRL_REG1_OST;
+        }
+    }
+
+    bool readRegisters(uint8_t address, uint8_t reg, uint8_t* data, size_t length) override {
+        reads++;
+        if (address != MPL3115A2Driver::DEFAULT_ADDRESS || failNext) {
+            failNext = false;
+            return false;
+        }
+        advance();
+        for (size_t i = 0; i < length; ++i) {
+            data[i] = registers[reg + i];
+        }
+        if (reg <= 0x01 && reg + length > 0x01) {
+            registers[MPL3115A2Driver::STATUS] = 0; // Reading OUT_P clears the flags
+        }
+        return true;
+    }
+
+    bool writeRegister(uint8_t address, uint8_t reg, uint8_t value) override {
+        writes++;
+        if (address != MPL3115A2Driver::DEFAULT_ADDRESS || failNext) {
+            failNext = false;
+            return false;
+        }
+        registers[reg] = value;
+        if (reg == MPL3115A2Driver::CTRL_REG1 && (value & MPL3115A2Driver::CTRL_REG1_OST)) {
+            uint8_t os = (value >> 3) & 0x07;
+            conversionEnd = now + 5500u * (1u << os);
+            converting = true;
+            conversions++;
+        }
+        return true;
+    }
+};
+
+FakeMPL3115A2* bus;
+MPL3115A2Driver* driver;
+
+void setUp(void) {
+    bus = new FakeMPL3115A2();
+    driver = new MPL3115A2Driver(*bus, 0);
+}
+
+void tearDown(void) {
+    delete driver;
+    delete bus;
+}
+
+// Poll once per tick until a sample arrives or the time limit passes
+bool pollUntilSample(uint64_t tick, uint64_t limit) {
+    uint64_t end = bus->now + limit;
+    while (bus->now < end) {
+        bus->now += tick;
+        if (driver->poll(bus->now)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void test_begin_configures_part(void) {
+    TEST_ASSERT_TRUE(driver->begin(bus->now));
+    TEST_ASSERT_TRUE(driver->isRunning());
+    TEST_ASSERT_EQUAL(MPL3115A2Driver::PT_DATA_CFG_ALL, bus->registers[MPL3115A2Driver::PT_DATA_CFG]);
+    // Barometer mode, standby, one-shot started
+    TEST_ASSERT_EQUAL(MPL3115A2Driver::CTRL_REG1_OST, bus->registers[MPL3115A2Driver::CTRL_REG1]);
+    TEST_ASSERT_EQUAL(1, bus->conversions);
+}
+
+void test_begin_fails_without_part(void) {
+    bus->registers[MPL3115A2Driver::WHO_AM_I] = 0;
+    TEST_ASSERT_FALSE(driver->begin(bus->now));
+    TEST_ASSERT_FALSE(driver->isRunning());
+
+    // The part appears later and poll picks it up
+    bus->registers[MPL3115A2Driver::WHO_AM_I] = MPL3115A2Driver::WHO_AM_I_VALUE;
+    driver->poll(bus->now);
+    TEST_ASSERT_TRUE(driver->isRunning());
+}
+
+void test_reads_and_decodes_sample(void) {
+    bus->setSample(101325.25f, -5.5f);
+    driver->begin(bus->now);
+    TEST_ASSERT_TRUE(pollUntilSample(1000, 20000));
+    TEST_ASSERT_EQUAL_FLOAT(101325.25f, driver->getPressure());
+    TEST_ASSERT_EQUAL_FLOAT(-5.5f, driver->getTemperature());
+}
+
+void test_does_not_block_or_touch_bus_early(void) {
+    driver->begin(bus->now);
+    int reads = bus->reads;
+    for (int i = 0; i < 5; ++i) {
+        bus->now += 1000;
+        TEST_ASSERT_FALSE(driver->poll(bus->now));
+    }
+    // Conversion time has not passed, so STATUS is not polled
+    TEST_ASSERT_EQUAL(reads, bus->reads);
+}
+
+void test_three_transactions_per_sample(void) {
+    bus->setSample(90000, 20);
+    driver->begin(bus->now);
+    pollUntilSample(1000, 20000);
+    int transactions = bus->reads + bus->writes;
+
+    for (int i = 0; i < 10; ++i) {
+        TEST_ASSERT_TRUE(pollUntilSample(1000, 20000));
+    }
+    // STATUS read, 5-byte burst and the next one-shot trigger
+    TEST_ASSERT_EQUAL(30, bus->reads + bus->writes - transactions);
+    TEST_ASSERT_EQUAL(0, driver->getErrorCount());
+}
+
+void test_timestamp_in_middle_of_conversion(void) {
+    driver->begin(bus->now);
+    uint64_t start = bus->now;
+    TEST_ASSERT_TRUE(pollUntilSample(6000, 20000));
+    TEST_ASSERT_EQUAL(start + (bus->now - start) / 2, driver->getTimestamp());
+}
+
+void test_recovers_from_bus_error(void) {
+    bus->setSample(95000, 15);
+    driver->begin(bus->now);
+    bus->now += 6000;
+    bus->failNext = true;
+    TEST_ASSERT_FALSE(driver->poll(bus->now));
+    TEST_ASSERT_EQUAL(1, driver->getErrorCount());
+    TEST_ASSERT_TRUE(pollUntilSample(1000, 20000));
+    TEST_ASSERT_EQUAL_FLOAT(95000, driver->getPressure());
+}
+
+void test_restarts_timed_out_conversion(void) {
+    driver->begin(bus->now);
+    bus->hung = true;
+    TEST_ASSERT_FALSE(pollUntilSample(1000, 13000));
+    TEST_ASSERT_EQUAL(1, driver->getErrorCount());
+    TEST_ASSERT_EQUAL(2, bus->conversions);
+
+    bus->hung = false;
+    TEST_ASSERT_TRUE(pollUntilSample(1000, 20000));
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_begin_configures_part);
+    RUN_TEST(test_begin_fails_without_part);
+    RUN_TEST(test_reads_and_decodes_sample);
+    RUN_TEST(test_does_not_block_or_touch_bus_early);
+    RUN_TEST(test_three_transactions_per_sample);
+    RUN_TEST(test_timestamp_in_middle_of_conversion);
+    RUN_TEST(test_recovers_from_bus_error);
+    RUN_TEST(test_restarts_timed_out_conversion);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,101 @@
+#include <unity.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "orderStatisticTree.hpp"
+
+const size_t WINDOW = 64;
+
+OrderStatisticTree<WINDOW> tree;
+std::vector<float> reference;
+
+// Median of a copy of the values, averaging the middle pair for even sizes
+float referenceMedian(std::vector<float> values) {
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return (n % 2) ? values[n / 2] : 0.5f * (values[n / 2 - 1] + values[n / 2]);
+}
+
+// Median absolute deviation of the values about a centre, by sorting
+float referenceMAD(const std::vector<float>& values, float centre) {
+    std::vector<float> deviations;
+    for (float value : values) {
+        deviations.push_back(std::fabs(value - centre));
+    }
+    return referenceMedian(deviations);
+}
+
+// Setup function runs before each test
+void setUp(void) {
+    tree.clear();
+    reference.clear();
+}
+
+// Teardown function runs after each test
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_sliding_window_matches_sort() {
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 2.0f);
+
+    for (int i = 0; i < 2000; ++i) {
+        // Quantise so the window holds plenty of duplicates
+        float value = std::round(noise(rng) * 4.0f) / 4.0f;
+        if (reference.size() == WINDOW) {
+            TEST_ASSERT_TRUE(tree.erase(reference.front()));
+            reference.erase(reference.begin());
+        }
+        TEST_ASSERT_TRUE(tree.insert(value));
+        reference.push_back(value);
+
+        TEST_ASSERT_EQUAL_UINT32(reference.size(), tree.size());
+        float median = referenceMedian(reference);
+        TEST_ASSERT_EQUAL_FLOAT(median, tree.median());
+        TEST_ASSERT_EQUAL_FLOAT(referenceMAD(reference, median), tree.medianAbsoluteDeviation(median));
+        // The deviation search must also work about a centre away from the median
+        TEST_ASSERT_EQUAL_FLOAT(referenceMAD(reference, median + 1.5f), tree.medianAbsoluteDeviation(median + 1.5f));
+    }
+}
+
+void test_select_and_rank() {
+    const float values[] = {5.0f, 1.0f, 3.0f, 3.0f, 9.0f};
+    for (float value : values) {
+        tree.insert(value);
+    }
+
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, tree.select(0));
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, tree.select(2));
+    TEST_ASSERT_EQUAL_FLOAT(9.0f, tree.select(4));
+    TEST_ASSERT_EQUAL_UINT32(1, tree.rank(3.0f));
+    TEST_ASSERT_EQUAL_UINT32(3, tree.rank(4.0f));
+    TEST_ASSERT_FALSE(tree.erase(4.0f));
+}
+
+void test_capacity_is_bounded() {
+    for (size_t i = 0; i < WINDOW; ++i) {
+        TEST_ASSERT_TRUE(tree.insert(static_cast<float>(i)));
+    }
+    TEST_ASSERT_TRUE(tree.full());
+    TEST_ASSERT_FALSE(tree.insert(0.0f));
+
+    // Freed nodes are reused
+    TEST_ASSERT_TRUE(tree.erase(10.0f));
+    TEST_ASSERT_TRUE(tree.insert(100.0f));
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, tree.select(WINDOW - 1));
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_sliding_window_matches_sort);
+    RUN_TEST(test_select_and_rank);
+    RUN_TEST(test_capacity_is_bounded);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,96 @@
+#define PROFILING
+#include <unity.h>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include "profiler.hpp"
+
+void setUp(void) {
+    // Any setup code can go here
+    Profiler::reset();
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_bucket_boundaries(void) {
+    TEST_ASSERT_EQUAL(0, LatencyHistogram::bucketOf(0));
+    TEST_ASSERT_EQUAL(0, LatencyHistogram::bucketOf(255));
+    TEST_ASSERT_EQUAL(1, LatencyHistogram::bucketOf(256));
+    TEST_ASSERT_EQUAL(1, LatencyHistogram::bucketOf(511));
+    TEST_ASSERT_EQUAL(2, LatencyHistogram::bucketOf(512));
+    TEST_ASSERT_EQUAL(13, LatencyHistogram::bucketOf(1500000)); // 1.5 ms
+    TEST_ASSERT_EQUAL(LatencyHistogram::NUM_BUCKETS - 1, LatencyHistogram::bucketOf(UINT32_MAX));
+
+    // Every duration is below the limit of its bucket and at least the limit of the one before
+    for (uint32_t nanos = 1; nanos < 200000000; nanos = nanos * 3 + 1) {
+        size_t bucket = LatencyHistogram::bucketOf(nanos);
+        TEST_ASSERT_TRUE(nanos < LatencyHistogram::bucketLimit(bucket));
+        if (bucket > 0) {
+            TEST_ASSERT_TRUE(nanos >= LatencyHistogram::bucketLimit(bucket - 1));
+        }
+    }
+}
+
+void test_histogram_statistics(void) {
+    LatencyHistogram histogram;
+    histogram.record(1000);
+    histogram.record(3000);
+    histogram.record(3500);
+    histogram.record(100000000);
+    TEST_ASSERT_EQUAL(4, histogram.getCount());
+    TEST_ASSERT_EQUAL(100000000, histogram.getMax());
+    TEST_ASSERT_EQUAL(25001875, histogram.getMean());
+    TEST_ASSERT_EQUAL(1, histogram.getBucketCount(2));
+    TEST_ASSERT_EQUAL(2, histogram.getBucketCount(4));
+    TEST_ASSERT_EQUAL(1, histogram.getBucketCount(LatencyHistogram::NUM_BUCKETS - 1));
+
+    histogram.reset();
+    TEST_ASSERT_EQUAL(0, histogram.getCount());
+    TEST_ASSERT_EQUAL(0, histogram.getMean());
+}
+
+void test_format(void) {
+    LatencyHistogram histogram;
+    histogram.record(1000);
+    histogram.record(3000);
+    histogram.record(3500);
+    char buffer[128];
+    histogram.format(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(0, strcmp("n=3 mean=2.50us max=3.50us <1.0:1 <4.1:2", buffer));
+
+    // Truncated output stays terminated
+    char small[12];
+    TEST_ASSERT_EQUAL(sizeof(small) - 1, histogram.format(small, sizeof(small)));
+    TEST_ASSERT_EQUAL(sizeof(small) - 1, strlen(small));
+}
+
+void test_scope_records_into_section(void) {
+    for (int i = 0; i < 3; ++i) {
+        PROFILE_SCOPE(SENSOR_FUSION);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    const LatencyHistogram& fusion = Profiler::getHistogram(ProfileSection::SENSOR_FUSION);
+    TEST_ASSERT_EQUAL(3, fusion.getCount());
+    TEST_ASSERT_TRUE(fusion.getMean() >= 2000000);
+    TEST_ASSERT_EQUAL(0, Profiler::getHistogram(ProfileSection::LOG_DATA).getCount());
+
+    char buffer[256];
+    Profiler::format(ProfileSection::SENSOR_FUSION, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(0, strncmp(buffer, "PROFILE sensor_fusion: n=3 ", 27));
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_bucket_boundaries);
+    RUN_TEST(test_histogram_statistics);
+    RUN_TEST(test_format);
+    RUN_TEST(test_scope_records_into_section);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
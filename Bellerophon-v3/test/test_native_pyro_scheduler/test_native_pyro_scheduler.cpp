@@ -0,0 +1,239 @@
+#include <unity.h>
+#include <cstring>
+#include "pyroScheduler.hpp"
+
+const uint32_t HOLD = 2000000;    // Pyro hold time (us)
+const uint32_t TICK = 2000;       // 500 Hz control tick (us)
+const uint32_t SPACING = 50000;   // Minimum spacing between channels (us)
+
+uint64_t fakeTime = 0;
+
+uint64_t fakeClock() {
+    return fakeTime;
+}
+
+void noWrite(uint8_t, bool) {}
+
+/**
+ * @brief Advance the fake clock, servicing the timer the way its interrupt would.
+ */
+void runUntil(PyroScheduler& scheduler, uint64_t until, FlightState state, float altitude) {
+    while (fakeTime < until) {
+        fakeTime += TICK;
+        scheduler.service(fakeTime);
+        scheduler.update(fakeTime, state, altitude, 0);
+    }
+}
+
+bool isSlowDescent(const PyroFlightData& flight) {
+    return flight.apogeeTime != 0 && flight.velocity > -5.0f;
+}
+
+void setUp(void) {
+    // Any setup code can go here
+    fakeTime = 0;
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_state_event_fires_only_when_armed(void) {
+    PyroScheduler scheduler(noWrite, fakeClock);
+    int drogue = scheduler.addChannel("drogue", 15, HOLD);
+    int event = scheduler.addStateEvent("drogue", drogue, FlightState::APOGEE, 5000);
+    TEST_ASSERT_EQUAL(0, event);
+
+    fakeTime = 1000000;
+    TEST_ASSERT_EQUAL(0, scheduler.update(fakeTime, FlightState::APOGEE, 500, 0));
+    TEST_ASSERT_TRUE(scheduler.getEventState(event) == PyroEventState::WAITING);
+
+    scheduler.setArmed(true);
+    TEST_ASSERT_EQUAL(1, scheduler.update(fakeTime, FlightState::APOGEE, 500, 0));
+    TEST_ASSERT_TRUE(scheduler.getEventState(event) == PyroEventState::SCHEDULED);
+    TEST_ASSERT_TRUE(scheduler.getEventTime(event) == 1000000);
+    TEST_ASSERT_TRUE(scheduler.getTimer().getCommandedTime(drogue) == 1005000);
+
+    // Triggers once only
+    TEST_ASSERT_EQUAL(0, scheduler.update(fakeTime + TICK, FlightState::APOGEE, 500, 0));
+    TEST_ASSERT_FALSE(scheduler.isEventComplete(event));
+}
+
+void test_event_completes_after_the_hold(void) {
+    PyroScheduler scheduler(noWrite, fakeClock);
+    int drogue = scheduler.addChannel("drogue", 15, HOLD);
+    int event = scheduler.addStateEvent("drogue", drogue, FlightState::APOGEE, 0);
+    scheduler.setArmed(true);
+    scheduler.update(fakeTime, FlightState::APOGEE, 500, 0);
+
+    runUntil(scheduler, HOLD - TICK, FlightState::APOGEE, 500);
+    TEST_ASSERT_FALSE(scheduler.isEventComplete(event));
+    runUntil(scheduler, HOLD, FlightState::APOGEE, 500);
+    TEST_ASSERT_TRUE(scheduler.isEventComplete(event));
+}
+
+void test_altitude_events_follow_the_flight_phase(void) {
+    PyroScheduler scheduler(noWrite, fakeClock);
+    int airstart = scheduler.addChannel("airstart", 5, HOLD);
+    int mainChannel = scheduler.addChannel("main", 7, HOLD);
+    int ascentEvent = scheduler.addAltitudeEvent("airstart", airstart, 300, false, 0);
+    int descentEvent = scheduler.addAltitudeEvent("main", mainChannel, 120, true, 0);
+    scheduler.setArmed(true);
+
+    // Below the main altitude on the climb, which must not deploy the main
+    scheduler.update(10000, FlightState::ASCENT, 100, 80);
+    TEST_ASSERT_TRUE(scheduler.getEventState(descentEvent) == PyroEventState::WAITING);
+    scheduler.update(20000, FlightState::ASCENT, 310, 60);
+    TEST_ASSERT_TRUE(scheduler.getEventState(ascentEvent) == PyroEventState::SCHEDULED);
+
+    scheduler.update(30000, FlightState::APOGEE, 600, 0);
+    scheduler.update(40000, FlightState::DESCENT_DROGUE, 121, -20);
+    TEST_ASSERT_TRUE(scheduler.getEventState(descentEvent) == PyroEventState::WAITING);
+    scheduler.update(50000, FlightState::DESCENT_DROGUE, 119, -20);
+    TEST_ASSERT_TRUE(scheduler.getEventState(descentEvent) == PyroEventState::SCHEDULED);
+    TEST_ASSERT_TRUE(scheduler.getFlightData().launchTime == 10000);
+    TEST_ASSERT_TRUE(scheduler.getFlightData().apogeeTime == 30000);
+}
+
+void test_time_event_is_commanded_at_the_exact_time(void) {
+    PyroScheduler scheduler(noWrite, fakeClock);
+    int channel = scheduler.addChannel("stage", 5, HOLD);
+    int event = scheduler.addTimeEvent("stage", channel, false, 3500000);
+    scheduler.setArmed(true);
+
+    scheduler.update(1000000, FlightState::PRE_LAUNCH, 0, 0);
+    TEST_ASSERT_TRUE(scheduler.getEventState(event) == PyroEventState::WAITING);
+    // Launch seen at 1.002 s; the charge is commanded 3.5 s later, not at a tick
+    scheduler.update(1002000, FlightState::ASCENT, 1, 10);
+    TEST_ASSERT_TRUE(scheduler.getEventState(event) == PyroEventState::SCHEDULED);
+    TEST_ASSERT_TRUE(scheduler.getTimer().getCommandedTime(channel) == 4502000);
+}
+
+void test_condition_event(void) {
+    PyroScheduler scheduler(noWrite, fakeClock);
+    int channel = scheduler.addChannel("main", 7, HOLD);
+    TEST_ASSERT_EQUAL(-1, scheduler.addConditionEvent("none", channel, nullptr, 0));
+    int event = scheduler.addConditionEvent("main", channel, isSlowDescent, 0);
+    scheduler.setArmed(true);
+
+    scheduler.update(10000, FlightState::ASCENT, 100, -1);
+    TEST_ASSERT_TRUE(scheduler.getEventState(event) == PyroEventState::WAITING);
+    scheduler.update(20000, FlightState::APOGEE, 500, -30);
+    TEST_ASSERT_TRUE(scheduler.getEventState(event) == PyroEventState::WAITING);
+    scheduler.update(30000, FlightState::DESCENT_DROGUE, 480, -4);
+    TEST_ASSERT_TRUE(scheduler.getEventState(event) == PyroEventState::SCHEDULED);
+}
+
+void test_backup_fires_after_its_primary(void) {
+    PyroScheduler scheduler(noWrite, fakeClock);
+    int drogue = scheduler.addChannel("drogue", 15, HOLD);
+    int backup = scheduler.addChannel("drogue_backup", 8, HOLD);
+    int primary = scheduler.addStateEvent("drogue", drogue, FlightState::APOGEE, 5000);
+    TEST_ASSERT_EQUAL(-1, scheduler.addBackup("same_channel", primary, drogue, 1000000));
+    int backupEvent = scheduler.addBackup("drogue_backup", primary, backup, 1000000);
+    scheduler.setArmed(true);
+
+    fakeTime = 2000000;
+    TEST_ASSERT_EQUAL(2, scheduler.update(fakeTime, FlightState::APOGEE, 500, 0));
+    TEST_ASSERT_TRUE(scheduler.getEventState(backupEvent) == PyroEventState::SCHEDULED);
+    TEST_ASSERT_TRUE(scheduler.getTimer().getCommandedTime(drogue) == 2005000);
+    TEST_ASSERT_TRUE(scheduler.getTimer().getCommandedTime(backup) == 3005000);
+}
+
+void test_minimum_spacing_between_channels(void) {
+    PyroScheduler scheduler(noWrite, fakeClock);
+    int a = scheduler.addChannel("a", 15, HOLD);
+    int b = scheduler.addChannel("b", 7, HOLD);
+    int c = scheduler.addChannel("c", 8, HOLD);
+    scheduler.addStateEvent("a", a, FlightState::APOGEE, 0);
+    scheduler.addStateEvent("b", b, FlightState::APOGEE, 0);
+    int eventC = scheduler.addStateEvent("c", c, FlightState::APOGEE, 10000);
+    scheduler.setMinimumSpacing(SPACING);
+    scheduler.setArmed(true);
+
+    fakeTime = 1000000;
+    scheduler.update(fakeTime, FlightState::APOGEE, 500, 0);
+    const PyroTimer& timer = scheduler.getTimer();
+    TEST_ASSERT_TRUE(timer.getCommandedTime(a) == 1000000);
+    TEST_ASSERT_TRUE(timer.getCommandedTime(b) == 1000000 + SPACING);
+    // Clear of a, then of b
+    TEST_ASSERT_TRUE(scheduler.getRequestedTime(eventC) == 1010000);
+    TEST_ASSERT_TRUE(timer.getCommandedTime(c) == 1000000 + 2 * SPACING);
+}
+
+void test_used_channel_is_skipped(void) {
+    PyroScheduler scheduler(noWrite, fakeClock);
+    int drogue = scheduler.addChannel("drogue", 15, HOLD);
+    scheduler.addStateEvent("first", drogue, FlightState::APOGEE, 0);
+    int second = scheduler.addStateEvent("second", drogue, FlightState::DESCENT_DROGUE, 0);
+    scheduler.setArmed(true);
+
+    scheduler.update(1000, FlightState::APOGEE, 500, 0);
+    scheduler.update(2000, FlightState::DESCENT_DROGUE, 490, -10);
+    TEST_ASSERT_TRUE(scheduler.getEventState(second) == PyroEventState::SKIPPED);
+}
+
+void test_disarm_cancels_pending_charges(void) {
+    PyroScheduler scheduler(noWrite, fakeClock);
+    int drogue = scheduler.addChannel("drogue", 15, HOLD);
+    int event = scheduler.addStateEvent("drogue", drogue, FlightState::APOGEE, 500000);
+    scheduler.setArmed(true);
+    scheduler.update(1000, FlightState::APOGEE, 500, 0);
+    TEST_ASSERT_TRUE(scheduler.getTimer().getState(drogue) == PyroChannelState::SCHEDULED);
+
+    scheduler.setArmed(false);
+    TEST_ASSERT_TRUE(scheduler.getTimer().getState(drogue) == PyroChannelState::IDLE);
+    TEST_ASSERT_TRUE(scheduler.getEventState(event) == PyroEventState::WAITING);
+}
+
+void test_channel_states_for_telemetry_and_logs(void) {
+    PyroScheduler scheduler(noWrite, fakeClock);
+    int drogue = scheduler.addChannel("drogue", 15, HOLD);
+    scheduler.addChannel("main", 7, HOLD);
+    scheduler.addStateEvent("drogue", drogue, FlightState::APOGEE, 1000);
+    TEST_ASSERT_EQUAL(0, scheduler.getChannelStates());
+
+    // Two bits per channel, the first channel lowest
+    scheduler.setArmed(true);
+    scheduler.update(0, FlightState::APOGEE, 500, 0);
+    TEST_ASSERT_EQUAL(0x1, scheduler.getChannelStates());
+
+    char buffer[64];
+    int written = scheduler.formatChannels(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(static_cast<int>(strlen(buffer)), written);
+    TEST_ASSERT_EQUAL(0, strcmp(buffer, "drogue=SCHEDULED main=IDLE"));
+
+    // Truncated output stays terminated
+    written = scheduler.formatChannels(buffer, 10);
+    TEST_ASSERT_EQUAL(9, written);
+    TEST_ASSERT_EQUAL(9, static_cast<int>(strlen(buffer)));
+
+    // An idle first channel keeps the second in its own bits
+    PyroScheduler mainOnly(noWrite, fakeClock);
+    mainOnly.addChannel("drogue", 15, HOLD);
+    int mainChannel = mainOnly.addChannel("main", 7, HOLD);
+    mainOnly.addStateEvent("main", mainChannel, FlightState::LOW_ALTITUDE_DETECTION, 1000);
+    mainOnly.setArmed(true);
+    mainOnly.update(0, FlightState::LOW_ALTITUDE_DETECTION, 100, 0);
+    TEST_ASSERT_EQUAL(0x4, mainOnly.getChannelStates());
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_state_event_fires_only_when_armed);
+    RUN_TEST(test_event_completes_after_the_hold);
+    RUN_TEST(test_altitude_events_follow_the_flight_phase);
+    RUN_TEST(test_time_event_is_commanded_at_the_exact_time);
+    RUN_TEST(test_condition_event);
+    RUN_TEST(test_backup_fires_after_its_primary);
+    RUN_TEST(test_minimum_spacing_between_channels);
+    RUN_TEST(test_used_channel_is_skipped);
+    RUN_TEST(test_disarm_cancels_pending_charges);
+    RUN_TEST(test_channel_states_for_telemetry_and_logs);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,223 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include "pyroTimer.hpp"
+#include "interruptGuard.hpp"
+
+const uint8_t DROGUE_PIN = 9;
+const uint8_t MAIN_PIN = 6;
+const uint32_t HOLD = 2000000; // Pyro hold time (us)
+
+/**
+ * A pin edge made by the timer.
+ */
+struct Edge {
+    uint8_t pin;
+    bool high;
+    uint64_t time;
+};
+
+uint64_t fakeTime = 0;
+Edge edges[16];
+size_t numEdges = 0;
+
+uint64_t fakeClock() {
+    return fakeTime;
+}
+
+void recordEdge(uint8_t pin, bool high) {
+    if (numEdges < sizeof(edges) / sizeof(edges[0])) {
+        edges[numEdges++] = {pin, high, fakeTime};
+    }
+}
+
+size_t unmaskedEdges = 0;
+
+/**
+ * @brief Clock that masks and restores interrupts, as Timer::currentTimeMicros() does.
+ */
+uint64_t maskingClock() {
+    InterruptGuard guard;
+    return fakeTime;
+}
+
+void checkMaskedEdge(uint8_t pin, bool high) {
+    if (!InterruptGuard::isMasked()) {
+        unmaskedEdges++;
+    }
+    recordEdge(pin, high);
+}
+
+void setUp(void) {
+    // Any setup code can go here
+    fakeTime = 0;
+    numEdges = 0;
+    unmaskedEdges = 0;
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_fires_and_releases_on_schedule(void) {
+    PyroTimer timer(recordEdge, fakeClock);
+    int drogue = timer.addChannel(DROGUE_PIN, HOLD);
+    TEST_ASSERT_EQUAL(0, drogue);
+    TEST_ASSERT_TRUE(timer.getNextEdge() == PyroTimer::NO_EDGE);
+
+    TEST_ASSERT_TRUE(timer.schedule(drogue, 1000000));
+    TEST_ASSERT_TRUE(timer.getState(drogue) == PyroChannelState::SCHEDULED);
+    TEST_ASSERT_TRUE(timer.getNextEdge() == 1000000);
+
+    // Early service makes no edge
+    fakeTime = 999999;
+    timer.service(fakeTime);
+    TEST_ASSERT_EQUAL(0, numEdges);
+
+    fakeTime = 1000000;
+    timer.service(fakeTime);
+    TEST_ASSERT_EQUAL(1, numEdges);
+    TEST_ASSERT_TRUE(edges[0].high);
+    TEST_ASSERT_EQUAL(DROGUE_PIN, edges[0].pin);
+    TEST_ASSERT_TRUE(timer.getState(drogue) == PyroChannelState::FIRING);
+    TEST_ASSERT_TRUE(timer.getNextEdge() == 1000000 + HOLD);
+
+    fakeTime = 1000000 + HOLD;
+    timer.service(fakeTime);
+    TEST_ASSERT_EQUAL(2, numEdges);
+    TEST_ASSERT_FALSE(edges[1].high);
+    TEST_ASSERT_TRUE(timer.getState(drogue) == PyroChannelState::FIRED);
+    TEST_ASSERT_TRUE(timer.getCommandedTime(drogue) == 1000000);
+    TEST_ASSERT_TRUE(timer.getFireTime(drogue) == 1000000);
+    TEST_ASSERT_TRUE(timer.getReleaseTime(drogue) == 1000000 + HOLD);
+    TEST_ASSERT_TRUE(timer.getNextEdge() == PyroTimer::NO_EDGE);
+}
+
+void test_past_time_fires_at_once(void) {
+    PyroTimer timer(recordEdge, fakeClock);
+    int mainPyro = timer.addChannel(MAIN_PIN, HOLD);
+
+    // Commanded in the past, so the pin goes HIGH inside schedule()
+    fakeTime = 5000000;
+    TEST_ASSERT_TRUE(timer.schedule(mainPyro, 4000000));
+    TEST_ASSERT_EQUAL(1, numEdges);
+    TEST_ASSERT_TRUE(edges[0].high);
+    TEST_ASSERT_TRUE(timer.getFireTime(mainPyro) == 5000000);
+
+    // A firing channel cannot be rescheduled
+    TEST_ASSERT_FALSE(timer.schedule(mainPyro, 6000000));
+}
+
+void test_late_service_still_holds_in_full(void) {
+    PyroTimer timer(recordEdge, fakeClock);
+    int drogue = timer.addChannel(DROGUE_PIN, HOLD);
+    timer.schedule(drogue, 1000000);
+
+    // Serviced late; the hold runs from when the pin actually went HIGH
+    fakeTime = 1000500;
+    timer.service(fakeTime);
+    fakeTime = 1000000 + HOLD;
+    timer.service(fakeTime);
+    TEST_ASSERT_TRUE(timer.getState(drogue) == PyroChannelState::FIRING);
+    fakeTime = 1000500 + HOLD;
+    timer.service(fakeTime);
+    TEST_ASSERT_TRUE(timer.getState(drogue) == PyroChannelState::FIRED);
+}
+
+void test_cancel_drives_pin_low(void) {
+    PyroTimer timer(recordEdge, fakeClock);
+    int drogue = timer.addChannel(DROGUE_PIN, HOLD);
+    int mainPyro = timer.addChannel(MAIN_PIN, HOLD);
+
+    timer.schedule(drogue, 1000);
+    timer.schedule(mainPyro, 3000);
+    fakeTime = 1000;
+    timer.service(fakeTime);
+    TEST_ASSERT_TRUE(timer.cancel(drogue));
+    TEST_ASSERT_EQUAL(2, numEdges);
+    TEST_ASSERT_FALSE(edges[1].high);
+    TEST_ASSERT_EQUAL(DROGUE_PIN, edges[1].pin);
+    TEST_ASSERT_TRUE(timer.getState(drogue) == PyroChannelState::IDLE);
+
+    // The other channel is still pending
+    TEST_ASSERT_TRUE(timer.getNextEdge() == 3000);
+    TEST_ASSERT_TRUE(timer.cancel(mainPyro));
+    TEST_ASSERT_TRUE(timer.getNextEdge() == PyroTimer::NO_EDGE);
+    TEST_ASSERT_EQUAL(2, numEdges);
+    TEST_ASSERT_FALSE(timer.cancel(mainPyro));
+}
+
+void test_channel_limits(void) {
+    PyroTimer timer(recordEdge, fakeClock);
+    for (size_t i = 0; i < PyroTimer::MAX_CHANNELS; ++i) {
+        TEST_ASSERT_EQUAL(static_cast<int>(i), timer.addChannel(static_cast<uint8_t>(i), HOLD));
+    }
+    TEST_ASSERT_EQUAL(-1, timer.addChannel(10, HOLD));
+    TEST_ASSERT_FALSE(timer.schedule(-1, 0));
+    TEST_ASSERT_FALSE(timer.schedule(static_cast<int>(PyroTimer::MAX_CHANNELS), 0));
+}
+
+void test_fires_on_time_while_main_thread_stalls(void) {
+    PyroTimer timer;
+    int drogue = timer.addChannel(DROGUE_PIN, 20000);
+    TEST_ASSERT_TRUE(timer.start());
+
+    PyroTimer other;
+    TEST_ASSERT_FALSE(other.start());
+
+    uint64_t commanded = timer.now() + 50000;
+    TEST_ASSERT_TRUE(timer.schedule(drogue, commanded));
+
+    // The main thread is busy well past the fire time
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    TEST_ASSERT_TRUE(timer.getState(drogue) == PyroChannelState::FIRED);
+    timer.stop();
+
+    uint64_t late = timer.getFireTime(drogue) - commanded;
+    uint64_t held = timer.getReleaseTime(drogue) - timer.getFireTime(drogue);
+    char message[96];
+    snprintf(message, sizeof(message), "Fired %lu us after the commanded time, held %lu us",
+             static_cast<unsigned long>(late), static_cast<unsigned long>(held));
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(timer.getFireTime(drogue) >= commanded);
+    // Far inside the 100 ms the main thread was stalled past the fire time
+    TEST_ASSERT_TRUE(late < 20000);
+    TEST_ASSERT_TRUE(held >= 20000);
+}
+
+void test_edges_are_made_with_interrupts_masked(void) {
+    PyroTimer timer(checkMaskedEdge, maskingClock);
+    int drogue = timer.addChannel(DROGUE_PIN, HOLD);
+    int mainPyro = timer.addChannel(MAIN_PIN, HOLD);
+
+    // Already due, so schedule() makes the edge itself after reading the clock
+    fakeTime = 1000000;
+    TEST_ASSERT_TRUE(timer.schedule(drogue, 500000));
+    TEST_ASSERT_TRUE(timer.schedule(mainPyro, 1000000 + HOLD));
+    fakeTime = 1000000 + HOLD;
+    timer.service(fakeTime);
+    TEST_ASSERT_TRUE(timer.cancel(mainPyro));
+
+    // Fire and release of the drogue, fire of the main and its cancel
+    TEST_ASSERT_EQUAL(4, numEdges);
+    TEST_ASSERT_EQUAL(0, unmaskedEdges);
+    TEST_ASSERT_FALSE(InterruptGuard::isMasked());
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_fires_and_releases_on_schedule);
+    RUN_TEST(test_past_time_fires_at_once);
+    RUN_TEST(test_late_service_still_holds_in_full);
+    RUN_TEST(test_cancel_drives_pin_low);
+    RUN_TEST(test_channel_limits);
+    RUN_TEST(test_fires_on_time_while_main_thread_stalls);
+    RUN_TEST(test_edges_are_made_with_interrupts_masked);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,231 @@
+#include <unity.h>
+#include <cmath>
+#include "rateController.hpp"
+
+const uint32_t TICK = 2000;              // 500 Hz control tick (us)
+const float DT = TICK * 1e-6f;           // Control tick (s)
+const float REFERENCE_VELOCITY = 100.0f; // Velocity the gains are set for (m/s)
+const float MIN_VELOCITY = 30.0f;        // Controller disengages below this (m/s)
+const float MAX_GAIN_SCALE = 4.0f;       // Gain scale limit at low velocity
+const float MAX_DEFLECTION = 15.0f;      // Fin deflection limit (degrees)
+const float SERVO_LAG = 0.02f;           // Servo time constant (s)
+
+/**
+ * @brief Rigid airframe with four fins, at the velocity it flies.
+ *
+ * Fin moments and aerodynamic damping grow with dynamic pressure, so with
+ * the velocity ratio squared. The airframe is far stiffer in roll than in
+ * pitch and yaw. Fin deflections follow their command with a first-order
+ * lag, as a servo would.
+ */
+struct Airframe {
+    float velocity;          // Airspeed (m/s)
+    Vector3 rate;            // Body rate (rad/s)
+    float fins[RateController::NUM_FINS]; // Actual fin deflections (degrees)
+    float rollDisturbance;   // Roll acceleration at the reference velocity, e.g. from fin cant (rad/s^2)
+
+    explicit Airframe(float v) : velocity(v), rate{0, 0, 0}, fins(), rollDisturbance(0) {}
+
+    void step(const RateController& controller) {
+        for (size_t i = 0; i < RateController::NUM_FINS; ++i) {
+            fins[i] += (controller.getDeflection(i) - fins[i]) * DT / SERVO_LAG;
+        }
+        float pressure = (velocity / REFERENCE_VELOCITY) * (velocity / REFERENCE_VELOCITY);
+        float roll = (fins[0] + fins[1] + fins[2] + fins[3]) / 4;
+        float pitch = (fins[0] - fins[2]) / 2;
+        float yaw = (fins[1] - fins[3]) / 2;
+        // Angular acceleration per degree of fin at the reference velocity (rad/s^2), and damping (1/s)
+        rate.z += pressure * (20.0f * roll + rollDisturbance - 5.0f * rate.z) * DT;
+        rate.x += pressure * (2.0f * pitch - 0.5f * rate.x) * DT;
+        rate.y += pressure * (2.0f * yaw - 0.5f * rate.y) * DT;
+    }
+};
+
+uint64_t fakeTime = 0;
+
+void configure(RateController& controller) {
+    controller.setGains(ControlAxis::ROLL, {0.3f, 1.2f, 0});
+    controller.setGains(ControlAxis::PITCH, {4.0f, 4.0f, 0});
+    controller.setGains(ControlAxis::YAW, {4.0f, 4.0f, 0});
+    controller.setSchedule(REFERENCE_VELOCITY, MIN_VELOCITY, MAX_GAIN_SCALE);
+    controller.setMaxDeflection(MAX_DEFLECTION);
+}
+
+/**
+ * @brief Fly the airframe under the controller for a time.
+ *
+ * @return Largest absolute pitch rate seen after the first half of the run (rad/s).
+ */
+float fly(RateController& controller, Airframe& airframe, float seconds) {
+    float peak = 0;
+    int steps = static_cast<int>(seconds / DT);
+    for (int i = 0; i < steps; ++i) {
+        fakeTime += TICK;
+        controller.update(fakeTime, airframe.rate, airframe.velocity);
+        airframe.step(controller);
+        if (i > steps / 2 && std::fabs(airframe.rate.x) > peak) {
+            peak = std::fabs(airframe.rate.x);
+        }
+    }
+    return peak;
+}
+
+void setUp(void) {
+    // Any setup code can go here
+    fakeTime = 0;
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_mixer_pure_axes(void) {
+    float fins[RateController::NUM_FINS];
+
+    RateController::mix(2.0f, 0, 0, fins);
+    for (float fin : fins) {
+        TEST_ASSERT_EQUAL_FLOAT(2.0f, fin);
+    }
+
+    RateController::mix(0, 3.0f, 0, fins);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, fins[0]);
+    TEST_ASSERT_EQUAL_FLOAT(0, fins[1]);
+    TEST_ASSERT_EQUAL_FLOAT(-3.0f, fins[2]);
+    TEST_ASSERT_EQUAL_FLOAT(0, fins[3]);
+
+    RateController::mix(0, 0, -1.5f, fins);
+    TEST_ASSERT_EQUAL_FLOAT(0, fins[0]);
+    TEST_ASSERT_EQUAL_FLOAT(-1.5f, fins[1]);
+    TEST_ASSERT_EQUAL_FLOAT(0, fins[2]);
+    TEST_ASSERT_EQUAL_FLOAT(1.5f, fins[3]);
+}
+
+void test_saturated_mix_scales_all_fins(void) {
+    RateController controller;
+    controller.setGains(ControlAxis::ROLL, {10.0f, 0, 0});
+    controller.setGains(ControlAxis::PITCH, {10.0f, 0, 0});
+    controller.setSchedule(REFERENCE_VELOCITY, MIN_VELOCITY, MAX_GAIN_SCALE);
+    controller.setMaxDeflection(MAX_DEFLECTION);
+
+    // Roll 10 and pitch 10 ask 20 of fin A; all fins shrink by 15/20
+    TEST_ASSERT_TRUE(controller.update(0, {-1.0f, 0, -1.0f}, REFERENCE_VELOCITY));
+    TEST_ASSERT_TRUE(controller.isSaturated());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 15.0f, controller.getDeflection(0));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 7.5f, controller.getDeflection(1));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0, controller.getDeflection(2));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 7.5f, controller.getDeflection(3));
+    TEST_ASSERT_EQUAL_FLOAT(0, controller.getDeflection(RateController::NUM_FINS));
+}
+
+void test_gain_schedule(void) {
+    RateController controller;
+    configure(controller);
+
+    controller.update(0, {0, 0, 0}, REFERENCE_VELOCITY);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, controller.getGainScale());
+    controller.update(TICK, {0, 0, 0}, 200.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.25f, controller.getGainScale());
+    // Descending velocity schedules the same as ascending
+    controller.update(2 * TICK, {0, 0, 0}, -200.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.25f, controller.getGainScale());
+    controller.update(3 * TICK, {0, 0, 0}, 40.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, MAX_GAIN_SCALE, controller.getGainScale());
+}
+
+void test_neutral_below_minimum_velocity(void) {
+    RateController controller;
+    configure(controller);
+
+    TEST_ASSERT_FALSE(controller.update(0, {1.0f, 1.0f, 1.0f}, 10.0f));
+    TEST_ASSERT_FALSE(controller.isEngaged());
+    for (size_t i = 0; i < RateController::NUM_FINS; ++i) {
+        TEST_ASSERT_EQUAL_FLOAT(0, controller.getDeflection(i));
+    }
+
+    TEST_ASSERT_TRUE(controller.update(TICK, {1.0f, 0, 0}, REFERENCE_VELOCITY));
+    TEST_ASSERT_TRUE(controller.update(2 * TICK, {1.0f, 0, 0}, REFERENCE_VELOCITY));
+    TEST_ASSERT_TRUE(controller.getDeflection(0) != 0);
+    TEST_ASSERT_TRUE(controller.getPid(ControlAxis::PITCH).getIntegral() != 0);
+
+    // Slowing down releases the fins and clears the integrals
+    TEST_ASSERT_FALSE(controller.update(3 * TICK, {1.0f, 0, 0}, 20.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0, controller.getDeflection(0));
+    TEST_ASSERT_EQUAL_FLOAT(0, controller.getPid(ControlAxis::PITCH).getIntegral());
+}
+
+void test_rejects_roll_disturbance(void) {
+    RateController controller;
+    configure(controller);
+    Airframe airframe(REFERENCE_VELOCITY);
+    airframe.rollDisturbance = 10.0f; // As from half a degree of fin cant
+
+    fly(controller, airframe, 3.0f);
+
+    // Proportional alone would leave 10 / (20 * 0.3 + 5) rad/s; the integral trims it out
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 0, airframe.rate.z);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, -0.5f, controller.getCommand(ControlAxis::ROLL));
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, -0.5f, controller.getDeflection(0));
+    TEST_ASSERT_FALSE(controller.isSaturated());
+}
+
+void test_anti_windup_bounds_the_integral(void) {
+    RateController controller;
+    configure(controller);
+    Airframe airframe(REFERENCE_VELOCITY);
+    // Needs 20 degrees of fin to hold, more than the fins have
+    airframe.rollDisturbance = 400.0f;
+
+    fly(controller, airframe, 2.0f);
+    const PidController& roll = controller.getPid(ControlAxis::ROLL);
+    TEST_ASSERT_TRUE(roll.isSaturated());
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, -MAX_DEFLECTION, controller.getDeflection(0));
+    float integral = roll.getIntegral();
+    TEST_ASSERT_TRUE(integral > -MAX_DEFLECTION);
+
+    // The integral stopped where the output saturated instead of running on
+    fly(controller, airframe, 8.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, integral, roll.getIntegral());
+
+    // With the disturbance gone it unwinds and settles
+    airframe.rollDisturbance = 0;
+    fly(controller, airframe, 8.0f);
+    TEST_ASSERT_FALSE(roll.isSaturated());
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 0, airframe.rate.z);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0, controller.getDeflection(0));
+}
+
+void test_stable_across_velocities(void) {
+    const float velocities[] = {40.0f, REFERENCE_VELOCITY, 300.0f};
+    for (float velocity : velocities) {
+        RateController controller;
+        configure(controller);
+        Airframe airframe(velocity);
+        airframe.rate = {1.0f, -1.0f, 0.5f};
+
+        float late = fly(controller, airframe, 4.0f);
+
+        TEST_MESSAGE(velocity < 50 ? "40 m/s" : (velocity < 200 ? "100 m/s" : "300 m/s"));
+        TEST_ASSERT_FLOAT_WITHIN(0.02f, 0, airframe.rate.x);
+        TEST_ASSERT_FLOAT_WITHIN(0.02f, 0, airframe.rate.y);
+        TEST_ASSERT_FLOAT_WITHIN(0.02f, 0, airframe.rate.z);
+        // No sustained oscillation in the second half
+        TEST_ASSERT_TRUE(late < 0.05f);
+    }
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_mixer_pure_axes);
+    RUN_TEST(test_saturated_mix_scales_all_fins);
+    RUN_TEST(test_gain_schedule);
+    RUN_TEST(test_neutral_below_minimum_velocity);
+    RUN_TEST(test_rejects_roll_disturbance);
+    RUN_TEST(test_anti_windup_bounds_the_integral);
+    RUN_TEST(test_stable_across_velocities);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
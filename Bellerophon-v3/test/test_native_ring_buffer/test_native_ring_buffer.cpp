@@ -0,0 +1,99 @@
+#include <unity.h>
+#include "ringBuffer.hpp"
+
+const size_t CAPACITY = 8;
+
+// Setup function runs before each test
+void setUp(void) {
+    // Any setup code can go here
+}
+
+// Teardown function runs after each test
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_limit_is_clamped_to_the_capacity() {
+    RingBuffer<int, CAPACITY> unlimited;
+    RingBuffer<int, CAPACITY> tooLarge(100);
+    RingBuffer<int, CAPACITY> zero(0);
+    RingBuffer<int, CAPACITY> limited(3);
+
+    TEST_ASSERT_EQUAL(CAPACITY, unlimited.capacity());
+    TEST_ASSERT_EQUAL(CAPACITY, tooLarge.capacity());
+    TEST_ASSERT_EQUAL(1, zero.capacity());
+    TEST_ASSERT_EQUAL(3, limited.capacity());
+}
+
+void test_push_keeps_age_order() {
+    RingBuffer<int, CAPACITY> buffer;
+    TEST_ASSERT_TRUE(buffer.empty());
+
+    for (int i = 0; i < 5; ++i) {
+        buffer.push(i);
+    }
+    TEST_ASSERT_EQUAL(5, buffer.size());
+    TEST_ASSERT_FALSE(buffer.full());
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        TEST_ASSERT_EQUAL(static_cast<int>(i), buffer[i]);
+        TEST_ASSERT_EQUAL(4 - static_cast<int>(i), buffer.fromNewest(i));
+    }
+    TEST_ASSERT_EQUAL(0, buffer.front());
+    TEST_ASSERT_EQUAL(4, buffer.back());
+}
+
+void test_wraparound_overwrites_the_oldest() {
+    RingBuffer<int, CAPACITY> buffer(5);
+
+    // Several times round the storage, so the head passes the end repeatedly
+    for (int i = 0; i < 23; ++i) {
+        buffer.push(i);
+        TEST_ASSERT_EQUAL(i, buffer.back());
+        TEST_ASSERT_EQUAL(i < 5 ? 0 : i - 4, buffer.front());
+    }
+    TEST_ASSERT_TRUE(buffer.full());
+    TEST_ASSERT_EQUAL(5, buffer.size());
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        TEST_ASSERT_EQUAL(18 + static_cast<int>(i), buffer[i]);
+    }
+}
+
+void test_pop_and_clear() {
+    RingBuffer<int, CAPACITY> buffer(4);
+    for (int i = 0; i < 6; ++i) {
+        buffer.push(i);
+    }
+
+    buffer.pop();
+    TEST_ASSERT_EQUAL(3, buffer.size());
+    TEST_ASSERT_EQUAL(3, buffer.front());
+    TEST_ASSERT_EQUAL(5, buffer.back());
+
+    // Pushing after a pop across the wrap point fills the freed slot
+    buffer.push(6);
+    TEST_ASSERT_TRUE(buffer.full());
+    TEST_ASSERT_EQUAL(3, buffer.front());
+    TEST_ASSERT_EQUAL(6, buffer.back());
+
+    buffer.clear();
+    TEST_ASSERT_TRUE(buffer.empty());
+    buffer.pop(); // Does nothing when empty
+    TEST_ASSERT_EQUAL(0, buffer.size());
+    buffer.push(7);
+    TEST_ASSERT_EQUAL(7, buffer.front());
+    TEST_ASSERT_EQUAL(7, buffer.back());
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_limit_is_clamped_to_the_capacity);
+    RUN_TEST(test_push_keeps_age_order);
+    RUN_TEST(test_wraparound_overwrites_the_oldest);
+    RUN_TEST(test_pop_and_clear);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,70 @@
+#include <unity.h>
+#include "sampleStore.hpp"
+
+// Setup function runs before each test
+void setUp(void) {
+    // Any setup code can go here
+}
+
+// Teardown function runs after each test
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_columns_advance_in_lockstep() {
+    SampleStore<16> store(4);
+    TEST_ASSERT_EQUAL(4, store.capacity());
+
+    // Past the limit, so every column wraps together
+    for (int i = 0; i < 10; ++i) {
+        store.push(static_cast<float>(i * i), 1000u * i);
+    }
+    TEST_ASSERT_TRUE(store.full());
+    TEST_ASSERT_EQUAL(4, store.size());
+    for (size_t i = 0; i < store.size(); ++i) {
+        int n = 6 + static_cast<int>(i);
+        TEST_ASSERT_EQUAL_FLOAT(static_cast<float>(n * n), store.value[i]);
+        TEST_ASSERT_EQUAL(1000u * n, store.timestamp[i]);
+        TEST_ASSERT_EQUAL_FLOAT(static_cast<float>(2 * n - 1), store.rateOfChange[i]);
+    }
+}
+
+void test_rate_of_change_is_absolute() {
+    SampleStore<8> store;
+    store.push(5.0f, 0);
+    store.push(2.0f, 10);
+    store.push(3.5f, 20);
+
+    // The first sample has nothing to change from
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, store.rateOfChange[0]);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, store.rateOfChange[1]);
+    TEST_ASSERT_EQUAL_FLOAT(1.5f, store.rateOfChange[2]);
+}
+
+void test_clear_empties_every_column() {
+    SampleStore<8> store;
+    store.push(5.0f, 0);
+    store.push(7.0f, 10);
+    store.clear();
+
+    TEST_ASSERT_EQUAL(0, store.size());
+    TEST_ASSERT_TRUE(store.timestamp.empty());
+    TEST_ASSERT_TRUE(store.rateOfChange.empty());
+
+    // The change is measured from nothing again
+    store.push(9.0f, 20);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, store.rateOfChange.back());
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_columns_advance_in_lockstep);
+    RUN_TEST(test_rate_of_change_is_absolute);
+    RUN_TEST(test_clear_empties_every_column);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
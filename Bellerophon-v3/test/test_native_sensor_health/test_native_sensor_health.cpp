@@ -0,0 +1,127 @@
+#include <unity.h>
+#include <cstring>
+#include "sensorHealthMonitor.hpp"
+
+const uint64_t PERIOD = 10000; // 100 Hz checks (us)
+
+/**
+ * Sensor processor whose update count, raw value, outlier ratio and error
+ * count are set directly by the test.
+ */
+class FakeSensor : public SensorProcessor {
+public:
+    uint32_t updates = 0;
+    uint32_t errors = 0;
+    float outlierRatio = 0;
+    mutable float raw[2] = {0, 0};
+
+    void newSample(float value) {
+        raw[0] = value;
+        updates++;
+    }
+
+    void update() override {}
+    bool hasEstimate(SensorOutput) const override { return true; }
+    float getVariance(SensorOutput) const override { return 1.0f; }
+    uint32_t getUpdateCount() const override { return updates; }
+    uint32_t getErrorCount() const override { return errors; }
+    float getOutlierRatio() const override { return outlierRatio; }
+    float getAltitude() const override { return raw[0]; }
+    float getVerticalVelocity() const override { return 0; }
+    float getAcceleration() const override { return 0; }
+    float getGroundAltitude() const override { return 0; }
+    float getMaxAltitude() const override { return 0; }
+    float getMaxVelocity() const override { return 0; }
+    float getMaxAcceleration() const override { return 0; }
+    float* getRawData() const override { return raw; }
+    size_t getNumSensorValues() const override { return 2; }
+    std::string getSensorNames() const override { return "fake,temperature"; }
+};
+
+FakeSensor sensor;
+SensorHealthMonitor monitor;
+uint64_t now;
+
+void setUp(void) {
+    sensor = FakeSensor();
+    monitor = SensorHealthMonitor();
+    now = 0;
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+// Run checks for a number of periods, giving the sensor a new sample every `divider` checks
+void run(int checks, int divider = 1, bool changing = true) {
+    for (int i = 0; i < checks; ++i) {
+        now += PERIOD;
+        if (divider > 0 && i % divider == 0) {
+            sensor.newSample(changing ? static_cast<float>(i) : 1.0f);
+        }
+        monitor.update(sensor, now);
+    }
+}
+
+void test_healthy_sensor_stays_healthy(void) {
+    run(300);
+    TEST_ASSERT_TRUE(monitor.isHealthy());
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 100.0f, monitor.getUpdateRate());
+}
+
+void test_detects_stale_sensor_and_recovers(void) {
+    run(200);
+    run(60, 0); // no new data for 600 ms
+    TEST_ASSERT_FALSE(monitor.isHealthy());
+    TEST_ASSERT_TRUE(monitor.getFaults() & SensorHealthMonitor::STALE);
+
+    // Two full windows of good data clear every fault
+    run(250);
+    TEST_ASSERT_TRUE(monitor.isHealthy());
+}
+
+void test_detects_low_update_rate(void) {
+    run(300, 20); // 5 Hz
+    TEST_ASSERT_TRUE(monitor.getFaults() & SensorHealthMonitor::LOW_RATE);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 5.0f, monitor.getUpdateRate());
+}
+
+void test_detects_stuck_values(void) {
+    run(100);
+    run(60, 1, false);
+    TEST_ASSERT_TRUE(monitor.getFaults() & SensorHealthMonitor::STUCK);
+}
+
+void test_detects_outliers_and_bus_errors(void) {
+    run(100);
+    sensor.outlierRatio = 0.8f;
+    sensor.errors = 20;
+    TEST_ASSERT_TRUE(monitor.update(sensor, now + PERIOD));
+    TEST_ASSERT_TRUE(monitor.getFaults() & SensorHealthMonitor::OUTLIERS);
+    TEST_ASSERT_TRUE(monitor.getFaults() & SensorHealthMonitor::BUS_ERRORS);
+}
+
+void test_formats_diagnostics(void) {
+    run(200);
+    run(60, 0);
+    char buffer[128];
+    monitor.formatDiagnostics(buffer, sizeof(buffer), sensor);
+    TEST_ASSERT_TRUE(strstr(buffer, "EXCLUDED") != nullptr);
+    TEST_ASSERT_TRUE(strstr(buffer, "stale") != nullptr);
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_healthy_sensor_stays_healthy);
+    RUN_TEST(test_detects_stale_sensor_and_recovers);
+    RUN_TEST(test_detects_low_update_rate);
+    RUN_TEST(test_detects_stuck_values);
+    RUN_TEST(test_detects_outliers_and_bus_errors);
+    RUN_TEST(test_formats_diagnostics);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
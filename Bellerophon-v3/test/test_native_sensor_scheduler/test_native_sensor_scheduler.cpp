@@ -0,0 +1,100 @@
+#include <unity.h>
+#include <cstdio>
+#include "sensorScheduler.hpp"
+
+const uint32_t BAROMETER_PERIOD = 6000; // MPL3115A2 without oversampling (us)
+const uint32_t IMU_PERIOD = 9615;       // LSM6DSL at 104 Hz (us)
+
+void setUp(void) {
+    // Any setup code can go here
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_samples_once_per_period(void) {
+    SensorSchedule schedule(BAROMETER_PERIOD);
+    int samples = 0;
+    // 1 kHz loop for one second
+    for (uint64_t now = 0; now < 1000000; now += 1000) {
+        samples += schedule.isDue(now);
+    }
+    TEST_ASSERT_EQUAL(167, samples);
+    TEST_ASSERT_EQUAL(167, schedule.getPerformedCount());
+    TEST_ASSERT_EQUAL(833, schedule.getSkippedCount());
+}
+
+void test_zero_period_samples_every_pass(void) {
+    SensorSchedule schedule;
+    for (uint64_t now = 0; now < 100; ++now) {
+        TEST_ASSERT_TRUE(schedule.isDue(now));
+    }
+    TEST_ASSERT_EQUAL(0, schedule.getSkippedCount());
+}
+
+void test_late_pass_does_not_burst(void) {
+    SensorSchedule schedule(BAROMETER_PERIOD);
+    TEST_ASSERT_TRUE(schedule.isDue(0));
+
+    // The loop stalls for ten periods
+    TEST_ASSERT_TRUE(schedule.isDue(60500));
+    TEST_ASSERT_FALSE(schedule.isDue(61000));
+    TEST_ASSERT_FALSE(schedule.isDue(66000));
+    TEST_ASSERT_TRUE(schedule.isDue(66500));
+}
+
+void test_keeps_phase_when_on_time(void) {
+    SensorSchedule schedule(BAROMETER_PERIOD);
+    TEST_ASSERT_TRUE(schedule.isDue(0));
+    // Slightly late passes do not accumulate into drift
+    TEST_ASSERT_TRUE(schedule.isDue(6400));
+    TEST_ASSERT_FALSE(schedule.isDue(11900));
+    TEST_ASSERT_TRUE(schedule.isDue(12000));
+}
+
+void test_set_period_samples_next_pass(void) {
+    SensorSchedule schedule(BAROMETER_PERIOD);
+    TEST_ASSERT_TRUE(schedule.isDue(0));
+    schedule.setPeriod(IMU_PERIOD);
+    TEST_ASSERT_TRUE(schedule.isDue(1000));
+    TEST_ASSERT_FALSE(schedule.isDue(10000));
+    TEST_ASSERT_EQUAL(IMU_PERIOD, schedule.getPeriod());
+}
+
+void test_reduction_in_sensor_reads(void) {
+    SensorSchedule barometer(BAROMETER_PERIOD);
+    SensorSchedule imu(IMU_PERIOD);
+    const uint32_t loopPeriod = 500; // 2 kHz main loop
+    const int passes = 2000;
+
+    for (int i = 0; i < passes; ++i) {
+        uint64_t now = static_cast<uint64_t>(i) * loopPeriod;
+        barometer.isDue(now);
+        imu.isDue(now);
+    }
+
+    uint32_t reads = barometer.getPerformedCount() + imu.getPerformedCount();
+    char message[80];
+    snprintf(message, sizeof(message), "sensor reads per second: %lu scheduled vs %d polled",
+             static_cast<unsigned long>(reads), 2 * passes);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL(167, barometer.getPerformedCount());
+    TEST_ASSERT_EQUAL(104, imu.getPerformedCount());
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_samples_once_per_period);
+    RUN_TEST(test_zero_period_samples_every_pass);
+    RUN_TEST(test_late_pass_does_not_burst);
+    RUN_TEST(test_keeps_phase_when_on_time);
+    RUN_TEST(test_set_period_samples_next_pass);
+    RUN_TEST(test_reduction_in_sensor_reads);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
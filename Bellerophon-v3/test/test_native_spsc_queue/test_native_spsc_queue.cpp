@@ -0,0 +1,229 @@
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "spscQueue.hpp"
+#include "sensorSampler.hpp"
+
+/**
+ * Sample passed through the queues. The checksum catches a slot read while
+ * it is being written.
+ */
+struct Sample {
+    uint32_t sequence;
+    uint32_t values[6];
+    uint32_t checksum;
+
+    static Sample make(uint32_t sequence) {
+        Sample sample{sequence, {}, sequence};
+        for (uint32_t i = 0; i < 6; ++i) {
+            sample.values[i] = sequence * 7 + i;
+            sample.checksum ^= sample.values[i];
+        }
+        return sample;
+    }
+
+    bool valid() const {
+        uint32_t check = sequence;
+        for (uint32_t i = 0; i < 6; ++i) {
+            check ^= values[i];
+        }
+        return check == checksum;
+    }
+};
+
+/**
+ * Sensor processor whose acquire() queues a sample on every serviced tick,
+ * like the pressure and IMU sensors, and whose update() drains the queue.
+ */
+class QueuedSensor : public SensorProcessor {
+public:
+    SpscQueue<Sample, 64> queue;
+    uint32_t produced = 0;  // producer side only
+    uint32_t consumed = 0;  // consumer side only
+    uint32_t updates = 0;
+    bool ordered = true;
+    uint32_t period = 0;
+
+    void acquire(uint64_t now) override {
+        if (queue.push(Sample::make(produced))) {
+            produced++;
+        }
+    }
+
+    void update() override {
+        Sample sample;
+        while (queue.pop(sample)) {
+            ordered = ordered && sample.valid() && sample.sequence == consumed;
+            consumed++;
+            updates++;
+        }
+    }
+
+    bool hasEstimate(SensorOutput) const override { return false; }
+    float getVariance(SensorOutput) const override { return 1.0f; }
+    uint32_t getUpdateCount() const override { return updates; }
+    uint32_t getUpdatePeriod() const override { return period; }
+    float getAltitude() const override { return 0; }
+    float getVerticalVelocity() const override { return 0; }
+    float getAcceleration() const override { return 0; }
+    float getGroundAltitude() const override { return 0; }
+    float getMaxAltitude() const override { return 0; }
+    float getMaxVelocity() const override { return 0; }
+    float getMaxAcceleration() const override { return 0; }
+    float* getRawData() const override { return nullptr; }
+    size_t getNumSensorValues() const override { return 0; }
+    std::string getSensorNames() const override { return "queued"; }
+};
+
+void setUp(void) {
+    // Any setup code can go here
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_push_pop_in_order(void) {
+    SpscQueue<int, 4> queue;
+    int value = 0;
+    TEST_ASSERT_FALSE(queue.pop(value));
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT_TRUE(queue.push(i));
+    }
+    TEST_ASSERT_EQUAL(4, queue.size());
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT_TRUE(queue.pop(value));
+        TEST_ASSERT_EQUAL(i, value);
+    }
+    TEST_ASSERT_TRUE(queue.empty());
+}
+
+void test_full_queue_drops_newest(void) {
+    SpscQueue<int, 4> queue;
+    for (int i = 0; i < 6; ++i) {
+        queue.push(i);
+    }
+    TEST_ASSERT_EQUAL(2, queue.getDroppedCount());
+    int value = -1;
+    queue.pop(value);
+    TEST_ASSERT_EQUAL(0, value);
+}
+
+void test_indices_wrap(void) {
+    SpscQueue<int, 2> queue;
+    int value = 0;
+    for (int i = 0; i < 1000; ++i) {
+        TEST_ASSERT_TRUE(queue.push(i));
+        TEST_ASSERT_TRUE(queue.pop(value));
+        TEST_ASSERT_EQUAL(i, value);
+    }
+}
+
+void test_concurrent_producer_and_consumer(void) {
+    static SpscQueue<Sample, 64> queue;
+    const uint32_t count = 200000;
+    std::atomic<bool> done(false);
+
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < count;) {
+            if (queue.push(Sample::make(i))) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        done = true;
+    });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    Sample sample;
+    while (!done || !queue.empty()) {
+        if (queue.pop(sample)) {
+            ordered = ordered && sample.valid() && sample.sequence == expected;
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL(count, expected);
+}
+
+uint64_t steadyMicros() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void test_sampler_tick_drives_main_loop(void) {
+    QueuedSensor fast;
+    QueuedSensor slow;
+    slow.period = 5000;
+
+    SensorSampler sampler;
+    TEST_ASSERT_TRUE(sampler.addSource(fast));
+    TEST_ASSERT_TRUE(sampler.addSource(slow));
+    TEST_ASSERT_TRUE(sampler.start(500));
+
+    // The tick only counts, nothing is read until the main loop services it
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    TEST_ASSERT_TRUE(sampler.getTickCount() > 0);
+    TEST_ASSERT_EQUAL(0, fast.produced);
+
+    // Main loop with irregular stalls, like a flash write
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+    int pass = 0;
+    while (std::chrono::steady_clock::now() < end) {
+        sampler.service(steadyMicros());
+        fast.update();
+        slow.update();
+        std::this_thread::sleep_for(std::chrono::microseconds((++pass % 50 == 0) ? 20000 : 100));
+    }
+    sampler.stop();
+    sampler.service(steadyMicros());
+    fast.update();
+    slow.update();
+
+    TEST_ASSERT_FALSE(sampler.isRunning());
+    TEST_ASSERT_TRUE(fast.ordered);
+    TEST_ASSERT_TRUE(slow.ordered);
+    TEST_ASSERT_EQUAL(fast.produced, fast.consumed);
+    TEST_ASSERT_TRUE(fast.consumed > 100);
+    TEST_ASSERT_TRUE(slow.consumed > 10);
+    TEST_ASSERT_TRUE(slow.consumed < fast.consumed / 4);
+    // Ticks missed during a stall are serviced once
+    TEST_ASSERT_TRUE(sampler.getCoalescedCount() > 0);
+    TEST_ASSERT_EQUAL(sampler.getTickCount(), sampler.getSchedule(0).getPerformedCount() + sampler.getCoalescedCount());
+
+    // No new tick, nothing to service
+    TEST_ASSERT_FALSE(sampler.service(steadyMicros()));
+}
+
+void test_only_one_sampler_owns_the_tick(void) {
+    SensorSampler first;
+    SensorSampler second;
+    TEST_ASSERT_TRUE(first.start(1000));
+    TEST_ASSERT_FALSE(second.start(1000));
+    first.stop();
+    TEST_ASSERT_TRUE(second.start(1000));
+    second.stop();
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_push_pop_in_order);
+    RUN_TEST(test_full_queue_drops_newest);
+    RUN_TEST(test_indices_wrap);
+    RUN_TEST(test_concurrent_producer_and_consumer);
+    RUN_TEST(test_sampler_tick_drives_main_loop);
+    RUN_TEST(test_only_one_sampler_owns_the_tick);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,180 @@
+#include <unity.h>
+#include "taskScheduler.hpp"
+
+// Simulated clock, advanced by the tasks as they "run"
+static uint64_t simulatedTime = 0;
+static uint64_t simulatedClock() {
+    return simulatedTime;
+}
+
+// Flight task: has work once per 2 ms control tick, taking 300 us
+static uint64_t nextTick = 0;
+static int flightRuns = 0;
+static uint64_t worstTickLatency = 0;
+static bool flightTask() {
+    if (simulatedTime < nextTick) {
+        return false;
+    }
+    uint64_t latency = simulatedTime - nextTick;
+    if (latency > worstTickLatency) {
+        worstTickLatency = latency;
+    }
+    nextTick += 2000;
+    simulatedTime += 300;
+    flightRuns++;
+    return true;
+}
+
+// Ground task: always has work, in 150 us steps, like streaming a file
+static int groundRuns = 0;
+static bool groundTask() {
+    simulatedTime += 150;
+    groundRuns++;
+    return true;
+}
+
+// Periodic task, 50 us per step
+static int periodicRuns = 0;
+static bool periodicTask() {
+    simulatedTime += 50;
+    periodicRuns++;
+    return true;
+}
+
+// Polled task with nothing to do
+static int idleCalls = 0;
+static bool idleTask() {
+    idleCalls++;
+    return false;
+}
+
+// Step that runs long
+static bool slowTask() {
+    simulatedTime += 5000;
+    return true;
+}
+
+void setUp(void) {
+    // Any setup code can go here
+    simulatedTime = 0;
+    nextTick = 0;
+    flightRuns = 0;
+    worstTickLatency = 0;
+    groundRuns = 0;
+    periodicRuns = 0;
+    idleCalls = 0;
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_priority_order_not_add_order(void) {
+    TaskScheduler scheduler(simulatedClock);
+    int ground = scheduler.addTask("ground", groundTask, TaskPriority::GROUND);
+    int flight = scheduler.addTask("flight", flightTask, TaskPriority::FLIGHT_CRITICAL);
+    TEST_ASSERT_EQUAL(0, ground);
+    TEST_ASSERT_EQUAL(1, flight);
+
+    // Flight work is due, so it runs first even though it was added last
+    TEST_ASSERT_TRUE(scheduler.runPass());
+    TEST_ASSERT_EQUAL(1, flightRuns);
+    TEST_ASSERT_EQUAL(0, groundRuns);
+
+    // Nothing left for flight, the ground task gets the pass
+    TEST_ASSERT_TRUE(scheduler.runPass());
+    TEST_ASSERT_EQUAL(1, groundRuns);
+}
+
+void test_ground_work_cannot_starve_flight(void) {
+    TaskScheduler scheduler(simulatedClock);
+    scheduler.addTask("ground", groundTask, TaskPriority::GROUND);
+    scheduler.addTask("flight", flightTask, TaskPriority::FLIGHT_CRITICAL);
+
+    // One second of a ground operation that never runs out of work
+    while (simulatedTime < 1000000) {
+        scheduler.runPass();
+    }
+    TEST_ASSERT_EQUAL(500, flightRuns);
+    TEST_ASSERT_TRUE(groundRuns > 5000);
+    // A tick waits at most for the ground step already running
+    TEST_ASSERT_TRUE(worstTickLatency <= 150);
+}
+
+void test_periodic_task_keeps_its_rate(void) {
+    TaskScheduler scheduler(simulatedClock);
+    int periodic = scheduler.addTask("periodic", periodicTask, TaskPriority::PERIPHERAL, 1000, 500);
+    scheduler.addTask("idle", idleTask, TaskPriority::GROUND);
+
+    for (simulatedTime = 0; simulatedTime < 100000; simulatedTime += 10) {
+        scheduler.runPass();
+    }
+    TEST_ASSERT_EQUAL(100, periodicRuns);
+    TEST_ASSERT_EQUAL(100, scheduler.getTask(periodic).runs);
+    TEST_ASSERT_EQUAL(0, scheduler.getTask(periodic).deadlineMisses);
+    TEST_ASSERT_EQUAL(50, scheduler.getTask(periodic).maxRunTime);
+    // The idle task is polled whenever the periodic task is not released
+    TEST_ASSERT_TRUE(idleCalls > 9000);
+}
+
+void test_held_task_skips_missed_releases(void) {
+    TaskScheduler scheduler(simulatedClock);
+    int periodic = scheduler.addTask("periodic", periodicTask, TaskPriority::PERIPHERAL, 1000, 500);
+    TEST_ASSERT_TRUE(scheduler.runPass());
+
+    // The loop is held for over five periods
+    simulatedTime = 5600;
+    TEST_ASSERT_TRUE(scheduler.runPass());
+    TEST_ASSERT_EQUAL(1, scheduler.getTask(periodic).deadlineMisses);
+    // Released again on the original grid, not straight away
+    TEST_ASSERT_FALSE(scheduler.runPass());
+    simulatedTime = 6000;
+    TEST_ASSERT_TRUE(scheduler.runPass());
+    TEST_ASSERT_EQUAL(3, periodicRuns);
+}
+
+void test_deadline_miss_is_counted(void) {
+    TaskScheduler scheduler(simulatedClock);
+    int slow = scheduler.addTask("slow", slowTask, TaskPriority::FLIGHT, 10000, 2000);
+    scheduler.runPass();
+    TEST_ASSERT_EQUAL(1, scheduler.getTask(slow).deadlineMisses);
+    TEST_ASSERT_EQUAL(5000, scheduler.getTask(slow).maxRunTime);
+}
+
+void test_disabled_task_does_not_run(void) {
+    TaskScheduler scheduler(simulatedClock);
+    int ground = scheduler.addTask("ground", groundTask, TaskPriority::GROUND);
+    scheduler.setEnabled(ground, false);
+    TEST_ASSERT_FALSE(scheduler.runPass());
+    TEST_ASSERT_EQUAL(0, groundRuns);
+    scheduler.setEnabled(ground, true);
+    TEST_ASSERT_TRUE(scheduler.runPass());
+    TEST_ASSERT_EQUAL(1, groundRuns);
+}
+
+void test_scheduler_full(void) {
+    TaskScheduler scheduler(simulatedClock);
+    for (size_t i = 0; i < TaskScheduler::MAX_TASKS; ++i) {
+        TEST_ASSERT_EQUAL(i, scheduler.addTask("idle", idleTask, TaskPriority::GROUND));
+    }
+    TEST_ASSERT_EQUAL(-1, scheduler.addTask("idle", idleTask, TaskPriority::GROUND));
+    TEST_ASSERT_EQUAL(-1, TaskScheduler(simulatedClock).addTask("null", nullptr, TaskPriority::GROUND));
+    TEST_ASSERT_EQUAL(TaskScheduler::MAX_TASKS, scheduler.getNumTasks());
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_priority_order_not_add_order);
+    RUN_TEST(test_ground_work_cannot_starve_flight);
+    RUN_TEST(test_periodic_task_keeps_its_rate);
+    RUN_TEST(test_held_task_skips_missed_releases);
+    RUN_TEST(test_deadline_miss_is_counted);
+    RUN_TEST(test_disabled_task_does_not_run);
+    RUN_TEST(test_scheduler_full);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
@@ -0,0 +1,245 @@
+#include <unity.h>
+#include <vector>
+#include "timeOrderedFilter.hpp"
+
+const float MODEL_SIGMA = 5.0f;
+const float ALTITUDE_SIGMA = 1.0f;
+const float ACCELERATION_SIGMA = 0.5f;
+
+/**
+ * A correction the filter asked a sensor for: the sensor, the measurement's
+ * timestamp and the time the filter state had been predicted to.
+ */
+struct Correction {
+    int sensor;
+    uint64_t measurementTime;
+    uint64_t stateTime;
+};
+
+const TimeOrderedFilter* activeFilter = nullptr;
+std::vector<Correction> corrections;
+
+/**
+ * Sensor holding the new measurements of one update, oldest first. Reading a
+ * measurement records it as a correction, with the filter state time at that point.
+ */
+class FakeSensor : public SensorProcessor {
+public:
+    FakeSensor(int id, SensorOutput output) : id_(id), output_(output) {}
+
+    void set(const std::vector<uint64_t>& times, const std::vector<float>& values) {
+        times_ = times;
+        values_ = values;
+    }
+
+    void update() override {}
+    bool hasEstimate(SensorOutput output) const override { return output == output_; }
+    float getVariance(SensorOutput) const override { return 1.0f; }
+    uint32_t getUpdateCount() const override { return 0; }
+    size_t getNumNewMeasurements() const override { return times_.size(); }
+    uint64_t getNewMeasurementTime(size_t index) const override { return times_[index]; }
+    float getNewMeasurement(SensorOutput, size_t index) const override {
+        corrections.push_back({id_, times_[index], activeFilter->getStateTime()});
+        return values_[index];
+    }
+    float getAltitude() const override { return 0; }
+    float getVerticalVelocity() const override { return 0; }
+    float getAcceleration() const override { return 0; }
+    float getGroundAltitude() const override { return 0; }
+    float getMaxAltitude() const override { return 0; }
+    float getMaxVelocity() const override { return 0; }
+    float getMaxAcceleration() const override { return 0; }
+    float* getRawData() const override { return nullptr; }
+    size_t getNumSensorValues() const override { return 0; }
+    std::string getSensorNames() const override { return ""; }
+
+private:
+    int id_;
+    SensorOutput output_;
+    std::vector<uint64_t> times_;
+    std::vector<float> values_;
+};
+
+const int BARO = 0;
+const int IMU = 1;
+
+// Start the filter with one barometer sample at a time
+void initialise(TimeOrderedFilter& filter, FakeSensor& baro, uint64_t time) {
+    baro.set({time}, {0.0f});
+    filter.begin();
+    filter.queue(baro);
+    filter.fuse(time);
+    corrections.clear();
+}
+
+// Fuse one pass, queueing the sensors in the given order
+void fusePass(TimeOrderedFilter& filter, FakeSensor* const* sensors, size_t count, uint64_t now) {
+    activeFilter = &filter;
+    filter.begin();
+    for (size_t i = 0; i < count; ++i) {
+        TEST_ASSERT_TRUE(filter.queue(*sensors[i]));
+    }
+    filter.fuse(now);
+}
+
+// Setup function runs before each test
+void setUp(void) {
+    corrections.clear();
+}
+
+// Teardown function runs after each test
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_interleaved_measurements_run_in_timestamp_order() {
+    TimeOrderedFilter filter(MODEL_SIGMA, ALTITUDE_SIGMA, ACCELERATION_SIGMA);
+    FakeSensor baro(BARO, SensorOutput::ALTITUDE);
+    FakeSensor imu(IMU, SensorOutput::ACCELERATION);
+    activeFilter = &filter;
+    initialise(filter, baro, 1000);
+
+    // The IMU batch arrives before the barometer samples taken between its samples
+    imu.set({2000, 3000, 4000, 5000, 6000, 7000}, {1, 1, 1, 1, 1, 1});
+    baro.set({3500, 6500}, {0.1f, 0.2f});
+    FakeSensor* arrival[] = {&imu, &baro};
+    fusePass(filter, arrival, 2, 8000);
+
+    const int expectedSensors[] = {IMU, IMU, BARO, IMU, IMU, IMU, BARO, IMU};
+    const uint64_t expectedTimes[] = {2000, 3000, 3500, 4000, 5000, 6000, 6500, 7000};
+    TEST_ASSERT_EQUAL(8, corrections.size());
+    for (size_t i = 0; i < corrections.size(); ++i) {
+        TEST_ASSERT_EQUAL(expectedSensors[i], corrections[i].sensor);
+        TEST_ASSERT_EQUAL(expectedTimes[i], corrections[i].measurementTime);
+        // Each correction follows a prediction to its own timestamp
+        TEST_ASSERT_EQUAL(expectedTimes[i], corrections[i].stateTime);
+    }
+    TEST_ASSERT_EQUAL(7000, filter.getStateTime());
+}
+
+void test_queue_order_does_not_change_the_result() {
+    TimeOrderedFilter imuFirst(MODEL_SIGMA, ALTITUDE_SIGMA, ACCELERATION_SIGMA);
+    TimeOrderedFilter baroFirst(MODEL_SIGMA, ALTITUDE_SIGMA, ACCELERATION_SIGMA);
+    FakeSensor baro(BARO, SensorOutput::ALTITUDE);
+    FakeSensor imu(IMU, SensorOutput::ACCELERATION);
+    activeFilter = &imuFirst;
+    initialise(imuFirst, baro, 1000);
+    activeFilter = &baroFirst;
+    initialise(baroFirst, baro, 1000);
+
+    // Climbing at 2 m/s^2, the barometer at 100 Hz and the IMU at 1 kHz
+    for (uint64_t pass = 0; pass < 50; ++pass) {
+        uint64_t start = 1000 + pass * 10000;
+        std::vector<uint64_t> imuTimes;
+        std::vector<float> imuValues;
+        for (uint64_t t = start + 1000; t <= start + 10000; t += 1000) {
+            imuTimes.push_back(t);
+            imuValues.push_back(2.0f);
+        }
+        float seconds = (start + 5000 - 1000) * 1e-6f;
+        imu.set(imuTimes, imuValues);
+        baro.set({start + 5000}, {seconds * seconds});
+
+        FakeSensor* first[] = {&imu, &baro};
+        FakeSensor* second[] = {&baro, &imu};
+        fusePass(imuFirst, first, 2, start + 10000);
+        fusePass(baroFirst, second, 2, start + 10000);
+    }
+
+    TEST_ASSERT_EQUAL(imuFirst.getStateTime(), baroFirst.getStateTime());
+    TEST_ASSERT_EQUAL_FLOAT(imuFirst.getAltitude(), baroFirst.getAltitude());
+    TEST_ASSERT_EQUAL_FLOAT(imuFirst.getVelocity(), baroFirst.getVelocity());
+    TEST_ASSERT_EQUAL_FLOAT(imuFirst.getAcceleration(), baroFirst.getAcceleration());
+    TEST_ASSERT_FLOAT_WITHIN(0.2f, 2.0f, imuFirst.getAcceleration());
+}
+
+void test_late_measurement_corrects_the_current_state() {
+    TimeOrderedFilter filter(MODEL_SIGMA, ALTITUDE_SIGMA, ACCELERATION_SIGMA);
+    FakeSensor baro(BARO, SensorOutput::ALTITUDE);
+    FakeSensor imu(IMU, SensorOutput::ACCELERATION);
+    activeFilter = &filter;
+    initialise(filter, baro, 1000);
+
+    FakeSensor* imuOnly[] = {&imu};
+    imu.set({2000, 3000, 4000}, {0, 0, 0});
+    fusePass(filter, imuOnly, 1, 5000);
+    corrections.clear();
+
+    // A barometer sample taken before the state time, with more latency than the IMU
+    FakeSensor* baroOnly[] = {&baro};
+    baro.set({2500}, {0.0f});
+    fusePass(filter, baroOnly, 1, 6000);
+    TEST_ASSERT_EQUAL(1, corrections.size());
+    TEST_ASSERT_EQUAL(4000, corrections[0].stateTime);
+    TEST_ASSERT_EQUAL(4000, filter.getStateTime());
+}
+
+void test_untimed_measurement_uses_the_processing_time() {
+    TimeOrderedFilter filter(MODEL_SIGMA, ALTITUDE_SIGMA, ACCELERATION_SIGMA);
+    FakeSensor baro(BARO, SensorOutput::ALTITUDE);
+    FakeSensor imu(IMU, SensorOutput::ACCELERATION);
+    activeFilter = &filter;
+    initialise(filter, baro, 1000);
+
+    // Without a timestamp the barometer sample is taken as made when processed, after the IMU batch
+    baro.set({0}, {0.0f});
+    imu.set({2000, 3000}, {0, 0});
+    FakeSensor* arrival[] = {&baro, &imu};
+    fusePass(filter, arrival, 2, 4000);
+    TEST_ASSERT_EQUAL(3, corrections.size());
+    TEST_ASSERT_EQUAL(IMU, corrections[0].sensor);
+    TEST_ASSERT_EQUAL(IMU, corrections[1].sensor);
+    TEST_ASSERT_EQUAL(BARO, corrections[2].sensor);
+    TEST_ASSERT_EQUAL(4000, corrections[2].stateTime);
+}
+
+void test_filter_waits_for_an_altitude() {
+    TimeOrderedFilter filter(MODEL_SIGMA, ALTITUDE_SIGMA, ACCELERATION_SIGMA);
+    FakeSensor baro(BARO, SensorOutput::ALTITUDE);
+    FakeSensor imu(IMU, SensorOutput::ACCELERATION);
+
+    // Accelerations alone can not start the filter
+    imu.set({1000, 2000}, {1, 1});
+    FakeSensor* imuOnly[] = {&imu};
+    fusePass(filter, imuOnly, 1, 3000);
+    TEST_ASSERT_FALSE(filter.isInitialised());
+    TEST_ASSERT_EQUAL(0, corrections.size());
+
+    // The first altitude starts it at its own time
+    baro.set({2500}, {12.0f});
+    FakeSensor* baroOnly[] = {&baro};
+    fusePass(filter, baroOnly, 1, 4000);
+    TEST_ASSERT_TRUE(filter.isInitialised());
+    TEST_ASSERT_EQUAL(2500, filter.getStateTime());
+    TEST_ASSERT_EQUAL_FLOAT(12.0f, filter.getAltitude());
+}
+
+void test_queue_is_bounded() {
+    TimeOrderedFilter filter(MODEL_SIGMA, ALTITUDE_SIGMA, ACCELERATION_SIGMA);
+    FakeSensor baro(BARO, SensorOutput::ALTITUDE);
+    filter.begin();
+    for (size_t i = 0; i < TimeOrderedFilter::MAX_SOURCES; ++i) {
+        TEST_ASSERT_TRUE(filter.queue(baro));
+    }
+    TEST_ASSERT_FALSE(filter.queue(baro));
+
+    // The next pass starts empty
+    filter.begin();
+    TEST_ASSERT_TRUE(filter.queue(baro));
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_interleaved_measurements_run_in_timestamp_order);
+    RUN_TEST(test_queue_order_does_not_change_the_result);
+    RUN_TEST(test_late_measurement_corrects_the_current_state);
+    RUN_TEST(test_untimed_measurement_uses_the_processing_time);
+    RUN_TEST(test_filter_waits_for_an_altitude);
+    RUN_TEST(test_queue_is_bounded);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}
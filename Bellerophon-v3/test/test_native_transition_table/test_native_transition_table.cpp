@@ -0,0 +1,159 @@
+#include <unity.h>
+#include "transitionTable.hpp"
+
+enum class PadState { IDLE, ARMED, FIRING, DONE, NUM_STATES };
+
+constexpr size_t NUM_PAD_STATES = static_cast<size_t>(PadState::NUM_STATES);
+
+/**
+ * Small launch pad controller with the guards and actions the tables point at.
+ */
+class Pad {
+public:
+    bool key = false;
+    bool button = false;
+    bool fired = false;
+    int actions = 0;
+    mutable int evaluations = 0;
+
+    bool isKeyed() const { evaluations++; return key; }
+    bool isUnkeyed() const { evaluations++; return !key; }
+    bool isPressed() const { evaluations++; return button; }
+    bool isFired() const { evaluations++; return fired; }
+    void count() { actions++; }
+};
+
+typedef Transition<PadState, Pad> PadTransition;
+
+constexpr PadTransition TABLE[] = {
+    {PadState::IDLE,   &Pad::isKeyed,   &Pad::count, PadState::ARMED,  "keyed"},
+    {PadState::ARMED,  &Pad::isUnkeyed, nullptr,     PadState::IDLE,   "unkeyed"},
+    {PadState::ARMED,  &Pad::isPressed, &Pad::count, PadState::FIRING, "pressed"},
+    {PadState::FIRING, &Pad::isFired,   &Pad::count, PadState::DONE,   "fired"},
+};
+constexpr size_t TABLE_SIZE = sizeof(TABLE) / sizeof(TABLE[0]);
+constexpr TransitionIndex<NUM_PAD_STATES> INDEX = TransitionTable::makeIndex<NUM_PAD_STATES>(TABLE, TABLE_SIZE);
+
+static_assert(TransitionTable::statesInRange(TABLE, TABLE_SIZE, NUM_PAD_STATES), "states in range");
+static_assert(TransitionTable::isGroupedByState(TABLE, TABLE_SIZE), "grouped by state");
+static_assert(TransitionTable::isWellFormed(TABLE, TABLE_SIZE), "well formed");
+static_assert(TransitionTable::allReachable(TABLE, TABLE_SIZE, NUM_PAD_STATES, PadState::IDLE), "all reachable");
+
+// Tables each check must reject
+constexpr PadTransition UNGROUPED[] = {
+    {PadState::ARMED, &Pad::isPressed, nullptr, PadState::FIRING, "pressed"},
+    {PadState::IDLE,  &Pad::isKeyed,   nullptr, PadState::ARMED,  "keyed"},
+    {PadState::ARMED, &Pad::isUnkeyed, nullptr, PadState::IDLE,   "unkeyed"},
+};
+constexpr PadTransition UNGUARDED[] = {
+    {PadState::IDLE, nullptr, nullptr, PadState::ARMED, "always"},
+};
+constexpr PadTransition SELF_LOOP[] = {
+    {PadState::IDLE, &Pad::isKeyed, nullptr, PadState::IDLE, "loop"},
+};
+constexpr PadTransition OUT_OF_RANGE[] = {
+    {PadState::IDLE, &Pad::isKeyed, nullptr, PadState::NUM_STATES, "nowhere"},
+};
+constexpr PadTransition UNREACHABLE[] = {
+    {PadState::IDLE,  &Pad::isKeyed,   nullptr, PadState::ARMED, "keyed"},
+    {PadState::ARMED, &Pad::isUnkeyed, nullptr, PadState::IDLE,  "unkeyed"},
+    {PadState::FIRING, &Pad::isFired,  nullptr, PadState::DONE,  "fired"},
+};
+
+static_assert(!TransitionTable::isGroupedByState(UNGROUPED, 3), "rejects ungrouped");
+static_assert(!TransitionTable::isWellFormed(UNGUARDED, 1), "rejects a missing guard");
+static_assert(!TransitionTable::isWellFormed(SELF_LOOP, 1), "rejects a self transition");
+static_assert(!TransitionTable::statesInRange(OUT_OF_RANGE, 1, NUM_PAD_STATES), "rejects an invalid state");
+static_assert(!TransitionTable::allReachable(UNREACHABLE, 3, NUM_PAD_STATES, PadState::IDLE), "rejects unreachable states");
+
+struct Behaviour {
+    PadState state;
+    int logInterval;
+};
+constexpr Behaviour BEHAVIOURS[] = {{PadState::IDLE, 0}, {PadState::ARMED, 1}, {PadState::FIRING, 2}, {PadState::DONE, 3}};
+constexpr Behaviour MISORDERED[] = {{PadState::IDLE, 0}, {PadState::FIRING, 2}, {PadState::ARMED, 1}, {PadState::DONE, 3}};
+static_assert(TransitionTable::isIndexedByState(BEHAVIOURS, 4, NUM_PAD_STATES), "indexed by state");
+static_assert(!TransitionTable::isIndexedByState(MISORDERED, 4, NUM_PAD_STATES), "rejects misordered rows");
+static_assert(!TransitionTable::isIndexedByState(BEHAVIOURS, 3, NUM_PAD_STATES), "rejects a missing state");
+
+/**
+ * @brief Take one step of the pad state machine.
+ */
+PadState step(Pad& pad, PadState state) {
+    int row = TransitionTable::findTransition(pad, TABLE, INDEX, state);
+    if (row < 0) {
+        return state;
+    }
+    if (TABLE[row].action != nullptr) {
+        (pad.*TABLE[row].action)();
+    }
+    return TABLE[row].to;
+}
+
+void setUp(void) {
+    // Any setup code can go here
+}
+
+void tearDown(void) {
+    // Any cleanup code can go here
+}
+
+void test_index_covers_each_state(void) {
+    TEST_ASSERT_EQUAL(0, INDEX.first[static_cast<size_t>(PadState::IDLE)]);
+    TEST_ASSERT_EQUAL(1, INDEX.first[static_cast<size_t>(PadState::ARMED)]);
+    TEST_ASSERT_EQUAL(3, INDEX.first[static_cast<size_t>(PadState::FIRING)]);
+    TEST_ASSERT_EQUAL(4, INDEX.first[static_cast<size_t>(PadState::DONE)]);
+    TEST_ASSERT_EQUAL(4, INDEX.first[NUM_PAD_STATES]);
+}
+
+void test_only_guards_of_the_current_state_run(void) {
+    Pad pad;
+    TEST_ASSERT_TRUE(step(pad, PadState::IDLE) == PadState::IDLE);
+    TEST_ASSERT_EQUAL(1, pad.evaluations);
+
+    // DONE has no transitions, so nothing is evaluated
+    pad.evaluations = 0;
+    TEST_ASSERT_TRUE(step(pad, PadState::DONE) == PadState::DONE);
+    TEST_ASSERT_EQUAL(0, pad.evaluations);
+}
+
+void test_first_passing_guard_wins(void) {
+    Pad pad;
+    pad.key = false;
+    pad.button = true;
+    // Unkeyed comes first in the table, so the pad disarms rather than fires
+    TEST_ASSERT_TRUE(step(pad, PadState::ARMED) == PadState::IDLE);
+    TEST_ASSERT_EQUAL(1, pad.evaluations);
+    TEST_ASSERT_EQUAL(0, pad.actions);
+}
+
+void test_runs_a_sequence_with_actions(void) {
+    Pad pad;
+    PadState state = PadState::IDLE;
+    pad.key = true;
+    state = step(pad, state);
+    TEST_ASSERT_TRUE(state == PadState::ARMED);
+    state = step(pad, state);
+    TEST_ASSERT_TRUE(state == PadState::ARMED);
+    pad.button = true;
+    state = step(pad, state);
+    TEST_ASSERT_TRUE(state == PadState::FIRING);
+    pad.fired = true;
+    state = step(pad, state);
+    TEST_ASSERT_TRUE(state == PadState::DONE);
+    TEST_ASSERT_EQUAL(3, pad.actions);
+}
+
+int main(int argc, char **argv) {
+    // Start Unity test framework
+    UNITY_BEGIN();
+
+    // Run the test cases
+    RUN_TEST(test_index_covers_each_state);
+    RUN_TEST(test_only_guards_of_the_current_state_run);
+    RUN_TEST(test_first_passing_guard_wins);
+    RUN_TEST(test_runs_a_sequence_with_actions);
+
+    // Finish Unity test framework
+    return UNITY_END();
+}